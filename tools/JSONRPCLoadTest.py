@@ -0,0 +1,102 @@
+#
+#      Copyright (C) 2005-2012 Team XBMC
+#      http://www.xbmc.org
+#
+#  This Program is free software; you can redistribute it and/or modify
+#  it under the terms of the GNU General Public License as published by
+#  the Free Software Foundation; either version 2, or (at your option)
+#  any later version.
+#
+#  This Program is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with XBMC; see the file COPYING.  If not, write to
+#  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+#  http://www.gnu.org/copyleft/gpl.html
+#
+
+# Load test for the JSON-RPC TCP server.
+#
+# Connects a number of clients that read announcements, and a number of
+# clients that never read anything, then has one more client send
+# JSONRPC.NotifyAll requests as fast as it gets the replies. Reports how
+# long the requests took and when each reading client got the announcements,
+# which shouldn't depend on the clients that don't read.
+#
+# usage: python JSONRPCLoadTest.py [host] [port] [readers] [stalled] [announcements]
+
+import socket, sys, threading, time
+
+host          = len(sys.argv) > 1 and sys.argv[1] or "127.0.0.1"
+port          = len(sys.argv) > 2 and int(sys.argv[2]) or 9090
+readers       = len(sys.argv) > 3 and int(sys.argv[3]) or 32
+stalled       = len(sys.argv) > 4 and int(sys.argv[4]) or 4
+announcements = len(sys.argv) > 5 and int(sys.argv[5]) or 1000
+
+MARKER = b'"Other.loadtest"'
+
+class Reader(threading.Thread):
+  def __init__(self):
+    threading.Thread.__init__(self)
+    self.daemon = True
+    self.sock = socket.create_connection((host, port))
+    self.count = 0
+    self.last = None
+
+  def run(self):
+    tail = b''
+    while self.count < announcements:
+      data = self.sock.recv(65536)
+      if not data:
+        break
+      data = tail + data
+      self.count += data.count(MARKER)
+      tail = data[-len(MARKER):]
+      self.last = time.time()
+
+# clients that connect and never read, with receive buffers as small as we can get
+stalledClients = []
+for i in range(stalled):
+  s = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+  s.setsockopt(socket.SOL_SOCKET, socket.SO_RCVBUF, 1024)
+  s.connect((host, port))
+  stalledClients.append(s)
+
+readerClients = [Reader() for i in range(readers)]
+for r in readerClients:
+  r.start()
+
+driver = socket.create_connection((host, port))
+request = '{"jsonrpc": "2.0", "method": "JSONRPC.NotifyAll", "params": {"sender": "loadtest", "message": "loadtest", "data": %d}, "id": %d}'
+
+start = time.time()
+slowest = 0
+buffer = b''
+for i in range(announcements):
+  sent = time.time()
+  driver.sendall((request % (i, i)).encode())
+  # wait for our reply, skipping the announcements the driver gets as well
+  reply = ('"id":%d,' % i).encode()
+  while reply not in buffer:
+    buffer += driver.recv(65536)
+  buffer = buffer[buffer.index(reply) + len(reply):]
+  slowest = max(slowest, time.time() - sent)
+elapsed = time.time() - start
+
+print("%d requests in %.2fs, %.0f/s, slowest %.1fms" % (announcements, elapsed, announcements / elapsed, slowest * 1000))
+
+deadline = time.time() + 10
+for r in readerClients:
+  r.join(max(0, deadline - time.time()))
+
+complete = [r for r in readerClients if r.count >= announcements]
+print("%d of %d readers got all %d announcements" % (len(complete), readers, announcements))
+if complete:
+  lags = [r.last - start for r in complete]
+  print("last announcement received after %.2fs - %.2fs" % (min(lags), max(lags)))
+for r in readerClients:
+  if r.count < announcements:
+    print("reader got %d announcements" % r.count)
@@ -0,0 +1,74 @@
+#
+#      Copyright (C) 2005-2012 Team XBMC
+#      http://www.xbmc.org
+#
+#  This Program is free software; you can redistribute it and/or modify
+#  it under the terms of the GNU General Public License as published by
+#  the Free Software Foundation; either version 2, or (at your option)
+#  any later version.
+#
+#  This Program is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with XBMC; see the file COPYING.  If not, write to
+#  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+#  http://www.gnu.org/copyleft/gpl.html
+#
+
+# Request rate benchmark for the JSON-RPC TCP server.
+#
+# Sends the Player.GetProperties call remotes poll with, one request after
+# the other, and reports how many requests per second were answered. Start
+# playing something first, otherwise every request fails after validation.
+#
+# usage: python JSONRPCPollTest.py [host] [port] [requests] [playerid]
+
+import json, socket, sys, time
+
+host     = len(sys.argv) > 1 and sys.argv[1] or "127.0.0.1"
+port     = len(sys.argv) > 2 and int(sys.argv[2]) or 9090
+requests = len(sys.argv) > 3 and int(sys.argv[3]) or 10000
+playerid = len(sys.argv) > 4 and int(sys.argv[4]) or 1
+
+properties = ["time", "totaltime", "percentage", "speed", "playlistid", "position", "repeat",
+              "shuffled", "canseek", "partymode", "subtitleenabled", "currentaudiostream",
+              "currentsubtitle"]
+
+sock = socket.create_connection((host, port))
+sock.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+decoder = json.JSONDecoder()
+buffer = ""
+
+def receive(id):
+  global buffer
+  while True:
+    try:
+      obj, end = decoder.raw_decode(buffer.lstrip())
+      buffer = buffer.lstrip()[end:]
+      # skip announcements
+      if obj.get("id") == id:
+        return obj
+      continue
+    except ValueError:
+      pass
+    data = sock.recv(65536)
+    if not data:
+      raise IOError("connection closed")
+    buffer += data.decode("utf-8")
+
+start = time.time()
+slowest = 0
+errors = 0
+for i in range(requests):
+  sent = time.time()
+  sock.sendall(json.dumps({"jsonrpc": "2.0", "method": "Player.GetProperties",
+                           "params": {"playerid": playerid, "properties": properties}, "id": i}).encode())
+  if "error" in receive(i):
+    errors += 1
+  slowest = max(slowest, time.time() - sent)
+elapsed = time.time() - start
+
+print("%d requests in %.2fs, %.0f/s, slowest %.1fms, %d errors" % (requests, elapsed, requests / elapsed, slowest * 1000, errors))
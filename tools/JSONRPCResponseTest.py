@@ -0,0 +1,111 @@
+#
+#      Copyright (C) 2005-2012 Team XBMC
+#      http://www.xbmc.org
+#
+#  This Program is free software; you can redistribute it and/or modify
+#  it under the terms of the GNU General Public License as published by
+#  the Free Software Foundation; either version 2, or (at your option)
+#  any later version.
+#
+#  This Program is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with XBMC; see the file COPYING.  If not, write to
+#  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+#  http://www.gnu.org/copyleft/gpl.html
+#
+
+# Measures large JSON-RPC responses over HTTP and TCP.
+#
+# Requests the whole movie and song libraries with all properties and reports
+# how long it took until the first byte and the whole response arrived. Given
+# the pid of a local XBMC, also reports its peak memory use (VmHWM) after each
+# request, which is best measured against a freshly started instance.
+#
+# usage: python JSONRPCResponseTest.py [host] [httpport] [tcpport] [pid]
+
+import json, socket, sys, time
+
+host     = len(sys.argv) > 1 and sys.argv[1] or "127.0.0.1"
+httpport = len(sys.argv) > 2 and int(sys.argv[2]) or 8080
+tcpport  = len(sys.argv) > 3 and int(sys.argv[3]) or 9090
+pid      = len(sys.argv) > 4 and sys.argv[4] or None
+
+MOVIE_PROPERTIES = ["title", "genre", "year", "rating", "director", "trailer", "tagline", "plot",
+                    "plotoutline", "originaltitle", "lastplayed", "playcount", "writer", "studio",
+                    "mpaa", "cast", "country", "imdbnumber", "runtime", "set", "showlink",
+                    "streamdetails", "top250", "votes", "fanart", "thumbnail", "file", "sorttitle",
+                    "resume", "setid", "dateadded", "tag", "art"]
+SONG_PROPERTIES = ["title", "artist", "albumartist", "genre", "year", "rating", "album", "track",
+                   "duration", "comment", "lyrics", "musicbrainztrackid", "musicbrainzartistid",
+                   "musicbrainzalbumid", "musicbrainzalbumartistid", "playcount", "fanart",
+                   "thumbnail", "file", "albumid", "lastplayed", "disc", "genreid", "artistid",
+                   "displayartist", "albumartistid"]
+
+requests = [
+  ("VideoLibrary.GetMovies", {"properties": MOVIE_PROPERTIES}),
+  ("AudioLibrary.GetSongs", {"properties": SONG_PROPERTIES}),
+]
+
+def peakMemory():
+  if not pid:
+    return ""
+  for line in open("/proc/%s/status" % pid):
+    if line.startswith("VmHWM:"):
+      return ", peak memory %s" % " ".join(line.split()[1:])
+  return ""
+
+def request(method, params):
+  return json.dumps({"jsonrpc": "2.0", "method": method, "params": params, "id": 1}).encode()
+
+def http(method, params):
+  body = request(method, params)
+  sock = socket.create_connection((host, httpport))
+  start = time.time()
+  sock.sendall(("POST /jsonrpc HTTP/1.1\r\nHost: %s\r\nContent-Type: application/json\r\n"
+                "Content-Length: %d\r\nConnection: close\r\n\r\n" % (host, len(body))).encode() + body)
+  first = None
+  size = 0
+  while True:
+    data = sock.recv(65536)
+    if not data:
+      break
+    if first is None:
+      first = time.time()
+    size += len(data)
+  sock.close()
+  return start, first, time.time(), size
+
+def tcp(method, params):
+  sock = socket.create_connection((host, tcpport))
+  start = time.time()
+  sock.sendall(request(method, params))
+  decoder = json.JSONDecoder()
+  first = None
+  response = ""
+  while True:
+    data = sock.recv(65536)
+    if not data:
+      break
+    if first is None:
+      first = time.time()
+    response += data.decode("utf-8")
+    try:
+      # skip any announcements that arrive before the response
+      obj, end = decoder.raw_decode(response.lstrip())
+      if "id" in obj:
+        break
+      response = response.lstrip()[end:]
+    except ValueError:
+      pass
+  sock.close()
+  return start, first, time.time(), len(response)
+
+for method, params in requests:
+  for name, transport in (("HTTP", http), ("TCP", tcp)):
+    start, first, end, size = transport(method, params)
+    print("%s over %s: %d bytes, first byte after %.0fms, complete after %.0fms%s" %
+          (method, name, size, (first - start) * 1000, (end - start) * 1000, peakMemory()))
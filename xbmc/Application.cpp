@@ -54,6 +54,8 @@
 #include "utils/LCDFactory.h"
 #endif
 #include "guilib/GUIControlProfiler.h"
+#include "utils/GUIBenchmark.h"
+#include "cores/dvdplayer/DVDSyncTest.h"
 #include "utils/LangCodeExpander.h"
 #include "GUIInfoManager.h"
 #include "playlists/PlayListFactory.h"
@@ -180,6 +182,7 @@
 
 // Windows includes
 #include "guilib/GUIWindowManager.h"
+#include "guilib/GUIWindowCache.h"
 #include "windows/GUIWindowHome.h"
 #include "guilib/GUIStandardWindow.h"
 #include "settings/GUIWindowSettings.h"
@@ -1296,6 +1299,8 @@ bool CApplication::Initialize()
 
     /* window id's 3000 - 3100 are reserved for python */
 
+    int64_t skinStart = CurrentHostCounter();
+
     // Make sure we have at least the default skin
     if (!LoadSkin(g_guiSettings.GetString("lookandfeel.skin")) && !LoadSkin(DEFAULT_SKIN))
     {
@@ -1325,6 +1330,9 @@ bool CApplication::Initialize()
       g_windowManager.ActivateWindow(g_SkinInfo->GetFirstWindow());
     }
 
+    CLog::Log(LOGDEBUG, "Skin cold start: %.2fms", 1000.f * (CurrentHostCounter() - skinStart) / CurrentHostFrequency());
+    g_TextureManager.PrintBundleStats();
+    CGUIWindowCache::Get().PrintStats();
   }
   else //No GUI Created
   {
@@ -1991,6 +1999,11 @@ void CApplication::LoadSkin(const SkinPtr& skin)
       CGUIDialog *dialog = (CGUIDialog *)g_windowManager.GetWindow(currentModelessWindows[i]);
       if (dialog) dialog->Show();
     }
+
+    end = CurrentHostCounter();
+    CLog::Log(LOGDEBUG, "Skin reload: %.2fms", 1000.f * (end - start) / freq);
+    g_TextureManager.PrintBundleStats();
+    CGUIWindowCache::Get().PrintStats();
   }
 
   if (g_application.m_pPlayer && g_application.IsPlayingVideo())
@@ -2943,7 +2956,11 @@ void CApplication::FrameMove(bool processEvents, bool processGUI)
   if (processGUI)
   {
     if (!m_bStop)
+    {
+      CGUIBenchmark::Get().Process();
+      CDVDSyncTest::Get().Process();
       g_windowManager.Process(CTimeUtils::GetFrameTime());
+    }
     g_windowManager.FrameMove();
   }
 }
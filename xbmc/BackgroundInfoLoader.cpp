@@ -86,7 +86,10 @@ void CBackgroundInfoLoader::Run()
         lock.Leave();
         try
         {
-          if (LoadItem(pItem.get()) && m_pObserver)
+          bool loaded = LoadItem(pItem.get());
+          // the item's tags are filled in now, so its labels are due for a refresh
+          pItem->SetInfoChanged();
+          if (loaded && m_pObserver)
             m_pObserver->OnItemLoaded(pItem.get());
         }
         catch (...)
@@ -2179,7 +2179,10 @@ bool CGUIInfoManager::GetBool(int condition1, int contextWindow, const CGUIListI
       }
       break;
     case VIDEOPLAYER_USING_OVERLAYS:
-      bReturn = (g_guiSettings.GetInt("videoplayer.rendermethod") == RENDER_OVERLAYS);
+      {
+        static CSettingHandle renderMethod("videoplayer.rendermethod");
+        bReturn = (g_guiSettings.GetInt(renderMethod) == RENDER_OVERLAYS);
+      }
     break;
     case VIDEOPLAYER_ISFULLSCREEN:
       bReturn = g_windowManager.GetActiveWindow() == WINDOW_FULLSCREEN_VIDEO;
@@ -4290,6 +4293,20 @@ CStdString CGUIInfoManager::GetItemImage(const CFileItem *item, int info, CStdSt
   return GetItemLabel(item, info, fallback);
 }
 
+bool CGUIInfoManager::IsItemOnlyInfo(int info) const
+{
+  if (info < LISTITEM_START || info > LISTITEM_END)
+    return false; // skin variables and anything not about the item
+
+  switch (info)
+  {
+  case LISTITEM_ICON: // also sets the fallback image
+  case LISTITEM_PLOT: // depends on the videolibrary.showunwatchedplots setting
+    return false;
+  }
+  return true;
+}
+
 bool CGUIInfoManager::GetItemBool(const CGUIListItem *item, int condition) const
 {
   if (!item) return false;
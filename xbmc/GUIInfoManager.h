@@ -684,6 +684,12 @@ public:
   CStdString GetItemLabel(const CFileItem *item, int info, CStdString *fallback = NULL);
   CStdString GetItemImage(const CFileItem *item, int info, CStdString *fallback = NULL);
 
+  /*! \brief Whether the value of an item info label depends on nothing but the item
+   Such labels can be cached with the item until it changes.
+   \sa CGUIListItem::GetCachedInfoLabel
+   */
+  bool IsItemOnlyInfo(int info) const;
+
   // Called from tuxbox service thread to update current status
   void UpdateFromTuxBox();
 
@@ -39,12 +39,44 @@
 #include "music/tags/MusicInfoTagLoaderFactory.h"
 #include "music/infoscanner/MusicInfoScanner.h"
 #include "music/Artist.h"
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "utils/CPUInfo.h"
+
+#include <algorithm>
 
 using namespace XFILE;
 using namespace std;
 using namespace VIDEO;
 using namespace MUSIC_INFO;
 
+// a thumb extraction rate is logged each time this many thumbs have been extracted
+#define THUMB_STATS_INTERVAL 50
+
+static CCriticalSection g_thumbStatsSection;
+static unsigned int g_thumbStatsCount = 0;
+static unsigned int g_thumbStatsStart = 0;
+static unsigned int g_thumbStatsLast = 0;
+
+static void UpdateThumbStats(unsigned int start)
+{
+  CSingleLock lock(g_thumbStatsSection);
+  unsigned int now = XbmcThreads::SystemClockMillis();
+
+  // a pause of a minute between thumbs starts a new batch
+  if (!g_thumbStatsCount || now - g_thumbStatsLast > 60000)
+  {
+    g_thumbStatsCount = 0;
+    g_thumbStatsStart = start;
+  }
+  g_thumbStatsCount++;
+  g_thumbStatsLast = now;
+
+  if (g_thumbStatsCount % THUMB_STATS_INTERVAL == 0 && now > g_thumbStatsStart)
+    CLog::Log(LOGDEBUG, "%s - extracted %u thumbs in %u s, %.1f thumbs/minute", __FUNCTION__,
+              g_thumbStatsCount, (now - g_thumbStatsStart) / 1000, g_thumbStatsCount * 60000.0 / (now - g_thumbStatsStart));
+}
+
 CThumbLoader::CThumbLoader(int nThreads) :
   CBackgroundInfoLoader(nThreads)
 {
@@ -123,9 +155,11 @@ bool CThumbExtractor::DoWork()
     // construct the thumb cache file
     CTextureDetails details;
     details.file = CTextureCache::GetCacheFile(m_target) + ".jpg";
+    unsigned int start = XbmcThreads::SystemClockMillis();
     result = CDVDFileInfo::ExtractThumb(m_path, details, &m_item.GetVideoInfoTag()->m_streamDetails);
     if(result)
     {
+      UpdateThumbStats(start);
       CTextureCache::Get().AddCachedTexture(m_target, details);
       m_item.SetProperty("HasAutoThumb", true);
       m_item.SetProperty("AutoThumbImage", m_target);
@@ -141,8 +175,10 @@ bool CThumbExtractor::DoWork()
   return result;
 }
 
+// extraction is mostly decoding and scaling, so run one job per core.
+// the job manager limits the number of low priority jobs running at once anyway.
 CVideoThumbLoader::CVideoThumbLoader() :
-  CThumbLoader(1), CJobQueue(true), m_pStreamDetailsObs(NULL)
+  CThumbLoader(1), CJobQueue(true, std::max(1, std::min(g_cpuInfo.getCPUCount(), 4))), m_pStreamDetailsObs(NULL)
 {
   m_database = new CVideoDatabase();
 }
@@ -180,9 +180,19 @@ void CSkinInfo::LoadIncludes()
   m_includes.LoadIncludes(includesPath);
 }
 
-void CSkinInfo::ResolveIncludes(TiXmlElement *node)
+void CSkinInfo::ResolveIncludes(TiXmlElement *node, bool *conditional /* = NULL */)
 {
-  m_includes.ResolveIncludes(node);
+  m_includes.ResolveIncludes(node, conditional);
+}
+
+void CSkinInfo::GetIncludeFiles(vector<CStdString> &files) const
+{
+  files = m_includes.GetFiles();
+}
+
+bool CSkinInfo::LoadIncludeFile(const CStdString &file)
+{
+  return m_includes.LoadIncludes(file);
 }
 
 int CSkinInfo::GetStartWindow() const
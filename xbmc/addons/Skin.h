@@ -92,7 +92,18 @@ public:
    */
   static bool TranslateResolution(const CStdString &name, RESOLUTION_INFO &res);
 
-  void ResolveIncludes(TiXmlElement *node);
+  void ResolveIncludes(TiXmlElement *node, bool *conditional = NULL);
+
+  /*! \brief Retrieve the include files loaded so far
+   \param files [out] the include files.
+   */
+  void GetIncludeFiles(std::vector<CStdString> &files) const;
+
+  /*! \brief Load an include file, if it isn't loaded already
+   \param file the include file to load.
+   \return true if the file is loaded.
+   */
+  bool LoadIncludeFile(const CStdString &file);
 
   float GetEffectsSlowdown() const { return m_effectsSlowDown; };
 
@@ -20,7 +20,7 @@
  */
 #include "system.h"
 #include "Visualisation.h"
-#include "utils/fft.h"
+#include "utils/RealFFT.h"
 #include "GUIInfoManager.h"
 #include "Application.h"
 #include "music/tags/MusicInfoTag.h"
@@ -273,17 +273,24 @@ void CVisualisation::OnAudioData(const float* pAudioData, int iAudioDataLength)
   if (m_bWantsFreq)
   {
     const float *psAudioData = ptrAudioBuffer->Get();
-    memcpy(m_fFreq, psAudioData, AUDIO_BUFFER_SIZE * sizeof(float));
 
-    // FFT the data
-    twochanwithwindow(m_fFreq, AUDIO_BUFFER_SIZE);
-
-    // Normalize the data
-    float fMinData = (float)AUDIO_BUFFER_SIZE * AUDIO_BUFFER_SIZE * 3 / 8 * 0.5 * 0.5; // 3/8 for the Hann window, 0.5 as minimum amplitude
-    float fInvMinData = 1.0f/fMinData;
-    for (int i = 0; i < AUDIO_BUFFER_SIZE + 2; i++)
+    // FFT each channel, windowed and zero padded to AUDIO_BUFFER_SIZE samples
+    // so we get AUDIO_BUFFER_SIZE / 2 bins per channel
+    const int iFrames = AUDIO_BUFFER_SIZE / 2;
+    const float fMinData = (float)iFrames * iFrames * 3 / 8 * 0.5 * 0.5; // 3/8 for the Hann window, 0.5 as minimum amplitude
+    const float fInvMinData = 1.0f/fMinData;
+    for (int iChannel = 0; iChannel < 2; iChannel++)
     {
-      m_fFreq[i] *= fInvMinData;
+      for (int i = 0; i < iFrames; i++)
+        m_fFFTInput[i] = psAudioData[i * 2 + iChannel] * m_fFFTWindow[i];
+
+      m_pFFT->Forward(m_fFFTInput, m_fFFTRe, m_fFFTIm);
+      CRealFFT::Power(m_fFFTRe, m_fFFTIm, m_fFFTRe, iFrames);
+
+      // interleave the channels again, doubling all but DC for the one sided spectrum
+      m_fFreq[iChannel] = m_fFFTRe[0] * fInvMinData;
+      for (int i = 1; i < iFrames; i++)
+        m_fFreq[i * 2 + iChannel] = m_fFFTRe[i] * 2.0f * fInvMinData;
     }
 
     // Transfer data to our visualisation
@@ -309,6 +316,15 @@ void CVisualisation::CreateBuffers()
     m_iNumBuffers = MAX_AUDIO_BUFFERS;
   if (m_iNumBuffers < 1)
     m_iNumBuffers = 1;
+
+  if (m_bWantsFreq)
+  {
+    m_pFFT = CRealFFT::Get(AUDIO_BUFFER_SIZE);
+    for (int i = 0; i < AUDIO_BUFFER_SIZE / 2; i++)
+      m_fFFTWindow[i] = (float)(0.5 * (1 - cos(2 * M_PI * i / (AUDIO_BUFFER_SIZE / 2))));
+    for (int i = AUDIO_BUFFER_SIZE / 2; i < AUDIO_BUFFER_SIZE; i++)
+      m_fFFTInput[i] = 0.0f;
+  }
 }
 
 void CVisualisation::ClearBuffers()
@@ -33,6 +33,7 @@
 #define MAX_AUDIO_BUFFERS 16
 
 class CCriticalSection;
+class CRealFFT;
 
 typedef DllAddon<Visualisation, VIS_PROPS> DllVisualisation;
 
@@ -55,8 +56,8 @@ namespace ADDON
                        , public IAudioCallback
   {
   public:
-    CVisualisation(const ADDON::AddonProps &props) : CAddonDll<DllVisualisation, Visualisation, VIS_PROPS>(props) {}
-    CVisualisation(const cp_extension_t *ext) : CAddonDll<DllVisualisation, Visualisation, VIS_PROPS>(ext) {}
+    CVisualisation(const ADDON::AddonProps &props) : CAddonDll<DllVisualisation, Visualisation, VIS_PROPS>(props), m_pFFT(NULL) {}
+    CVisualisation(const cp_extension_t *ext) : CAddonDll<DllVisualisation, Visualisation, VIS_PROPS>(ext), m_pFFT(NULL) {}
     virtual void OnInitialize(int iChannels, int iSamplesPerSec, int iBitsPerSample);
     virtual void OnAudioData(const float* pAudioData, int iAudioDataLength);
     bool Create(int x, int y, int w, int h);
@@ -103,6 +104,11 @@ namespace ADDON
     int m_iNumBuffers;        // Number of Audio buffers
     bool m_bWantsFreq;
     float m_fFreq[2*AUDIO_BUFFER_SIZE];         // Frequency data
+    const CRealFFT *m_pFFT;
+    float m_fFFTWindow[AUDIO_BUFFER_SIZE/2];    // Hann window over one channel of a buffer
+    float m_fFFTInput[AUDIO_BUFFER_SIZE];       // windowed and zero padded channel
+    float m_fFFTRe[AUDIO_BUFFER_SIZE/2+1];
+    float m_fFFTIm[AUDIO_BUFFER_SIZE/2+1];
     bool m_bCalculate_Freq;       // True if the vis wants freq data
 
     // track information
@@ -239,3 +239,30 @@ void CAEFactory::GarbageCollect()
   if(AE)
     AE->GarbageCollect();
 }
+
+bool CAEFactory::ForceNullSink(bool force)
+{
+#if !defined(TARGET_DARWIN)
+  CSoftAE *softAE = dynamic_cast<CSoftAE*>(AE);
+  if (softAE)
+  {
+    softAE->m_forceNullSink = force;
+    softAE->OpenSink();
+    return true;
+  }
+#endif
+  return false;
+}
+
+bool CAEFactory::GetSinkClockStats(AESinkClockStats &stats)
+{
+#if !defined(TARGET_DARWIN)
+  CSoftAE *softAE = dynamic_cast<CSoftAE*>(AE);
+  if (softAE)
+  {
+    softAE->GetSinkClockStats(stats);
+    return true;
+  }
+#endif
+  return false;
+}
@@ -23,6 +23,8 @@
 #include "Interfaces/AE.h"
 #include "threads/Thread.h"
 
+struct AESinkClockStats;
+
 enum AEEngine
 {
   AE_ENGINE_NULL,
@@ -55,6 +57,10 @@ public:
     unsigned int encodedSampleRate, CAEChannelInfo channelLayout, unsigned int options = 0);
   static IAEStream *FreeStream(IAEStream *stream);
   static void GarbageCollect();
+  /* send all output to the NULL sink, returns false if the engine can't */
+  static bool ForceNullSink(bool force);
+  /* drift and jitter of the sink clock, returns false if the engine doesn't track it */
+  static bool GetSinkClockStats(AESinkClockStats &stats);
 private:
   static bool LoadEngine(enum AEEngine engine);
   static IAE *AE;
@@ -62,7 +62,8 @@ void CAESinkFactory::ParseDevice(std::string &device, std::string &driver)
   #endif
         driver == "OSS"         ||
 #endif
-        driver == "PROFILER")
+        driver == "PROFILER"    ||
+        driver == "NULL")
       device = device.substr(pos + 1, device.length() - pos - 1);
     else
       driver.clear();
@@ -99,6 +100,9 @@ IAESink *CAESinkFactory::Create(std::string &device, AEAudioFormat &desiredForma
   if (driver == "PROFILER")
     TRY_SINK(Profiler);
 
+  if (driver == "NULL")
+    TRY_SINK(NULL);
+
 
 #if defined(TARGET_WINDOWS)
   if ((driver.empty() && g_sysinfo.IsVistaOrHigher() ||
@@ -45,10 +45,16 @@ using namespace std;
 
 CSoftAE::CSoftAE():
   m_thread             (NULL        ),
+  m_forceNullSink      (false       ),
   m_audiophile         (true        ),
   m_running            (false       ),
   m_reOpen             (false       ),
+  m_frameSize          (0           ),
+  m_mixBlockSize       (0           ),
   m_sink               (NULL        ),
+  m_packFn             (NULL        ),
+  m_softClip           (false       ),
+  m_sinkFramesWritten  (0           ),
   m_transcode          (false       ),
   m_rawPassthrough     (false       ),
   m_soundMode          (AE_SOUND_OFF),
@@ -293,6 +299,7 @@ void CSoftAE::InternalOpenSink()
       delete m_sink;
       m_sink = NULL;
     }
+    ResetSinkClock();
 
     /* if we already have a driver, prepend it to the device string */
     if (!driver.empty())
@@ -347,6 +354,7 @@ void CSoftAE::InternalOpenSink()
       m_buffer.Empty();
 
     m_convertFn      = NULL;
+    m_packFn         = NULL;
     m_bytesPerSample = CAEUtil::DataFormatToBits(m_sinkFormat.m_dataFormat) >> 3;
     m_frameSize      = m_sinkFormat.m_frameSize;
     neededBufferSize = m_sinkFormat.m_frames * m_sinkFormat.m_frameSize;
@@ -381,12 +389,14 @@ void CSoftAE::InternalOpenSink()
       reInit = (reInit || m_chLayout != m_encoderFormat.m_channelLayout);
       m_chLayout       = m_encoderFormat.m_channelLayout;
       m_convertFn      = CAEConvert::FrFloat(m_encoderFormat.m_dataFormat);
+      m_packFn         = CAEConvert::FrFloatVol(m_encoderFormat.m_dataFormat);
       neededBufferSize = m_encoderFormat.m_frames * sizeof(float) * m_chLayout.Count();
       CLog::Log(LOGDEBUG, "CSoftAE::Initialize - Encoding using layout: %s", ((std::string)m_chLayout).c_str());
     }
     else
     {
       m_convertFn      = CAEConvert::FrFloat(m_sinkFormat.m_dataFormat);
+      m_packFn         = CAEConvert::FrFloatVol(m_sinkFormat.m_dataFormat);
       neededBufferSize = m_sinkFormat.m_frames * sizeof(float) * m_chLayout.Count();
       CLog::Log(LOGDEBUG, "CSoftAE::Initialize - Using speaker layout: %s", CAEUtil::GetStdChLayoutName(m_stdChLayout));
     }
@@ -397,6 +407,7 @@ void CSoftAE::InternalOpenSink()
 
   if (m_buffer.Size() < neededBufferSize)
     m_buffer.Alloc(neededBufferSize);
+  m_mixBlockSize = neededBufferSize;
 
   if (reInit)
   {
@@ -531,6 +542,9 @@ void CSoftAE::LoadSettings()
   VerifySoundDevice(m_device           , false);
   VerifySoundDevice(m_passthroughDevice, true );
 
+  if (m_forceNullSink)
+    m_device = m_passthroughDevice = "NULL:";
+
   m_transcode = (
     g_guiSettings.GetBool("audiooutput.ac3passthrough") /*||
     g_guiSettings.GetBool("audiooutput.dtspassthrough") */
@@ -584,6 +598,7 @@ void CSoftAE::Deinitialize()
     delete m_sink;
     m_sink = NULL;
   }
+  ResetSinkClock();
 
   delete m_encoder;
   m_encoder = NULL;
@@ -806,7 +821,7 @@ double CSoftAE::GetDelay()
   double delay = (double)m_buffer.Used() * m_sinkFormatFrameSizeMul *m_sinkFormatSampleRateMul;
   CSharedLock sinkLock(m_sinkLock);
   if (m_sink)
-    delay += m_sink->GetDelay();
+    delay += GetSinkDelay();
   sinkLock.Leave();
 
   if (m_transcode && m_encoder && !m_rawPassthrough)
@@ -835,6 +850,52 @@ double CSoftAE::GetCacheTotal()
   return total;
 }
 
+double CSoftAE::GetSinkDelay()
+{
+  /* the frames written less the frames the sink clock says were played */
+  CSingleLock lock(m_sinkClockLock);
+  if (m_sinkClock.IsLocked())
+  {
+    double now     = (double)CurrentHostCounter() / CurrentHostFrequency();
+    double written = (double)m_sinkFramesWritten / m_sinkFormat.m_sampleRate;
+    return std::max(0.0, written - m_sinkClock.GetPosition(now));
+  }
+  lock.Leave();
+
+  return m_sink->GetDelay();
+}
+
+void CSoftAE::UpdateSinkClock(unsigned int frames)
+{
+  /* the sink was just written to, so this is as close to the write as the delay gets */
+  double delay = m_sink->GetDelay();
+  double now   = (double)CurrentHostCounter() / CurrentHostFrequency();
+
+  CSingleLock lock(m_sinkClockLock);
+  m_sinkFramesWritten += frames;
+  double written = (double)m_sinkFramesWritten / m_sinkFormat.m_sampleRate;
+  m_sinkClock.Update(now, written - delay);
+}
+
+void CSoftAE::ResetSinkClock()
+{
+  CSingleLock lock(m_sinkClockLock);
+  AESinkClockStats stats;
+  m_sinkClock.GetStats(stats);
+  if (stats.reports)
+    CLog::Log(LOGDEBUG, "CSoftAE::ResetSinkClock - sink drift %.1f ppm, jitter %.2f ms rms, %.2f ms max, %u reports, %u relocks",
+              stats.drift, stats.jitter * 1000.0, stats.maxError * 1000.0, stats.reports, stats.relocks);
+
+  m_sinkClock.Reset();
+  m_sinkFramesWritten = 0;
+}
+
+void CSoftAE::GetSinkClockStats(AESinkClockStats &stats)
+{
+  CSingleLock lock(m_sinkClockLock);
+  m_sinkClock.GetStats(stats);
+}
+
 float CSoftAE::GetVolume()
 {
   return m_volume;
@@ -876,16 +937,22 @@ void CSoftAE::Run()
     if ((this->*m_outputStageFn)(hasAudio) > 0)
       hasAudio = false; /* taken some audio - reset our silence flag */
 
+    /* fill the buffer up to a whole block so the streams are mixed a period at a time */
+    size_t want = 0;
+    if (m_buffer.Used() < m_mixBlockSize)
+      want = std::min(m_mixBlockSize - m_buffer.Used(), m_buffer.Free());
+
     /* if we have enough room in the buffer */
-    if (m_buffer.Free() >= m_frameSize)
+    if (m_frameSize && want >= m_frameSize)
     {
       /* take some data for our use from the buffer */
-      uint8_t *out = (uint8_t*)m_buffer.Take(m_frameSize);
-      memset(out, 0, m_frameSize);
+      const unsigned int frames = want / m_frameSize;
+      uint8_t *out = (uint8_t*)m_buffer.Take(frames * m_frameSize);
+      memset(out, 0, frames * m_frameSize);
 
       /* run the stream stage */
       CSoftAEStream *oldMaster = m_masterStream;
-      if ((this->*m_streamStageFn)(m_chLayout.Count(), out, restart) > 0)
+      if ((this->*m_streamStageFn)(m_chLayout.Count(), out, frames, restart) > 0)
         hasAudio = true; /* have some audio */
 
       /* if in audiophile mode and the master stream has changed, flag for restart */
@@ -981,37 +1048,51 @@ bool CSoftAE::FinalizeSamples(float *buffer, unsigned int samples, bool hasAudio
     return false;
   }
 
+  return true;
+}
+
+void CSoftAE::PackSamples(float *buffer, unsigned int samples, uint8_t *dest)
+{
+  const float volume = m_sinkHandlesVolume ? 1.0f : m_volume;
+
+  if (m_packFn)
+  {
+    /* volume, clamp and convert in one pass */
+    const bool clipped = m_packFn(buffer, samples, volume, m_softClip, dest);
+    if (clipped != m_softClip)
+    {
+      CLog::Log(LOGDEBUG, "CSoftAE::PackSamples - %s soft clipping", clipped ? "enabling" : "disabling");
+      m_softClip = clipped;
+    }
+    return;
+  }
+
   /* deamplify */
-  if (!m_sinkHandlesVolume && m_volume < 1.0)
+  if (volume < 1.0)
   {
     #ifdef __SSE__
-      CAEUtil::SSEMulArray(buffer, m_volume, samples);
+      CAEUtil::SSEMulArray(buffer, volume, samples);
     #else
       float *fbuffer = buffer;
       for (unsigned int i = 0; i < samples; i++)
-        *fbuffer++ *= m_volume;
+        *fbuffer++ *= volume;
     #endif
   }
 
   /* check if we need to clamp */
-  bool clamp = false;
   float *fbuffer = buffer;
   for (unsigned int i = 0; i < samples; i++, fbuffer++)
   {
     if (*fbuffer < -1.0f || *fbuffer > 1.0f)
     {
-      clamp = true;
+      CLog::Log(LOGDEBUG, "CSoftAE::PackSamples - Clamping buffer of %d samples", samples);
+      CAEUtil::ClampArray(buffer, samples);
       break;
     }
   }
 
-  /* if there were no samples outside of the range, dont clamp the buffer */
-  if (!clamp)
-    return true;
-
-  CLog::Log(LOGDEBUG, "CSoftAE::FinalizeSamples - Clamping buffer of %d samples", samples);
-  CAEUtil::ClampArray(buffer, samples);
-  return true;
+  if (m_convertFn)
+    m_convertFn(buffer, samples, dest);
 }
 
 int CSoftAE::RunOutputStage(bool hasAudio)
@@ -1030,9 +1111,11 @@ int CSoftAE::RunOutputStage(bool hasAudio)
     const unsigned int convertedBytes = m_sinkFormat.m_frames * m_sinkFormat.m_frameSize;
     AllocateConvIfNeeded(convertedBytes, !hasAudio);
     if (hasAudio)
-      m_convertFn((float*)data, needSamples, m_converted);
+      PackSamples((float*)data, needSamples, m_converted);
     data = m_converted;
   }
+  else if (hasAudio)
+    PackSamples((float*)data, needSamples, (uint8_t*)data);
 
   wroteFrames = m_sink->AddPackets((uint8_t*)data, m_sinkFormat.m_frames, hasAudio);
 
@@ -1043,6 +1126,8 @@ int CSoftAE::RunOutputStage(bool hasAudio)
     wroteFrames = 0;
     m_reOpen = true;
   }
+  else if (wroteFrames > 0)
+    UpdateSinkClock(wroteFrames);
 
   m_buffer.Shift(NULL, wroteFrames * m_sinkFormat.m_channelLayout.Count() * sizeof(float));
   return wroteFrames;
@@ -1082,6 +1167,8 @@ int CSoftAE::RunRawOutputStage(bool hasAudio)
     wroteFrames = 0;
     m_reOpen = true;
   }
+  else if (wroteFrames > 0)
+    UpdateSinkClock(wroteFrames);
 
   m_buffer.Shift(NULL, wroteFrames * m_sinkFormat.m_frameSize);
   return wroteFrames;
@@ -1104,12 +1191,16 @@ int CSoftAE::RunTranscodeStage(bool hasAudio)
       unsigned int newsize = m_encoderFormat.m_frames * m_encoderFormat.m_frameSize;
       AllocateConvIfNeeded(newsize, !hasAudio);
       if (hasAudio)
-        m_convertFn((float*)m_buffer.Raw(block),
+        PackSamples((float*)m_buffer.Raw(block),
           m_encoderFormat.m_frames * m_encoderFormat.m_channelLayout.Count(), m_converted);
       buffer = m_converted;
     }
     else
+    {
       buffer = m_buffer.Raw(block);
+      if (hasAudio)
+        PackSamples((float*)buffer, m_encoderFormat.m_frameSamples, (uint8_t*)buffer);
+    }
 
     encodedFrames = m_encoder->Encode((float*)buffer, m_encoderFormat.m_frames);
     m_buffer.Shift(NULL, encodedFrames * m_encoderFormat.m_frameSize);
@@ -1136,30 +1227,38 @@ int CSoftAE::RunTranscodeStage(bool hasAudio)
       wroteFrames = 0;
       m_reOpen = true;
     }
+    else if (wroteFrames > 0)
+      UpdateSinkClock(wroteFrames);
 
     m_encodedBuffer.Shift(NULL, wroteFrames * m_sinkFormat.m_frameSize);
   }
   return encodedFrames;
 }
 
-unsigned int CSoftAE::RunRawStreamStage(unsigned int channelCount, void *out, bool &restart)
+unsigned int CSoftAE::RunRawStreamStage(unsigned int channelCount, void *out, unsigned int frames, bool &restart)
 {
   StreamList resumeStreams;
-  static StreamList::iterator itt;
   CSingleLock streamLock(m_streamLock);
 
   /* handle playing streams */
-  for (itt = m_playingStreams.begin(); itt != m_playingStreams.end(); ++itt)
+  for (StreamList::iterator itt = m_playingStreams.begin(); itt != m_playingStreams.end(); ++itt)
   {
     CSoftAEStream *sitt = *itt;
     if (sitt == m_masterStream)
       continue;
 
     /* consume data from streams even though we cant use it */
-    uint8_t *frame = sitt->GetFrame();
+    unsigned int done = 0;
+    while (done < frames)
+    {
+      unsigned int got;
+      if (!sitt->GetFrames(frames - done, got))
+        break;
+      done += got;
+    }
 
     /* flag the stream's slave to be resumed if it has drained */
-    if (!frame && sitt->IsDrained() && sitt->m_slave && sitt->m_slave->IsPaused())
+    if (done < frames && sitt->IsDrained() && sitt->m_slave && sitt->m_slave->IsPaused())
       resumeStreams.push_back(sitt);
   }
 
@@ -1167,36 +1266,37 @@ unsigned int CSoftAE::RunRawStreamStage(unsigned int channelCount, void *out, bo
   if (!m_masterStream)
     return 0;
 
-  /* get the frame and append it to the output */
-  uint8_t *frame = m_masterStream->GetFrame();
-  unsigned int mixed;
-  if (frame)
+  /* get the frames and append them to the output */
+  uint8_t *dst  = (uint8_t*)out;
+  unsigned int done = 0;
+  while (done < frames)
   {
-    mixed = 1;
-    memcpy(out, frame, m_sinkFormat.m_frameSize);
-  }
-  else
-  {
-    mixed = 0;
-    if (m_masterStream->IsDrained() && m_masterStream->m_slave && m_masterStream->m_slave->IsPaused())
-      resumeStreams.push_back(m_masterStream);
+    unsigned int got;
+    uint8_t *frame = m_masterStream->GetFrames(frames - done, got);
+    if (!frame)
+      break;
+    memcpy(dst, frame, got * m_sinkFormat.m_frameSize);
+    dst  += got * m_sinkFormat.m_frameSize;
+    done += got;
   }
 
+  if (done < frames && m_masterStream->IsDrained() && m_masterStream->m_slave && m_masterStream->m_slave->IsPaused())
+    resumeStreams.push_back(m_masterStream);
+
   ResumeSlaveStreams(resumeStreams);
-  return mixed;
+  return done > 0 ? 1 : 0;
 }
 
-unsigned int CSoftAE::RunStreamStage(unsigned int channelCount, void *out, bool &restart)
+unsigned int CSoftAE::RunStreamStage(unsigned int channelCount, void *out, unsigned int frames, bool &restart)
 {
   // no point doing anything if we have no streams,
   // we do not have to take a lock just to check empty
   if (m_playingStreams.empty())
     return 0;
 
-  float *dst = (float*)out;
   unsigned int mixed = 0;
 
-  /* identify the master stream */
+  /* the stream lock is held once for the whole block */
   CSingleLock streamLock(m_streamLock);
 
   /* mix in any running streams */
@@ -1204,26 +1304,54 @@ unsigned int CSoftAE::RunStreamStage(unsigned int channelCount, void *out, bool
   for (StreamList::iterator itt = m_playingStreams.begin(); itt != m_playingStreams.end(); ++itt)
   {
     CSoftAEStream *stream = *itt;
+    float *dst = (float*)out;
 
-    float *frame = (float*)stream->GetFrame();
-    if (!frame && stream->IsDrained() && stream->m_slave && stream->m_slave->IsPaused())
-      resumeStreams.push_back(stream);
+    /* a block may span several of the stream's packets */
+    unsigned int done = 0;
+    while (done < frames)
+    {
+      unsigned int got;
+      float startVolume = stream->GetVolume();
+      float *frame = (float*)stream->GetFrames(frames - done, got);
+      if (!frame)
+        break;
 
-    if (!frame)
-      continue;
+      const float rgain = stream->GetReplayGain();
+      const unsigned int samples = got * channelCount;
+      float endVolume = stream->GetVolume();
+      if (startVolume == endVolume)
+      {
+        float volume = endVolume * rgain;
+        #ifdef __SSE__
+        CAEUtil::SSEMulAddArray(dst, frame, volume, samples);
+        #else
+        for (unsigned int i = 0; i < samples; ++i)
+          dst[i] += frame[i] * volume;
+        #endif
+        dst += samples;
+      }
+      else
+      {
+        /* the stream is fading, ramp the volume across the frames */
+        const float step = (endVolume - startVolume) / got;
+        float volume = startVolume;
+        for (unsigned int i = 0; i < got; ++i)
+        {
+          volume += step;
+          const float mul = volume * rgain;
+          for (unsigned int j = 0; j < channelCount; ++j)
+            *dst++ += *frame++ * mul;
+        }
+      }
 
-    float volume = stream->GetVolume() * stream->GetReplayGain();
-    #ifdef __SSE__
-    if (channelCount > 1)
-      CAEUtil::SSEMulAddArray(dst, frame, volume, channelCount);
-    else
-    #endif
-    {
-      for (unsigned int i = 0; i < channelCount; ++i)
-        *dst++ += *frame++ * volume;
+      done += got;
     }
 
-    ++mixed;
+    if (done < frames && stream->IsDrained() && stream->m_slave && stream->m_slave->IsPaused())
+      resumeStreams.push_back(stream);
+
+    if (done > 0)
+      ++mixed;
   }
 
   ResumeSlaveStreams(resumeStreams);
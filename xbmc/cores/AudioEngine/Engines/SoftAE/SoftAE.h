@@ -31,6 +31,7 @@
 
 #include "Interfaces/ThreadedAE.h"
 #include "Utils/AEBuffer.h"
+#include "Utils/AESinkClock.h"
 #include "AEAudioFormat.h"
 #include "AESinkFactory.h"
 
@@ -47,6 +48,7 @@ class CSoftAE : public IThreadedAE
 {
 protected:
   friend class CAEFactory;
+  friend class CSoftAEBenchmark;
   CSoftAE();
   virtual ~CSoftAE();
 
@@ -96,6 +98,9 @@ public:
   double GetCacheTime();
   double GetCacheTotal();
 
+  /* drift and jitter of the current sink against the host clock */
+  void GetSinkClockStats(AESinkClockStats &stats);
+
   virtual void EnumerateOutputDevices(AEDeviceList &devices, bool passthrough);
   virtual std::string GetDefaultDevice(bool passthrough);
   virtual bool SupportsRaw();
@@ -121,9 +126,20 @@ private:
   IAESink *GetSink(AEAudioFormat &desiredFormat, bool passthrough, std::string &device);
   void StopAllSounds();
 
+  /*! \brief Feed the sink clock after frames were written to the sink.
+   Called on the engine thread, polls the sink for its delay.
+   \param frames the frames the sink took.
+   */
+  void   UpdateSinkClock(unsigned int frames);
+  /* log the statistics of the sink clock and start it over for a new sink */
+  void   ResetSinkClock();
+  /* the delay of the sink from the filtered sink clock, as reported until it locked */
+  double GetSinkDelay();
+
   enum AEStdChLayout m_stdChLayout;
   std::string m_device;
   std::string m_passthroughDevice;
+  bool m_forceNullSink; /* output to the NULL sink, used by CSoftAEBenchmark and CAEFactory::ForceNullSink */
   bool m_audiophile;
   bool m_stereoUpmix;
 
@@ -143,6 +159,7 @@ private:
   bool                m_muted;
   CAEChannelInfo      m_chLayout;
   unsigned int        m_frameSize;
+  size_t              m_mixBlockSize; /* bytes the stream stage fills the buffer up to */
 
   /* the sink, its format information, and conversion function */
   AESinkInfoList            m_sinkInfoList;
@@ -156,6 +173,13 @@ private:
   float                     m_encoderFrameSizeMul;
   unsigned int              m_bytesPerSample;
   CAEConvert::AEConvertFrFn m_convertFn;
+  CAEConvert::AEConvertFrVolFn m_packFn;
+  bool                      m_softClip; /* the last period exceeded full scale, soft clip this one */
+
+  /* the play position of the sink, filtered so GetDelay doesn't carry the jitter of the reports */
+  CCriticalSection          m_sinkClockLock;
+  CAESinkClock              m_sinkClock;
+  uint64_t                  m_sinkFramesWritten;
 
   /* currently playing sounds */
   typedef struct {
@@ -200,7 +224,7 @@ private:
   unsigned int MixSounds        (float *buffer, unsigned int samples);
 
   /*! \brief Finalize samples ready for sending to the output device.
-   Mixes in any UI sounds, applies volume adjustment, and clamps to [-1,1].
+   Mixes in any UI sounds and silences the buffer if we are muted.
    \param buffer the audio data.
    \param samples the number of samples in the buffer.
    \param hasAudio whether we have audio from a stream (true) or silence (false)
@@ -208,6 +232,15 @@ private:
    */
   bool         FinalizeSamples  (float *buffer, unsigned int samples, bool hasAudio);
 
+  /*! \brief Apply the volume, clamp to [-1,1] and convert to the output format.
+   Uses the fused kernel from CAEConvert::FrFloatVol when there is one so the
+   buffer is only read once, otherwise scales in place and calls m_convertFn.
+   \param buffer the finalized audio data.
+   \param samples the number of samples in the buffer.
+   \param dest the output buffer, may be buffer if no conversion is required.
+   */
+  void         PackSamples      (float *buffer, unsigned int samples, uint8_t *dest);
+
   CSoftAEStream *m_masterStream;
 
   /*! \brief Run the output stage on the audio.
@@ -221,9 +254,18 @@ private:
   int          RunRawOutputStage(bool hasAudio);
   int          RunTranscodeStage(bool hasAudio);
 
-  unsigned int (CSoftAE::*m_streamStageFn)(unsigned int channelCount, void *out, bool &restart);
-  unsigned int RunRawStreamStage (unsigned int channelCount, void *out, bool &restart);
-  unsigned int RunStreamStage    (unsigned int channelCount, void *out, bool &restart);
+  /*! \brief Run the stream stage on a block of frames.
+   Pulls up to frames frames from each playing stream and mixes them into out,
+   which must be zeroed by the caller.
+   \param channelCount the number of channels per frame in out.
+   \param out the buffer to mix into.
+   \param frames the number of frames to mix.
+   \param restart set to true if the sink needs to be reopened.
+   \return the number of streams that provided audio.
+   */
+  unsigned int (CSoftAE::*m_streamStageFn)(unsigned int channelCount, void *out, unsigned int frames, bool &restart);
+  unsigned int RunRawStreamStage (unsigned int channelCount, void *out, unsigned int frames, bool &restart);
+  unsigned int RunStreamStage    (unsigned int channelCount, void *out, unsigned int frames, bool &restart);
 
   void         ResumeSlaveStreams(const StreamList &streams);
   void         RunNormalizeStage (unsigned int channelCount, void *out, unsigned int mixed);
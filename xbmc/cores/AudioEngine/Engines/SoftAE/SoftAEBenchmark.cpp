@@ -0,0 +1,236 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+
+#include "system.h"
+#include "SoftAEBenchmark.h"
+#include "SoftAE.h"
+#include "AEFactory.h"
+#include "Interfaces/AEStream.h"
+#include "Utils/AEConvert.h"
+#include "Utils/AEUtil.h"
+#include "threads/SystemClock.h"
+#include "utils/log.h"
+#include "utils/TimeUtils.h"
+
+#include <math.h>
+#include <vector>
+
+#define AE (*((CSoftAE*)CAEFactory::GetEngine()))
+
+#define BENCHMARK_SAMPLERATE 48000
+#define BENCHMARK_CHANNELS   2
+
+#define KERNEL_CHANNELS      8
+#define KERNEL_FRAMES        1024
+#define KERNEL_RUNS          2000
+
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+#include <intrin.h>
+static inline uint64_t ReadCycles() { return __rdtsc(); }
+#elif defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+static inline uint64_t ReadCycles() { return __builtin_ia32_rdtsc(); }
+#else
+static inline uint64_t ReadCycles() { return 0; }
+#endif
+
+CSoftAEBenchmark::CSoftAEBenchmark(unsigned int seconds) :
+  m_seconds(std::max(1U, seconds))
+{
+}
+
+bool CSoftAEBenchmark::DoWork()
+{
+  if (!dynamic_cast<CSoftAE*>(CAEFactory::GetEngine()))
+  {
+    CLog::Log(LOGERROR, "CSoftAEBenchmark - SoftAE is not the active audio engine");
+    return false;
+  }
+
+  RunOutputKernels();
+
+  CLog::Log(LOGNOTICE, "CSoftAEBenchmark - mixing through the NULL sink for %u seconds per run", m_seconds);
+
+  AE.m_forceNullSink = true;
+  AE.OpenSink();
+
+  static const unsigned int counts[] = { 1, 2, 8 };
+  for (unsigned int i = 0; i < sizeof(counts) / sizeof(counts[0]); ++i)
+  {
+    float usage = Run(counts[i]);
+    if (usage < 0.0f)
+      break;
+    CLog::Log(LOGNOTICE, "CSoftAEBenchmark - %u stream(s): %.3f ms CPU per second of audio", counts[i], usage);
+  }
+
+  AE.m_forceNullSink = false;
+  AE.OpenSink();
+  return true;
+}
+
+float CSoftAEBenchmark::Run(unsigned int streams)
+{
+  std::vector<IAEStream*> list;
+  for (unsigned int i = 0; i < streams; ++i)
+  {
+    IAEStream *stream = AE.MakeStream(AE_FMT_FLOAT, BENCHMARK_SAMPLERATE, BENCHMARK_SAMPLERATE, AE_CH_LAYOUT_2_0, AESTREAM_AUTOSTART);
+    if (!stream)
+      break;
+    stream->SetVolume(1.0f / streams);
+    list.push_back(stream);
+  }
+
+  /* one second of a 1khz tone, offset per stream so they are not identical */
+  const unsigned int frames = BENCHMARK_SAMPLERATE;
+  std::vector<float> tone(frames * BENCHMARK_CHANNELS);
+  for (unsigned int i = 0; i < frames; ++i)
+    tone[i * BENCHMARK_CHANNELS] = tone[i * BENCHMARK_CHANNELS + 1] = 0.5f * sinf(2.0f * (float)M_PI * 1000.0f * i / BENCHMARK_SAMPLERATE);
+
+  float usage = -1.0f;
+  if (list.size() == streams)
+  {
+    std::vector<unsigned int> offset(streams);
+    for (unsigned int i = 0; i < streams; ++i)
+      offset[i] = (i * 97) % frames;
+
+    /* prime the streams before we start measuring */
+    bool measuring = false;
+    int64_t startUsage = 0;
+    unsigned int startTime = 0;
+    XbmcThreads::EndTime end((m_seconds + 1) * 1000);
+    while (!end.IsTimePast())
+    {
+      for (unsigned int i = 0; i < streams; ++i)
+      {
+        unsigned int space = list[i]->GetSpace() / (BENCHMARK_CHANNELS * sizeof(float));
+        while (space > 0)
+        {
+          unsigned int count = std::min(space, frames - offset[i]);
+          unsigned int added = list[i]->AddData(&tone[offset[i] * BENCHMARK_CHANNELS], count * BENCHMARK_CHANNELS * sizeof(float));
+          added /= BENCHMARK_CHANNELS * sizeof(float);
+          if (added == 0)
+            break;
+          offset[i] = (offset[i] + added) % frames;
+          space -= std::min(space, added);
+        }
+      }
+
+      if (!measuring && end.MillisLeft() <= m_seconds * 1000)
+      {
+        measuring  = true;
+        startUsage = AE.m_thread->GetAbsoluteUsage();
+        startTime  = XbmcThreads::SystemClockMillis();
+      }
+
+      Sleep(10);
+    }
+
+    /* thread usage is in 100ns units, the NULL sink plays in real time */
+    unsigned int elapsed = XbmcThreads::SystemClockMillis() - startTime;
+    int64_t used = AE.m_thread->GetAbsoluteUsage() - startUsage;
+    if (elapsed > 0)
+      usage = (float)used / 10000.0f / (elapsed / 1000.0f);
+  }
+  else
+    CLog::Log(LOGERROR, "CSoftAEBenchmark - failed to create %u streams", streams);
+
+  for (unsigned int i = 0; i < list.size(); ++i)
+    AE.FreeStream(list[i]);
+
+  return usage;
+}
+
+void CSoftAEBenchmark::RunOutputKernels()
+{
+  static const enum AEDataFormat formats[] =
+  {
+    AE_FMT_FLOAT, AE_FMT_S16NE, AE_FMT_S24NE4, AE_FMT_S24NE3, AE_FMT_S32NE
+  };
+
+  const unsigned int samples = KERNEL_FRAMES * KERNEL_CHANNELS;
+  const float volume = 0.8f;
+
+  /* a mix that stays within full scale, the case every period without clipping hits */
+  std::vector<float> tone(samples);
+  for (unsigned int i = 0; i < samples; ++i)
+    tone[i] = 0.9f * sinf(2.0f * (float)M_PI * 1000.0f * (i / KERNEL_CHANNELS) / BENCHMARK_SAMPLERATE);
+
+  float *mix = (float*)_aligned_malloc(samples * sizeof(float), 16);
+  uint8_t *out = (uint8_t*)_aligned_malloc(samples * sizeof(double), 16);
+
+  for (unsigned int f = 0; f < sizeof(formats) / sizeof(formats[0]); ++f)
+  {
+    CAEConvert::AEConvertFrFn    convertFn = CAEConvert::FrFloat   (formats[f]);
+    CAEConvert::AEConvertFrVolFn packFn    = CAEConvert::FrFloatVol(formats[f]);
+
+    /* the separate passes FinalizeSamples used to make */
+    int64_t  start  = CurrentHostCounter();
+    uint64_t cycles = ReadCycles();
+    for (unsigned int run = 0; run < KERNEL_RUNS; ++run)
+    {
+      memcpy(mix, &tone[0], samples * sizeof(float));
+      #ifdef __SSE__
+        CAEUtil::SSEMulArray(mix, volume, samples);
+      #else
+        for (unsigned int i = 0; i < samples; ++i)
+          mix[i] *= volume;
+      #endif
+      for (unsigned int i = 0; i < samples; ++i)
+        if (mix[i] < -1.0f || mix[i] > 1.0f)
+        {
+          CAEUtil::ClampArray(mix, samples);
+          break;
+        }
+      if (convertFn)
+        convertFn(mix, samples, out);
+    }
+    uint64_t separateCycles = ReadCycles() - cycles;
+    int64_t  separateTicks  = CurrentHostCounter() - start;
+
+    const double frames = (double)KERNEL_RUNS * KERNEL_FRAMES;
+    const double nsMul  = 1000000000.0 / CurrentHostFrequency() / frames;
+    if (!packFn)
+    { /* e.g. S32 on NEON builds, which keeps its vector converter */
+      CLog::Log(LOGNOTICE, "CSoftAEBenchmark - %s output stage, %u channels: separate %.2f ns (%.1f cycles) per frame, no fused kernel",
+        CAEUtil::DataFormatToStr(formats[f]), KERNEL_CHANNELS,
+        separateTicks * nsMul, separateCycles / frames);
+      continue;
+    }
+
+    start  = CurrentHostCounter();
+    cycles = ReadCycles();
+    for (unsigned int run = 0; run < KERNEL_RUNS; ++run)
+    {
+      memcpy(mix, &tone[0], samples * sizeof(float));
+      packFn(mix, samples, volume, false, convertFn ? out : (uint8_t*)mix);
+    }
+    uint64_t fusedCycles = ReadCycles() - cycles;
+    int64_t  fusedTicks  = CurrentHostCounter() - start;
+
+    CLog::Log(LOGNOTICE, "CSoftAEBenchmark - %s output stage, %u channels: separate %.2f ns (%.1f cycles), fused %.2f ns (%.1f cycles) per frame",
+      CAEUtil::DataFormatToStr(formats[f]), KERNEL_CHANNELS,
+      separateTicks * nsMul, separateCycles / frames,
+      fusedTicks    * nsMul, fusedCycles    / frames);
+  }
+
+  _aligned_free(out);
+  _aligned_free(mix);
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+
+#include "utils/Job.h"
+
+/*!
+ \brief Measures the CPU cost of the SoftAE mixer.
+
+ Switches the engine to the NULL sink, which consumes audio in real time,
+ then plays 1, 2 and 8 synthetic streams for a number of seconds each and
+ logs the CPU time the engine thread used per second of audio. The previous
+ output device is restored once done.
+
+ Before that the output stage kernels are timed on their own for each sink
+ format, comparing the separate volume, clamp and convert passes against the
+ fused CAEConvert::FrFloatVol kernel.
+ */
+class CSoftAEBenchmark : public CJob
+{
+public:
+  CSoftAEBenchmark(unsigned int seconds = 10);
+  virtual ~CSoftAEBenchmark() {}
+
+  virtual const char *GetType() const { return "aebenchmark"; }
+  virtual bool DoWork();
+
+private:
+  float Run(unsigned int streams);
+  void  RunOutputKernels();
+
+  unsigned int m_seconds;
+};
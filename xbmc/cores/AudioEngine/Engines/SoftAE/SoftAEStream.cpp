@@ -23,6 +23,7 @@
 #include "threads/SingleLock.h"
 #include "utils/log.h"
 #include "utils/MathUtils.h"
+#include "settings/AdvancedSettings.h"
 
 #include "AEFactory.h"
 #include "Utils/AEUtil.h"
@@ -43,21 +44,18 @@ CSoftAEStream::CSoftAEStream(enum AEDataFormat dataFormat, unsigned int sampleRa
   m_delete          (false),
   m_volume          (1.0f ),
   m_rgain           (1.0f ),
-  m_refillBuffer    (0    ),
+  m_refilling       (true ),
   m_convertFn       (NULL ),
-  m_ssrc            (NULL ),
-  m_framesBuffered  (0    ),
-  m_newPacket       (NULL ),
-  m_packet          (NULL ),
-  m_vizPacketPos    (NULL ),
+  m_resampleBuffer  (NULL ),
+  m_resampleFrames  (0    ),
+  m_framesHeld      (0    ),
+  m_overrunFrames   (0    ),
   m_draining        (false),
   m_vizBufferSamples(0    ),
   m_audioCallback   (NULL ),
   m_fadeRunning     (false),
   m_slave           (NULL )
 {
-  m_ssrcData.data_out = NULL;
-
   m_initDataFormat        = dataFormat;
   m_initSampleRate        = sampleRate;
   m_initEncodedSampleRate = encodedSampleRate;
@@ -91,6 +89,7 @@ void CSoftAEStream::InitializeRemap()
       m_aeChannelLayout = AE.GetChannelLayout();
       m_samplesPerFrame = AE.GetChannelLayout().Count();
       m_aeBytesPerFrame = AE_IS_RAW(m_initDataFormat) ? m_bytesPerFrame : (m_samplesPerFrame * sizeof(float));
+      CreateFrameRing();
     }
   }
 }
@@ -101,15 +100,14 @@ void CSoftAEStream::Initialize()
   if (m_valid)
   {
     InternalFlush();
-    delete m_newPacket;
 
     if (m_convert)
       _aligned_free(m_convertBuffer);
 
     if (m_resample)
     {
-      _aligned_free(m_ssrcData.data_out);
-      m_ssrcData.data_out = NULL;
+      _aligned_free(m_resampleBuffer);
+      m_resampleBuffer = NULL;
     }
   }
 
@@ -139,7 +137,7 @@ void CSoftAEStream::Initialize()
   // set the waterlevel to 75 percent of the number of frames per second.
   // this lets us drain the main buffer down futher before flagging an underrun.
   m_waterLevel      = AE.GetSampleRate() - (AE.GetSampleRate() / 4);
-  m_refillBuffer    = m_waterLevel;
+  m_refilling       = true;
 
   m_format.m_dataFormat    = useDataFormat;
   m_format.m_sampleRate    = m_initSampleRate;
@@ -149,10 +147,7 @@ void CSoftAEStream::Initialize()
   m_format.m_frameSamples  = m_format.m_frames * m_initChannelLayout.Count();
   m_format.m_frameSize     = m_bytesPerFrame;
 
-  m_newPacket = new PPacket();
-  if (AE_IS_RAW(m_initDataFormat))
-    m_newPacket->data.Alloc(m_format.m_frames * m_format.m_frameSize);
-  else
+  if (!AE_IS_RAW(m_initDataFormat))
   {
     if (
       !m_remap   .Initialize(m_initChannelLayout, m_aeChannelLayout               , false, false, AE.GetStdChLayout()) ||
@@ -161,12 +156,8 @@ void CSoftAEStream::Initialize()
       m_valid = false;
       return;
     }
-
-    m_newPacket->data.Alloc(m_format.m_frameSamples * sizeof(float));
   }
 
-  m_packet = NULL;
-
   m_inputBuffer.Alloc(m_format.m_frames * m_format.m_frameSize);
 
   m_resample      = (m_forceResample || m_initSampleRate != AE.GetSampleRate()) && !AE_IS_RAW(m_initDataFormat);
@@ -184,25 +175,49 @@ void CSoftAEStream::Initialize()
       m_valid         = false;
   }
   else
-    m_convertBuffer = (float*)m_inputBuffer.Raw(m_format.m_frames * m_format.m_frameSize);
+    m_convertBuffer = NULL;
 
   /* if we need to resample, set it up */
   if (m_resample)
   {
-    int err;
-    m_ssrc                   = src_new(SRC_SINC_MEDIUM_QUALITY, m_initChannelLayout.Count(), &err);
-    m_ssrcData.data_in       = m_convertBuffer;
-    m_internalRatio          = (double)AE.GetSampleRate() / (double)m_initSampleRate;
-    m_ssrcData.src_ratio     = m_internalRatio;
-    m_ssrcData.data_out      = (float*)_aligned_malloc(m_format.m_frameSamples * (int)std::ceil(m_ssrcData.src_ratio) * sizeof(float), 16);
-    m_ssrcData.output_frames = m_format.m_frames * (long)std::ceil(m_ssrcData.src_ratio);
-    m_ssrcData.end_of_input  = 0;
+    m_internalRatio  = (double)AE.GetSampleRate() / (double)m_initSampleRate;
+    m_resampler.Initialize(
+      m_initChannelLayout.Count(),
+      m_internalRatio,
+      (CAEResampler::Quality)g_advancedSettings.m_audioResampleQuality,
+      g_advancedSettings.m_audioPolyphaseResampler
+    );
+    m_resampleBuffer = (float*)_aligned_malloc(m_format.m_frameSamples * (int)std::ceil(m_resampler.GetRatio()) * sizeof(float), 16);
+    m_resampleFrames = m_format.m_frames * (unsigned int)std::ceil(m_resampler.GetRatio());
   }
 
   m_chLayoutCount = m_format.m_channelLayout.Count();
+  CreateFrameRing();
   m_valid = true;
 }
 
+void CSoftAEStream::CreateFrameRing()
+{
+  /* room for the water level, a processed block and the frames the engine holds */
+  unsigned int blockFrames = m_resample ? m_resampleFrames : m_format.m_frames;
+  unsigned int ringFrames  = m_waterLevel + 2 * blockFrames + AE.GetFrames();
+
+  m_frameRing.Create(ringFrames * m_aeBytesPerFrame);
+  if (!AE_IS_RAW(m_initDataFormat))
+    m_vizRing.Create(ringFrames * 2 * sizeof(float));
+  m_framesHeld = 0;
+}
+
+unsigned int CSoftAEStream::GetFramesBuffered()
+{
+  if (!m_aeBytesPerFrame)
+    return 0;
+
+  /* the frames the engine holds are already being played */
+  unsigned int frames = m_frameRing.GetReadSize() / m_aeBytesPerFrame;
+  return frames - std::min(frames, m_framesHeld);
+}
+
 void CSoftAEStream::Destroy()
 {
   CExclusiveLock lock(m_lock);
@@ -220,9 +235,8 @@ CSoftAEStream::~CSoftAEStream()
 
   if (m_resample)
   {
-    _aligned_free(m_ssrcData.data_out);
-    src_delete(m_ssrc);
-    m_ssrc = NULL;
+    _aligned_free(m_resampleBuffer);
+    m_resampler.Deinitialize();
   }
 
   CLog::Log(LOGDEBUG, "CSoftAEStream::~CSoftAEStream - Destructed");
@@ -230,18 +244,28 @@ CSoftAEStream::~CSoftAEStream()
 
 unsigned int CSoftAEStream::GetSpace()
 {
+  CSharedLock lock(m_lock);
   if (!m_valid || m_draining)
     return 0;
 
-  if (m_framesBuffered >= m_waterLevel)
+  unsigned int buffered = GetFramesBuffered();
+  if (buffered >= m_waterLevel)
     return 0;
 
-  return m_inputBuffer.Free() + (std::max(0U, (m_waterLevel - m_framesBuffered)) * m_format.m_frameSize);
+  /* the ring holds output frames, convert the room left to input frames */
+  double       ratio    = m_resample ? m_resampler.GetRatio() : 1.0;
+  unsigned int ringFree = m_frameRing.GetWriteSize() / m_aeBytesPerFrame;
+  unsigned int frames   = CAEUtil::ResampleInputSpace(ringFree, m_waterLevel - buffered, m_format.m_frames, ratio);
+  return m_inputBuffer.Free() + frames * m_format.m_frameSize;
 }
 
 unsigned int CSoftAEStream::AddData(void *data, unsigned int size)
 {
-  CExclusiveLock lock(m_lock);
+  /*
+    we are the only writer of the frame ring and the engine the only reader,
+    the shared lock just keeps Flush and Initialize out while we work
+  */
+  CSharedLock lock(m_lock);
   if (!m_valid || size == 0 || data == NULL)
     return 0;
 
@@ -249,7 +273,7 @@ unsigned int CSoftAEStream::AddData(void *data, unsigned int size)
   if (m_draining)
   {
     /* if the stream has finished draining, cork it */
-    if (m_packet && !m_packet->data.Used() && m_outBuffer.empty())
+    if (m_frameRing.GetReadSize() == 0)
       m_draining = false;
     else
       return 0;
@@ -260,56 +284,60 @@ unsigned int CSoftAEStream::AddData(void *data, unsigned int size)
   if (size == 0)
     return 0;
 
+  uint8_t     *ptr   = (uint8_t*)data;
+  unsigned int block = m_inputBuffer.Size();
   unsigned int taken = 0;
   while(size)
   {
-    unsigned int copy = std::min((unsigned int)m_inputBuffer.Free(), size);
-    if (copy > 0)
+    unsigned int copy;
+    if (m_inputBuffer.Used() == 0 && size >= block && ((uintptr_t)ptr & 0xF) == 0)
     {
-      m_inputBuffer.Push(data, copy);
-      size  -= copy;
-      taken += copy;
-      data   = (uint8_t*)data + copy;
+      /* a whole block is available, process it where it is */
+      unsigned int consumed = ProcessFrameBuffer(ptr, block);
+      m_inputBuffer.Push(ptr + consumed, block - consumed);
+      copy = block;
     }
-
-    if (m_inputBuffer.Free() == 0)
+    else
     {
-      unsigned int consumed = ProcessFrameBuffer();
-      m_inputBuffer.Shift(NULL, consumed);
+      copy = std::min((unsigned int)m_inputBuffer.Free(), size);
+      m_inputBuffer.Push(ptr, copy);
+      if (m_inputBuffer.Free() == 0)
+      {
+        unsigned int consumed = ProcessFrameBuffer((uint8_t*)m_inputBuffer.Raw(m_inputBuffer.Used()), m_inputBuffer.Used());
+        m_inputBuffer.Shift(NULL, consumed);
+      }
     }
+
+    ptr   += copy;
+    size  -= copy;
+    taken += copy;
   }
 
   lock.Leave();
 
   /* if the stream is flagged to autoStart when the buffer is full, then do it */
-  if (m_autoStart && m_framesBuffered >= m_waterLevel)
+  if (m_autoStart && GetFramesBuffered() >= m_waterLevel)
     Resume();
 
   return taken;
 }
 
-unsigned int CSoftAEStream::ProcessFrameBuffer()
+unsigned int CSoftAEStream::ProcessFrameBuffer(uint8_t *input, unsigned int size)
 {
   uint8_t     *data;
-  unsigned int frames, consumed, sampleSize;
+  unsigned int frames, consumed;
 
   /* convert the data if we need to */
   unsigned int samples;
   if (m_convert)
   {
-    data       = (uint8_t*)m_convertBuffer;
-    samples    = m_convertFn(
-      (uint8_t*)m_inputBuffer.Raw(m_inputBuffer.Used()),
-      m_inputBuffer.Used() / m_bytesPerSample,
-      m_convertBuffer
-    );
-    sampleSize = sizeof(float);
+    data    = (uint8_t*)m_convertBuffer;
+    samples = m_convertFn(input, size / m_bytesPerSample, m_convertBuffer);
   }
   else
   {
-    data       = (uint8_t*)m_inputBuffer.Raw(m_inputBuffer.Used());
-    samples    = m_inputBuffer.Used() / m_bytesPerSample;
-    sampleSize = m_bytesPerSample;
+    data    = input;
+    samples = size / m_bytesPerSample;
   }
 
   if (samples == 0)
@@ -318,158 +346,164 @@ unsigned int CSoftAEStream::ProcessFrameBuffer()
   /* resample it if we need to */
   if (m_resample)
   {
-    m_ssrcData.input_frames = samples / m_chLayoutCount;
-    if (src_process(m_ssrc, &m_ssrcData) != 0)
-      return 0;
-    data     = (uint8_t*)m_ssrcData.data_out;
-    frames   = m_ssrcData.output_frames_gen;
-    consumed = m_ssrcData.input_frames_used * m_bytesPerFrame;
+    unsigned int used;
+    frames   = m_resampler.Process((float*)data, samples / m_chLayoutCount, used, m_resampleBuffer, m_resampleFrames);
+    data     = (uint8_t*)m_resampleBuffer;
+    consumed = used * m_bytesPerFrame;
     if (!frames)
       return consumed;
-
-    samples = frames * m_chLayoutCount;
   }
   else
   {
-    data     = (uint8_t*)m_convertBuffer;
     frames   = samples / m_chLayoutCount;
     consumed = frames * m_bytesPerFrame;
   }
 
-  if (m_refillBuffer)
-  {
-    if (frames > m_refillBuffer)
-      m_refillBuffer = 0;
-    else
-      m_refillBuffer -= frames;
-  }
+  WriteFrames(data, frames);
+  return consumed;
+}
 
-  /* buffer the data */
-  m_framesBuffered += frames;
-  const unsigned int inputBlockSize = m_format.m_frames * m_format.m_channelLayout.Count() * sampleSize;
+void CSoftAEStream::WriteFrames(uint8_t *data, unsigned int frames)
+{
+  const bool raw = AE_IS_RAW(m_initDataFormat);
 
-  size_t remaining = samples * sampleSize;
-  while (remaining)
+  /* the viz data goes in first so the engine never sees frames without it */
+  if (m_audioCallback && !raw)
   {
-    size_t copy = std::min(m_newPacket->data.Free(), remaining);
-    m_newPacket->data.Push(data, copy);
-    data      += copy;
-    remaining -= copy;
-
-    /* wait till we have a full packet, or no more data before processing the packet */
-    if ((!m_draining || remaining) && m_newPacket->data.Free() > 0)
-      continue;
-
-    /* if we have a full block of data */
-    if (AE_IS_RAW(m_initDataFormat))
+    float       *in    = (float*)data;
+    unsigned int count = frames;
+    while (count)
     {
-      m_outBuffer.push_back(m_newPacket);
-      m_newPacket = new PPacket();
-      m_newPacket->data.Alloc(inputBlockSize);
-      continue;
+      unsigned int space;
+      float *out = (float*)m_vizRing.GetWritePtr(space);
+      unsigned int chunk = std::min(count, space / (unsigned int)(2 * sizeof(float)));
+      if (!chunk)
+        break;
+
+      m_vizRemap.Remap(in, out, chunk);
+      m_vizRing.CommitWrite(chunk * 2 * sizeof(float));
+      in    += chunk * m_chLayoutCount;
+      count -= chunk;
     }
+  }
 
-    /* make a new packet for downmix/remap */
-    PPacket *pkt = new PPacket();
-
-    /* downmix/remap the data */
-    size_t frames = m_newPacket->data.Used() / m_format.m_channelLayout.Count() / sizeof(float);
-    size_t used   = frames * m_aeChannelLayout.Count() * sizeof(float);
-    pkt->data.Alloc(used);
-    m_remap.Remap(
-      (float*)m_newPacket->data.Raw (m_newPacket->data.Used()),
-      (float*)pkt        ->data.Take(used),
-      frames
-    );
-
-    /* downmix for the viz if we have one */
-    if (m_audioCallback)
+  /* downmix/remap straight into the ring, RAW data is copied as is */
+  const unsigned int inFrameSize = raw ? m_bytesPerFrame : m_chLayoutCount * sizeof(float);
+  while (frames)
+  {
+    unsigned int space;
+    uint8_t *out = m_frameRing.GetWritePtr(space);
+    unsigned int chunk = std::min(frames, space / m_aeBytesPerFrame);
+    if (!chunk)
     {
-      size_t vizUsed = frames * 2 * sizeof(float);
-      pkt->vizData.Alloc(vizUsed);
-      m_vizRemap.Remap(
-        (float*)m_newPacket->data   .Raw (m_newPacket->data.Used()),
-        (float*)pkt        ->vizData.Take(vizUsed),
-        frames
-      );
+      /* only log the start and the end of an overrun, not every write */
+      if (!m_overrunFrames)
+        CLog::Log(LOGWARNING, "CSoftAEStream::WriteFrames - Overrun, dropping frames");
+      m_overrunFrames += frames;
+      return;
     }
 
-    /* add the packet to the output */
-    m_outBuffer.push_back(pkt);
-    m_newPacket->data.Empty();
+    if (raw)
+      memcpy(out, data, chunk * m_aeBytesPerFrame);
+    else
+      m_remap.Remap((float*)data, (float*)out, chunk);
+
+    m_frameRing.CommitWrite(chunk * m_aeBytesPerFrame);
+    data   += chunk * inFrameSize;
+    frames -= chunk;
   }
 
-  return consumed;
+  if (m_overrunFrames)
+  {
+    CLog::Log(LOGWARNING, "CSoftAEStream::WriteFrames - Overrun ended, dropped %u frames", m_overrunFrames);
+    m_overrunFrames = 0;
+  }
 }
 
-uint8_t* CSoftAEStream::GetFrame()
+uint8_t* CSoftAEStream::GetFrames(unsigned int maxFrames, unsigned int &frames)
 {
-  CExclusiveLock lock(m_lock);
+  /* see AddData, the shared lock only keeps Flush and Initialize out */
+  CSharedLock lock(m_lock);
 
-  /* if we are fading, this runs even if we have underrun as it is time based */
-  if (m_fadeRunning)
+  frames = 0;
+  uint8_t *ret = NULL;
+
+  /* the frames we handed out last time have been mixed, release them */
+  if (m_framesHeld)
   {
-    m_volume += m_fadeStep;
-    m_volume = std::min(1.0f, std::max(0.0f, m_volume));
-    if (m_fadeDirUp)
-    {
-      if (m_volume >= m_fadeTarget)
-        m_fadeRunning = false;
-    }
-    else
-    {
-      if (m_volume <= m_fadeTarget)
-        m_fadeRunning = false;
-    }
+    m_frameRing.CommitRead(m_framesHeld * m_aeBytesPerFrame);
+    m_framesHeld = 0;
   }
 
   /* if we have been deleted or are refilling but not draining */
-  if (!m_valid || m_delete || (m_refillBuffer && !m_draining))
-    return NULL;
-
-  /* if the packet is empty, advance to the next one */
-  if (!m_packet || m_packet->data.CursorEnd())
+  if (m_valid && !m_delete)
   {
-    delete m_packet;
-    m_packet = NULL;
+    unsigned int buffered = m_frameRing.GetReadSize() / m_aeBytesPerFrame;
+    if (m_refilling && (buffered >= m_waterLevel || m_draining))
+      m_refilling = false;
 
-    /* no more packets, return null */
-    if (m_outBuffer.empty())
+    if (!m_refilling)
     {
-      if (m_draining)
-        return NULL;
+      if (buffered == 0)
+      {
+        if (!m_draining)
+        {
+          /* underrun, we need to refill our buffers */
+          CLog::Log(LOGDEBUG, "CSoftAEStream::GetFrames - Underrun");
+          m_refilling = true;
+        }
+      }
       else
       {
-        /* underrun, we need to refill our buffers */
-        CLog::Log(LOGDEBUG, "CSoftAEStream::GetFrame - Underrun");
-        ASSERT(m_waterLevel > m_framesBuffered);
-        m_refillBuffer = m_waterLevel - m_framesBuffered;
-        return NULL;
+        /* fetch as many frames as we can before the ring wraps */
+        unsigned int size;
+        ret          = m_frameRing.GetReadPtr(size);
+        frames       = std::min(size / m_aeBytesPerFrame, maxFrames);
+        m_framesHeld = frames;
+
+        /* we have frames, if we have a viz we need to hand the data to it */
+        if (m_audioCallback)
+        {
+          /* if the viz was registered mid stream the older frames have no viz data */
+          unsigned int vizFrames = m_vizRing.GetReadSize() / (2 * sizeof(float));
+          unsigned int count     = frames - std::min(frames, buffered - std::min(buffered, vizFrames));
+          while (count)
+          {
+            unsigned int chunk = std::min(count, (512 - m_vizBufferSamples) / 2);
+            m_vizRing.Read((unsigned char*)(m_vizBuffer + m_vizBufferSamples), chunk * 2 * sizeof(float));
+            m_vizBufferSamples += chunk * 2;
+            count              -= chunk;
+            if (m_vizBufferSamples == 512)
+            {
+              m_audioCallback->OnAudioData(m_vizBuffer, 512);
+              m_vizBufferSamples = 0;
+            }
+          }
+        }
       }
     }
-
-    /* get the next packet */
-    m_packet = m_outBuffer.front();
-    m_outBuffer.pop_front();
   }
 
-  /* fetch one frame of data */
-  uint8_t *ret = (uint8_t*)m_packet->data.CursorRead(m_aeBytesPerFrame);
-
-  /* we have a frame, if we have a viz we need to hand the data to it */
-  if (m_audioCallback && !m_packet->vizData.CursorEnd())
+  /*
+    if we are fading, this runs even if we have underrun as it is time based,
+    the caller ramps between the volume before and after this call
+  */
+  if (m_fadeRunning)
   {
-    float *vizData = (float*)m_packet->vizData.CursorRead(2 * sizeof(float));
-    memcpy(m_vizBuffer + m_vizBufferSamples, vizData, 2 * sizeof(float));
-    m_vizBufferSamples += 2;
-    if (m_vizBufferSamples == 512)
+    m_volume += m_fadeStep * (ret ? frames : maxFrames);
+    m_volume = std::min(1.0f, std::max(0.0f, m_volume));
+    if (m_fadeDirUp)
+    {
+      if (m_volume >= m_fadeTarget)
+        m_fadeRunning = false;
+    }
+    else
     {
-      m_audioCallback->OnAudioData(m_vizBuffer, 512);
-      m_vizBufferSamples = 0;
+      if (m_volume <= m_fadeTarget)
+        m_fadeRunning = false;
     }
   }
 
-  --m_framesBuffered;
   return ret;
 }
 
@@ -480,7 +514,7 @@ double CSoftAEStream::GetDelay()
 
   double delay = AE.GetDelay();
   delay += (double)(m_inputBuffer.Used() / m_format.m_frameSize) / (double)m_format.m_sampleRate;
-  delay += (double)m_framesBuffered                              / (double)AE.GetSampleRate();
+  delay += (double)GetFramesBuffered()                           / (double)AE.GetSampleRate();
 
   return delay;
 }
@@ -492,7 +526,7 @@ double CSoftAEStream::GetCacheTime()
 
   double time;
   time  = (double)(m_inputBuffer.Used() / m_format.m_frameSize) / (double)m_format.m_sampleRate;
-  time += (double)(m_waterLevel - m_framesBuffered)             / (double)AE.GetSampleRate();
+  time += (double)(m_waterLevel - GetFramesBuffered())          / (double)AE.GetSampleRate();
   time += AE.GetCacheTime();
   return time;
 }
@@ -528,14 +562,23 @@ void CSoftAEStream::Resume()
 
 void CSoftAEStream::Drain()
 {
-  CSharedLock lock(m_lock);
+  /* processing writes the ring, keep AddData and the engine out */
+  CExclusiveLock lock(m_lock);
+
+  /* push out the partial block left in the input buffer so it gets played */
+  if (m_valid && !m_draining && m_inputBuffer.Used())
+  {
+    unsigned int consumed = ProcessFrameBuffer((uint8_t*)m_inputBuffer.Raw(m_inputBuffer.Used()), m_inputBuffer.Used());
+    m_inputBuffer.Shift(NULL, consumed);
+  }
+
   m_draining = true;
 }
 
 bool CSoftAEStream::IsDrained()
 {
   CSharedLock lock(m_lock);
-  return (m_draining && !m_packet && m_outBuffer.empty());
+  return (m_draining && m_frameRing.GetReadSize() == 0);
 }
 
 void CSoftAEStream::Flush()
@@ -552,33 +595,19 @@ void CSoftAEStream::InternalFlush()
 {
   /* reset the resampler */
   if (m_resample)
-  {
-    m_ssrcData.end_of_input = 0;
-    src_reset(m_ssrc);
-  }
-
-  /* invalidate any incoming samples */
-  m_newPacket->data.Empty();
+    m_resampler.Reset();
 
   /*
-    clear the current buffered packet, we cant delete the data as it may be
-    in use by the AE thread, so we just seek to the end of the buffer
+    drop the buffered frames, the ring memory stays allocated as the AE
+    thread may still be mixing the frames it was last given
   */
-  if (m_packet)
-    m_packet->data.CursorSeek(m_packet->data.Size());
-
-  /* clear any other buffered packets */
-  while (!m_outBuffer.empty())
-  {
-    PPacket *p = m_outBuffer.front();
-    m_outBuffer.pop_front();
-    delete p;
-  }
+  m_frameRing.Reset();
+  m_vizRing.Reset();
+  m_framesHeld = 0;
 
   /* reset our counts */
-  m_framesBuffered = 0;
-  m_refillBuffer   = m_waterLevel;
-  m_draining       = false;
+  m_refilling = true;
+  m_draining  = false;
 }
 
 double CSoftAEStream::GetResampleRatio()
@@ -587,7 +616,7 @@ double CSoftAEStream::GetResampleRatio()
     return 1.0f;
 
   CSharedLock lock(m_lock);
-  return m_ssrcData.src_ratio;
+  return m_resampler.GetRatio();
 }
 
 bool CSoftAEStream::SetResampleRatio(double ratio)
@@ -595,21 +624,20 @@ bool CSoftAEStream::SetResampleRatio(double ratio)
   if (!m_resample)
     return false;
 
-  CSharedLock lock(m_lock);
+  /* the resample buffer may be reallocated under AddData */
+  CExclusiveLock lock(m_lock);
 
-  int oldRatioInt = (int)std::ceil(m_ssrcData.src_ratio);
+  int oldRatioInt = (int)std::ceil(m_resampler.GetRatio());
 
   m_resampleRatio = ratio;
-
-  src_set_ratio(m_ssrc, m_resampleRatio * m_internalRatio);
-  m_ssrcData.src_ratio = m_resampleRatio * m_internalRatio;
+  m_resampler.SetRatio(m_resampleRatio * m_internalRatio);
 
   //Check the resample buffer size and resize if necessary.
-  if (oldRatioInt < std::ceil(m_ssrcData.src_ratio))
+  if (oldRatioInt < std::ceil(m_resampler.GetRatio()))
   {
-    _aligned_free(m_ssrcData.data_out);
-    m_ssrcData.data_out      = (float*)_aligned_malloc(m_format.m_frameSamples * (int)std::ceil(m_ssrcData.src_ratio) * sizeof(float), 16);
-    m_ssrcData.output_frames = m_format.m_frames * (long)std::ceil(m_ssrcData.src_ratio);
+    _aligned_free(m_resampleBuffer);
+    m_resampleBuffer = (float*)_aligned_malloc(m_format.m_frameSamples * (int)std::ceil(m_resampler.GetRatio()) * sizeof(float), 16);
+    m_resampleFrames = m_format.m_frames * (unsigned int)std::ceil(m_resampler.GetRatio());
   }
   return true;
 }
@@ -618,6 +646,7 @@ void CSoftAEStream::RegisterAudioCallback(IAudioCallback* pCallback)
 {
   CExclusiveLock lock(m_lock);
   m_vizBufferSamples = 0;
+  m_vizRing.Reset();
   m_audioCallback = pCallback;
   if (m_audioCallback)
     m_audioCallback->OnInitialize(2, m_initSampleRate, 32);
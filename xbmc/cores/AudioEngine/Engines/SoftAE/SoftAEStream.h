@@ -20,16 +20,15 @@
  *
  */
 
-#include <samplerate.h>
-#include <list>
-
 #include "threads/SharedSection.h"
 
 #include "AEAudioFormat.h"
 #include "Interfaces/AEStream.h"
 #include "Utils/AEConvert.h"
+#include "Utils/AEResampler.h"
 #include "Utils/AERemap.h"
 #include "Utils/AEBuffer.h"
+#include "Utils/AERingBuffer.h"
 
 class IAEPostProc;
 class CSoftAEStream : public IAEStream
@@ -42,7 +41,7 @@ protected:
   void Initialize();
   void InitializeRemap();
   void Destroy();
-  uint8_t* GetFrame();
+  uint8_t* GetFrames(unsigned int maxFrames, unsigned int &frames);
 
   bool IsPaused   () { return m_paused; }
   bool IsDestroyed() { return m_delete; }
@@ -53,7 +52,7 @@ public:
   virtual unsigned int      GetSpace        ();
   virtual unsigned int      AddData         (void *data, unsigned int size);
   virtual double            GetDelay        ();
-  virtual bool              IsBuffering     () { return m_refillBuffer > 0; }
+  virtual bool              IsBuffering     () { return m_refilling; }
   virtual double            GetCacheTime    ();
   virtual double            GetCacheTotal   ();
 
@@ -86,6 +85,9 @@ public:
 private:
   void InternalFlush();
   void CheckResampleBuffers();
+  void CreateFrameRing();
+  void WriteFrames(uint8_t *data, unsigned int frames);
+  unsigned int GetFramesBuffered();
 
   CSharedSection    m_lock;
   enum AEDataFormat m_initDataFormat;
@@ -93,12 +95,6 @@ private:
   unsigned int      m_initEncodedSampleRate;
   CAEChannelInfo    m_initChannelLayout;
   unsigned int      m_chLayoutCount;
-  
-  typedef struct
-  {
-    CAEBuffer data;
-    CAEBuffer vizData;
-  } PPacket;
 
   AEAudioFormat m_format;
 
@@ -114,7 +110,7 @@ private:
   float                   m_volume;        /* the volume level */
   float                   m_rgain;         /* replay gain level */
   unsigned int            m_waterLevel;    /* the fill level to fall below before calling the data callback */
-  unsigned int            m_refillBuffer;  /* how many frames that need to be buffered before we return any frames */
+  bool                    m_refilling;     /* true if no frames are returned until the water level is reached */
 
   CAEConvert::AEConvertToFn m_convertFn;
 
@@ -124,15 +120,20 @@ private:
   unsigned int        m_samplesPerFrame;
   CAEChannelInfo      m_aeChannelLayout;
   unsigned int        m_aeBytesPerFrame;
-  SRC_STATE          *m_ssrc;
-  SRC_DATA            m_ssrcData;
-  unsigned int        m_framesBuffered;
-  std::list<PPacket*> m_outBuffer;
-  unsigned int        ProcessFrameBuffer();
-  PPacket            *m_newPacket;
-  PPacket            *m_packet;
-  uint8_t            *m_packetPos;
-  float              *m_vizPacketPos;
+  CAEResampler        m_resampler;
+  float              *m_resampleBuffer;
+  unsigned int        m_resampleFrames;
+  unsigned int        ProcessFrameBuffer(uint8_t *input, unsigned int size);
+
+  /*
+    frames ready for the engine in the engine's layout. AddData is the only
+    writer and GetFrames the only reader so neither needs the stream lock
+    exclusively, the frames GetFrames returns are released on its next call
+  */
+  AERingBuffer        m_frameRing;
+  AERingBuffer        m_vizRing;       /* stereo downmix of m_frameRing for the viz */
+  unsigned int        m_framesHeld;    /* frames returned by the last GetFrames */
+  unsigned int        m_overrunFrames; /* frames dropped since the ring last took a whole write */
   bool                m_paused;
   bool                m_autoStart;
   bool                m_draining;
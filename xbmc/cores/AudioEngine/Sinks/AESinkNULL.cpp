@@ -23,7 +23,10 @@
 
 #include "AESinkNULL.h"
 #include <stdint.h>
+#include <stdlib.h>
 #include <limits.h>
+#include <math.h>
+#include <algorithm>
 
 #include "guilib/LocalizeStrings.h"
 #include "dialogs/GUIDialogKaiToast.h"
@@ -34,6 +37,7 @@
 #include "utils/MathUtils.h"
 #include "utils/TimeUtils.h"
 #include "settings/GUISettings.h"
+#include "settings/AdvancedSettings.h"
 
 CAESinkNULL::CAESinkNULL() {
 }
@@ -46,9 +50,14 @@ bool CAESinkNULL::Initialize(AEAudioFormat &format, std::string &device)
 {
   m_msPerFrame           = 1000.0f / format.m_sampleRate;
   m_ts                   = 0;
+  m_speed                = 1.0 + g_advancedSettings.m_audioNullSinkDriftPpm * 1e-6;
+  m_period               = g_advancedSettings.m_audioNullSinkPeriodMsec / 1000.0;
+  m_jitter               = g_advancedSettings.m_audioNullSinkJitterMsec / 1000.0;
 
   format.m_dataFormat    = AE_IS_RAW(format.m_dataFormat) ? AE_FMT_S16NE : AE_FMT_FLOAT;
   format.m_frames        = format.m_sampleRate / 1000 * 500; /* 500ms */
+  if (m_period > 0.0)
+    format.m_frames      = (unsigned int)(format.m_sampleRate * m_period); /* packets of a virtual device period */
   format.m_frameSamples  = format.m_channelLayout.Count();
   format.m_frameSize     = format.m_frameSamples * (CAEUtil::DataFormatToBits(format.m_dataFormat) >> 3);
 
@@ -78,14 +87,37 @@ bool CAESinkNULL::IsCompatible(const AEAudioFormat format, const std::string dev
 
 double CAESinkNULL::GetDelay()
 {
-  return std::max(0.0, (double)(m_ts - CurrentHostCounter()) / 1000000.0f);
+  double delay = (double)(m_ts - CurrentHostCounter()) / CurrentHostFrequency() * m_speed;
+  if (delay <= 0.0)
+    return 0.0;
+
+  /* a device only knows which period it is playing, and the report is late by some jitter */
+  if (m_period > 0.0)
+    delay = ceil(delay / m_period) * m_period;
+  if (m_jitter > 0.0)
+    delay += m_jitter * (2.0 * rand() / RAND_MAX - 1.0);
+
+  return std::max(0.0, delay);
 }
 
 unsigned int CAESinkNULL::AddPackets(uint8_t *data, unsigned int frames, bool hasAudio)
 {
-  float timeout = m_msPerFrame * frames;
-  m_ts = CurrentHostCounter() + MathUtils::round_int(timeout * 1000000.0f);
-  Sleep(MathUtils::round_int(timeout));
+  /*
+    behave like a device with a one packet buffer, m_ts is when the last
+    queued frame will have been played. The host counter may be running
+    faster than real time (see SetHostCounterSpeed) so sleeps are scaled.
+  */
+  int64_t now      = CurrentHostCounter();
+  int64_t duration = (int64_t)(m_msPerFrame * frames * CurrentHostFrequency() / 1000.0 / m_speed);
+
+  /* wait for the previous packet to play out before accepting this one */
+  if (m_ts > now)
+  {
+    double ms = (double)(m_ts - now) * 1000.0 / CurrentHostFrequency();
+    Sleep(MathUtils::round_int(ms / GetHostCounterSpeed()));
+  }
+
+  m_ts = std::max(m_ts, now) + duration;
   return frames;
 }
 
@@ -47,4 +47,9 @@ public:
 private:
   int64_t m_ts;
   float   m_msPerFrame;
+
+  /* the virtual device, see the nullsink advanced settings */
+  double  m_speed;   /* device seconds per host second */
+  double  m_period;  /* granularity of the reported delay in seconds */
+  double  m_jitter;  /* peak random error added to the reported delay in seconds */
 };
@@ -132,6 +132,35 @@ CAEConvert::AEConvertFrFn CAEConvert::FrFloat(enum AEDataFormat dataFormat)
   }
 }
 
+CAEConvert::AEConvertFrVolFn CAEConvert::FrFloatVol(enum AEDataFormat dataFormat)
+{
+  switch (dataFormat)
+  {
+#ifdef __BIG_ENDIAN__
+    case AE_FMT_S16NE : return &Float_Vol_S16BE;
+    case AE_FMT_S32NE : return &Float_Vol_S32BE;
+#else
+    case AE_FMT_S16NE : return &Float_Vol_S16LE;
+    case AE_FMT_S32NE : return &Float_Vol_S32LE;
+#endif
+    case AE_FMT_S16LE : return &Float_Vol_S16LE;
+    case AE_FMT_S16BE : return &Float_Vol_S16BE;
+    case AE_FMT_S24NE4: return &Float_Vol_S24NE4;
+    case AE_FMT_S24NE3: return &Float_Vol_S24NE3;
+#if defined(__ARM_NEON__)
+    /* no NEON kernels, keep the NEON converters of FrFloat rather than a scalar pass */
+    case AE_FMT_S32LE : return NULL;
+    case AE_FMT_S32BE : return NULL;
+#else
+    case AE_FMT_S32LE : return &Float_Vol_S32LE;
+    case AE_FMT_S32BE : return &Float_Vol_S32BE;
+#endif
+    case AE_FMT_FLOAT : return &Float_Vol_FLOAT;
+    default:
+      return NULL;
+  }
+}
+
 unsigned int CAEConvert::U8_Float(uint8_t *data, const unsigned int samples, float *dest)
 {
   const float mul = 2.0f / UINT8_MAX;
@@ -1149,3 +1178,220 @@ unsigned int CAEConvert::Float_DOUBLE(float *data, const unsigned int samples, u
   return samples * sizeof(double);
 }
 
+
+/*
+  Fused volume, clip and pack kernels used by the SoftAE output stage.
+
+  VolClip applies the volume and clips a sample, Float_Vol walks the buffer
+  once and hands the clipped samples to a packer which writes them in the
+  destination format, four at a time with SSE. The soft clipper is the same
+  rational tanh approximation as CAEUtil::SoftClamp, which reaches full scale
+  at +/-3.0.
+*/
+
+/* the largest float below 2^31, INT32_MAX itself rounds up and overflows */
+#define S32_FULLSCALE 2147483520.0f
+
+static inline float VolClip(float s, const float volume, const bool softClip, bool &over)
+{
+  s *= volume;
+  if (s > 1.0f || s < -1.0f)
+    over = true;
+
+  if (softClip)
+  {
+    s = std::min(3.0f, std::max(-3.0f, s));
+    const float y = s * s;
+    return s * (27.0f + y) / (27.0f + 9.0f * y);
+  }
+
+  return std::min(1.0f, std::max(-1.0f, s));
+}
+
+#ifdef __SSE__
+static inline __m128 VolClip4(__m128 s, const __m128 volume, const bool softClip, __m128 &over)
+{
+  const __m128 one      = _mm_set_ps1( 1.0f);
+  const __m128 minusOne = _mm_set_ps1(-1.0f);
+
+  s    = _mm_mul_ps(s, volume);
+  over = _mm_or_ps(over, _mm_or_ps(_mm_cmpgt_ps(s, one), _mm_cmplt_ps(s, minusOne)));
+
+  if (softClip)
+  {
+    s = _mm_min_ps(_mm_set_ps1(3.0f), _mm_max_ps(_mm_set_ps1(-3.0f), s));
+    const __m128 y = _mm_mul_ps(s, s);
+    const __m128 d = _mm_add_ps(_mm_set_ps1(27.0f), _mm_mul_ps(_mm_set_ps1(9.0f), y));
+
+    /* reciprocal estimate refined with one newton step is much cheaper than a divide */
+    __m128 r = _mm_rcp_ps(d);
+    r = _mm_mul_ps(r, _mm_sub_ps(_mm_set_ps1(2.0f), _mm_mul_ps(d, r)));
+    s = _mm_mul_ps(_mm_mul_ps(s, _mm_add_ps(_mm_set_ps1(27.0f), y)), r);
+    return _mm_min_ps(one, _mm_max_ps(minusOne, s));
+  }
+
+  return _mm_min_ps(one, _mm_max_ps(minusOne, s));
+}
+#endif
+
+template <class Packer>
+static inline bool Float_Vol(float *data, const unsigned int samples, const float volume, const bool softClip, uint8_t *dest)
+{
+  bool over = false;
+  unsigned int i = 0;
+
+#ifdef __SSE__
+  const __m128 vol   = _mm_set_ps1(volume);
+  __m128       over4 = _mm_setzero_ps();
+  for (; i + 4 <= samples; i += 4, data += 4, dest += Packer::size * 4)
+    Packer::Pack4(VolClip4(_mm_loadu_ps(data), vol, softClip, over4), dest);
+  over = _mm_movemask_ps(over4) != 0;
+#endif
+
+  for (; i < samples; ++i, ++data, dest += Packer::size)
+    Packer::Pack1(VolClip(*data, volume, softClip, over), dest);
+
+  return over;
+}
+
+struct CPackFloat
+{
+  static const unsigned int size = sizeof(float);
+  static inline void Pack1(const float s, uint8_t *dest) { *(float*)dest = s; }
+#ifdef __SSE__
+  static inline void Pack4(const __m128 s, uint8_t *dest) { _mm_storeu_ps((float*)dest, s); }
+#endif
+};
+
+/* same random rounding as Float_S16LE/BE, packs saturate at full scale */
+template <bool BigEndian>
+struct CPackS16
+{
+  static const unsigned int size = sizeof(int16_t);
+  static inline void Pack1(const float s, uint8_t *dest)
+  {
+    int16_t v = (int16_t)std::min(INT16_MAX, std::max(INT16_MIN, safeRound(s * ((float)INT16_MAX + CAEUtil::FloatRand1(-0.5f, 0.5f)))));
+    *(int16_t*)dest = BigEndian ? Endian_SwapBE16(v) : Endian_SwapLE16(v);
+  }
+#ifdef __SSE__
+  static inline void Pack4(const __m128 s, uint8_t *dest)
+  {
+    __m128 rand;
+    CAEUtil::FloatRand4(-0.5f, 0.5f, NULL, &rand);
+    __m128i con = _mm_cvtps_epi32(_mm_mul_ps(s, _mm_add_ps(_mm_set_ps1((float)INT16_MAX), rand)));
+    con = _mm_packs_epi32(con, con);
+    if (BigEndian)
+      con = _mm_or_si128(_mm_slli_epi16(con, 8), _mm_srli_epi16(con, 8));
+    _mm_storel_epi64((__m128i*)dest, con);
+  }
+#endif
+};
+
+struct CPackS24NE4
+{
+  static const unsigned int size = sizeof(int32_t);
+  static inline void Pack1(const float s, uint8_t *dest)
+  {
+    *(int32_t*)dest = (safeRound(s * (float)INT24_MAX) & 0xFFFFFF) << 8;
+  }
+#ifdef __SSE__
+  static inline void Pack4(const __m128 s, uint8_t *dest)
+  {
+    __m128i con = _mm_cvtps_epi32(_mm_mul_ps(s, _mm_set_ps1((float)INT24_MAX)));
+    _mm_storeu_si128((__m128i*)dest, _mm_slli_epi32(con, 8));
+  }
+#endif
+};
+
+struct CPackS24NE3
+{
+  static const unsigned int size = 3;
+  static inline void Put(const int32_t v, uint8_t *dest)
+  {
+#ifdef __BIG_ENDIAN__
+    dest[0] = (uint8_t)(v >> 16);
+    dest[1] = (uint8_t)(v >>  8);
+    dest[2] = (uint8_t)(v      );
+#else
+    dest[0] = (uint8_t)(v      );
+    dest[1] = (uint8_t)(v >>  8);
+    dest[2] = (uint8_t)(v >> 16);
+#endif
+  }
+  static inline void Pack1(const float s, uint8_t *dest)
+  {
+    Put(safeRound(s * (float)INT24_MAX), dest);
+  }
+#ifdef __SSE__
+  static inline void Pack4(const __m128 s, uint8_t *dest)
+  {
+    MEMALIGN(16, int32_t v[4]);
+    _mm_store_si128((__m128i*)v, _mm_cvtps_epi32(_mm_mul_ps(s, _mm_set_ps1((float)INT24_MAX))));
+    Put(v[0], dest    );
+    Put(v[1], dest + 3);
+    Put(v[2], dest + 6);
+    Put(v[3], dest + 9);
+  }
+#endif
+};
+
+template <bool BigEndian>
+struct CPackS32
+{
+  static const unsigned int size = sizeof(int32_t);
+  static inline void Pack1(const float s, uint8_t *dest)
+  {
+    int32_t v = safeRound(std::min(S32_FULLSCALE, s * (float)INT32_MAX));
+    *(int32_t*)dest = BigEndian ? Endian_SwapBE32(v) : Endian_SwapLE32(v);
+  }
+#ifdef __SSE__
+  static inline void Pack4(const __m128 s, uint8_t *dest)
+  {
+    __m128i con = _mm_cvtps_epi32(_mm_min_ps(_mm_set_ps1(S32_FULLSCALE), _mm_mul_ps(s, _mm_set_ps1((float)INT32_MAX))));
+    if (BigEndian)
+      con = _mm_or_si128(
+        _mm_or_si128(_mm_slli_epi32(con, 24), _mm_srli_epi32(con, 24)),
+        _mm_or_si128(
+          _mm_and_si128(_mm_slli_epi32(con, 8), _mm_set1_epi32(0x00FF0000)),
+          _mm_and_si128(_mm_srli_epi32(con, 8), _mm_set1_epi32(0x0000FF00))
+        )
+      );
+    _mm_storeu_si128((__m128i*)dest, con);
+  }
+#endif
+};
+
+bool CAEConvert::Float_Vol_FLOAT(float *data, const unsigned int samples, const float volume, const bool softClip, uint8_t *dest)
+{
+  return Float_Vol<CPackFloat>(data, samples, volume, softClip, dest);
+}
+
+bool CAEConvert::Float_Vol_S16LE(float *data, const unsigned int samples, const float volume, const bool softClip, uint8_t *dest)
+{
+  return Float_Vol<CPackS16<false> >(data, samples, volume, softClip, dest);
+}
+
+bool CAEConvert::Float_Vol_S16BE(float *data, const unsigned int samples, const float volume, const bool softClip, uint8_t *dest)
+{
+  return Float_Vol<CPackS16<true> >(data, samples, volume, softClip, dest);
+}
+
+bool CAEConvert::Float_Vol_S24NE4(float *data, const unsigned int samples, const float volume, const bool softClip, uint8_t *dest)
+{
+  return Float_Vol<CPackS24NE4>(data, samples, volume, softClip, dest);
+}
+
+bool CAEConvert::Float_Vol_S24NE3(float *data, const unsigned int samples, const float volume, const bool softClip, uint8_t *dest)
+{
+  return Float_Vol<CPackS24NE3>(data, samples, volume, softClip, dest);
+}
+
+bool CAEConvert::Float_Vol_S32LE(float *data, const unsigned int samples, const float volume, const bool softClip, uint8_t *dest)
+{
+  return Float_Vol<CPackS32<false> >(data, samples, volume, softClip, dest);
+}
+
+bool CAEConvert::Float_Vol_S32BE(float *data, const unsigned int samples, const float volume, const bool softClip, uint8_t *dest)
+{
+  return Float_Vol<CPackS32<true> >(data, samples, volume, softClip, dest);
+}
@@ -52,11 +52,35 @@ private:
   static unsigned int Float_S32LE_Neon (float   *data, const unsigned int samples, uint8_t *dest);
   static unsigned int Float_S32BE_Neon (float   *data, const unsigned int samples, uint8_t *dest);
 
+  static bool Float_Vol_FLOAT (float *data, const unsigned int samples, const float volume, const bool softClip, uint8_t *dest);
+  static bool Float_Vol_S16LE (float *data, const unsigned int samples, const float volume, const bool softClip, uint8_t *dest);
+  static bool Float_Vol_S16BE (float *data, const unsigned int samples, const float volume, const bool softClip, uint8_t *dest);
+  static bool Float_Vol_S24NE4(float *data, const unsigned int samples, const float volume, const bool softClip, uint8_t *dest);
+  static bool Float_Vol_S24NE3(float *data, const unsigned int samples, const float volume, const bool softClip, uint8_t *dest);
+  static bool Float_Vol_S32LE (float *data, const unsigned int samples, const float volume, const bool softClip, uint8_t *dest);
+  static bool Float_Vol_S32BE (float *data, const unsigned int samples, const float volume, const bool softClip, uint8_t *dest);
+
 public:
   typedef unsigned int (*AEConvertToFn)(uint8_t *data, const unsigned int samples, float   *dest);
   typedef unsigned int (*AEConvertFrFn)(float   *data, const unsigned int samples, uint8_t *dest);
 
   static AEConvertToFn ToFloat(enum AEDataFormat dataFormat);
   static AEConvertFrFn FrFloat(enum AEDataFormat dataFormat);
+
+  /*!
+   \brief Fused output stage conversion
+   Scales the float mix by volume, clips it to full scale and packs it into the
+   destination format in a single pass. With softClip set the tanh-like soft
+   clipper is applied to every sample, otherwise samples are hard limited.
+   For AE_FMT_FLOAT dest may be the same buffer as data.
+   \return true if any sample exceeded full scale once the volume was applied
+   */
+  typedef bool (*AEConvertFrVolFn)(float *data, const unsigned int samples, const float volume, const bool softClip, uint8_t *dest);
+
+  /*!
+   \brief Returns the fused kernel for dataFormat, or NULL if there is none and
+          FrFloat must be used instead
+   */
+  static AEConvertFrVolFn FrFloatVol(enum AEDataFormat dataFormat);
 };
 
@@ -0,0 +1,469 @@
+/*
+ *      Copyright (C) 2010-2012 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+
+#include "AELoudness.h"
+#include "system.h"
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+
+#ifdef __SSE__
+#include <xmmintrin.h>
+#endif
+
+#ifdef __ARM_NEON__
+#include <arm_neon.h>
+#endif
+
+/* frames deinterleaved per pass */
+#define CHUNK_FRAMES 256
+
+/* taps per phase of the true peak filter, BS.1770 uses 48 taps for 4x */
+#define TP_TAPS 12
+
+/* gating thresholds, LUFS and LU */
+#define ABSOLUTE_GATE -70.0
+#define RELATIVE_GATE -10.0
+
+static inline double EnergyToLUFS(double energy)
+{
+  return -0.691 + 10.0 * log10(energy);
+}
+
+static inline double LUFSToEnergy(double lufs)
+{
+  return pow(10.0, (lufs + 0.691) / 10.0);
+}
+
+/*
+  run both K-weighting biquads (transposed direct form II) over a group of
+  four planar channels and add the squared output to energy, in is strided
+*/
+static inline void KWeightGroup(float *state, const float *c, const float *in, unsigned int stride, unsigned int frames, float *energy)
+{
+#if defined(__SSE__)
+  const __m128 b10 = _mm_set_ps1(c[0]), b11 = _mm_set_ps1(c[1]), b12 = _mm_set_ps1(c[2]);
+  const __m128 a11 = _mm_set_ps1(c[3]), a12 = _mm_set_ps1(c[4]);
+  const __m128 b20 = _mm_set_ps1(c[5]), b21 = _mm_set_ps1(c[6]), b22 = _mm_set_ps1(c[7]);
+  const __m128 a21 = _mm_set_ps1(c[8]), a22 = _mm_set_ps1(c[9]);
+  __m128 z11 = _mm_load_ps(state     ), z12 = _mm_load_ps(state +  4);
+  __m128 z21 = _mm_load_ps(state +  8), z22 = _mm_load_ps(state + 12);
+  __m128 sum = _mm_load_ps(energy);
+  for (unsigned int i = 0; i < frames; ++i, in += stride)
+  {
+    __m128 x = _mm_load_ps(in);
+    __m128 y = _mm_add_ps(_mm_mul_ps(b10, x), z11);
+    z11 = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(b11, x), _mm_mul_ps(a11, y)), z12);
+    z12 = _mm_sub_ps(_mm_mul_ps(b12, x), _mm_mul_ps(a12, y));
+
+    x   = y;
+    y   = _mm_add_ps(_mm_mul_ps(b20, x), z21);
+    z21 = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(b21, x), _mm_mul_ps(a21, y)), z22);
+    z22 = _mm_sub_ps(_mm_mul_ps(b22, x), _mm_mul_ps(a22, y));
+    sum = _mm_add_ps(sum, _mm_mul_ps(y, y));
+  }
+  _mm_store_ps(state     , z11); _mm_store_ps(state +  4, z12);
+  _mm_store_ps(state +  8, z21); _mm_store_ps(state + 12, z22);
+  _mm_store_ps(energy, sum);
+#elif defined(__ARM_NEON__)
+  float32x4_t z11 = vld1q_f32(state     ), z12 = vld1q_f32(state +  4);
+  float32x4_t z21 = vld1q_f32(state +  8), z22 = vld1q_f32(state + 12);
+  float32x4_t sum = vld1q_f32(energy);
+  for (unsigned int i = 0; i < frames; ++i, in += stride)
+  {
+    float32x4_t x = vld1q_f32(in);
+    float32x4_t y = vmlaq_n_f32(z11, x, c[0]);
+    z11 = vmlsq_n_f32(vmlaq_n_f32(z12, x, c[1]), y, c[3]);
+    z12 = vmlsq_n_f32(vmulq_n_f32(x, c[2]), y, c[4]);
+
+    x   = y;
+    y   = vmlaq_n_f32(z21, x, c[5]);
+    z21 = vmlsq_n_f32(vmlaq_n_f32(z22, x, c[6]), y, c[8]);
+    z22 = vmlsq_n_f32(vmulq_n_f32(x, c[7]), y, c[9]);
+    sum = vmlaq_f32(sum, y, y);
+  }
+  vst1q_f32(state     , z11); vst1q_f32(state +  4, z12);
+  vst1q_f32(state +  8, z21); vst1q_f32(state + 12, z22);
+  vst1q_f32(energy, sum);
+#else
+  for (unsigned int ch = 0; ch < 4; ++ch)
+  {
+    float z11 = state[ch    ], z12 = state[ch +  4];
+    float z21 = state[ch + 8], z22 = state[ch + 12];
+    float sum = energy[ch];
+    const float *src = in + ch;
+    for (unsigned int i = 0; i < frames; ++i, src += stride)
+    {
+      float x = *src;
+      float y = c[0] * x + z11;
+      z11 = c[1] * x - c[3] * y + z12;
+      z12 = c[2] * x - c[4] * y;
+
+      x   = y;
+      y   = c[5] * x + z21;
+      z21 = c[6] * x - c[8] * y + z22;
+      z22 = c[7] * x - c[9] * y;
+      sum += y * y;
+    }
+    state[ch    ] = z11; state[ch +  4] = z12;
+    state[ch + 8] = z21; state[ch + 12] = z22;
+    energy[ch] = sum;
+  }
+#endif
+}
+
+/*
+  oversample a group of four planar channels and track the absolute peak,
+  history holds 2 * TP_TAPS frames of 4 floats, pos is the oldest frame
+*/
+static inline void TruePeakGroup(float *history, unsigned int pos, const float *filter, unsigned int phases, const float *in, unsigned int stride, unsigned int frames, float *peak)
+{
+#if defined(__SSE__)
+  const __m128 sign = _mm_set_ps1(-0.0f);
+  __m128 max = _mm_load_ps(peak);
+  for (unsigned int i = 0; i < frames; ++i, in += stride)
+  {
+    __m128 x = _mm_load_ps(in);
+    _mm_store_ps(history + pos * 4, x);
+    _mm_store_ps(history + (pos + TP_TAPS) * 4, x);
+    pos = (pos + 1) % TP_TAPS;
+
+    max = _mm_max_ps(max, _mm_andnot_ps(sign, x));
+    const float *window = history + pos * 4;
+    for (unsigned int p = 0; p < phases; ++p)
+    {
+      const float *f = filter + p * TP_TAPS;
+      __m128 sum = _mm_setzero_ps();
+      for (unsigned int t = 0; t < TP_TAPS; ++t)
+        sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set_ps1(f[t]), _mm_load_ps(window + t * 4)));
+      max = _mm_max_ps(max, _mm_andnot_ps(sign, sum));
+    }
+  }
+  _mm_store_ps(peak, max);
+#elif defined(__ARM_NEON__)
+  float32x4_t max = vld1q_f32(peak);
+  for (unsigned int i = 0; i < frames; ++i, in += stride)
+  {
+    float32x4_t x = vld1q_f32(in);
+    vst1q_f32(history + pos * 4, x);
+    vst1q_f32(history + (pos + TP_TAPS) * 4, x);
+    pos = (pos + 1) % TP_TAPS;
+
+    max = vmaxq_f32(max, vabsq_f32(x));
+    const float *window = history + pos * 4;
+    for (unsigned int p = 0; p < phases; ++p)
+    {
+      const float *f = filter + p * TP_TAPS;
+      float32x4_t sum = vdupq_n_f32(0.0f);
+      for (unsigned int t = 0; t < TP_TAPS; ++t)
+        sum = vmlaq_n_f32(sum, vld1q_f32(window + t * 4), f[t]);
+      max = vmaxq_f32(max, vabsq_f32(sum));
+    }
+  }
+  vst1q_f32(peak, max);
+#else
+  for (unsigned int i = 0; i < frames; ++i, in += stride)
+  {
+    for (unsigned int ch = 0; ch < 4; ++ch)
+    {
+      history[pos * 4 + ch] = history[(pos + TP_TAPS) * 4 + ch] = in[ch];
+      peak[ch] = std::max(peak[ch], fabsf(in[ch]));
+    }
+    pos = (pos + 1) % TP_TAPS;
+
+    const float *window = history + pos * 4;
+    for (unsigned int p = 0; p < phases; ++p)
+    {
+      const float *f = filter + p * TP_TAPS;
+      for (unsigned int ch = 0; ch < 4; ++ch)
+      {
+        float sum = 0.0f;
+        for (unsigned int t = 0; t < TP_TAPS; ++t)
+          sum += f[t] * window[t * 4 + ch];
+        peak[ch] = std::max(peak[ch], fabsf(sum));
+      }
+    }
+  }
+#endif
+}
+
+CAELoudness::CAELoudness() :
+  m_channels  (0),
+  m_groups    (0),
+  m_sampleRate(0),
+  m_coeffs    (NULL),
+  m_state     (NULL),
+  m_energy    (NULL),
+  m_peak      (NULL),
+  m_planar    (NULL),
+  m_tpFilter  (NULL),
+  m_tpHistory (NULL),
+  m_tpPhases  (0),
+  m_tpPos     (0),
+  m_hopFrames (0),
+  m_hopPos    (0),
+  m_hops      (0)
+{
+}
+
+CAELoudness::~CAELoudness()
+{
+  Deinitialize();
+}
+
+bool CAELoudness::Initialize(const CAEChannelInfo &channelLayout, unsigned int sampleRate)
+{
+  Deinitialize();
+
+  if (!channelLayout.Count() || sampleRate < 8000)
+    return false;
+
+  m_channels   = channelLayout.Count();
+  m_groups     = (m_channels + 3) / 4;
+  m_sampleRate = sampleRate;
+  m_hopFrames  = (sampleRate + 5) / 10;
+
+  /* BS.1770 channel weights, surrounds are +1.5dB and the LFE is ignored */
+  for (unsigned int ch = 0; ch < m_channels; ++ch)
+  {
+    switch (channelLayout[ch])
+    {
+      case AE_CH_LFE:
+        m_weights[ch] = 0.0;
+        break;
+      case AE_CH_BL:
+      case AE_CH_BR:
+      case AE_CH_SL:
+      case AE_CH_SR:
+        m_weights[ch] = 1.41;
+        break;
+      default:
+        m_weights[ch] = 1.0;
+        break;
+    }
+  }
+
+  /* the true peak only needs oversampling while the sample rate is low */
+  if      (sampleRate <  96000) m_tpPhases = 4;
+  else if (sampleRate < 192000) m_tpPhases = 2;
+  else                          m_tpPhases = 1;
+
+  const unsigned int lanes = m_groups * 4;
+  m_coeffs    = (float*)_aligned_malloc(16 * sizeof(float), 16);
+  m_state     = (float*)_aligned_malloc(m_groups * 16 * sizeof(float), 16);
+  m_energy    = (float*)_aligned_malloc(lanes * sizeof(float), 16);
+  m_peak      = (float*)_aligned_malloc(lanes * sizeof(float), 16);
+  m_planar    = (float*)_aligned_malloc(CHUNK_FRAMES * lanes * sizeof(float), 16);
+  m_tpFilter  = (float*)_aligned_malloc(m_tpPhases * TP_TAPS * sizeof(float), 16);
+  m_tpHistory = (float*)_aligned_malloc(m_groups * 2 * TP_TAPS * 4 * sizeof(float), 16);
+
+  /* the padding lanes are never written, keep them silent */
+  memset(m_planar, 0, CHUNK_FRAMES * lanes * sizeof(float));
+
+  BuildFilters();
+  Reset();
+  return true;
+}
+
+void CAELoudness::Deinitialize()
+{
+  _aligned_free(m_coeffs);
+  _aligned_free(m_state);
+  _aligned_free(m_energy);
+  _aligned_free(m_peak);
+  _aligned_free(m_planar);
+  _aligned_free(m_tpFilter);
+  _aligned_free(m_tpHistory);
+  m_coeffs    = NULL;
+  m_state     = NULL;
+  m_energy    = NULL;
+  m_peak      = NULL;
+  m_planar    = NULL;
+  m_tpFilter  = NULL;
+  m_tpHistory = NULL;
+  m_channels  = 0;
+  m_groups    = 0;
+  m_blocks.clear();
+}
+
+void CAELoudness::Reset()
+{
+  if (!m_channels)
+    return;
+
+  const unsigned int lanes = m_groups * 4;
+  memset(m_state    , 0, m_groups * 16 * sizeof(float));
+  memset(m_energy   , 0, lanes * sizeof(float));
+  memset(m_peak     , 0, lanes * sizeof(float));
+  memset(m_tpHistory, 0, m_groups * 2 * TP_TAPS * 4 * sizeof(float));
+  m_tpPos  = 0;
+  m_hopPos = 0;
+  m_hops   = 0;
+  m_blocks.clear();
+}
+
+void CAELoudness::BuildFilters()
+{
+  /* BS.1770 pre-filter (high shelf) and RLB (high pass), recalculated for the sample rate */
+  const double fs = m_sampleRate;
+
+  double f0 = 1681.974450955533;
+  double G  = 3.999843853973347;
+  double Q  = 0.7071752369554196;
+  double K  = tan(M_PI * f0 / fs);
+  double Vh = pow(10.0, G / 20.0);
+  double Vb = pow(Vh, 0.4996667741545416);
+  double a0 = 1.0 + K / Q + K * K;
+  m_coeffs[0] = (float)((Vh + Vb * K / Q + K * K) / a0);
+  m_coeffs[1] = (float)(2.0 * (K * K - Vh) / a0);
+  m_coeffs[2] = (float)((Vh - Vb * K / Q + K * K) / a0);
+  m_coeffs[3] = (float)(2.0 * (K * K - 1.0) / a0);
+  m_coeffs[4] = (float)((1.0 - K / Q + K * K) / a0);
+
+  f0 = 38.13547087602444;
+  Q  = 0.5003270373238773;
+  K  = tan(M_PI * f0 / fs);
+  a0 = 1.0 + K / Q + K * K;
+  m_coeffs[5] =  1.0f;
+  m_coeffs[6] = -2.0f;
+  m_coeffs[7] =  1.0f;
+  m_coeffs[8] = (float)(2.0 * (K * K - 1.0) / a0);
+  m_coeffs[9] = (float)((1.0 - K / Q + K * K) / a0);
+
+  /*
+    blackman windowed sinc for the oversampler, split into phases with the taps
+    reversed so they line up with the history (oldest frame first)
+  */
+  const unsigned int length = m_tpPhases * TP_TAPS;
+  const double center = (length - 1) / 2.0;
+  for (unsigned int p = 0; p < m_tpPhases; ++p)
+  {
+    double sum = 0.0;
+    for (unsigned int t = 0; t < TP_TAPS; ++t)
+    {
+      unsigned int n = p + (TP_TAPS - 1 - t) * m_tpPhases;
+      double x = (n - center) / m_tpPhases;
+      double h = fabs(x) < 1e-9 ? 1.0 : sin(M_PI * x) / (M_PI * x);
+      double w = 0.42 - 0.5 * cos(2.0 * M_PI * (n + 0.5) / length) + 0.08 * cos(4.0 * M_PI * (n + 0.5) / length);
+      m_tpFilter[p * TP_TAPS + t] = (float)(h * w);
+      sum += h * w;
+    }
+
+    /* unity gain per phase */
+    for (unsigned int t = 0; t < TP_TAPS; ++t)
+      m_tpFilter[p * TP_TAPS + t] /= (float)sum;
+  }
+}
+
+void CAELoudness::AddFrames(const float *data, unsigned int frames)
+{
+  if (!m_channels)
+    return;
+
+  const unsigned int lanes = m_groups * 4;
+  while (frames)
+  {
+    /* never cross a hop so its energy can be closed off afterwards */
+    unsigned int count = std::min(std::min(frames, (unsigned int)CHUNK_FRAMES), m_hopFrames - m_hopPos);
+
+    if (lanes == m_channels)
+      memcpy(m_planar, data, count * lanes * sizeof(float));
+    else
+    {
+      float *dst = m_planar;
+      const float *src = data;
+      for (unsigned int i = 0; i < count; ++i, dst += lanes, src += m_channels)
+        memcpy(dst, src, m_channels * sizeof(float));
+    }
+
+    for (unsigned int g = 0; g < m_groups; ++g)
+    {
+      KWeightGroup(m_state + g * 16, m_coeffs, m_planar + g * 4, lanes, count, m_energy + g * 4);
+      TruePeakGroup(m_tpHistory + g * 2 * TP_TAPS * 4, m_tpPos, m_tpFilter, m_tpPhases, m_planar + g * 4, lanes, count, m_peak + g * 4);
+    }
+    m_tpPos = (m_tpPos + count) % TP_TAPS;
+
+    data   += count * m_channels;
+    frames -= count;
+    m_hopPos += count;
+    if (m_hopPos == m_hopFrames)
+      EndHop();
+  }
+}
+
+void CAELoudness::EndHop()
+{
+  double energy = 0.0;
+  for (unsigned int ch = 0; ch < m_channels; ++ch)
+    energy += m_weights[ch] * m_energy[ch];
+  memset(m_energy, 0, m_groups * 4 * sizeof(float));
+
+  /* flush denormals out of the filter state during silence */
+  for (unsigned int i = 0; i < m_groups * 16; ++i)
+    if (fabsf(m_state[i]) < 1e-20f)
+      m_state[i] = 0.0f;
+
+  m_hopEnergy[m_hops & 3] = energy;
+  m_hopPos = 0;
+  if (++m_hops < 4)
+    return;
+
+  double block = m_hopEnergy[0] + m_hopEnergy[1] + m_hopEnergy[2] + m_hopEnergy[3];
+  m_blocks.push_back(block / (4.0 * m_hopFrames));
+}
+
+float CAELoudness::GetTruePeak() const
+{
+  float peak = 0.0f;
+  for (unsigned int ch = 0; ch < m_channels; ++ch)
+    peak = std::max(peak, m_peak[ch]);
+  return peak;
+}
+
+double CAELoudness::GetIntegrated(const std::vector<double> &blocks)
+{
+  const double absoluteGate = LUFSToEnergy(ABSOLUTE_GATE);
+
+  double sum = 0.0;
+  unsigned int count = 0;
+  for (std::vector<double>::const_iterator it = blocks.begin(); it != blocks.end(); ++it)
+    if (*it > absoluteGate)
+    {
+      sum += *it;
+      ++count;
+    }
+
+  if (!count)
+    return -HUGE_VAL;
+
+  const double gate = std::max(absoluteGate, sum / count * pow(10.0, RELATIVE_GATE / 10.0));
+  sum   = 0.0;
+  count = 0;
+  for (std::vector<double>::const_iterator it = blocks.begin(); it != blocks.end(); ++it)
+    if (*it > gate)
+    {
+      sum += *it;
+      ++count;
+    }
+
+  return EnergyToLUFS(sum / count);
+}
@@ -0,0 +1,84 @@
+#pragma once
+/*
+ *      Copyright (C) 2010-2012 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+
+#include <vector>
+#include "AEChannelInfo.h"
+
+/*!
+ \brief EBU R128 / ITU-R BS.1770 loudness meter for interleaved float audio.
+
+ The K-weighting filters run on four channels at a time with SSE or NEON.
+ Loudness is measured over 400ms blocks with a 100ms hop and gated at -70 LUFS
+ absolute and -10 LU relative. The true peak is taken from a 4x oversampled
+ signal. The block energies are kept so several tracks can be combined into
+ an album loudness.
+ */
+class CAELoudness
+{
+public:
+  CAELoudness();
+  ~CAELoudness();
+
+  bool Initialize(const CAEChannelInfo &channelLayout, unsigned int sampleRate);
+  void Deinitialize();
+  void Reset();
+
+  /* feed interleaved frames in the layout given to Initialize */
+  void AddFrames(const float *data, unsigned int frames);
+
+  /* integrated loudness in LUFS, -HUGE_VAL if everything was gated out */
+  double GetIntegrated() const { return GetIntegrated(m_blocks); }
+  /* true peak as a linear sample value */
+  float  GetTruePeak() const;
+  /* mean square energy of each 400ms block measured so far */
+  const std::vector<double>& GetBlocks() const { return m_blocks; }
+
+  static double GetIntegrated(const std::vector<double> &blocks);
+
+private:
+  void BuildFilters();
+  void EndHop();
+
+  unsigned int m_channels;
+  unsigned int m_groups;       /* channels rounded up to groups of 4 */
+  unsigned int m_sampleRate;
+
+  float       *m_coeffs;       /* b0, b1, b2, a1, a2 of both K-weighting stages */
+  float       *m_state;        /* 16 floats of filter state per group */
+  float       *m_energy;       /* sum of squares of the current hop per channel */
+  float       *m_peak;         /* absolute peak per channel */
+  float       *m_planar;       /* deinterleaved input, padded to whole groups */
+  double       m_weights[AE_CH_MAX];
+
+  /* true peak oversampling filter, m_tpPhases rows of TP_TAPS coefficients */
+  float       *m_tpFilter;
+  float       *m_tpHistory;    /* doubled history per group so the taps never wrap */
+  unsigned int m_tpPhases;
+  unsigned int m_tpPos;
+
+  unsigned int m_hopFrames;
+  unsigned int m_hopPos;
+  unsigned int m_hops;
+  double       m_hopEnergy[4];
+  std::vector<double> m_blocks;
+};
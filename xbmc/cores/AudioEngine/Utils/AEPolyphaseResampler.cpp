@@ -0,0 +1,337 @@
+/*
+ *      Copyright (C) 2010-2012 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+
+#include "AEPolyphaseResampler.h"
+#include "system.h"
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+
+#ifdef __SSE__
+#include <xmmintrin.h>
+#endif
+
+#ifdef __ARM_NEON__
+#include <arm_neon.h>
+#endif
+
+/* taps per phase at unity ratio, phases, kaiser beta and passband, per quality */
+static const struct
+{
+  unsigned int taps;
+  unsigned int phases;
+  double       beta;
+  double       cutoff;
+} g_polyphaseQuality[] =
+{
+  {  8,  64, 5.0, 0.80 },
+  { 16, 128, 7.0, 0.90 },
+  { 32, 256, 8.5, 0.94 },
+  { 64, 256, 10.0, 0.96 }
+};
+
+/* rebuild the filter when the cutoff moves by more than this while downsampling */
+#define CUTOFF_TOLERANCE 0.01
+
+static double BesselI0(double x)
+{
+  /* power series, converges quickly for the betas we use */
+  double sum  = 1.0;
+  double term = 1.0;
+  for (int k = 1; k < 50; ++k)
+  {
+    term *= (x / (2.0 * k)) * (x / (2.0 * k));
+    sum  += term;
+    if (term < sum * 1e-12)
+      break;
+  }
+  return sum;
+}
+
+static inline void InterpolateCoeffs(float *out, const float *a, const float *b, float t, unsigned int taps)
+{
+#if defined(__SSE__)
+  const __m128 mt = _mm_set_ps1(t);
+  for (unsigned int i = 0; i < taps; i += 4)
+  {
+    __m128 va = _mm_load_ps(a + i);
+    __m128 vb = _mm_load_ps(b + i);
+    _mm_store_ps(out + i, _mm_add_ps(va, _mm_mul_ps(_mm_sub_ps(vb, va), mt)));
+  }
+#elif defined(__ARM_NEON__)
+  for (unsigned int i = 0; i < taps; i += 4)
+  {
+    float32x4_t va = vld1q_f32(a + i);
+    float32x4_t vb = vld1q_f32(b + i);
+    vst1q_f32(out + i, vmlaq_n_f32(va, vsubq_f32(vb, va), t));
+  }
+#else
+  for (unsigned int i = 0; i < taps; ++i)
+    out[i] = a[i] + (b[i] - a[i]) * t;
+#endif
+}
+
+/* coeffs must be 16 byte aligned, taps a multiple of 4 */
+static inline float DotProduct(const float *coeffs, const float *data, unsigned int taps)
+{
+#if defined(__SSE__)
+  __m128 sum = _mm_setzero_ps();
+  for (unsigned int i = 0; i < taps; i += 4)
+    sum = _mm_add_ps(sum, _mm_mul_ps(_mm_load_ps(coeffs + i), _mm_loadu_ps(data + i)));
+  sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+  sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+  float ret;
+  _mm_store_ss(&ret, sum);
+  return ret;
+#elif defined(__ARM_NEON__)
+  float32x4_t sum = vdupq_n_f32(0.0f);
+  for (unsigned int i = 0; i < taps; i += 4)
+    sum = vmlaq_f32(sum, vld1q_f32(coeffs + i), vld1q_f32(data + i));
+  float32x2_t half = vadd_f32(vget_low_f32(sum), vget_high_f32(sum));
+  return vget_lane_f32(vpadd_f32(half, half), 0);
+#else
+  float sum = 0.0f;
+  for (unsigned int i = 0; i < taps; ++i)
+    sum += coeffs[i] * data[i];
+  return sum;
+#endif
+}
+
+CAEPolyphaseResampler::CAEPolyphaseResampler() :
+  m_channels     (0),
+  m_ratio        (1.0),
+  m_quality      (0),
+  m_filter       (NULL),
+  m_filterSize   (0),
+  m_coeffs       (NULL),
+  m_taps         (0),
+  m_phases       (0),
+  m_cutoff       (0.0),
+  m_history      (NULL),
+  m_historySize  (0),
+  m_historyFrames(0),
+  m_position     (0.0)
+{
+}
+
+CAEPolyphaseResampler::~CAEPolyphaseResampler()
+{
+  Deinitialize();
+}
+
+bool CAEPolyphaseResampler::Initialize(unsigned int channels, double ratio, int quality)
+{
+  Deinitialize();
+
+  const int qualities = sizeof(g_polyphaseQuality) / sizeof(g_polyphaseQuality[0]);
+  m_channels = channels;
+  m_ratio    = ratio;
+  m_quality  = std::min(std::max(quality, 0), qualities - 1);
+
+  BuildFilter();
+  Reset();
+  return true;
+}
+
+void CAEPolyphaseResampler::Deinitialize()
+{
+  _aligned_free(m_filter);
+  _aligned_free(m_coeffs);
+  _aligned_free(m_history);
+  m_filter        = NULL;
+  m_filterSize    = 0;
+  m_coeffs        = NULL;
+  m_history       = NULL;
+  m_taps          = 0;
+  m_historySize   = 0;
+  m_historyFrames = 0;
+  m_position      = 0.0;
+}
+
+void CAEPolyphaseResampler::Reset()
+{
+  /*
+    prime the history with silence so the first output frame lines up with the
+    first input frame, the filter is centered between taps/2 - 1 and taps/2
+  */
+  m_historyFrames = 0;
+  ResizeHistory(m_taps);
+  for (unsigned int ch = 0; ch < m_channels; ++ch)
+    memset(m_history + ch * m_historySize, 0, (m_taps / 2 - 1) * sizeof(float));
+  m_historyFrames = m_taps / 2 - 1;
+  m_position      = 0.0;
+}
+
+void CAEPolyphaseResampler::SetRatio(double ratio)
+{
+  m_ratio = ratio;
+
+  /* upsampling never changes the filter, downsampling moves the cutoff */
+  double cutoff = g_polyphaseQuality[m_quality].cutoff * std::min(1.0, m_ratio);
+  if (fabs(cutoff - m_cutoff) > m_cutoff * CUTOFF_TOLERANCE)
+  {
+    unsigned int oldCenter = m_taps / 2 - 1;
+    BuildFilter();
+    unsigned int newCenter = m_taps / 2 - 1;
+
+    /* keep the next output frame at the same point in time */
+    m_position += (double)oldCenter - (double)newCenter;
+    if (m_position < 0.0)
+    {
+      unsigned int pad = (unsigned int)ceil(-m_position);
+      ResizeHistory(m_historyFrames + pad);
+      for (unsigned int ch = 0; ch < m_channels; ++ch)
+      {
+        float *row = m_history + ch * m_historySize;
+        memmove(row + pad, row, m_historyFrames * sizeof(float));
+        memset (row, 0, pad * sizeof(float));
+      }
+      m_historyFrames += pad;
+      m_position      += pad;
+    }
+  }
+}
+
+void CAEPolyphaseResampler::BuildFilter()
+{
+  const double scale = std::min(1.0, m_ratio);
+  const double beta  = g_polyphaseQuality[m_quality].beta;
+  m_cutoff = g_polyphaseQuality[m_quality].cutoff * scale;
+  m_phases = g_polyphaseQuality[m_quality].phases;
+
+  /* widen the filter when downsampling so it keeps the same number of zero crossings */
+  m_taps = (unsigned int)ceil(g_polyphaseQuality[m_quality].taps / scale);
+  m_taps = (m_taps + 3) & ~3;
+
+  /*
+    the rows are packed at the current width, so the buffers are only replaced when
+    the filter outgrows them, with room to spare as the ratio tends to keep drifting
+  */
+  unsigned int size = (m_phases + 1) * m_taps;
+  if (size > m_filterSize)
+  {
+    unsigned int taps = (m_taps + m_taps / 4 + 3) & ~3;
+    _aligned_free(m_filter);
+    _aligned_free(m_coeffs);
+    m_filterSize = (m_phases + 1) * taps;
+    m_filter     = (float*)_aligned_malloc(m_filterSize * sizeof(float), 16);
+    m_coeffs     = (float*)_aligned_malloc(taps * sizeof(float), 16);
+  }
+
+  const double center = m_taps / 2 - 1;
+  const double half   = m_taps / 2;
+  const double i0beta = BesselI0(beta);
+  for (unsigned int p = 0; p <= m_phases; ++p)
+  {
+    float *row  = m_filter + p * m_taps;
+    double frac = (double)p / m_phases;
+    double sum  = 0.0;
+    for (unsigned int k = 0; k < m_taps; ++k)
+    {
+      double d = k - center - frac;
+      double x = M_PI * m_cutoff * d;
+      double h = fabs(x) < 1e-9 ? m_cutoff : m_cutoff * sin(x) / x;
+      double w = d / half;
+      w = w * w < 1.0 ? BesselI0(beta * sqrt(1.0 - w * w)) / i0beta : 0.0;
+      row[k] = (float)(h * w);
+      sum   += row[k];
+    }
+
+    /* normalize each phase to unity gain at DC */
+    for (unsigned int k = 0; k < m_taps; ++k)
+      row[k] = (float)(row[k] / sum);
+  }
+}
+
+void CAEPolyphaseResampler::ResizeHistory(unsigned int frames)
+{
+  if (frames <= m_historySize)
+    return;
+
+  unsigned int size = std::max(frames, m_historySize * 2);
+  float *history = (float*)_aligned_malloc(size * m_channels * sizeof(float), 16);
+  for (unsigned int ch = 0; ch < m_channels && m_history; ++ch)
+    memcpy(history + ch * size, m_history + ch * m_historySize, m_historyFrames * sizeof(float));
+
+  _aligned_free(m_history);
+  m_history     = history;
+  m_historySize = size;
+}
+
+unsigned int CAEPolyphaseResampler::Process(float *in, unsigned int inFrames, unsigned int &inUsed, float *out, unsigned int outFrames)
+{
+  const double step = 1.0 / m_ratio;
+
+  /* only take the input needed to fill out, the caller keeps the rest */
+  inUsed = 0;
+  if (outFrames > 0)
+  {
+    double last = m_position + (outFrames - 1) * step;
+    double needed = floor(last) + m_taps - m_historyFrames;
+    if (needed > 0.0)
+      inUsed = (unsigned int)std::min((double)inFrames, needed);
+  }
+
+  /* de-interleave the input onto the history so the kernel reads contiguous samples */
+  ResizeHistory(m_historyFrames + inUsed);
+  for (unsigned int ch = 0; ch < m_channels; ++ch)
+  {
+    float *dst = m_history + ch * m_historySize + m_historyFrames;
+    float *src = in + ch;
+    for (unsigned int i = 0; i < inUsed; ++i, src += m_channels)
+      dst[i] = *src;
+  }
+  m_historyFrames += inUsed;
+
+  unsigned int written = 0;
+  while (written < outFrames)
+  {
+    unsigned int index = (unsigned int)m_position;
+    if (index + m_taps > m_historyFrames)
+      break;
+
+    double       phase = (m_position - index) * m_phases;
+    unsigned int row   = (unsigned int)phase;
+    InterpolateCoeffs(m_coeffs, m_filter + row * m_taps, m_filter + (row + 1) * m_taps, (float)(phase - row), m_taps);
+
+    for (unsigned int ch = 0; ch < m_channels; ++ch)
+      *out++ = DotProduct(m_coeffs, m_history + ch * m_historySize + index, m_taps);
+
+    ++written;
+    m_position += step;
+  }
+
+  /* drop the history we will never need again */
+  unsigned int drop = std::min((unsigned int)m_position, m_historyFrames);
+  if (drop)
+  {
+    for (unsigned int ch = 0; ch < m_channels; ++ch)
+    {
+      float *row = m_history + ch * m_historySize;
+      memmove(row, row + drop, (m_historyFrames - drop) * sizeof(float));
+    }
+    m_historyFrames -= drop;
+    m_position      -= drop;
+  }
+
+  return written;
+}
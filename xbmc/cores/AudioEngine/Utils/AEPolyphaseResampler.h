@@ -0,0 +1,76 @@
+#pragma once
+/*
+ *      Copyright (C) 2010-2012 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+/*!
+ \brief Polyphase FIR sample rate converter for interleaved float audio.
+
+ The filter is a Kaiser windowed sinc, with the phases linearly interpolated
+ so the ratio can be changed at any time (for sync to display), and uses SSE
+ or NEON for the filter kernel.
+ */
+class CAEPolyphaseResampler
+{
+public:
+  CAEPolyphaseResampler();
+  ~CAEPolyphaseResampler();
+
+  /* quality is one of CAEResampler::Quality */
+  bool   Initialize(unsigned int channels, double ratio, int quality);
+  void   Deinitialize();
+  void   Reset();
+
+  /* ratio is output rate / input rate */
+  void   SetRatio(double ratio);
+
+  /*!
+   \brief Resample interleaved float frames.
+   \param in the input frames.
+   \param inFrames the number of input frames.
+   \param inUsed set to the number of input frames consumed, no more than are needed to fill out.
+   \param out the buffer for the output frames.
+   \param outFrames the room in out, in frames.
+   \return the number of frames written to out.
+   */
+  unsigned int Process(float *in, unsigned int inFrames, unsigned int &inUsed, float *out, unsigned int outFrames);
+
+private:
+  void BuildFilter();
+  void ResizeHistory(unsigned int frames);
+
+  unsigned int m_channels;
+  double       m_ratio;
+  int          m_quality;
+
+  /* (m_phases + 1) rows of m_taps coefficients, with room for m_filterSize floats */
+  float       *m_filter;
+  unsigned int m_filterSize;
+  float       *m_coeffs;       /* interpolated coefficients for the current output frame */
+  unsigned int m_taps;
+  unsigned int m_phases;
+  double       m_cutoff;
+
+  /* planar input history, one row of m_historySize frames per channel */
+  float       *m_history;
+  unsigned int m_historySize;
+  unsigned int m_historyFrames;
+  double       m_position;     /* position of the next output frame in the history */
+};
@@ -0,0 +1,107 @@
+/*
+ *      Copyright (C) 2010-2012 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+
+#include "AEResampler.h"
+#include <algorithm>
+
+#ifdef _WIN32
+#pragma comment(lib, "libsamplerate-0.lib")
+#endif
+
+CAEResampler::CAEResampler() :
+  m_channels (0),
+  m_ratio    (1.0),
+  m_quality  (QUALITY_MEDIUM),
+  m_polyphase(false),
+  m_src      (NULL)
+{
+}
+
+CAEResampler::~CAEResampler()
+{
+  Deinitialize();
+}
+
+bool CAEResampler::Initialize(unsigned int channels, double ratio, Quality quality, bool polyphase)
+{
+  Deinitialize();
+
+  m_channels  = channels;
+  m_ratio     = ratio;
+  m_quality   = (Quality)std::min(std::max((int)quality, (int)QUALITY_LOW), (int)QUALITY_BEST);
+  m_polyphase = polyphase;
+
+  if (m_polyphase)
+    return m_polyphaseResampler.Initialize(m_channels, m_ratio, m_quality);
+
+  static const int srcQuality[] = {SRC_LINEAR, SRC_SINC_FASTEST, SRC_SINC_MEDIUM_QUALITY, SRC_SINC_BEST_QUALITY};
+  int err;
+  m_src = src_new(srcQuality[m_quality], m_channels, &err);
+  return m_src != NULL;
+}
+
+void CAEResampler::Deinitialize()
+{
+  if (m_src)
+    src_delete(m_src);
+  m_src = NULL;
+
+  m_polyphaseResampler.Deinitialize();
+}
+
+void CAEResampler::Reset()
+{
+  if (m_polyphase)
+    m_polyphaseResampler.Reset();
+  else if (m_src)
+    src_reset(m_src);
+}
+
+void CAEResampler::SetRatio(double ratio)
+{
+  m_ratio = ratio;
+  if (m_polyphase)
+    m_polyphaseResampler.SetRatio(m_ratio);
+  else if (m_src)
+    src_set_ratio(m_src, m_ratio);
+}
+
+unsigned int CAEResampler::Process(float *in, unsigned int inFrames, unsigned int &inUsed, float *out, unsigned int outFrames)
+{
+  if (m_polyphase)
+    return m_polyphaseResampler.Process(in, inFrames, inUsed, out, outFrames);
+
+  SRC_DATA data;
+  data.data_in       = in;
+  data.data_out      = out;
+  data.input_frames  = inFrames;
+  data.output_frames = outFrames;
+  data.end_of_input  = 0;
+  data.src_ratio     = m_ratio;
+  if (!m_src || src_process(m_src, &data) != 0)
+  {
+    inUsed = 0;
+    return 0;
+  }
+  inUsed = data.input_frames_used;
+  return data.output_frames_gen;
+}
@@ -0,0 +1,76 @@
+#pragma once
+/*
+ *      Copyright (C) 2010-2012 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+
+#include <samplerate.h>
+#include "AEPolyphaseResampler.h"
+
+/*!
+ \brief Sample rate converter for interleaved float audio.
+
+ Wraps either libsamplerate or the built-in polyphase FIR resampler.
+ \sa CAEPolyphaseResampler
+ */
+class CAEResampler
+{
+public:
+  /* these match the RESAMPLE_* values of the GUI settings */
+  enum Quality
+  {
+    QUALITY_LOW = 0,
+    QUALITY_MEDIUM,
+    QUALITY_HIGH,
+    QUALITY_BEST
+  };
+
+  CAEResampler();
+  ~CAEResampler();
+
+  bool   Initialize(unsigned int channels, double ratio, Quality quality, bool polyphase);
+  void   Deinitialize();
+  void   Reset();
+
+  /* ratio is output rate / input rate */
+  void   SetRatio(double ratio);
+  double GetRatio() const { return m_ratio; }
+  bool   IsPolyphase() const { return m_polyphase; }
+
+  /*!
+   \brief Resample interleaved float frames.
+   \param in the input frames.
+   \param inFrames the number of input frames.
+   \param inUsed set to the number of input frames consumed.
+   \param out the buffer for the output frames.
+   \param outFrames the room in out, in frames.
+   \return the number of frames written to out.
+   */
+  unsigned int Process(float *in, unsigned int inFrames, unsigned int &inUsed, float *out, unsigned int outFrames);
+
+private:
+  unsigned int m_channels;
+  double       m_ratio;
+  Quality      m_quality;
+  bool         m_polyphase;
+
+  SRC_STATE            *m_src;
+  CAEPolyphaseResampler m_polyphaseResampler;
+};
@@ -28,13 +28,20 @@
 //#define AE_RING_BUFFER_DEBUG
 
 #include "utils/log.h"  //CLog
+#include "threads/Atomics.h" //AtomicAdd
 #include <string.h>     //memset, memcpy
+#include <algorithm>    //std::min
 
 /**
  * This buffer can be used by one read and one write thread at any one time
  * without the risk of data corruption.
  * If you intend to call the Reset() method, please use Locks.
  * All other operations are thread-safe.
+ *
+ * The read and write counts are published with a full memory barrier, so
+ * the reader never sees a count before the data it covers. Besides the
+ * copying Read/Write the buffer can be accessed in place, see GetWritePtr
+ * and GetReadPtr.
  */
 class AERingBuffer {
 
@@ -75,6 +82,9 @@ public:
    */
   bool Create(int size)
   {
+    _aligned_free(m_Buffer);
+    Reset();
+    m_iSize = 0;
     m_Buffer =  (unsigned char*)_aligned_malloc(size,16);
     if ( m_Buffer )
     {
@@ -141,7 +151,7 @@ public:
     }
 
     //we can increase the write count now
-    m_iWritten+=size;
+    AtomicAdd(&m_iWritten, size);
     return AE_RING_BUFFER_OK;
   }
 
@@ -196,11 +206,61 @@ public:
       m_iReadPos = second;
     }
     //we can increase the read count now
-    m_iRead+=size;
+    AtomicAdd(&m_iRead, size);
 
     return AE_RING_BUFFER_OK;
   }
 
+  /**
+   * Returns the contiguous region that can be written in place, this may be
+   * less than GetWriteSize() when the free space wraps the end of the buffer.
+   * Only the write thread may call this, the data becomes visible to the
+   * reader once it is committed with CommitWrite().
+   *
+   * @param size set to the number of bytes that can be written
+   */
+  unsigned char *GetWritePtr(unsigned int &size)
+  {
+    size = std::min(GetWriteSize(), m_iSize - m_iWritePos);
+    return &m_Buffer[m_iWritePos];
+  }
+
+  /**
+   * Publishes size bytes written through GetWritePtr() to the reader.
+   */
+  void CommitWrite(unsigned int size)
+  {
+    m_iWritePos += size;
+    if (m_iWritePos == m_iSize)
+      m_iWritePos = 0;
+    AtomicAdd(&m_iWritten, size);
+  }
+
+  /**
+   * Returns the contiguous region that can be read in place, this may be
+   * less than GetReadSize() when the data wraps the end of the buffer.
+   * Only the read thread may call this, the region stays valid until it is
+   * released with CommitRead().
+   *
+   * @param size set to the number of bytes that can be read
+   */
+  unsigned char *GetReadPtr(unsigned int &size)
+  {
+    size = std::min(GetReadSize(), m_iSize - m_iReadPos);
+    return &m_Buffer[m_iReadPos];
+  }
+
+  /**
+   * Releases size bytes read through GetReadPtr() back to the writer.
+   */
+  void CommitRead(unsigned int size)
+  {
+    m_iReadPos += size;
+    if (m_iReadPos == m_iSize)
+      m_iReadPos = 0;
+    AtomicAdd(&m_iRead, size);
+  }
+
   /**
    * Dumps the buffer.
    */
@@ -224,7 +284,7 @@ public:
    */
   unsigned int GetWriteSize()
   {
-    return m_iSize - ( m_iWritten - m_iRead );
+    return m_iSize - GetReadSize();
   }
 
   /**
@@ -233,7 +293,7 @@ public:
    */
   unsigned int GetReadSize()
   {
-    return m_iWritten - m_iRead;
+    return (unsigned long)AtomicAdd(&m_iWritten, 0) - (unsigned long)AtomicAdd(&m_iRead, 0);
   }
 
   /**
@@ -247,8 +307,8 @@ public:
 private:
   unsigned int m_iReadPos;
   unsigned int m_iWritePos;
-  unsigned int m_iRead;
-  unsigned int m_iWritten;
+  volatile long m_iRead;
+  volatile long m_iWritten;
   unsigned int m_iSize;
   unsigned char *m_Buffer;
 };
@@ -0,0 +1,167 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+
+#include "AESinkClock.h"
+#include "system.h"
+#include <math.h>
+#include <algorithm>
+
+/* the loop runs this much wider until locked so it pulls in quickly */
+#define CLOCK_ACQUIRE_FACTOR 8.0
+/* locked once the wide loop ran for this long and this many reports */
+#define CLOCK_LOCK_TIME      1.0
+#define CLOCK_LOCK_REPORTS   4
+/*
+  once locked a report further off than this many times the rms report error is
+  a discontinuity (underrun, pause) rather than jitter, within these bounds
+*/
+#define CLOCK_ERROR_JITTERS  8.0
+#define CLOCK_MIN_ERROR      0.005
+#define CLOCK_MAX_ERROR      0.1
+/* weight of a report in the running rms report error */
+#define CLOCK_JITTER_WEIGHT  0.05
+/* reports in a row that have to be off before the clock is reseeded, a single one is a late poll */
+#define CLOCK_RESEED_REPORTS 2
+/* keeps the loop stable when the reports are far apart */
+#define CLOCK_MAX_OMEGA      0.5
+
+CAESinkClock::CAESinkClock(double bandwidth) :
+  m_bandwidth(bandwidth)
+{
+  Reset();
+}
+
+void CAESinkClock::Reset()
+{
+  m_seeded       = false;
+  m_seedTime     = 0.0;
+  m_lockTime     = 0.0;
+  m_lockPosition = 0.0;
+  m_time         = 0.0;
+  m_position     = 0.0;
+  m_rate         = 1.0;
+  m_reports      = 0;
+  m_errorSquares = 0.0;
+  m_outliers     = 0;
+
+  m_sumSquares   = 0.0;
+  m_maxError     = 0.0;
+  m_statReports  = 0;
+  m_relocks      = 0;
+}
+
+void CAESinkClock::Seed(double now, double position)
+{
+  m_seeded       = true;
+  m_seedTime     = now;
+  m_time         = now;
+  m_position     = position;
+  m_rate         = 1.0;
+  m_reports      = 0;
+  m_errorSquares = 0.0;
+  m_outliers     = 0;
+}
+
+bool CAESinkClock::IsLocked() const
+{
+  return m_seeded && m_reports >= CLOCK_LOCK_REPORTS && m_time - m_seedTime >= CLOCK_LOCK_TIME;
+}
+
+void CAESinkClock::Update(double now, double position)
+{
+  if (!m_seeded)
+  {
+    Seed(now, position);
+    return;
+  }
+
+  double dt = now - m_time;
+  if (dt <= 0.0)
+    return;
+
+  double predicted = m_position + m_rate * dt;
+  double error     = position - predicted;
+  bool   locked    = IsLocked();
+  if (fabs(error) > GetMaxError())
+  {
+    /* skip a late report, the next one tells whether the sink really jumped */
+    if (locked && ++m_outliers < CLOCK_RESEED_REPORTS)
+      return;
+
+    if (locked)
+      m_relocks++;
+    Seed(now, position);
+    return;
+  }
+  m_outliers      = 0;
+  m_errorSquares += (error * error - m_errorSquares) * CLOCK_JITTER_WEIGHT;
+
+  if (locked)
+  {
+    m_sumSquares += error * error;
+    m_maxError    = std::max(m_maxError, fabs(error));
+    m_statReports++;
+  }
+
+  /*
+    second order loop: the position takes a share of the error and the rate
+    integrates it, b = sqrt(2) * w and c = w^2 give critical damping
+  */
+  double bandwidth = locked ? m_bandwidth : m_bandwidth * CLOCK_ACQUIRE_FACTOR;
+  double omega     = std::min(2.0 * M_PI * bandwidth * dt, CLOCK_MAX_OMEGA);
+  m_position = predicted + sqrt(2.0) * omega * error;
+  m_rate    += omega * omega * error / dt;
+  m_time     = now;
+  m_reports++;
+
+  /* the drift is measured from the filtered position at the lock, the seed report is too rough */
+  if (!locked && IsLocked())
+  {
+    m_lockTime     = m_time;
+    m_lockPosition = m_position;
+  }
+}
+
+double CAESinkClock::GetMaxError() const
+{
+  /* the loop is still pulling in until it locks, only catch gross jumps */
+  if (!IsLocked())
+    return CLOCK_MAX_ERROR;
+
+  double maxError = CLOCK_ERROR_JITTERS * sqrt(m_errorSquares);
+  return std::min(std::max(maxError, CLOCK_MIN_ERROR), CLOCK_MAX_ERROR);
+}
+
+double CAESinkClock::GetPosition(double now) const
+{
+  return m_position + m_rate * (now - m_time);
+}
+
+void CAESinkClock::GetStats(AESinkClockStats &stats) const
+{
+  /* the loop rate is too noisy to show, average it since the lock */
+  stats.drift    = IsLocked() && m_time > m_lockTime ? ((m_position - m_lockPosition) / (m_time - m_lockTime) - 1.0) * 1e6 : 0.0;
+  stats.jitter   = m_statReports ? sqrt(m_sumSquares / m_statReports) : 0.0;
+  stats.maxError = m_maxError;
+  stats.reports  = m_statReports;
+  stats.relocks  = m_relocks;
+}
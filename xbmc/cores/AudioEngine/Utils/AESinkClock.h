@@ -0,0 +1,97 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+
+#include <stdint.h>
+
+/* diagnostics of a CAESinkClock */
+struct AESinkClockStats
+{
+  double       drift;      /* how much faster the sink runs than the host clock, in ppm */
+  double       jitter;     /* rms of the position reports around the filtered clock, in seconds */
+  double       maxError;   /* largest report error while locked, in seconds */
+  unsigned int reports;    /* position reports fed while locked */
+  unsigned int relocks;    /* times the clock had to be reseeded after a discontinuity */
+};
+
+/*!
+ \brief Filters the play position reported by a sink into a smooth clock.
+
+ Sinks report their delay with the granularity of the device period and with
+ the scheduling jitter of the engine thread that polls them. Each report is
+ turned into a play position (the frames written minus the delay) at a host
+ time and fed to a second order delay locked loop, which tracks the position
+ and the rate of the sink clock against the host clock. Between reports the
+ position is extrapolated at the tracked rate, so the delay derived from it
+ moves smoothly and the drift of the sink is available as well.
+
+ Once locked, reports that are off by more than a multiple of the measured
+ report jitter on consecutive polls are taken as a discontinuity and the
+ loop is reseeded from the new position.
+ */
+class CAESinkClock
+{
+public:
+  /* bandwidth is the loop bandwidth in Hz once locked */
+  CAESinkClock(double bandwidth = 0.1);
+
+  /* forget the clock and the statistics, e.g. when the sink is reopened */
+  void Reset();
+
+  /*! \brief Feed a position report of the sink
+   \param now the host time of the report in seconds
+   \param position the seconds of audio the sink has played at that time
+   */
+  void Update(double now, double position);
+
+  /* the position reports are tracked closely enough to be used */
+  bool   IsLocked() const;
+
+  /* the filtered play position in seconds at the host time now */
+  double GetPosition(double now) const;
+
+  void   GetStats(AESinkClockStats &stats) const;
+
+private:
+  void   Seed(double now, double position);
+  /* how far off a report may be before it counts as a discontinuity */
+  double GetMaxError() const;
+
+  double       m_bandwidth;
+
+  bool         m_seeded;
+  double       m_seedTime;     /* host time the loop was (re)started, it runs wider until locked */
+  double       m_lockTime;     /* host time and filtered position when the clock locked */
+  double       m_lockPosition;
+  double       m_time;         /* host time of the last report */
+  double       m_position;     /* filtered position at m_time */
+  double       m_rate;         /* sink seconds per host second */
+  unsigned int m_reports;
+  double       m_errorSquares; /* running mean square of the report errors */
+  unsigned int m_outliers;     /* reports in a row beyond GetMaxError() */
+
+  /* statistics */
+  double       m_sumSquares;
+  double       m_maxError;
+  unsigned int m_statReports;
+  unsigned int m_relocks;
+};
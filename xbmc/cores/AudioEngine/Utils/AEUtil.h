@@ -83,6 +83,26 @@ public:
     return pow(10.0f, dB/20);
   }
 
+  /*! \brief the number of input frames a stream can take without overrunning its output ring
+   The ring counts output frames and each resampled input frame turns into
+   ratio output frames, room for two blocks of output is kept back for the
+   block being completed in the input buffer and the resampler's rounding.
+   \param ringFree the free frames in the output ring
+   \param room the output frames wanted to reach the water level
+   \param blockFrames the input frames processed at a time
+   \param ratio the resample ratio (output rate / input rate)
+   \return the number of input frames that may be accepted on top of the block
+   */
+  static inline unsigned int ResampleInputSpace(const unsigned int ringFree, unsigned int room, const unsigned int blockFrames, const double ratio)
+  {
+    const unsigned int reserve = 2 * (unsigned int)ceil(blockFrames * ratio);
+    if (ringFree <= reserve)
+      return 0;
+    if (room > ringFree - reserve)
+      room = ringFree - reserve;
+    return (unsigned int)(room / ratio);
+  }
+
   #ifdef __SSE__
   static void SSEMulArray     (float *data, const float mul, uint32_t count);
   static void SSEMulAddArray  (float *data, float *add, const float mul, uint32_t count);
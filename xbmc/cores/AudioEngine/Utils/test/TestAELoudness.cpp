@@ -0,0 +1,154 @@
+/*
+ *      Copyright (C) 2010-2012 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+
+#include "cores/AudioEngine/Utils/AELoudness.h"
+
+#include <boost/test/unit_test.hpp>
+#include <math.h>
+#include <vector>
+
+#define TEST_BLOCK 1024
+
+/* append seconds of a sine at the given level in dBFS to every channel, except the LFE */
+static void AddTone(std::vector<float> &out, const CAEChannelInfo &layout, unsigned int rate, double freq, double dBFS, double seconds, double phase = 0.0)
+{
+  const unsigned int channels = layout.Count();
+  const unsigned int frames   = (unsigned int)(seconds * rate);
+  const double amplitude = pow(10.0, dBFS / 20.0);
+  for (unsigned int i = 0; i < frames; ++i)
+  {
+    float sample = (float)(amplitude * sin(2.0 * M_PI * freq * i / rate + phase));
+    for (unsigned int ch = 0; ch < channels; ++ch)
+      out.push_back(layout[ch] == AE_CH_LFE ? 0.0f : sample);
+  }
+}
+
+static double Measure(CAELoudness &meter, const std::vector<float> &in, unsigned int channels)
+{
+  const unsigned int frames = in.size() / channels;
+  for (unsigned int pos = 0; pos < frames; pos += TEST_BLOCK)
+    meter.AddFrames(&in[pos * channels], std::min((unsigned int)TEST_BLOCK, frames - pos));
+  return meter.GetIntegrated();
+}
+
+BOOST_AUTO_TEST_CASE(TestAELoudnessSine)
+{
+  /* EBU Tech 3341 case 1, a stereo 1kHz sine at -23dBFS reads -23 LUFS */
+  const unsigned int rates[] = { 44100, 48000, 96000 };
+  for (unsigned int r = 0; r < sizeof(rates) / sizeof(rates[0]); ++r)
+  {
+    CAEChannelInfo layout(AE_CH_LAYOUT_2_0);
+    CAELoudness meter;
+    BOOST_REQUIRE(meter.Initialize(layout, rates[r]));
+
+    std::vector<float> in;
+    AddTone(in, layout, rates[r], 1000.0, -23.0, 20.0);
+
+    double lufs = Measure(meter, in, layout.Count());
+    BOOST_CHECK(fabs(lufs + 23.0) < 0.1);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(TestAELoudnessGating)
+{
+  /* EBU Tech 3341 case 3, quiet passages and silence are gated out */
+  CAEChannelInfo layout(AE_CH_LAYOUT_2_0);
+  CAELoudness meter;
+  BOOST_REQUIRE(meter.Initialize(layout, 48000));
+
+  std::vector<float> in;
+  AddTone(in, layout, 48000, 1000.0, -36.0, 10.0);
+  AddTone(in, layout, 48000, 1000.0, -23.0, 60.0);
+  AddTone(in, layout, 48000, 1000.0, -36.0, 10.0);
+  AddTone(in, layout, 48000, 1000.0, -200.0, 10.0);
+
+  double lufs = Measure(meter, in, layout.Count());
+  BOOST_CHECK(fabs(lufs + 23.0) < 0.1);
+
+  /* pure silence has no loudness at all */
+  meter.Reset();
+  in.clear();
+  AddTone(in, layout, 48000, 1000.0, -200.0, 5.0);
+  BOOST_CHECK(Measure(meter, in, layout.Count()) == -HUGE_VAL);
+}
+
+BOOST_AUTO_TEST_CASE(TestAELoudnessSurround)
+{
+  /* the LFE is ignored and the surrounds carry +1.5dB, 5 weighted channels at -23dBFS */
+  CAEChannelInfo layout(AE_CH_LAYOUT_5_1);
+  CAELoudness meter;
+  BOOST_REQUIRE(meter.Initialize(layout, 48000));
+
+  std::vector<float> in;
+  AddTone(in, layout, 48000, 1000.0, -23.0, 20.0);
+
+  double weight = 0.0;
+  for (unsigned int ch = 0; ch < layout.Count(); ++ch)
+  {
+    if      (layout[ch] == AE_CH_LFE) continue;
+    else if (layout[ch] == AE_CH_BL || layout[ch] == AE_CH_BR || layout[ch] == AE_CH_SL || layout[ch] == AE_CH_SR)
+      weight += 1.41;
+    else
+      weight += 1.0;
+  }
+
+  double lufs = Measure(meter, in, layout.Count());
+  double expected = -23.0 + 10.0 * log10(weight / 2.0);
+  BOOST_CHECK(fabs(lufs - expected) < 0.1);
+}
+
+BOOST_AUTO_TEST_CASE(TestAELoudnessTruePeak)
+{
+  /* a sine at fs/4 sampled 45 degrees off its peaks only reaches 0.707 in the samples */
+  CAEChannelInfo layout(AE_CH_LAYOUT_2_0);
+  CAELoudness meter;
+  BOOST_REQUIRE(meter.Initialize(layout, 48000));
+
+  std::vector<float> in;
+  AddTone(in, layout, 48000, 12000.0, -6.0, 1.0, M_PI / 4.0);
+
+  Measure(meter, in, layout.Count());
+  double peak = 20.0 * log10(meter.GetTruePeak());
+  BOOST_CHECK(fabs(peak + 6.0) < 0.5);
+}
+
+BOOST_AUTO_TEST_CASE(TestAELoudnessAlbum)
+{
+  /* merging the blocks of two tracks gates them as one programme */
+  CAEChannelInfo layout(AE_CH_LAYOUT_2_0);
+  CAELoudness track1, track2;
+  BOOST_REQUIRE(track1.Initialize(layout, 44100));
+  BOOST_REQUIRE(track2.Initialize(layout, 44100));
+
+  std::vector<float> in;
+  AddTone(in, layout, 44100, 1000.0, -20.0, 10.0);
+  Measure(track1, in, layout.Count());
+  in.clear();
+  AddTone(in, layout, 44100, 1000.0, -20.0, 10.0);
+  AddTone(in, layout, 44100, 1000.0, -26.0, 10.0);
+  Measure(track2, in, layout.Count());
+
+  std::vector<double> blocks(track1.GetBlocks());
+  blocks.insert(blocks.end(), track2.GetBlocks().begin(), track2.GetBlocks().end());
+  double album = CAELoudness::GetIntegrated(blocks);
+  BOOST_CHECK(album < track1.GetIntegrated() && album > track2.GetIntegrated());
+}
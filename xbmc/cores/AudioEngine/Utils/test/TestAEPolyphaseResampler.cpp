@@ -0,0 +1,163 @@
+/*
+ *      Copyright (C) 2010-2012 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+
+#include "cores/AudioEngine/Utils/AEPolyphaseResampler.h"
+
+#include <boost/test/unit_test.hpp>
+#include <math.h>
+#include <vector>
+
+#define TEST_INRATE   44100
+#define TEST_OUTRATE  48000
+#define TEST_CHANNELS 2
+#define TEST_FRAMES   (TEST_INRATE * 2)
+#define TEST_BLOCK    1024
+#define TEST_QUALITY  2 /* CAEResampler::QUALITY_HIGH */
+
+/* resample a sine of the given frequency in blocks, returns the output frames */
+static std::vector<float> ResampleTone(CAEPolyphaseResampler &resampler, double freq)
+{
+  std::vector<float> in(TEST_FRAMES * TEST_CHANNELS);
+  for (unsigned int i = 0; i < TEST_FRAMES; ++i)
+    for (unsigned int ch = 0; ch < TEST_CHANNELS; ++ch)
+      in[i * TEST_CHANNELS + ch] = 0.5f * (float)sin(2.0 * M_PI * freq * i / TEST_INRATE);
+
+  const unsigned int outRoom = TEST_BLOCK * 2 + 16;
+  std::vector<float> out;
+  std::vector<float> block(outRoom * TEST_CHANNELS);
+
+  unsigned int pos = 0;
+  while (pos < TEST_FRAMES)
+  {
+    unsigned int frames = std::min((unsigned int)TEST_BLOCK, (unsigned int)TEST_FRAMES - pos);
+    unsigned int used;
+    unsigned int gen = resampler.Process(&in[pos * TEST_CHANNELS], frames, used, &block[0], outRoom);
+    out.insert(out.end(), block.begin(), block.begin() + gen * TEST_CHANNELS);
+    if (!used && !gen)
+      break;
+    pos += used;
+  }
+
+  return out;
+}
+
+/* fit the output to a sine of the expected frequency and return the SNR in dB and the amplitude */
+static double MeasureSNR(const std::vector<float> &out, double freq, double &amplitude)
+{
+  /* skip the filter warm up and the tail */
+  const unsigned int frames = out.size() / TEST_CHANNELS;
+  const unsigned int first  = 1000;
+  const unsigned int last   = frames - 1000;
+
+  /* least squares fit of a * sin + b * cos, so any fixed delay is ignored */
+  double ss = 0.0, cc = 0.0, sc = 0.0, ys = 0.0, yc = 0.0;
+  for (unsigned int i = first; i < last; ++i)
+  {
+    double s = sin(2.0 * M_PI * freq * i / TEST_OUTRATE);
+    double c = cos(2.0 * M_PI * freq * i / TEST_OUTRATE);
+    double y = out[i * TEST_CHANNELS];
+    ss += s * s; cc += c * c; sc += s * c;
+    ys += y * s; yc += y * c;
+  }
+  double det = ss * cc - sc * sc;
+  double a   = (ys * cc - yc * sc) / det;
+  double b   = (yc * ss - ys * sc) / det;
+  amplitude  = sqrt(a * a + b * b);
+
+  double signal = 0.0, noise = 0.0;
+  for (unsigned int i = first; i < last; ++i)
+  {
+    double fit = a * sin(2.0 * M_PI * freq * i / TEST_OUTRATE) + b * cos(2.0 * M_PI * freq * i / TEST_OUTRATE);
+    double err = out[i * TEST_CHANNELS] - fit;
+    signal += fit * fit;
+    noise  += err * err;
+  }
+
+  return 10.0 * log10(signal / std::max(noise, 1e-30));
+}
+
+BOOST_AUTO_TEST_CASE(TestAEPolyphaseResamplerUpsample)
+{
+  CAEPolyphaseResampler resampler;
+  BOOST_REQUIRE(resampler.Initialize(TEST_CHANNELS, (double)TEST_OUTRATE / TEST_INRATE, TEST_QUALITY));
+
+  double amplitude;
+  std::vector<float> out = ResampleTone(resampler, 1000.0);
+
+  /* the output length must follow the ratio */
+  double expected = (double)TEST_FRAMES * TEST_OUTRATE / TEST_INRATE;
+  BOOST_CHECK(fabs(out.size() / TEST_CHANNELS - expected) < 64.0);
+
+  BOOST_CHECK(MeasureSNR(out, 1000.0, amplitude) > 80.0);
+  BOOST_CHECK(fabs(amplitude - 0.5) < 0.005);
+
+  /* the pass band should stay flat up to 16kHz */
+  resampler.Reset();
+  out = ResampleTone(resampler, 16000.0);
+  MeasureSNR(out, 16000.0, amplitude);
+  BOOST_CHECK(fabs(20.0 * log10(amplitude / 0.5)) < 0.1);
+}
+
+BOOST_AUTO_TEST_CASE(TestAEPolyphaseResamplerDownsample)
+{
+  /* a tone above the output nyquist must be rejected */
+  CAEPolyphaseResampler resampler;
+  BOOST_REQUIRE(resampler.Initialize(TEST_CHANNELS, 0.5, TEST_QUALITY));
+
+  std::vector<float> out = ResampleTone(resampler, 15000.0);
+  double peak = 0.0;
+  for (unsigned int i = 1000; i < out.size() - 1000; ++i)
+    peak = std::max(peak, (double)fabs(out[i]));
+  BOOST_CHECK(peak < 0.5 * 0.001);
+
+  /* changing the ratio must keep the stream running */
+  resampler.SetRatio((double)TEST_OUTRATE / TEST_INRATE);
+  out = ResampleTone(resampler, 1000.0);
+  BOOST_CHECK(out.size() > 0);
+}
+
+BOOST_AUTO_TEST_CASE(TestAEPolyphaseResamplerInputUsed)
+{
+  CAEPolyphaseResampler resampler;
+  BOOST_REQUIRE(resampler.Initialize(TEST_CHANNELS, (double)TEST_OUTRATE / TEST_INRATE, TEST_QUALITY));
+
+  std::vector<float> in(TEST_BLOCK * TEST_CHANNELS, 0.25f);
+  std::vector<float> out(TEST_BLOCK * 4 * TEST_CHANNELS);
+
+  /* with little room for output only the input needed for it is taken */
+  unsigned int used;
+  unsigned int gen = resampler.Process(&in[0], TEST_BLOCK, used, &out[0], 16);
+  BOOST_CHECK_EQUAL(gen, 16u);
+  BOOST_CHECK(used < TEST_BLOCK / 2);
+
+  /* the rest is taken once there is room */
+  unsigned int total = used;
+  gen = resampler.Process(&in[used * TEST_CHANNELS], TEST_BLOCK - used, used, &out[0], TEST_BLOCK * 4);
+  total += used;
+  BOOST_CHECK_EQUAL(total, (unsigned int)TEST_BLOCK);
+  BOOST_CHECK(gen > 0);
+
+  /* no room, nothing taken */
+  gen = resampler.Process(&in[0], TEST_BLOCK, used, &out[0], 0);
+  BOOST_CHECK_EQUAL(gen, 0u);
+  BOOST_CHECK_EQUAL(used, 0u);
+}
@@ -0,0 +1,241 @@
+/*
+ *      Copyright (C) 2010-2012 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "system.h"
+#include "cores/AudioEngine/Utils/AERingBuffer.h"
+#include "cores/AudioEngine/Utils/AEPolyphaseResampler.h"
+#include "cores/AudioEngine/Utils/AEUtil.h"
+
+#include <boost/test/unit_test.hpp>
+#include <pthread.h>
+#include <vector>
+
+#define RING_RATE     48000
+#define RING_CHANNELS 6
+#define RING_SECONDS  20
+#define RING_FRAMES   (RING_RATE * RING_SECONDS)
+#define RING_PACKET   1536 /* frames per decoded packet, as for AC3 */
+#define RING_BLOCK    1024 /* frames the engine takes at a time */
+#define RING_SIZE     (RING_RATE * RING_CHANNELS * sizeof(float))
+
+/*
+  the decoder thread writes RING_FRAMES frames numbered by their position and
+  the engine thread checks it reads them back in order, so the ring has to
+  publish its counts after the data
+*/
+struct SRingTest
+{
+  AERingBuffer ring;
+  bool         inOrder;
+
+  SRingTest() : ring(RING_SIZE), inOrder(true) {}
+};
+
+static void *RingProducer(void *arg)
+{
+  SRingTest *test = (SRingTest*)arg;
+  std::vector<float> packet(RING_PACKET * RING_CHANNELS);
+  unsigned int frame = 0;
+  while (frame < RING_FRAMES)
+  {
+    /* decode a packet */
+    unsigned int frames = std::min((unsigned int)RING_PACKET, (unsigned int)RING_FRAMES - frame);
+    for (unsigned int i = 0; i < frames * RING_CHANNELS; ++i)
+      packet[i] = (float)(frame * RING_CHANNELS + i);
+
+    /* and write it straight into the ring */
+    unsigned int done = 0;
+    while (done < frames)
+    {
+      unsigned int space;
+      float *out = (float*)test->ring.GetWritePtr(space);
+      unsigned int count = std::min(frames - done, space / (unsigned int)(RING_CHANNELS * sizeof(float)));
+      if (!count)
+      {
+        sched_yield();
+        continue;
+      }
+      memcpy(out, &packet[done * RING_CHANNELS], count * RING_CHANNELS * sizeof(float));
+      test->ring.CommitWrite(count * RING_CHANNELS * sizeof(float));
+      done += count;
+    }
+    frame += frames;
+  }
+  return NULL;
+}
+
+static void *RingConsumer(void *arg)
+{
+  SRingTest *test = (SRingTest*)arg;
+  unsigned int sample = 0;
+  while (sample < RING_FRAMES * RING_CHANNELS)
+  {
+    unsigned int size;
+    float *in = (float*)test->ring.GetReadPtr(size);
+    unsigned int samples = std::min(size / (unsigned int)sizeof(float), (unsigned int)(RING_BLOCK * RING_CHANNELS));
+    if (!samples)
+    {
+      sched_yield();
+      continue;
+    }
+
+    /* the engine mixes in place */
+    for (unsigned int i = 0; i < samples; ++i)
+      if (in[i] != (float)(sample + i))
+        test->inOrder = false;
+
+    test->ring.CommitRead(samples * sizeof(float));
+    sample += samples;
+  }
+  return NULL;
+}
+
+#define STREAM_INRATE   22050
+#define STREAM_OUTRATE  48000
+#define STREAM_CHANNELS 2
+#define STREAM_BLOCK    (STREAM_INRATE / 8)         /* input frames processed at a time */
+#define STREAM_WATER    (STREAM_OUTRATE * 3 / 4)    /* output frames buffered before playback */
+#define STREAM_QUALITY  2                           /* CAEResampler::QUALITY_HIGH */
+
+/*
+  feeds a stream resampling STREAM_INRATE to STREAM_OUTRATE (times adjust) the
+  way SoftAEStream does, taking only what its space calculation allows, with
+  the ring sized as the stream sizes it, returns false if the ring overran
+*/
+static bool ResampleStream(double adjust, bool &reachedWater)
+{
+  const unsigned int frameSize = STREAM_CHANNELS * sizeof(float);
+  const double       ratio     = (double)STREAM_OUTRATE / STREAM_INRATE;
+
+  CAEPolyphaseResampler resampler;
+  resampler.Initialize(STREAM_CHANNELS, ratio, STREAM_QUALITY);
+  const unsigned int blockOut = STREAM_BLOCK * (unsigned int)ceil(ratio);
+  resampler.SetRatio(ratio * adjust);
+  const double adjusted = ratio * adjust;
+
+  AERingBuffer ring((STREAM_WATER + 2 * blockOut + RING_BLOCK) * frameSize);
+  std::vector<float> input(STREAM_BLOCK * STREAM_CHANNELS);
+  std::vector<float> output(blockOut * STREAM_CHANNELS);
+  unsigned int inputUsed = 0;
+
+  bool playing = false;
+  reachedWater = false;
+  for (unsigned int period = 0; period < STREAM_OUTRATE * 4 / RING_BLOCK; ++period)
+  {
+    /* the decoder fills all the space the stream advertises, as PAPlayer does */
+    unsigned int buffered = ring.GetReadSize() / frameSize;
+    unsigned int space    = 0;
+    if (buffered < STREAM_WATER)
+      space = (STREAM_BLOCK - inputUsed) + CAEUtil::ResampleInputSpace(ring.GetWriteSize() / frameSize, STREAM_WATER - buffered, STREAM_BLOCK, adjusted);
+
+    unsigned int frames = space;
+    while (frames)
+    {
+      unsigned int copy = std::min(frames, (unsigned int)STREAM_BLOCK - inputUsed);
+      for (unsigned int i = 0; i < copy * STREAM_CHANNELS; ++i)
+        input[inputUsed * STREAM_CHANNELS + i] = 0.25f;
+      inputUsed += copy;
+      frames    -= copy;
+
+      if (inputUsed < STREAM_BLOCK)
+        break;
+
+      unsigned int used;
+      unsigned int out = resampler.Process(&input[0], inputUsed, used, &output[0], output.size() / STREAM_CHANNELS);
+      memmove(&input[0], &input[used * STREAM_CHANNELS], (inputUsed - used) * frameSize);
+      inputUsed -= used;
+
+      if (ring.Write((unsigned char*)&output[0], out * frameSize) != 0)
+        return false;
+    }
+
+    if (ring.GetReadSize() / frameSize >= STREAM_WATER)
+      playing = reachedWater = true;
+
+    /* the engine takes a block every period once playing */
+    if (playing)
+    {
+      unsigned int take = std::min(ring.GetReadSize(), (unsigned int)(RING_BLOCK * frameSize));
+      ring.CommitRead(take);
+    }
+  }
+
+  return true;
+}
+
+BOOST_AUTO_TEST_CASE(TestAERingBufferWrap)
+{
+  AERingBuffer ring(16);
+  unsigned char in[12], out[12];
+  for (unsigned int i = 0; i < sizeof(in); ++i)
+    in[i] = i + 1;
+
+  /* fill to 12, drain 8, the next 12 bytes wrap */
+  BOOST_CHECK(ring.Write(in, 12) == 0);
+  BOOST_CHECK(ring.Read(out, 8) == 0);
+  BOOST_CHECK_EQUAL(ring.GetReadSize(), 4U);
+  BOOST_CHECK_EQUAL(ring.GetWriteSize(), 12U);
+
+  /* in place access stops at the end of the buffer */
+  unsigned int size;
+  unsigned char *ptr = ring.GetWritePtr(size);
+  BOOST_CHECK_EQUAL(size, 4U);
+  memcpy(ptr, in, size);
+  ring.CommitWrite(size);
+  ptr = ring.GetWritePtr(size);
+  BOOST_CHECK_EQUAL(size, 8U);
+  memcpy(ptr, in + 4, size);
+  ring.CommitWrite(size);
+  BOOST_CHECK_EQUAL(ring.GetWriteSize(), 0U);
+
+  ptr = ring.GetReadPtr(size);
+  BOOST_CHECK_EQUAL(size, 8U);
+  BOOST_CHECK_EQUAL(ptr[4], 1);
+  ring.CommitRead(size);
+  BOOST_CHECK(ring.Read(out, 8) == 0);
+  BOOST_CHECK(memcmp(out, in + 4, 8) == 0);
+  BOOST_CHECK_EQUAL(ring.GetReadSize(), 0U);
+}
+
+BOOST_AUTO_TEST_CASE(TestAERingBufferThreads)
+{
+  SRingTest test;
+  pthread_t threads[2];
+  pthread_create(&threads[0], NULL, RingProducer, &test);
+  pthread_create(&threads[1], NULL, RingConsumer, &test);
+  pthread_join(threads[0], NULL);
+  pthread_join(threads[1], NULL);
+
+  BOOST_CHECK(test.inOrder);
+  BOOST_CHECK_EQUAL(test.ring.GetReadSize(), 0U);
+}
+
+BOOST_AUTO_TEST_CASE(TestAERingBufferResampledSpace)
+{
+  /* 22050 to 48000 produces more than two output frames per input frame */
+  bool reachedWater;
+  BOOST_CHECK(ResampleStream(1.0, reachedWater));
+  BOOST_CHECK(reachedWater);
+
+  /* as does a stream sped up for sync to display */
+  BOOST_CHECK(ResampleStream(1.05, reachedWater));
+  BOOST_CHECK(reachedWater);
+}
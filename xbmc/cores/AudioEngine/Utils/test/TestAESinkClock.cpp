@@ -0,0 +1,162 @@
+/*
+ *      Copyright (C) 2010-2012 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+
+#include "cores/AudioEngine/Utils/AESinkClock.h"
+
+#include <boost/test/unit_test.hpp>
+#include <math.h>
+#include <algorithm>
+
+/*
+  a virtual device whose clock drifts against the host, that only reports
+  which period it is playing, polled by an engine thread that wakes up late
+*/
+struct SDevice
+{
+  double       drift;    /* ppm */
+  double       period;   /* seconds */
+  double       jitter;   /* peak error of a report in seconds */
+  double       poll;     /* seconds between reports */
+  unsigned int seed;
+
+  SDevice(double d, double p, double j, double i) : drift(d), period(p), jitter(j), poll(i), seed(1) {}
+
+  double Random() /* -1 to 1, repeatable */
+  {
+    seed = seed * 1103515245 + 12345;
+    return (double)((seed >> 8) & 0xFFFF) / 32768.0 - 1.0;
+  }
+
+  double Position(double now) { return now * (1.0 + drift * 1e-6); }
+
+  double Report(double now)
+  {
+    double position = Position(now);
+    return floor(position / period) * period + jitter * Random();
+  }
+};
+
+/* runs the device for seconds, returns the standard deviation of the raw and filtered positions against the true one */
+static void Run(CAESinkClock &clock, SDevice &device, double start, double seconds, double settle, double &raw, double &filtered)
+{
+  double sumRaw = 0.0, sumRaw2 = 0.0, sumFlt = 0.0, sumFlt2 = 0.0;
+  unsigned int count = 0;
+  for (double now = start; now < start + seconds; now += device.poll * (1.0 + 0.2 * device.Random()))
+  {
+    double report = device.Report(now);
+    clock.Update(now, report);
+    if (now - start < settle || !clock.IsLocked())
+      continue;
+
+    double r = report - device.Position(now);
+    double f = clock.GetPosition(now) - device.Position(now);
+    sumRaw += r; sumRaw2 += r * r;
+    sumFlt += f; sumFlt2 += f * f;
+    count++;
+  }
+  BOOST_REQUIRE(count > 0);
+  raw      = sqrt(std::max(0.0, sumRaw2 / count - (sumRaw / count) * (sumRaw / count)));
+  filtered = sqrt(std::max(0.0, sumFlt2 / count - (sumFlt / count) * (sumFlt / count)));
+}
+
+BOOST_AUTO_TEST_CASE(TestAESinkClockSmoothing)
+{
+  /* an ALSA like device, 20ms periods polled every 13ms with 5ms of jitter */
+  const double drifts[] = { 0.0, 120.0, -300.0 };
+  for (unsigned int i = 0; i < sizeof(drifts) / sizeof(drifts[0]); ++i)
+  {
+    CAESinkClock clock;
+    SDevice device(drifts[i], 0.020, 0.005, 0.013);
+
+    double raw, filtered;
+    Run(clock, device, 100.0, 300.0, 30.0, raw, filtered);
+
+    AESinkClockStats stats;
+    clock.GetStats(stats);
+    BOOST_CHECK(filtered < raw / 4.0);
+    BOOST_CHECK(fabs(stats.drift - drifts[i]) < 20.0);
+    BOOST_CHECK(stats.jitter > 0.0 && stats.jitter < 0.020);
+    BOOST_CHECK_EQUAL(stats.relocks, 0u);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(TestAESinkClockDiscontinuity)
+{
+  CAESinkClock clock;
+  SDevice device(50.0, 0.010, 0.002, 0.010);
+
+  double raw, filtered;
+  Run(clock, device, 0.0, 20.0, 5.0, raw, filtered);
+  BOOST_REQUIRE(clock.IsLocked());
+
+  /* the device underruns and its position stands still for 200ms */
+  double stall = device.Position(20.0);
+  for (double now = 20.0; now < 20.2; now += device.poll)
+    clock.Update(now, stall);
+
+  AESinkClockStats stats;
+  clock.GetStats(stats);
+  BOOST_CHECK_EQUAL(stats.relocks, 1u);
+
+  /* the clock picks up the position it continues from */
+  for (double now = 20.2; now < 22.0; now += device.poll)
+    clock.Update(now, stall + (now - 20.2));
+  BOOST_CHECK(clock.IsLocked());
+  BOOST_CHECK(fabs(clock.GetPosition(22.0) - (stall + 1.8)) < 0.005);
+
+  /* a new sink starts over */
+  clock.Reset();
+  clock.GetStats(stats);
+  BOOST_CHECK(!clock.IsLocked());
+  BOOST_CHECK_EQUAL(stats.reports, 0u);
+  BOOST_CHECK_EQUAL(stats.relocks, 0u);
+}
+
+BOOST_AUTO_TEST_CASE(TestAESinkClockSmallJump)
+{
+  /* a quiet sink, 5ms periods polled every 5ms with 0.5ms of jitter */
+  CAESinkClock clock;
+  SDevice device(0.0, 0.005, 0.0005, 0.005);
+
+  double raw, filtered;
+  Run(clock, device, 0.0, 20.0, 5.0, raw, filtered);
+  BOOST_REQUIRE(clock.IsLocked());
+
+  /* one late poll is not a discontinuity */
+  clock.Update(20.0, device.Position(20.0) - 0.030);
+  for (double now = 20.005; now < 21.0; now += device.poll)
+    clock.Update(now, device.Report(now));
+
+  AESinkClockStats stats;
+  clock.GetStats(stats);
+  BOOST_CHECK_EQUAL(stats.relocks, 0u);
+  BOOST_CHECK(fabs(clock.GetPosition(21.0) - device.Position(21.0)) < 0.005);
+
+  /* but the sink dropping 30ms is, far below what a jittery sink needs */
+  for (double now = 21.0; now < 23.0; now += device.poll)
+    clock.Update(now, device.Report(now) - 0.030);
+
+  clock.GetStats(stats);
+  BOOST_CHECK_EQUAL(stats.relocks, 1u);
+  BOOST_CHECK(clock.IsLocked());
+  BOOST_CHECK(fabs(clock.GetPosition(23.0) - (device.Position(23.0) - 0.030)) < 0.005);
+}
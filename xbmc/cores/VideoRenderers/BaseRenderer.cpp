@@ -337,7 +337,8 @@ void CBaseRenderer::CalcNormalDisplayRect(float offsetX, float offsetY, float sc
 
   // allow a certain error to maximize screen size
   float fCorrection = screenWidth / screenHeight / outputFrameRatio - 1.0f;
-  float fAllowed    = g_guiSettings.GetInt("videoplayer.errorinaspect") * 0.01f;
+  static CSettingHandle errorInAspect("videoplayer.errorinaspect");
+  float fAllowed    = g_guiSettings.GetInt(errorInAspect) * 0.01f;
   if(fCorrection >   fAllowed) fCorrection =   fAllowed;
   if(fCorrection < - fAllowed) fCorrection = - fAllowed;
 
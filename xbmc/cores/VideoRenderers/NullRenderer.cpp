@@ -0,0 +1,95 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+
+#include "system.h"
+
+#if defined(HAS_HEADLESS)
+
+#include "NullRenderer.h"
+#include "settings/GUISettings.h"
+#include "settings/Settings.h"
+
+CNullRenderer::CNullRenderer()
+{
+  m_bConfigured = false;
+  m_flipCount   = 0;
+}
+
+CNullRenderer::~CNullRenderer()
+{
+  UnInit();
+}
+
+bool CNullRenderer::Configure(unsigned int width, unsigned int height, unsigned int d_width, unsigned int d_height, float fps, unsigned flags, ERenderFormat format, unsigned extended_format, unsigned int orientation)
+{
+  m_sourceWidth = width;
+  m_sourceHeight = height;
+  m_renderOrientation = orientation;
+  m_fps = fps;
+
+  // Calculate the input frame aspect ratio.
+  CalculateFrameAspectRatio(d_width, d_height);
+  ChooseBestResolution(fps);
+  SetViewMode(g_settings.m_currentVideoSettings.m_ViewMode);
+  ManageDisplay();
+
+  m_bConfigured = true;
+  return true;
+}
+
+void CNullRenderer::Update(bool bPauseDrawing)
+{
+  if (!m_bConfigured) return;
+  ManageDisplay();
+}
+
+void CNullRenderer::FlipPage(int source)
+{
+  m_flipCount++;
+}
+
+unsigned int CNullRenderer::PreInit()
+{
+  m_bConfigured = false;
+  UnInit();
+  m_resolution = g_guiSettings.m_LookAndFeelResolution;
+  if ( m_resolution == RES_WINDOW )
+    m_resolution = RES_DESKTOP;
+
+  m_formats.clear();
+  m_formats.push_back(RENDER_FMT_YUV420P);
+  m_formats.push_back(RENDER_FMT_YUV420P10);
+  m_formats.push_back(RENDER_FMT_YUV420P16);
+  m_formats.push_back(RENDER_FMT_NV12);
+  m_formats.push_back(RENDER_FMT_YUYV422);
+  m_formats.push_back(RENDER_FMT_UYVY422);
+
+  return 0;
+}
+
+void CNullRenderer::UnInit()
+{
+  m_bConfigured = false;
+  m_flipCount   = 0;
+}
+
+#endif
@@ -0,0 +1,93 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "system.h"
+
+#if defined(HAS_HEADLESS)
+
+#include "BaseRenderer.h"
+#include "RenderCapture.h"
+#include "settings/VideoSettings.h"
+#include "cores/VideoRenderers/RenderFlags.h"
+
+#include <vector>
+
+#define AUTOSOURCE -1
+
+/*!
+ \brief Video renderer for builds without a display.
+
+ Pictures are accepted and flipped but never drawn, so the player runs its
+ normal timing and dropping logic without any GPU.
+ */
+class CNullRenderer : public CBaseRenderer
+{
+public:
+  CNullRenderer();
+  virtual ~CNullRenderer();
+
+  virtual void Update(bool bPauseDrawing);
+  virtual void SetupScreenshot() {};
+
+  bool RenderCapture(CRenderCapture* capture) { return false; }
+
+  // Player functions
+  virtual bool         Configure(unsigned int width, unsigned int height, unsigned int d_width, unsigned int d_height, float fps, unsigned flags, ERenderFormat format, unsigned extended_format, unsigned int orientation);
+  virtual bool         IsConfigured() { return m_bConfigured; }
+  virtual bool         AddVideoPicture(DVDVideoPicture* picture) { return true; }
+  virtual int          GetImage(YV12Image *image, int source = AUTOSOURCE, bool readonly = false) { return -1; }
+  virtual void         ReleaseImage(int source, bool preserve = false) {}
+  virtual void         FlipPage(int source);
+  virtual unsigned int PreInit();
+  virtual void         UnInit();
+  virtual void         Reset() {}
+  virtual void         Flush() {}
+
+#ifdef HAVE_LIBVDPAU
+  virtual void         AddProcessor(CVDPAU* vdpau) {}
+#endif
+#ifdef HAVE_LIBVA
+  virtual void         AddProcessor(VAAPI::CHolder& holder) {}
+#endif
+
+  virtual void RenderUpdate(bool clear, DWORD flags = 0, DWORD alpha = 255) {}
+
+  // Feature support
+  virtual bool Supports(ERENDERFEATURE feature)    { return false; }
+  virtual bool Supports(EDEINTERLACEMODE mode)     { return mode == VS_DEINTERLACEMODE_OFF; }
+  virtual bool Supports(EINTERLACEMETHOD method)   { return false; }
+  virtual bool Supports(ESCALINGMETHOD method)     { return method == VS_SCALINGMETHOD_NEAREST; }
+
+  virtual EINTERLACEMETHOD AutoInterlaceMethod()  { return VS_INTERLACEMETHOD_NONE; }
+
+  virtual std::vector<ERenderFormat> SupportedFormats() { return m_formats; }
+
+  unsigned int GetFlipCount() const { return m_flipCount; }
+
+protected:
+  bool                       m_bConfigured;
+  unsigned int               m_flipCount;
+  std::vector<ERenderFormat> m_formats;
+};
+
+#endif
@@ -241,4 +241,16 @@ class CRenderCapture : public CRenderCaptureDX
     CRenderCapture() {};
 };
 
+#elif defined(HAS_HEADLESS)
+
+//there is nothing to capture from, the renderer fails every capture
+class CRenderCapture : public CRenderCaptureBase
+{
+  public:
+    CRenderCapture() {};
+
+    int  GetCaptureFormat() { return CAPTUREFORMAT_BGRA; }
+    void ReadOut() {}
+};
+
 #endif
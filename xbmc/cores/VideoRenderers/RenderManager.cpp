@@ -36,7 +36,9 @@
 #include "settings/GUISettings.h"
 #include "settings/AdvancedSettings.h"
 
-#if defined(HAS_GL)
+#if defined(HAS_HEADLESS)
+  #include "NullRenderer.h"
+#elif defined(HAS_GL)
   #include "LinuxRendererGL.h"
 #elif HAS_GLES == 2
   #include "LinuxRendererGLES.h"
@@ -326,7 +328,9 @@ unsigned int CXBMCRenderManager::PreInit()
   m_bPauseDrawing = false;
   if (!m_pRenderer)
   {
-#if defined(HAS_GL)
+#if defined(HAS_HEADLESS)
+    m_pRenderer = new CNullRenderer();
+#elif defined(HAS_GL)
     m_pRenderer = new CLinuxRendererGL();
 #elif HAS_GLES == 2
     m_pRenderer = new CLinuxRendererGLES();
@@ -637,7 +641,8 @@ float CXBMCRenderManager::GetMaximumFPS()
 {
   float fps;
 
-  if (g_guiSettings.GetInt("videoscreen.vsync") != VSYNC_DISABLED)
+  static CSettingHandle vsync("videoscreen.vsync");
+  if (g_guiSettings.GetInt(vsync) != VSYNC_DISABLED)
   {
     fps = (float)g_VideoReferenceClock.GetRefreshRate();
     if (fps <= 0) fps = g_graphicsContext.GetFPS();
@@ -44,6 +44,7 @@ class CWinRenderer;
 class CLinuxRenderer;
 class CLinuxRendererGL;
 class CLinuxRendererGLES;
+class CNullRenderer;
 
 class CXBMCRenderManager
 {
@@ -111,7 +112,9 @@ public:
 
   void UpdateResolution();
 
-#ifdef HAS_GL
+#if defined(HAS_HEADLESS)
+  CNullRenderer       *m_pRenderer;
+#elif defined(HAS_GL)
   CLinuxRendererGL    *m_pRenderer;
 #elif HAS_GLES == 2
   CLinuxRendererGLES  *m_pRenderer;
@@ -36,6 +36,7 @@
 #include "DVDInputStreams/DVDInputStreamBluray.h"
 #endif
 #include "DVDDemuxUtils.h"
+#include "DVDDemuxProbeCache.h"
 #include "DVDClock.h" // for DVD_TIME_BASE
 #include "commons/Exception.h"
 #include "settings/AdvancedSettings.h"
@@ -437,22 +438,56 @@ bool CDVDDemuxFFmpeg::Open(CDVDInputStream* pInput)
       m_pFormatContext->max_analyze_duration = 500000;
 
 
-    CLog::Log(LOGDEBUG, "%s - avformat_find_stream_info starting", __FUNCTION__);
-    int iErr = m_dllAvFormat.avformat_find_stream_info(m_pFormatContext, NULL);
-    if (iErr < 0)
+    // the same file is usually probed for its stream details, its thumb and
+    // then for playback, so reuse what we found the last time if we can
+    CDVDProbeInfo probe;
+    bool probed = false;
+    bool useCache = UseProbeCache();
+    if (useCache && CDVDDemuxProbeCache::Get().Lookup(strFile, probe))
     {
-      CLog::Log(LOGWARNING,"could not find codec parameters for %s", strFile.c_str());
-      if (m_pInput->IsStreamType(DVDSTREAM_TYPE_DVD) || (m_pFormatContext->nb_streams == 1 && m_pFormatContext->streams[0]->codec->codec_id == CODEC_ID_AC3))
+      if (SetProbeResult(probe))
       {
-        // special case, our codecs can still handle it.
+        CLog::Log(LOGDEBUG, "%s - using cached stream info, saved %u ms", __FUNCTION__, probe.m_probeTime);
+        probed = true;
       }
       else
       {
-        Dispose();
-        return false;
+        CLog::Log(LOGDEBUG, "%s - cached stream info doesn't match %s", __FUNCTION__, strFile.c_str());
+        CDVDDemuxProbeCache::Get().Reject(strFile);
+      }
+    }
+
+    if (!probed)
+    {
+      if (useCache)
+        GetProbeHeader(probe);
+
+      CLog::Log(LOGDEBUG, "%s - avformat_find_stream_info starting", __FUNCTION__);
+      unsigned int start = XbmcThreads::SystemClockMillis();
+      int iErr = m_dllAvFormat.avformat_find_stream_info(m_pFormatContext, NULL);
+      if (iErr < 0)
+      {
+        CLog::Log(LOGWARNING,"could not find codec parameters for %s", strFile.c_str());
+        if (m_pInput->IsStreamType(DVDSTREAM_TYPE_DVD) || (m_pFormatContext->nb_streams == 1 && m_pFormatContext->streams[0]->codec->codec_id == CODEC_ID_AC3))
+        {
+          // special case, our codecs can still handle it.
+        }
+        else
+        {
+          Dispose();
+          return false;
+        }
+      }
+      probe.m_probeTime = XbmcThreads::SystemClockMillis() - start;
+      CLog::Log(LOGDEBUG, "%s - av_find_stream_info finished after %u ms", __FUNCTION__, probe.m_probeTime);
+
+      // streams may still show up while probing, in which case the header can't validate the entry
+      if (useCache && iErr >= 0 && probe.m_modifiedTime && probe.m_streams.size() == m_pFormatContext->nb_streams)
+      {
+        GetProbeResult(probe);
+        CDVDDemuxProbeCache::Get().Store(strFile, probe);
       }
     }
-    CLog::Log(LOGDEBUG, "%s - av_find_stream_info finished", __FUNCTION__);
   }
   // reset any timeout
   m_timeout.SetInfinite();
@@ -891,6 +926,168 @@ void CDVDDemuxFFmpeg::UpdateCurrentPTS()
   }
 }
 
+bool CDVDDemuxFFmpeg::UseProbeCache()
+{
+  // only plain files have a size and modification time to key on, and
+  // only formats that announce all their streams in the header can be validated
+  return m_ioContext && m_ioContext->seekable
+      && m_pInput->IsStreamType(DVDSTREAM_TYPE_FILE)
+      && !(m_pFormatContext->ctx_flags & AVFMTCTX_NOHEADER);
+}
+
+void CDVDDemuxFFmpeg::GetProbeHeader(CDVDProbeInfo& info)
+{
+  info.m_format = m_pFormatContext->iformat->name;
+  info.m_streams.resize(m_pFormatContext->nb_streams);
+  for (unsigned int i = 0; i < m_pFormatContext->nb_streams; i++)
+  {
+    AVStream *stream = m_pFormatContext->streams[i];
+    CDVDProbeStream &probe = info.m_streams[i];
+    probe.m_codecType = stream->codec->codec_type;
+    probe.m_headerCodecId = stream->codec->codec_id;
+    probe.m_timeBaseNum = stream->time_base.num;
+    probe.m_timeBaseDen = stream->time_base.den;
+  }
+}
+
+void CDVDDemuxFFmpeg::GetProbeResult(CDVDProbeInfo& info)
+{
+  info.m_duration = m_pFormatContext->duration;
+  info.m_startTime = m_pFormatContext->start_time;
+  info.m_bitRate = m_pFormatContext->bit_rate;
+  for (unsigned int i = 0; i < m_pFormatContext->nb_streams; i++)
+  {
+    AVStream *stream = m_pFormatContext->streams[i];
+    AVCodecContext *codec = stream->codec;
+    CDVDProbeStream &probe = info.m_streams[i];
+    probe.m_codecId = codec->codec_id;
+    probe.m_codecTag = codec->codec_tag;
+    probe.m_width = codec->width;
+    probe.m_height = codec->height;
+    probe.m_pixFmt = codec->pix_fmt;
+    probe.m_sampleRate = codec->sample_rate;
+    probe.m_channels = codec->channels;
+    probe.m_channelLayout = codec->channel_layout;
+    probe.m_sampleFmt = codec->sample_fmt;
+    probe.m_bitsPerCodedSample = codec->bits_per_coded_sample;
+    probe.m_bitsPerRawSample = codec->bits_per_raw_sample;
+    probe.m_blockAlign = codec->block_align;
+    probe.m_bitRate = codec->bit_rate;
+    probe.m_profile = codec->profile;
+    probe.m_level = codec->level;
+    probe.m_hasBFrames = codec->has_b_frames;
+    probe.m_ticksPerFrame = codec->ticks_per_frame;
+    probe.m_codecTimeBaseNum = codec->time_base.num;
+    probe.m_codecTimeBaseDen = codec->time_base.den;
+    probe.m_codecAspectNum = codec->sample_aspect_ratio.num;
+    probe.m_codecAspectDen = codec->sample_aspect_ratio.den;
+    probe.m_aspectNum = stream->sample_aspect_ratio.num;
+    probe.m_aspectDen = stream->sample_aspect_ratio.den;
+    probe.m_frameRateNum = stream->r_frame_rate.num;
+    probe.m_frameRateDen = stream->r_frame_rate.den;
+    probe.m_avgFrameRateNum = stream->avg_frame_rate.num;
+    probe.m_avgFrameRateDen = stream->avg_frame_rate.den;
+    probe.m_codecInfoFrames = stream->codec_info_nb_frames;
+    probe.m_frameSize = codec->frame_size;
+    probe.m_refs = codec->refs;
+    probe.m_fieldOrder = codec->field_order;
+    probe.m_colorPrimaries = codec->color_primaries;
+    probe.m_colorTrc = codec->color_trc;
+    probe.m_colorSpace = codec->colorspace;
+    probe.m_colorRange = codec->color_range;
+    probe.m_chromaLocation = codec->chroma_sample_location;
+    probe.m_audioServiceType = codec->audio_service_type;
+    probe.m_duration = stream->duration;
+    probe.m_startTime = stream->start_time;
+    if (codec->extradata && codec->extradata_size > 0)
+      probe.m_extraData.assign(codec->extradata, codec->extradata + codec->extradata_size);
+    else
+      probe.m_extraData.clear();
+  }
+}
+
+bool CDVDDemuxFFmpeg::SetProbeResult(const CDVDProbeInfo& info)
+{
+  if (info.m_format != m_pFormatContext->iformat->name
+  ||  info.m_streams.size() != m_pFormatContext->nb_streams)
+    return false;
+
+  for (unsigned int i = 0; i < m_pFormatContext->nb_streams; i++)
+  {
+    AVStream *stream = m_pFormatContext->streams[i];
+    const CDVDProbeStream &probe = info.m_streams[i];
+    if (probe.m_codecType     != stream->codec->codec_type
+    ||  probe.m_headerCodecId != stream->codec->codec_id
+    ||  probe.m_timeBaseNum   != stream->time_base.num
+    ||  probe.m_timeBaseDen   != stream->time_base.den)
+      return false;
+  }
+
+  m_pFormatContext->duration = info.m_duration;
+  m_pFormatContext->start_time = info.m_startTime;
+  m_pFormatContext->bit_rate = info.m_bitRate;
+  for (unsigned int i = 0; i < m_pFormatContext->nb_streams; i++)
+  {
+    AVStream *stream = m_pFormatContext->streams[i];
+    AVCodecContext *codec = stream->codec;
+    const CDVDProbeStream &probe = info.m_streams[i];
+    codec->codec_id = (CodecID)probe.m_codecId;
+    codec->codec_tag = probe.m_codecTag;
+    codec->width = probe.m_width;
+    codec->height = probe.m_height;
+    codec->pix_fmt = (PixelFormat)probe.m_pixFmt;
+    codec->sample_rate = probe.m_sampleRate;
+    codec->channels = probe.m_channels;
+    codec->channel_layout = probe.m_channelLayout;
+    codec->sample_fmt = (AVSampleFormat)probe.m_sampleFmt;
+    codec->bits_per_coded_sample = probe.m_bitsPerCodedSample;
+    codec->bits_per_raw_sample = probe.m_bitsPerRawSample;
+    codec->block_align = probe.m_blockAlign;
+    codec->bit_rate = probe.m_bitRate;
+    codec->profile = probe.m_profile;
+    codec->level = probe.m_level;
+    codec->has_b_frames = probe.m_hasBFrames;
+    codec->ticks_per_frame = probe.m_ticksPerFrame;
+    codec->time_base.num = probe.m_codecTimeBaseNum;
+    codec->time_base.den = probe.m_codecTimeBaseDen;
+    codec->sample_aspect_ratio.num = probe.m_codecAspectNum;
+    codec->sample_aspect_ratio.den = probe.m_codecAspectDen;
+    stream->sample_aspect_ratio.num = probe.m_aspectNum;
+    stream->sample_aspect_ratio.den = probe.m_aspectDen;
+    stream->r_frame_rate.num = probe.m_frameRateNum;
+    stream->r_frame_rate.den = probe.m_frameRateDen;
+    stream->avg_frame_rate.num = probe.m_avgFrameRateNum;
+    stream->avg_frame_rate.den = probe.m_avgFrameRateDen;
+    stream->codec_info_nb_frames = probe.m_codecInfoFrames;
+    codec->frame_size = probe.m_frameSize;
+    codec->refs = probe.m_refs;
+    codec->field_order = (AVFieldOrder)probe.m_fieldOrder;
+    codec->color_primaries = (AVColorPrimaries)probe.m_colorPrimaries;
+    codec->color_trc = (AVColorTransferCharacteristic)probe.m_colorTrc;
+    codec->colorspace = (AVColorSpace)probe.m_colorSpace;
+    codec->color_range = (AVColorRange)probe.m_colorRange;
+    codec->chroma_sample_location = (AVChromaLocation)probe.m_chromaLocation;
+    codec->audio_service_type = (AVAudioServiceType)probe.m_audioServiceType;
+    stream->duration = probe.m_duration;
+    stream->start_time = probe.m_startTime;
+
+    // probing may have extracted the extradata from the stream itself
+    if ((int)probe.m_extraData.size() != codec->extradata_size)
+    {
+      m_dllAvUtil.av_free(codec->extradata);
+      codec->extradata = NULL;
+      codec->extradata_size = 0;
+      if (!probe.m_extraData.empty())
+      {
+        codec->extradata = (uint8_t*)m_dllAvUtil.av_mallocz(probe.m_extraData.size() + FF_INPUT_BUFFER_PADDING_SIZE);
+        memcpy(codec->extradata, &probe.m_extraData[0], probe.m_extraData.size());
+        codec->extradata_size = probe.m_extraData.size();
+      }
+    }
+  }
+  return true;
+}
+
 int CDVDDemuxFFmpeg::GetStreamLength()
 {
   if (!m_pFormatContext)
@@ -29,6 +29,8 @@
 #include "threads/CriticalSection.h"
 #include "threads/SystemClock.h"
 
+class CDVDProbeInfo;
+
 class CDVDDemuxFFmpeg;
 
 class CDemuxStreamVideoFFmpeg
@@ -124,6 +126,11 @@ protected:
   double ConvertTimestamp(int64_t pts, int den, int num);
   void UpdateCurrentPTS();
 
+  bool UseProbeCache();
+  void GetProbeHeader(CDVDProbeInfo& info);
+  void GetProbeResult(CDVDProbeInfo& info);
+  bool SetProbeResult(const CDVDProbeInfo& info);
+
   CCriticalSection m_critSection;
   #define MAX_STREAMS 100
   CDemuxStream* m_streams[MAX_STREAMS]; // maximum number of streams that ffmpeg can handle
@@ -0,0 +1,380 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "DVDDemuxProbeCache.h"
+#include "FileItem.h"
+#include "filesystem/File.h"
+#include "filesystem/Directory.h"
+#include "settings/AdvancedSettings.h"
+#include "threads/SingleLock.h"
+#include "utils/log.h"
+#include "utils/PersistentCacheFile.h"
+
+#include <algorithm>
+
+using namespace std;
+using namespace XFILE;
+
+#define PROBE_CACHE_PATH     "special://temp/probecache/"
+#define PROBE_CACHE_EXT      ".probe"
+#define PROBE_CACHE_VERSION  2
+#define PROBE_CACHE_MEMORY   32
+
+// sanity limits for entries read back from disk
+#define PROBE_MAX_STREAMS    1024
+#define PROBE_MAX_EXTRADATA  (1024 * 1024)
+
+CDVDProbeStream::CDVDProbeStream()
+{
+  m_codecType = -1;
+  m_headerCodecId = 0;
+  m_timeBaseNum = 0;
+  m_timeBaseDen = 0;
+  m_codecId = 0;
+  m_codecTag = 0;
+  m_width = 0;
+  m_height = 0;
+  m_pixFmt = -1;
+  m_sampleRate = 0;
+  m_channels = 0;
+  m_channelLayout = 0;
+  m_sampleFmt = -1;
+  m_bitsPerCodedSample = 0;
+  m_bitsPerRawSample = 0;
+  m_blockAlign = 0;
+  m_bitRate = 0;
+  m_profile = 0;
+  m_level = 0;
+  m_hasBFrames = 0;
+  m_ticksPerFrame = 1;
+  m_codecTimeBaseNum = 0;
+  m_codecTimeBaseDen = 1;
+  m_codecAspectNum = 0;
+  m_codecAspectDen = 1;
+  m_aspectNum = 0;
+  m_aspectDen = 1;
+  m_frameRateNum = 0;
+  m_frameRateDen = 0;
+  m_avgFrameRateNum = 0;
+  m_avgFrameRateDen = 0;
+  m_codecInfoFrames = 0;
+  m_frameSize = 0;
+  m_refs = 0;
+  m_fieldOrder = 0;
+  m_colorPrimaries = 0;
+  m_colorTrc = 0;
+  m_colorSpace = 0;
+  m_colorRange = 0;
+  m_chromaLocation = 0;
+  m_audioServiceType = 0;
+  m_duration = 0;
+  m_startTime = 0;
+  m_valid = true;
+}
+
+void CDVDProbeStream::Archive(CArchive& ar)
+{
+  if (ar.IsStoring())
+  {
+    ar << m_codecType << m_headerCodecId << m_timeBaseNum << m_timeBaseDen;
+    ar << m_codecId << m_codecTag;
+    ar << m_width << m_height << m_pixFmt;
+    ar << m_sampleRate << m_channels << m_channelLayout << m_sampleFmt;
+    ar << m_bitsPerCodedSample << m_bitsPerRawSample << m_blockAlign << m_bitRate;
+    ar << m_profile << m_level << m_hasBFrames << m_ticksPerFrame;
+    ar << m_codecTimeBaseNum << m_codecTimeBaseDen;
+    ar << m_codecAspectNum << m_codecAspectDen << m_aspectNum << m_aspectDen;
+    ar << m_frameRateNum << m_frameRateDen << m_avgFrameRateNum << m_avgFrameRateDen;
+    ar << m_codecInfoFrames << m_frameSize << m_refs << m_fieldOrder;
+    ar << m_colorPrimaries << m_colorTrc << m_colorSpace << m_colorRange << m_chromaLocation;
+    ar << m_audioServiceType << m_duration << m_startTime;
+    // extradata is binary, which CArchive's strings don't survive
+    ar << (int)m_extraData.size();
+    if (!m_extraData.empty())
+      ar.Write(&m_extraData[0], m_extraData.size());
+  }
+  else
+  {
+    ar >> m_codecType >> m_headerCodecId >> m_timeBaseNum >> m_timeBaseDen;
+    ar >> m_codecId >> m_codecTag;
+    ar >> m_width >> m_height >> m_pixFmt;
+    ar >> m_sampleRate >> m_channels >> m_channelLayout >> m_sampleFmt;
+    ar >> m_bitsPerCodedSample >> m_bitsPerRawSample >> m_blockAlign >> m_bitRate;
+    ar >> m_profile >> m_level >> m_hasBFrames >> m_ticksPerFrame;
+    ar >> m_codecTimeBaseNum >> m_codecTimeBaseDen;
+    ar >> m_codecAspectNum >> m_codecAspectDen >> m_aspectNum >> m_aspectDen;
+    ar >> m_frameRateNum >> m_frameRateDen >> m_avgFrameRateNum >> m_avgFrameRateDen;
+    ar >> m_codecInfoFrames >> m_frameSize >> m_refs >> m_fieldOrder;
+    ar >> m_colorPrimaries >> m_colorTrc >> m_colorSpace >> m_colorRange >> m_chromaLocation;
+    ar >> m_audioServiceType >> m_duration >> m_startTime;
+    int size = 0;
+    ar >> size;
+    m_extraData.clear();
+    m_valid = size >= 0 && size <= PROBE_MAX_EXTRADATA;
+    if (m_valid && size > 0)
+    {
+      m_extraData.resize(size);
+      m_valid = ar.Read(&m_extraData[0], size);
+    }
+  }
+}
+
+CDVDProbeInfo::CDVDProbeInfo()
+{
+  m_size = 0;
+  m_modifiedTime = 0;
+  m_duration = 0;
+  m_startTime = 0;
+  m_bitRate = 0;
+  m_probeTime = 0;
+  m_valid = true;
+}
+
+void CDVDProbeInfo::Archive(CArchive& ar)
+{
+  if (ar.IsStoring())
+  {
+    ar << m_size << m_modifiedTime << m_format;
+    ar << m_duration << m_startTime << m_bitRate << m_probeTime;
+    ar << (int)m_streams.size();
+    for (unsigned int i = 0; i < m_streams.size(); i++)
+      ar << m_streams[i];
+  }
+  else
+  {
+    ar >> m_size >> m_modifiedTime >> m_format;
+    ar >> m_duration >> m_startTime >> m_bitRate >> m_probeTime;
+    int count = 0;
+    ar >> count;
+    m_streams.clear();
+    m_valid = count >= 0 && count <= PROBE_MAX_STREAMS;
+    if (!m_valid)
+      return;
+    m_streams.resize(count);
+    for (unsigned int i = 0; i < m_streams.size() && m_valid; i++)
+    {
+      ar >> m_streams[i];
+      m_valid = m_streams[i].m_valid;
+    }
+  }
+}
+
+CDVDDemuxProbeCache::CDVDDemuxProbeCache()
+{
+  m_accessCounter = 0;
+  m_diskInitialized = false;
+  m_hits = 0;
+  m_misses = 0;
+  m_rejects = 0;
+  m_timeSaved = 0;
+  m_timeSpent = 0;
+}
+
+CDVDDemuxProbeCache& CDVDDemuxProbeCache::Get()
+{
+  static CDVDDemuxProbeCache probeCache;
+  return probeCache;
+}
+
+bool CDVDDemuxProbeCache::Lookup(const CStdString& path, CDVDProbeInfo& info)
+{
+  info = CDVDProbeInfo();
+  if (g_advancedSettings.m_videoProbeCacheSize <= 0)
+    return false;
+
+  struct __stat64 buffer;
+  if (CFile::Stat(path, &buffer) != 0 || !buffer.st_mtime || !buffer.st_size)
+    return false;
+  info.m_size = buffer.st_size;
+  info.m_modifiedTime = buffer.st_mtime;
+
+  CSingleLock lock(m_cs);
+  map<CStdString, CMemoryEntry>::iterator it = m_memory.find(path);
+  if (it != m_memory.end())
+  {
+    if (it->second.m_info.m_size == info.m_size && it->second.m_info.m_modifiedTime == info.m_modifiedTime)
+    {
+      it->second.m_lastAccess = m_accessCounter++;
+      info = it->second.m_info;
+      m_hits++;
+      m_timeSaved += info.m_probeTime;
+      return true;
+    }
+    m_memory.erase(it);
+  }
+  lock.Leave();
+
+  CDVDProbeInfo cached;
+  if (LoadPersistent(path, cached)
+  &&  cached.m_size == info.m_size && cached.m_modifiedTime == info.m_modifiedTime)
+  {
+    info = cached;
+    lock.Enter();
+    AddToMemory(path, info);
+    m_hits++;
+    m_timeSaved += info.m_probeTime;
+    return true;
+  }
+
+  lock.Enter();
+  m_misses++;
+  return false;
+}
+
+void CDVDDemuxProbeCache::Store(const CStdString& path, const CDVDProbeInfo& info)
+{
+  if (g_advancedSettings.m_videoProbeCacheSize <= 0 || !info.m_modifiedTime)
+    return;
+
+  CSingleLock lock(m_cs);
+  m_timeSpent += info.m_probeTime;
+  AddToMemory(path, info);
+  lock.Leave();
+
+  SavePersistent(path, info);
+}
+
+void CDVDDemuxProbeCache::Reject(const CStdString& path)
+{
+  CSingleLock lock(m_cs);
+  m_memory.erase(path);
+  m_rejects++;
+}
+
+void CDVDDemuxProbeCache::PrintStats() const
+{
+  CSingleLock lock(m_cs);
+  CLog::Log(LOGDEBUG, "%s - hits: %u, misses: %u, rejected: %u, probe time spent: %u ms, saved: %u ms",
+            __FUNCTION__, m_hits, m_misses, m_rejects, m_timeSpent, m_timeSaved);
+}
+
+void CDVDDemuxProbeCache::AddToMemory(const CStdString& path, const CDVDProbeInfo& info)
+{
+  if (m_memory.size() >= PROBE_CACHE_MEMORY && m_memory.find(path) == m_memory.end())
+  {
+    map<CStdString, CMemoryEntry>::iterator oldest = m_memory.begin();
+    for (map<CStdString, CMemoryEntry>::iterator it = m_memory.begin(); it != m_memory.end(); ++it)
+    {
+      if (it->second.m_lastAccess < oldest->second.m_lastAccess)
+        oldest = it;
+    }
+    m_memory.erase(oldest);
+  }
+
+  CMemoryEntry &entry = m_memory[path];
+  entry.m_info = info;
+  entry.m_lastAccess = m_accessCounter++;
+}
+
+void CDVDDemuxProbeCache::InitPersistent()
+{
+  {
+    CSingleLock lock(m_cs);
+    if (m_diskInitialized)
+      return;
+  }
+
+  // list the cache files before taking the lock, another thread may list them too
+  CFileItemList items;
+  bool listed = CDirectory::Exists(PROBE_CACHE_PATH)
+             && CDirectory::GetDirectory(PROBE_CACHE_PATH, items, PROBE_CACHE_EXT, DIR_FLAG_NO_FILE_DIRS | DIR_FLAG_BYPASS_CACHE);
+
+  CSingleLock lock(m_cs);
+  if (m_diskInitialized)
+    return;
+  m_diskInitialized = true;
+  if (!listed)
+    return;
+
+  // oldest first, so those are the first to go once we are full
+  items.Sort(SORT_METHOD_DATE, SortOrderAscending);
+  for (int i = 0; i < items.Size(); i++)
+  {
+    if (!items[i]->m_bIsFolder)
+      m_diskFiles.push_back(items[i]->GetPath());
+  }
+  vector<CStdString> evicted;
+  CheckIfPersistentFull(evicted);
+  lock.Leave();
+
+  DeleteFiles(evicted);
+}
+
+void CDVDDemuxProbeCache::CheckIfPersistentFull(vector<CStdString>& evicted)
+{
+  while ((int)m_diskFiles.size() > g_advancedSettings.m_videoProbeCacheSize)
+  {
+    evicted.push_back(m_diskFiles.front());
+    m_diskFiles.pop_front();
+  }
+}
+
+void CDVDDemuxProbeCache::DeleteFiles(const vector<CStdString>& files)
+{
+  for (vector<CStdString>::const_iterator it = files.begin(); it != files.end(); ++it)
+    CFile::Delete(*it);
+}
+
+bool CDVDDemuxProbeCache::LoadPersistent(const CStdString& path, CDVDProbeInfo& info)
+{
+  InitPersistent();
+
+  CPersistentCacheFile cacheFile(PROBE_CACHE_PATH, PROBE_CACHE_EXT, PROBE_CACHE_VERSION);
+  CArchive *ar = cacheFile.Load(path);
+  if (!ar)
+    return false;
+
+  *ar >> info;
+  cacheFile.Close();
+  if (!info.m_valid)
+  {
+    CLog::Log(LOGDEBUG, "%s - ignoring corrupt entry for %s", __FUNCTION__, path.c_str());
+    return false;
+  }
+  return true;
+}
+
+void CDVDDemuxProbeCache::SavePersistent(const CStdString& path, const CDVDProbeInfo& info)
+{
+  InitPersistent();
+
+  CPersistentCacheFile cacheFile(PROBE_CACHE_PATH, PROBE_CACHE_EXT, PROBE_CACHE_VERSION);
+  CArchive *ar = cacheFile.Store(path);
+  if (!ar)
+    return;
+
+  *ar << const_cast<CDVDProbeInfo&>(info);
+  if (!cacheFile.Close())
+    return;
+
+  CStdString file = cacheFile.GetFile(path);
+  CSingleLock lock(m_cs);
+  deque<CStdString>::iterator it = find(m_diskFiles.begin(), m_diskFiles.end(), file);
+  if (it != m_diskFiles.end())
+    m_diskFiles.erase(it);
+  m_diskFiles.push_back(file);
+
+  vector<CStdString> evicted;
+  CheckIfPersistentFull(evicted);
+  lock.Leave();
+
+  DeleteFiles(evicted);
+}
@@ -0,0 +1,177 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "utils/StdString.h"
+#include "utils/Archive.h"
+#include "threads/CriticalSection.h"
+
+#include <map>
+#include <deque>
+#include <vector>
+
+/*!
+ \brief Codec parameters of a single stream as found by avformat_find_stream_info
+ */
+class CDVDProbeStream : public IArchivable
+{
+public:
+  CDVDProbeStream();
+  virtual void Archive(CArchive& ar);
+
+  // as reported by the container header, used to validate the entry
+  int m_codecType;
+  int m_headerCodecId;
+  int m_timeBaseNum;
+  int m_timeBaseDen;
+
+  // as found by probing
+  int m_codecId;
+  unsigned int m_codecTag;
+  int m_width;
+  int m_height;
+  int m_pixFmt;
+  int m_sampleRate;
+  int m_channels;
+  uint64_t m_channelLayout;
+  int m_sampleFmt;
+  int m_bitsPerCodedSample;
+  int m_bitsPerRawSample;
+  int m_blockAlign;
+  int m_bitRate;
+  int m_profile;
+  int m_level;
+  int m_hasBFrames;
+  int m_ticksPerFrame;
+  int m_codecTimeBaseNum;
+  int m_codecTimeBaseDen;
+  int m_codecAspectNum;
+  int m_codecAspectDen;
+  int m_aspectNum;
+  int m_aspectDen;
+  int m_frameRateNum;
+  int m_frameRateDen;
+  int m_avgFrameRateNum;
+  int m_avgFrameRateDen;
+  int m_codecInfoFrames;
+  int m_frameSize;
+  int m_refs;
+  int m_fieldOrder;
+  int m_colorPrimaries;
+  int m_colorTrc;
+  int m_colorSpace;
+  int m_colorRange;
+  int m_chromaLocation;
+  int m_audioServiceType;
+  int64_t m_duration;
+  int64_t m_startTime;
+  std::vector<unsigned char> m_extraData;
+
+  bool m_valid; ///< false if loaded from a corrupt entry
+};
+
+/*!
+ \brief Result of probing a file, keyed on the size and modification time of the file
+ */
+class CDVDProbeInfo : public IArchivable
+{
+public:
+  CDVDProbeInfo();
+  virtual void Archive(CArchive& ar);
+
+  int64_t m_size;
+  int64_t m_modifiedTime;
+  CStdString m_format;
+  int64_t m_duration;
+  int64_t m_startTime;
+  int m_bitRate;
+  unsigned int m_probeTime; ///< time in ms it took to probe, i.e. what a hit saves
+  std::vector<CDVDProbeStream> m_streams;
+
+  bool m_valid; ///< false if loaded from a corrupt entry
+};
+
+/*!
+ \brief Cache of demuxer probe results
+
+ A library scan fetches the stream details and a thumb for each file, and the file is
+ then played, each of which opens a demuxer and probes the streams. Probing reads and
+ decodes the first seconds of the file, which is slow over the network, so the results
+ are kept in memory for the next open and persisted to special://temp/probecache/.
+
+ Only the fields avformat_find_stream_info fills in that the players use are kept,
+ so the cache is off unless advancedsettings.xml sets video/probecachesize.
+ */
+class CDVDDemuxProbeCache
+{
+public:
+  CDVDDemuxProbeCache();
+
+  static CDVDDemuxProbeCache& Get();
+
+  /*!
+   \brief Look up the probe result for a file
+   \param path the file to look up
+   \param info receives the cached result on a hit, or only the size and modification time on a miss
+   \return true on a hit
+   */
+  bool Lookup(const CStdString& path, CDVDProbeInfo& info);
+
+  /*!
+   \brief Store the probe result of a file, previously looked up with Lookup()
+   */
+  void Store(const CStdString& path, const CDVDProbeInfo& info);
+
+  /*!
+   \brief Account for a cached result that the demuxer couldn't use
+   */
+  void Reject(const CStdString& path);
+
+  void PrintStats() const;
+
+private:
+  bool LoadPersistent(const CStdString& path, CDVDProbeInfo& info);
+  void SavePersistent(const CStdString& path, const CDVDProbeInfo& info);
+  void InitPersistent();
+  void CheckIfPersistentFull(std::vector<CStdString>& evicted);
+  static void DeleteFiles(const std::vector<CStdString>& files);
+  void AddToMemory(const CStdString& path, const CDVDProbeInfo& info);
+
+  struct CMemoryEntry
+  {
+    CDVDProbeInfo m_info;
+    unsigned int m_lastAccess;
+  };
+  std::map<CStdString, CMemoryEntry> m_memory;
+  unsigned int m_accessCounter;
+
+  std::deque<CStdString> m_diskFiles; ///< persisted entries, oldest first
+  bool m_diskInitialized;
+
+  CCriticalSection m_cs;
+
+  unsigned int m_hits;
+  unsigned int m_misses;
+  unsigned int m_rejects;
+  unsigned int m_timeSaved;
+  unsigned int m_timeSpent;
+};
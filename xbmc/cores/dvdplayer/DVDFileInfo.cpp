@@ -51,6 +51,9 @@
 #include "filesystem/File.h"
 #include "TextureCache.h"
 
+#include <algorithm>
+#include <math.h>
+
 
 bool CDVDFileInfo::GetFileDuration(const CStdString &path, int& duration)
 {
@@ -90,6 +93,92 @@ int DegreeToOrientation(int degrees)
   }
 }
 
+// positions to take a thumb from, as a fraction of the length, in order of preference
+static const double ThumbPositions[] = { 1.0 / 3.0, 0.5, 0.2, 2.0 / 3.0 };
+
+// a picture scoring at least this isn't worth looking any further than
+#define THUMB_SCORE_GOOD 20.0
+
+/*!
+ \brief Score a decoded picture on its suitability as a thumb
+ Uses the spread of the luminance, so that black, white or flat pictures (fades,
+ credits, title cards) lose out against pictures that actually show something.
+ */
+static double ScoreThumbPicture(const DVDVideoPicture &picture)
+{
+  if (!picture.data[0] || picture.iWidth == 0 || picture.iHeight == 0)
+    return 0.0;
+
+  // a sparse grid is plenty to tell a black frame from a real one
+  const unsigned int step = 8;
+  double sum = 0.0, sumSquares = 0.0;
+  unsigned int count = 0;
+  for (unsigned int y = 0; y < picture.iHeight; y += step)
+  {
+    const BYTE *line = picture.data[0] + y * picture.iLineSize[0];
+    for (unsigned int x = 0; x < picture.iWidth; x += step)
+    {
+      sum += line[x];
+      sumSquares += line[x] * line[x];
+      count++;
+    }
+  }
+
+  double mean = sum / count;
+  double deviation = sqrt(std::max(sumSquares / count - mean * mean, 0.0));
+
+  // nearly black or white pictures may still have some noise, don't let that win
+  if (mean < 32.0 || mean > 224.0)
+    deviation *= 0.25;
+  return deviation;
+}
+
+/*!
+ \brief Decode the first picture of the video stream from the current demuxer position
+ */
+static bool DecodeThumbPicture(CDVDDemux *pDemuxer, CDVDVideoCodec *pVideoCodec, int nVideoStream, DVDVideoPicture &picture, int &packetsTried)
+{
+  DemuxPacket* pPacket = NULL;
+  int iDecoderState = VC_ERROR;
+  memset(&picture, 0, sizeof(DVDVideoPicture));
+
+  // num streams * 80 frames, should get a valid frame, if not abort.
+  int abort_index = pDemuxer->GetNrOfStreams() * 80;
+  do
+  {
+    pPacket = pDemuxer->Read();
+    packetsTried++;
+
+    if (!pPacket)
+      break;
+
+    if (pPacket->iStreamId != nVideoStream)
+    {
+      CDVDDemuxUtils::FreeDemuxPacket(pPacket);
+      continue;
+    }
+
+    iDecoderState = pVideoCodec->Decode(pPacket->pData, pPacket->iSize, pPacket->dts, pPacket->pts);
+    CDVDDemuxUtils::FreeDemuxPacket(pPacket);
+
+    if (iDecoderState & VC_ERROR)
+      break;
+
+    if (iDecoderState & VC_PICTURE)
+    {
+      memset(&picture, 0, sizeof(DVDVideoPicture));
+      if (pVideoCodec->GetPicture(&picture))
+      {
+        if(!(picture.iFlags & DVP_FLAG_DROPPED))
+          break;
+      }
+    }
+
+  } while (abort_index--);
+
+  return (iDecoderState & VC_PICTURE) && !(picture.iFlags & DVP_FLAG_DROPPED);
+}
+
 bool CDVDFileInfo::ExtractThumb(const CStdString &strPath, CTextureDetails &details, CStreamDetails *pStreamDetails)
 {
   unsigned int nTime = XbmcThreads::SystemClockMillis();
@@ -177,90 +266,84 @@ bool CDVDFileInfo::ExtractThumb(const CStdString &strPath, CTextureDetails &deta
     if (pVideoCodec)
     {
       int nTotalLen = pDemuxer->GetStreamLength();
-      int nSeekTo = nTotalLen / 3;
-
-      CLog::Log(LOGDEBUG,"%s - seeking to pos %dms (total: %dms) in %s", __FUNCTION__, nSeekTo, nTotalLen, strPath.c_str());
-      if (pDemuxer->SeekTime(nSeekTo, true))
-      {
-        DemuxPacket* pPacket = NULL;
-        int iDecoderState = VC_ERROR;
-        DVDVideoPicture picture;
+      unsigned int nWidth = g_advancedSettings.GetThumbSize();
+      unsigned int nHeight = 0;
+      BYTE *pOutBuf = NULL;
+      double bestScore = -1.0;
 
-        // num streams * 80 frames, should get a valid frame, if not abort.
-        int abort_index = pDemuxer->GetNrOfStreams() * 80;
-        do
-        {
-          pPacket = pDemuxer->Read();
-          packetsTried++;
+      // we only want a single picture after each seek, so don't bother with frames nothing refers to.
+      // skipping everything but keyframes would be cheaper still, but codecs with b-frames only
+      // output the keyframe once the next reference frame is decoded, which would then never come.
+      pVideoCodec->SetDropState(true);
 
-          if (!pPacket)
-            break;
+      DllSwScale dllSwScale;
+      dllSwScale.Load();
 
-          if (pPacket->iStreamId != nVideoStream)
-          {
-            CDVDDemuxUtils::FreeDemuxPacket(pPacket);
-            continue;
-          }
+      for (unsigned int candidate = 0; candidate < sizeof(ThumbPositions) / sizeof(ThumbPositions[0]); candidate++)
+      {
+        int nSeekTo = (int)(nTotalLen * ThumbPositions[candidate]);
+        // without a length there's nowhere else to look
+        if (candidate > 0 && nTotalLen <= 0)
+          break;
 
-          iDecoderState = pVideoCodec->Decode(pPacket->pData, pPacket->iSize, pPacket->dts, pPacket->pts);
-          CDVDDemuxUtils::FreeDemuxPacket(pPacket);
+        CLog::Log(LOGDEBUG,"%s - seeking to pos %dms (total: %dms) in %s", __FUNCTION__, nSeekTo, nTotalLen, strPath.c_str());
+        if (!pDemuxer->SeekTime(nSeekTo, true))
+          break;
 
-          if (iDecoderState & VC_ERROR)
-            break;
+        // the same codec is reused for each candidate
+        if (candidate > 0)
+          pVideoCodec->Reset();
 
-          if (iDecoderState & VC_PICTURE)
-          {
-            memset(&picture, 0, sizeof(DVDVideoPicture));
-            if (pVideoCodec->GetPicture(&picture))
-            {
-              if(!(picture.iFlags & DVP_FLAG_DROPPED))
-                break;
-            }
-          }
+        DVDVideoPicture picture;
+        if (!DecodeThumbPicture(pDemuxer, pVideoCodec, nVideoStream, picture, packetsTried))
+        {
+          CLog::Log(LOGDEBUG,"%s - decode failed in %s after %d packets.", __FUNCTION__, strPath.c_str(), packetsTried);
+          continue;
+        }
 
-        } while (abort_index--);
+        double score = ScoreThumbPicture(picture);
+        CLog::Log(LOGDEBUG,"%s - picture at %dms scored %.1f", __FUNCTION__, nSeekTo, score);
+        if (score <= bestScore)
+          continue;
 
-        if (iDecoderState & VC_PICTURE && !(picture.iFlags & DVP_FLAG_DROPPED))
+        if (!pOutBuf)
         {
-          {
-            unsigned int nWidth = g_advancedSettings.GetThumbSize();
-            double aspect = (double)picture.iDisplayWidth / (double)picture.iDisplayHeight;
-            if(hint.forced_aspect && hint.aspect != 0)
-              aspect = hint.aspect;
-            unsigned int nHeight = (unsigned int)((double)g_advancedSettings.GetThumbSize() / aspect);
-
-            DllSwScale dllSwScale;
-            dllSwScale.Load();
-
-            BYTE *pOutBuf = new BYTE[nWidth * nHeight * 4];
-            struct SwsContext *context = dllSwScale.sws_getContext(picture.iWidth, picture.iHeight,
-                  PIX_FMT_YUV420P, nWidth, nHeight, PIX_FMT_BGRA, SWS_FAST_BILINEAR | SwScaleCPUFlags(), NULL, NULL, NULL);
-            uint8_t *src[] = { picture.data[0], picture.data[1], picture.data[2], 0 };
-            int     srcStride[] = { picture.iLineSize[0], picture.iLineSize[1], picture.iLineSize[2], 0 };
-            uint8_t *dst[] = { pOutBuf, 0, 0, 0 };
-            int     dstStride[] = { nWidth*4, 0, 0, 0 };
-
-            if (context)
-            {
-              int orientation = DegreeToOrientation(hint.orientation);
-              dllSwScale.sws_scale(context, src, srcStride, 0, picture.iHeight, dst, dstStride);
-              dllSwScale.sws_freeContext(context);
-
-              details.width = nWidth;
-              details.height = nHeight;
-              CPicture::CacheTexture(pOutBuf, nWidth, nHeight, nWidth * 4, orientation, nWidth, nHeight, CTextureCache::GetCachedPath(details.file));
-              bOk = true;
-            }
-
-            dllSwScale.Unload();
-            delete [] pOutBuf;
-          }
+          double aspect = (double)picture.iDisplayWidth / (double)picture.iDisplayHeight;
+          if(hint.forced_aspect && hint.aspect != 0)
+            aspect = hint.aspect;
+          nHeight = (unsigned int)((double)g_advancedSettings.GetThumbSize() / aspect);
+          pOutBuf = new BYTE[nWidth * nHeight * 4];
         }
-        else
+
+        struct SwsContext *context = dllSwScale.sws_getContext(picture.iWidth, picture.iHeight,
+              PIX_FMT_YUV420P, nWidth, nHeight, PIX_FMT_BGRA, SWS_FAST_BILINEAR | SwScaleCPUFlags(), NULL, NULL, NULL);
+        uint8_t *src[] = { picture.data[0], picture.data[1], picture.data[2], 0 };
+        int     srcStride[] = { picture.iLineSize[0], picture.iLineSize[1], picture.iLineSize[2], 0 };
+        uint8_t *dst[] = { pOutBuf, 0, 0, 0 };
+        int     dstStride[] = { nWidth*4, 0, 0, 0 };
+
+        if (context)
         {
-          CLog::Log(LOGDEBUG,"%s - decode failed in %s after %d packets.", __FUNCTION__, strPath.c_str(), packetsTried);
+          dllSwScale.sws_scale(context, src, srcStride, 0, picture.iHeight, dst, dstStride);
+          dllSwScale.sws_freeContext(context);
+          bestScore = score;
         }
+
+        if (bestScore >= THUMB_SCORE_GOOD)
+          break;
+      }
+
+      if (bestScore >= 0.0)
+      {
+        int orientation = DegreeToOrientation(hint.orientation);
+        details.width = nWidth;
+        details.height = nHeight;
+        CPicture::CacheTexture(pOutBuf, nWidth, nHeight, nWidth * 4, orientation, nWidth, nHeight, CTextureCache::GetCachedPath(details.file));
+        bOk = true;
       }
+
+      dllSwScale.Unload();
+      delete [] pOutBuf;
       delete pVideoCodec;
     }
   }
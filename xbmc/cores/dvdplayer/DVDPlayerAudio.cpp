@@ -26,6 +26,7 @@
 #include "DVDCodecs/DVDCodecs.h"
 #include "DVDCodecs/DVDFactoryCodec.h"
 #include "DVDPerformanceCounter.h"
+#include "DVDSyncTest.h"
 #include "settings/GUISettings.h"
 #include "video/VideoReferenceClock.h"
 #include "utils/log.h"
@@ -700,9 +701,12 @@ void CDVDPlayerAudio::HandleSyncError(double duration)
   double error = m_ptsOutput.Current() - clock;
   int64_t now;
 
+  CDVDSyncTest::Get().OnAudioError(error);
+
   if( fabs(error) > DVD_MSEC_TO_TIME(100) || m_syncclock )
   {
     m_pClock->Discontinuity(clock+error);
+    CDVDSyncTest::Get().OnAudioDiscontinuity();
     if(m_speed == DVD_PLAYSPEED_NORMAL)
       CLog::Log(LOGDEBUG, "CDVDPlayerAudio:: Discontinuity - was:%f, should be:%f, error:%f", clock, clock+error, error);
 
@@ -764,6 +768,7 @@ void CDVDPlayerAudio::HandleSyncError(double duration)
       if (fabs(error) > limit - 0.001)
       {
         m_pClock->Discontinuity(clock+error);
+        CDVDSyncTest::Get().OnAudioDiscontinuity();
         if(m_speed == DVD_PLAYSPEED_NORMAL)
           CLog::Log(LOGDEBUG, "CDVDPlayerAudio:: Discontinuity - was:%f, should be:%f, error:%f", clock, clock+error, error);
       }
@@ -810,12 +815,15 @@ bool CDVDPlayerAudio::OutputPacket(DVDAudioFrame &audioframe)
         m_dvdAudio.AddPackets(audioframe);
         m_skipdupcount++;
       }
+      else
+        CDVDSyncTest::Get().OnAudioSkipDup(-1);
     }
     else if (m_skipdupcount > 0)
     {
       m_dvdAudio.AddPackets(audioframe);
       m_dvdAudio.AddPackets(audioframe);
       m_skipdupcount--;
+      CDVDSyncTest::Get().OnAudioSkipDup(1);
     }
     else if (m_skipdupcount == 0)
     {
@@ -838,6 +846,7 @@ bool CDVDPlayerAudio::OutputPacket(DVDAudioFrame &audioframe)
 
     m_resampleratio = 1.0 / g_VideoReferenceClock.GetSpeed() + proportional + m_integral;
     m_dvdAudio.SetResampleRatio(m_resampleratio);
+    CDVDSyncTest::Get().OnAudioResample(m_resampleratio);
     m_dvdAudio.AddPackets(audioframe);
   }
 
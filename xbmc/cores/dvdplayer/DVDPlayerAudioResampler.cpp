@@ -23,18 +23,12 @@
 #include "DVDPlayerAudio.h"
 #include "utils/log.h"
 #include "utils/MathUtils.h"
-
-#ifdef _WIN32
-#pragma comment(lib, "libsamplerate-0.lib")
-#endif
+#include "settings/AdvancedSettings.h"
 
 CDVDPlayerResampler::CDVDPlayerResampler()
 {
   m_nrchannels = -1;
-  m_converter = NULL;
-  m_converterdata.end_of_input = 0;
-  m_converterdata.src_ratio = 1.0;
-  m_quality = SRC_LINEAR;
+  m_quality = CAEResampler::QUALITY_LOW;
   m_ratio = 1.0;
 
   m_buffer = NULL;
@@ -64,29 +58,28 @@ void CDVDPlayerResampler::Add(DVDAudioFrame &audioframe, double pts)
   ResizeSampleBuffer(m_bufferfill + nrframes + nrframes * MathUtils::round_int(m_ratio + 0.5) * 2);
 
   //assign samplebuffers
-  m_converterdata.input_frames = nrframes;
-  m_converterdata.output_frames = m_buffersize - m_bufferfill - m_converterdata.input_frames;
+  int outframes = m_buffersize - m_bufferfill - nrframes;
   //output buffer starts at the place where the buffer doesn't hold samples
-  m_converterdata.data_out = m_buffer + m_bufferfill * m_nrchannels;
+  float* dataout = m_buffer + m_bufferfill * m_nrchannels;
   //intput buffer is a block of data at the end of the buffer
-  m_converterdata.data_in = m_converterdata.data_out + m_converterdata.output_frames * m_nrchannels;
+  float* datain = dataout + outframes * m_nrchannels;
 
   //add samples to the resample input buffer
   int16_t* inputptr  = (int16_t*)audioframe.data;
-  float*   outputptr = m_converterdata.data_in;
+  float*   outputptr = datain;
 
   for (int i = 0; i < nrframes * m_nrchannels; i++)
     *outputptr++ = (float)*inputptr++ / scale;
 
   //resample
-  m_converterdata.src_ratio = m_ratio;
-  src_set_ratio(m_converter, m_ratio);
-  src_process(m_converter, &m_converterdata);
+  unsigned int used;
+  m_resampler.SetRatio(m_ratio);
+  int generated = m_resampler.Process(datain, nrframes, used, dataout, outframes);
 
   //calculate a pts for each sample
-  for (int i = 0; i < m_converterdata.output_frames_gen; i++)
+  for (int i = 0; i < generated; i++)
   {
-    m_ptsbuffer[m_bufferfill] = pts + i * (audioframe.duration / (double)m_converterdata.output_frames_gen);
+    m_ptsbuffer[m_bufferfill] = pts + i * (audioframe.duration / (double)generated);
     m_bufferfill++;
   }
 }
@@ -127,13 +120,12 @@ bool CDVDPlayerResampler::Retrieve(DVDAudioFrame &audioframe, double &pts)
 
 void CDVDPlayerResampler::CheckResampleBuffers(int channels)
 {
-  int error;
   if (channels != m_nrchannels)
   {
     Clean();
 
     m_nrchannels = channels;
-    m_converter = src_new(m_quality, m_nrchannels, &error);
+    m_resampler.Initialize(m_nrchannels, m_ratio, (CAEResampler::Quality)m_quality, g_advancedSettings.m_audioPolyphaseResampler);
   }
 }
 
@@ -160,15 +152,13 @@ void CDVDPlayerResampler::Flush()
 
 void CDVDPlayerResampler::SetQuality(int quality)
 {
-  int qualitylookup[] = {SRC_LINEAR, SRC_SINC_FASTEST, SRC_SINC_MEDIUM_QUALITY, SRC_SINC_BEST_QUALITY};
-  m_quality = qualitylookup[Clamp(quality, 0, 3)];
+  m_quality = Clamp(quality, (int)CAEResampler::QUALITY_LOW, (int)CAEResampler::QUALITY_BEST);
   Clean();
 }
 
 void CDVDPlayerResampler::Clean()
 {
-  if (m_converter) src_delete(m_converter);
-  m_converter = NULL;
+  m_resampler.Deinitialize();
 
   free(m_buffer);
   m_buffer = NULL;
@@ -179,7 +169,5 @@ void CDVDPlayerResampler::Clean()
   m_buffersize = 0;
 
   m_nrchannels = -1;
-  m_converterdata.end_of_input = 0;
-  m_converterdata.src_ratio = 1.0;
   m_ratio = 1.0;
 }
@@ -37,6 +37,7 @@
 #include "DVDDemuxers/DVDDemuxUtils.h"
 #include "DVDOverlayRenderer.h"
 #include "DVDPerformanceCounter.h"
+#include "DVDSyncTest.h"
 #include "DVDCodecs/DVDCodecs.h"
 #include "DVDCodecs/Overlay/DVDOverlayCodecCC.h"
 #include "DVDCodecs/Overlay/DVDOverlaySSA.h"
@@ -552,6 +553,7 @@ void CDVDPlayerVideo::Process()
       {
         m_iDroppedFrames++;
         iDropped++;
+        CDVDSyncTest::Get().OnVideoDecoderDrop();
       }
 
       // loop while no error
@@ -709,6 +711,7 @@ void CDVDPlayerVideo::Process()
             {
               m_iDroppedFrames++;
               iDropped++;
+              CDVDSyncTest::Get().OnVideoDropped(pts);
             }
             else
               iDropped = 0;
@@ -1317,6 +1320,9 @@ int CDVDPlayerVideo::OutputPicture(const DVDVideoPicture* src, double pts)
   if (index < 0)
     return EOS_DROPPED;
 
+  // how late this picture is shown compared to when the clock says it should be
+  CDVDSyncTest::Get().OnVideoFrame(pts, max(0.0, iSleepTime) - iClockSleep);
+
   g_renderManager.FlipPage(CThread::m_bStop, (iCurrentClock + iSleepTime) / DVD_TIME_BASE, -1, mDisplayField);
 
   return result;
@@ -0,0 +1,251 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+
+#include "system.h"
+#include "DVDSyncTest.h"
+#include "DVDClock.h"
+#include "Application.h"
+#include "ApplicationMessenger.h"
+#include "cores/AudioEngine/AEFactory.h"
+#include "cores/AudioEngine/Utils/AESinkClock.h"
+#include "filesystem/File.h"
+#include "threads/SingleLock.h"
+#include "utils/log.h"
+#include "utils/TimeUtils.h"
+
+#include <math.h>
+#include <algorithm>
+
+#define SYNCTEST_START_TIMEOUT 30000
+
+using namespace XFILE;
+
+CDVDSyncTest& CDVDSyncTest::Get()
+{
+  static CDVDSyncTest s_synctest;
+  return s_synctest;
+}
+
+CDVDSyncTest::CDVDSyncTest()
+{
+  m_enabled = false;
+  m_started = false;
+  m_playing = false;
+  m_recording = false;
+  m_speed = 1.0;
+  m_audioError = 0.0;
+  m_ratio = 1.0;
+  m_minRatio = 1.0;
+  m_maxRatio = 1.0;
+  m_decoderDrops = 0;
+  m_discontinuities = 0;
+  m_skips = 0;
+  m_dups = 0;
+  m_startCpu = 0;
+  m_startHost = 0;
+}
+
+void CDVDSyncTest::Enable(double speed)
+{
+  m_enabled = true;
+  m_speed = speed > 0.0 ? speed : 1.0;
+  SetHostCounterSpeed(m_speed);
+}
+
+void CDVDSyncTest::Process()
+{
+  if (!IsActive())
+    return;
+
+  if (!m_started)
+  {
+    m_started = true;
+    if (!CAEFactory::ForceNullSink(true))
+      CLog::Log(LOGWARNING, "%s - SoftAE is not the active audio engine, audio goes to the configured device", __FUNCTION__);
+    CLog::Log(LOGNOTICE, "%s - running at %.2fx real time", __FUNCTION__, m_speed);
+    m_startTimeout.Set(SYNCTEST_START_TIMEOUT);
+  }
+
+  bool playing = g_application.IsPlayingVideo();
+  if (playing && !m_playing)
+    Start();
+  else if (!playing && m_playing)
+    Finish();
+  else if (!playing && m_startTimeout.IsTimePast())
+  {
+    CLog::Log(LOGERROR, "%s - no video started playing, pass a file to play", __FUNCTION__);
+    m_enabled = false;
+    CApplicationMessenger::Get().Quit();
+  }
+  m_playing = playing;
+}
+
+void CDVDSyncTest::Start()
+{
+  CSingleLock lock(m_section);
+  m_frames.clear();
+  m_audioError = 0.0;
+  m_ratio = m_minRatio = m_maxRatio = 1.0;
+  m_decoderDrops = 0;
+  m_discontinuities = 0;
+  m_skips = 0;
+  m_dups = 0;
+  m_startCpu = clock();
+  m_startHost = CurrentHostCounter();
+  m_recording = true;
+}
+
+void CDVDSyncTest::OnVideoFrame(double pts, double error)
+{
+  if (!m_recording)
+    return;
+
+  CSingleLock lock(m_section);
+  SFrame frame;
+  frame.pts = pts / DVD_TIME_BASE;
+  frame.video = error / DVD_TIME_BASE;
+  frame.audio = m_audioError;
+  frame.ratio = m_ratio;
+  frame.dropped = false;
+  m_frames.push_back(frame);
+}
+
+void CDVDSyncTest::OnVideoDropped(double pts)
+{
+  if (!m_recording)
+    return;
+
+  CSingleLock lock(m_section);
+  SFrame frame;
+  frame.pts = pts / DVD_TIME_BASE;
+  frame.video = 0.0;
+  frame.audio = m_audioError;
+  frame.ratio = m_ratio;
+  frame.dropped = true;
+  m_frames.push_back(frame);
+}
+
+void CDVDSyncTest::OnVideoDecoderDrop()
+{
+  if (!m_recording)
+    return;
+
+  CSingleLock lock(m_section);
+  m_decoderDrops++;
+}
+
+void CDVDSyncTest::OnAudioError(double error)
+{
+  if (!m_recording)
+    return;
+
+  CSingleLock lock(m_section);
+  m_audioError = error / DVD_TIME_BASE;
+}
+
+void CDVDSyncTest::OnAudioDiscontinuity()
+{
+  if (!m_recording)
+    return;
+
+  CSingleLock lock(m_section);
+  m_discontinuities++;
+}
+
+void CDVDSyncTest::OnAudioSkipDup(int direction)
+{
+  if (!m_recording)
+    return;
+
+  CSingleLock lock(m_section);
+  if (direction < 0)
+    m_skips++;
+  else
+    m_dups++;
+}
+
+void CDVDSyncTest::OnAudioResample(double ratio)
+{
+  if (!m_recording)
+    return;
+
+  CSingleLock lock(m_section);
+  m_ratio = ratio;
+  m_minRatio = std::min(m_minRatio, ratio);
+  m_maxRatio = std::max(m_maxRatio, ratio);
+}
+
+void CDVDSyncTest::Finish()
+{
+  CSingleLock lock(m_section);
+  m_recording = false;
+
+  double cpu  = (double)(clock() - m_startCpu) / CLOCKS_PER_SEC;
+  double host = (double)(CurrentHostCounter() - m_startHost) / CurrentHostFrequency();
+
+  CStdString strFile = "special://home/synctest.csv";
+  CFile file;
+  if (file.OpenForWrite(strFile, true))
+  {
+    CStdString line = "pts,video_error,audio_error,av_offset,dropped,resample_ratio\n";
+    file.Write(line.c_str(), line.size());
+    for (std::vector<SFrame>::const_iterator it = m_frames.begin(); it != m_frames.end(); ++it)
+    {
+      line.Format("%.6f,%.6f,%.6f,%.6f,%d,%.6f\n", it->pts, it->video, it->audio, it->video + it->audio, it->dropped ? 1 : 0, it->ratio);
+      file.Write(line.c_str(), line.size());
+    }
+    file.Close();
+  }
+  else
+    CLog::Log(LOGERROR, "%s - unable to save %s", __FUNCTION__, strFile.c_str());
+
+  unsigned int shown = 0, dropped = 0;
+  double sum = 0.0, peak = 0.0;
+  for (std::vector<SFrame>::const_iterator it = m_frames.begin(); it != m_frames.end(); ++it)
+  {
+    if (it->dropped)
+    {
+      dropped++;
+      continue;
+    }
+    double offset = fabs(it->video + it->audio);
+    sum += offset;
+    peak = std::max(peak, offset);
+    shown++;
+  }
+  double media = m_frames.empty() ? 0.0 : m_frames.back().pts - m_frames.front().pts;
+
+  CLog::Log(LOGNOTICE, "%s - %u frames shown, %u dropped by the player, %u by the decoder", __FUNCTION__, shown, dropped, m_decoderDrops);
+  CLog::Log(LOGNOTICE, "%s - a/v offset mean %.2f ms, max %.2f ms", __FUNCTION__, shown ? sum / shown * 1000.0 : 0.0, peak * 1000.0);
+  CLog::Log(LOGNOTICE, "%s - audio %u discontinuities, %u skips, %u dups, resample ratio %.5f - %.5f", __FUNCTION__,
+            m_discontinuities, m_skips, m_dups, m_minRatio, m_maxRatio);
+  CLog::Log(LOGNOTICE, "%s - %.2f s of media in %.2f s virtual, %.2f s real, %.2f s cpu", __FUNCTION__,
+            media, host, host / m_speed, cpu);
+
+  AESinkClockStats clock;
+  if (CAEFactory::GetSinkClockStats(clock))
+    CLog::Log(LOGNOTICE, "%s - sink drift %.1f ppm, jitter %.2f ms rms, %.2f ms max, %u relocks", __FUNCTION__,
+              clock.drift, clock.jitter * 1000.0, clock.maxError * 1000.0, clock.relocks);
+
+  m_enabled = false;
+  CApplicationMessenger::Get().Quit();
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+
+#include "threads/CriticalSection.h"
+#include "threads/SystemClock.h"
+
+#include <stdint.h>
+#include <time.h>
+#include <vector>
+
+/*!
+ \brief Offline A/V sync harness for DVDPlayer.
+
+ Started with --sync-test[=<speed>] together with a file to play. Audio is
+ sent to the NULL sink and, when a speed is given, the host counter runs that
+ many times faster than real time, so no display or sound card is needed.
+ While video plays the player reports every presented or dropped frame and
+ every audio sync correction; when playback ends one row per frame is written
+ to special://home/synctest.csv, a summary is logged and XBMC quits.
+
+ All errors are in seconds. The video error is how late a frame was shown
+ relative to the clock, the audio error how far audio output is ahead of the
+ clock, and their sum the offset of audio ahead of video.
+ */
+class CDVDSyncTest
+{
+public:
+  static CDVDSyncTest& Get();
+
+  /*!
+   \brief Enable the harness.
+   \param speed rate of the virtual host clock relative to real time
+   */
+  void Enable(double speed);
+  bool IsActive() const { return m_enabled; }
+
+  /*!
+   \brief Advance the harness by one frame. Called from the application's FrameMove.
+   */
+  void Process();
+
+  /* called by the player threads, cheap no-ops unless a test is recording */
+  void OnVideoFrame(double pts, double error);
+  void OnVideoDropped(double pts);
+  void OnVideoDecoderDrop();
+  void OnAudioError(double error);
+  void OnAudioDiscontinuity();
+  void OnAudioSkipDup(int direction);
+  void OnAudioResample(double ratio);
+
+private:
+  CDVDSyncTest();
+  CDVDSyncTest(const CDVDSyncTest&);
+  CDVDSyncTest const& operator=(CDVDSyncTest const&);
+
+  void Start();
+  void Finish();
+
+  struct SFrame
+  {
+    double pts;
+    double video;
+    double audio;
+    double ratio;
+    bool   dropped;
+  };
+
+  CCriticalSection    m_section;
+  std::vector<SFrame> m_frames;
+  bool                m_enabled;
+  bool                m_started;
+  bool                m_playing;
+  volatile bool       m_recording;
+  double              m_speed;
+  XbmcThreads::EndTime m_startTimeout;
+
+  double              m_audioError;
+  double              m_ratio;
+  double              m_minRatio;
+  double              m_maxRatio;
+  unsigned int        m_decoderDrops;
+  unsigned int        m_discontinuities;
+  unsigned int        m_skips;
+  unsigned int        m_dups;
+  clock_t             m_startCpu;
+  int64_t             m_startHost;
+};
@@ -21,13 +21,42 @@
 
 #include "AudioDecoder.h"
 #include "CodecFactory.h"
+#include "settings/AdvancedSettings.h"
 #include "settings/GUISettings.h"
 #include "FileItem.h"
 #include "music/tags/MusicInfoTag.h"
+#include "music/MusicDatabase.h"
 #include "threads/SingleLock.h"
+#include "utils/JobManager.h"
 #include "utils/log.h"
+#include "utils/TimeUtils.h"
 #include <math.h>
 
+/* stores a seek index built during playback, off the player thread */
+class CSaveSeekIndexJob : public CJob
+{
+public:
+  CSaveSeekIndexJob(const CStdString &strFile, int64_t fileSize, const CSeekIndex &index) :
+    m_strFile(strFile), m_fileSize(fileSize), m_index(index) {}
+
+  virtual const char *GetType() const { return "seekindex"; }
+
+  virtual bool DoWork()
+  {
+    CMusicDatabase database;
+    if (!database.Open())
+      return false;
+    bool ret = database.SetSeekIndex(m_strFile, m_fileSize, m_index);
+    database.Close();
+    return ret;
+  }
+
+private:
+  CStdString m_strFile;
+  int64_t    m_fileSize;
+  CSeekIndex m_index;
+};
+
 CAudioDecoder::CAudioDecoder()
 {
   m_codec = NULL;
@@ -36,6 +65,9 @@ CAudioDecoder::CAudioDecoder()
 
   m_status = STATUS_NO_FILE;
   m_canPlay = false;
+
+  m_seekIndexStored = true;
+  m_seekStart = 0;
 }
 
 CAudioDecoder::~CAudioDecoder()
@@ -93,6 +125,27 @@ bool CAudioDecoder::Create(const CFileItem &file, int64_t seekOffset)
     return false;
   }
 
+  // files without replaygain tags may have been measured by the library scan,
+  // and library songs that were played through before have a seek index
+  bool loadGain = !m_codec->m_replayGain.iHasGainInfo && g_guiSettings.m_replayGain.iType != REPLAY_GAIN_NONE &&
+                  g_advancedSettings.m_bMusicLibraryAnalyseReplayGain;
+  bool inLibrary = file.HasMusicInfoTag() && file.GetMusicInfoTag()->GetDatabaseId() > 0;
+  m_strFile = file.GetPath();
+  m_seekIndexStored = !m_codec->UsesSeekIndex() || !inLibrary;
+  m_seekStart = 0;
+  if (loadGain || !m_seekIndexStored)
+  {
+    CMusicDatabase database;
+    if (database.Open())
+    {
+      if (loadGain)
+        database.GetReplayGain(file.GetPath(), file.m_lStartOffset, m_codec->m_replayGain);
+      if (!m_seekIndexStored)
+        m_seekIndexStored = database.GetSeekIndex(file.GetPath(), m_codec->m_file.GetLength(), m_codec->m_seekIndex);
+      database.Close();
+    }
+  }
+
   /* allocate the pcmBuffer for 2 seconds of audio */
   m_pcmBuffer.Create(2 * blockSize * m_codec->m_SampleRate);
 
@@ -126,6 +179,7 @@ int64_t CAudioDecoder::Seek(int64_t time)
     return 0;
   if (time < 0) time = 0;
   if (time > m_codec->m_TotalTime) time = m_codec->m_TotalTime;
+  m_seekStart = CurrentHostCounter();
   return m_codec->Seek(time);
 }
 
@@ -196,6 +250,14 @@ int CAudioDecoder::ReadSamples(int numsamples)
 
     if (result != READ_ERROR && readSize)
     {
+      if (m_seekStart)
+      {
+        CLog::Log(LOGDEBUG, "CAudioDecoder::ReadSamples - %s seek took %.1f ms until audio (%s)", m_codec->m_CodecName.c_str(),
+                  (CurrentHostCounter() - m_seekStart) * 1000.0 / CurrentHostFrequency(),
+                  m_codec->m_seekIndex.IsComplete() ? "complete seek index" : m_codec->m_seekIndex.IsEmpty() ? "no seek index" : "partial seek index");
+        m_seekStart = 0;
+      }
+
       // move it into our buffer
       m_pcmBuffer.WriteData((char *)m_pcmInputBuffer, readSize);
 
@@ -208,6 +270,8 @@ int CAudioDecoder::ReadSamples(int numsamples)
 
       if (result == READ_EOF) // EOF reached
       {
+        StoreSeekIndex();
+
         // setup ending if we're within set time of the end (currently just EOF)
         m_eof = true;
         if (m_status < STATUS_ENDING)
@@ -224,6 +288,7 @@ int CAudioDecoder::ReadSamples(int numsamples)
     }
     if (result == READ_EOF)
     {
+      StoreSeekIndex();
       m_eof = true;
       // setup ending if we're within set time of the end (currently just EOF)
       if (m_status < STATUS_ENDING)
@@ -233,6 +298,15 @@ int CAudioDecoder::ReadSamples(int numsamples)
   return RET_SLEEP; // nothing to do
 }
 
+void CAudioDecoder::StoreSeekIndex()
+{
+  if (m_seekIndexStored || !m_codec->m_seekIndex.IsComplete())
+    return;
+
+  m_seekIndexStored = true;
+  CJobManager::GetInstance().AddJob(new CSaveSeekIndexJob(m_strFile, m_codec->m_file.GetLength(), m_codec->m_seekIndex), NULL);
+}
+
 float CAudioDecoder::GetReplayGain()
 {
 #define REPLAY_GAIN_DEFAULT_LEVEL 89.0f
@@ -78,6 +78,8 @@ public:
   float GetReplayGain();
 
 private:
+  void StoreSeekIndex();
+
   // pcm buffer
   CRingBuffer m_pcmBuffer;
 
@@ -96,5 +98,12 @@ private:
   // the codec we're using
   ICodec*          m_codec;
 
+  // the file being decoded, and whether its seek index is in the music database
+  CStdString       m_strFile;
+  bool             m_seekIndexStored;
+
+  // host counter at the last seek, to measure how long it takes until audio comes back
+  int64_t          m_seekStart;
+
   CCriticalSection m_critSection;
 };
@@ -37,6 +37,8 @@ FLACCodec::FLACCodec()
   m_CodecName = "FLAC";
 
   m_pFlacDecoder=NULL;
+  m_indexing=false;
+  m_seekTarget=0;
 
   m_pBuffer=NULL;
   m_BufferSize=0;
@@ -96,6 +98,14 @@ bool FLACCodec::Init(const CStdString &strFile, unsigned int filecache)
     return false;
   }
 
+  //  The first frame follows the metadata, start indexing from there
+  FLAC__uint64 position;
+  m_seekIndex.Reset(m_SampleRate);
+  if (m_dll.FLAC__stream_decoder_get_decode_position(m_pFlacDecoder, &position))
+    m_seekIndex.Add(0, position);
+  m_indexing=true;
+  m_seekTarget=0;
+
   //  Extract ReplayGain info
   CFlacTag tag;
   if (tag.Read(strFile))
@@ -134,7 +144,23 @@ int64_t FLACCodec::Seek(int64_t iSeekTime)
   // may be called when the buffer is almost full (resulting in a buffer
   // overrun unless we reset m_BufferSize first).
   m_BufferSize=0;
-  if(!m_dll.FLAC__stream_decoder_seek_absolute(m_pFlacDecoder, (int64_t)(iSeekTime*m_SampleRate)/1000))
+  const uint64_t sample=(uint64_t)iSeekTime*m_SampleRate/1000;
+
+  //  If we know the frame before the target, jump there and decode forward
+  //  rather than letting libFLAC bisect the file.
+  CSeekIndex::Point point;
+  if (m_seekIndex.Lookup(sample, point) &&
+      m_dll.FLAC__stream_decoder_flush(m_pFlacDecoder) &&
+      m_file.Seek(point.offset, SEEK_SET)>=0)
+  {
+    m_indexing=true;
+    m_seekTarget=sample;
+    return iSeekTime;
+  }
+
+  m_indexing=false;
+  m_seekTarget=0;
+  if(!m_dll.FLAC__stream_decoder_seek_absolute(m_pFlacDecoder, sample))
     CLog::Log(LOGERROR, "FLACCodec::Seek - failed to seek");
 
   if(m_dll.FLAC__stream_decoder_get_state(m_pFlacDecoder)==FLAC__STREAM_DECODER_SEEK_ERROR)
@@ -184,7 +210,11 @@ int FLACCodec::ReadPCM(BYTE *pBuffer, int size, int *actualsize)
   }
 
   if (eof && m_BufferSize==0)
+  {
+    if (m_indexing)
+      m_seekIndex.SetComplete(m_dll.FLAC__stream_decoder_get_total_samples(m_pFlacDecoder));
     return READ_EOF;
+  }
 
   return READ_SUCCESS;
 }
@@ -270,24 +300,44 @@ FLAC__StreamDecoderWriteStatus FLACCodec::DecoderWriteCallback(const FLAC__Strea
   FLAC__int16* outptr16 = (FLAC__int16 *) outptr;
   FLAC__int32* outptr32 = (FLAC__int32 *) outptr;
 
-  unsigned int current_sample = 0;
-  for(current_sample = 0; current_sample < frame->header.blocksize; current_sample++)
+  uint64_t first_sample = frame->header.number.sample_number;
+  if (frame->header.number_type == FLAC__FRAME_NUMBER_TYPE_FRAME_NUMBER)
+    first_sample = (uint64_t)frame->header.number.frame_number * frame->header.blocksize;
+
+  //  after a seek through the index drop what comes before the target
+  unsigned int skip = 0;
+  if (pThis->m_seekTarget > first_sample)
+    skip = (unsigned int)std::min<uint64_t>(pThis->m_seekTarget - first_sample, frame->header.blocksize);
+  if (first_sample + frame->header.blocksize >= pThis->m_seekTarget)
+    pThis->m_seekTarget = 0;
+
+  if (pThis->m_indexing)
+  {
+    //  the decoder has consumed this frame, so its position is where the next one starts
+    FLAC__uint64 position;
+    if (pThis->m_dll.FLAC__stream_decoder_get_decode_position(decoder, &position))
+      pThis->m_seekIndex.Add(first_sample + frame->header.blocksize, position);
+  }
+
+  const unsigned int samples = frame->header.blocksize - skip;
+  for(unsigned int current_sample = 0; current_sample < samples; current_sample++)
   {
     for(unsigned int channel = 0; channel < frame->header.channels; channel++)
     {
+      const FLAC__int32 value = buffer[channel][current_sample + skip];
       switch(bytes_per_sample)
       {
         case 2:
-          outptr16[current_sample*frame->header.channels + channel] = (FLAC__int16) buffer[channel][current_sample];
+          outptr16[current_sample*frame->header.channels + channel] = (FLAC__int16) value;
           break;
         case 3:
-          outptr[2] = (buffer[channel][current_sample] >> 16) & 0xff;
-          outptr[1] = (buffer[channel][current_sample] >> 8 ) & 0xff;
-          outptr[0] = (buffer[channel][current_sample] >> 0 ) & 0xff;
+          outptr[2] = (value >> 16) & 0xff;
+          outptr[1] = (value >> 8 ) & 0xff;
+          outptr[0] = (value >> 0 ) & 0xff;
           outptr += bytes_per_sample;
           break;
         default:
-          outptr32[current_sample*frame->header.channels + channel] = buffer[channel][current_sample];
+          outptr32[current_sample*frame->header.channels + channel] = value;
           break;
       }
     }
@@ -295,14 +345,14 @@ FLAC__StreamDecoderWriteStatus FLACCodec::DecoderWriteCallback(const FLAC__Strea
 
   if (bytes_per_sample == 1)
   {
-    for(unsigned int i=0;i<current_sample;i++)
+    for(unsigned int i=0;i<samples;i++)
     {
       BYTE* outptr=pThis->m_pBuffer+pThis->m_BufferSize;
       outptr[i]^=0x80;
     }
   }
 
-  pThis->m_BufferSize += current_sample*bytes_per_sample*frame->header.channels;
+  pThis->m_BufferSize += samples*bytes_per_sample*frame->header.channels;
 
   return FLAC__STREAM_DECODER_WRITE_STATUS_CONTINUE;
 }
@@ -32,6 +32,7 @@ public:
 
   virtual bool Init(const CStdString &strFile, unsigned int filecache);
   virtual void DeInit();
+  virtual bool UsesSeekIndex() {return true;}
   virtual int64_t Seek(int64_t iSeekTime);
   virtual int ReadPCM(BYTE *pBuffer, int size, int *actualsize);
   virtual bool CanInit();
@@ -55,5 +56,7 @@ private:
   int m_BufferSize;                   //  size of buffer is filled with decoded audio data
   int m_MaxFrameSize;                 //  size of a single decoded frame
   FLAC__StreamDecoder* m_pFlacDecoder;
+  bool m_indexing;                    //  decoding is contiguous from the start, add frames to m_seekIndex
+  uint64_t m_seekTarget;              //  drop decoded samples before this one after a seek through the index
   CAEChannelInfo m_ChannelInfo;
 };
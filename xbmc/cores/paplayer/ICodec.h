@@ -22,6 +22,7 @@
  */
 
 #include "ReplayGain.h"
+#include "SeekIndex.h"
 #include "utils/StdString.h"
 #include "filesystem/File.h"
 
@@ -64,6 +65,12 @@ public:
 
   virtual bool CanSeek() {return true;}
 
+  // UsesSeekIndex()
+  // Should return true if the codec fills in m_seekIndex while decoding and
+  // uses it in Seek(). A complete index is stored in the music database and
+  // handed back to the codec (after Init()) the next time the file is played.
+  virtual bool UsesSeekIndex() {return false;}
+
   // Seek()
   // Should seek to the appropriate time (in ms) in the file, and return the
   // time to which we managed to seek (in the case where seeking is problematic)
@@ -104,6 +111,7 @@ public:
   int m_Bitrate;
   CStdString m_CodecName;
   CReplayGain m_replayGain;
+  CSeekIndex m_seekIndex;
   XFILE::CFile m_file;
 
 protected:
@@ -39,6 +39,10 @@ using namespace MUSIC_INFO;
 #define BITSPERSAMPLE     32
 #define OUTPUTFRAMESIZE   (SAMPLESPERFRAME * CHANNELSPERSAMPLE * (BITSPERSAMPLE >> 3))
 
+// seeks through the index start this many samples early, so the frames lost to
+// the bit reservoir and the decoder flush fall before the target
+#define SEEK_PREROLL      (4 * SAMPLESPERFRAME)
+
 MP3Codec::MP3Codec()
 {
   m_SampleRate = 0;
@@ -51,6 +55,8 @@ MP3Codec::MP3Codec()
   // mp3 related
   m_CallAgainWithSameBuffer = false;
   m_lastByteOffset = 0;
+  m_samplePos = 0;
+  m_seekTarget = -1;
   m_InputBufferSize = 64*1024;         // 64k is a reasonable amount, considering that we actual are
                                        // using a background reader thread now that caches in advance.
   m_InputBuffer = new BYTE[m_InputBufferSize];
@@ -111,6 +117,9 @@ bool MP3Codec::Init(const CStdString &strFile, unsigned int filecache)
   m_IgnoredBytes = 0;
   m_IgnoreLast = true;
   m_lastByteOffset = 0;
+  m_samplePos = 0;
+  m_seekTarget = -1;
+  m_seekIndex.Reset(0);
   m_eof = false;
   m_CallAgainWithSameBuffer = false;
   m_readRetries = 5;
@@ -203,10 +212,31 @@ void MP3Codec::FlushDecoder()
 
 int64_t MP3Codec::Seek(int64_t iSeekTime)
 {
+  // the index counts decoded samples, which includes the gapless start delay
+  int64_t sample = iSeekTime * m_SampleRate / 1000;
+  if (m_seekInfo.GetFirstSample())
+    sample += DECODER_DELAY + m_seekInfo.GetFirstSample();
+
+  // if we know a frame shortly before the target, start there and decode up to it
+  CSeekIndex::Point point;
+  if (m_seekIndex.Lookup(std::max<int64_t>(sample - SEEK_PREROLL, 0), point))
+  {
+    m_lastByteOffset = point.offset;
+    m_file.Seek(m_lastByteOffset, SEEK_SET);
+    FlushDecoder();
+    m_samplePos = point.sample;
+    m_seekTarget = sample;
+    m_IgnoreFirst = false;
+    m_IgnoredBytes = 0;
+    return iSeekTime;
+  }
+
   // calculate our offset to seek to in the file
   m_lastByteOffset = m_seekInfo.GetByteOffset(0.001f * iSeekTime);
   m_file.Seek(m_lastByteOffset, SEEK_SET);
   FlushDecoder();
+  m_samplePos = -1;
+  m_seekTarget = -1;
   return iSeekTime;
 }
 
@@ -303,6 +333,21 @@ int MP3Codec::Read(int size, bool init)
           }
         }
 
+        // after a seek through the index drop what was decoded before the target
+        if (m_seekTarget >= 0 && outputsize)
+        {
+          int frameSize = m_Channels * (m_BitsPerSample >> 3);
+          int64_t start = m_samplePos - outputsize / frameSize;
+          if (start < m_seekTarget)
+          {
+            int skip = (int)std::min<int64_t>(m_seekTarget - start, outputsize / frameSize) * frameSize;
+            memmove(m_OutputBuffer + m_OutputBufferPos, m_OutputBuffer + m_OutputBufferPos + skip, outputsize - skip);
+            outputsize -= skip;
+          }
+          if (m_samplePos >= m_seekTarget)
+            m_seekTarget = -1;
+        }
+
         // Do we still have data in the buffer to decode?
         if ( result == DECODING_CALLAGAIN )
           m_CallAgainWithSameBuffer = true;
@@ -358,7 +403,11 @@ int MP3Codec::ReadPCM(BYTE *pBuffer, int size, int *actualsize)
 
   // only return READ_EOF when we've reached the end of the mp3 file, we've finished decoding, and our output buffer is depleated.
   if (m_eof && !m_Decoding && !m_OutputBufferPos)
+  {
+    if (m_samplePos >= 0)
+      m_seekIndex.SetComplete(m_samplePos);
     return READ_EOF;
+  }
 
   return READ_SUCCESS;
 }
@@ -406,11 +455,14 @@ int MP3Codec::Decode(int *out_len)
       {
         if (m_dll.mad_frame_decode(&mxhouse.frame, &mxhouse.stream) == 0)
         {
+          AdvanceSamplePos();
           if (--skip == 0)
             m_dll.mad_synth_frame(&mxhouse.synth, &mxhouse.frame);
         }
         else if (!MAD_RECOVERABLE(mxhouse.stream.error))
           break;
+        else if (mxhouse.stream.error == MAD_ERROR_BADDATAPTR)
+          AdvanceSamplePos();
       }
       while (skip);
       mxstat.flushed = false;
@@ -509,9 +561,21 @@ madx_sig MP3Codec::madx_read(madx_house *mxhouse, madx_stat *mxstat, int maxwrit
         return(ERROR_OCCURED); 
       }
     }
+    // the frame is there but its bit reservoir isn't, as after a seek
+    if (mxhouse->stream.error == MAD_ERROR_BADDATAPTR)
+      AdvanceSamplePos();
     return(SKIP_FRAME); 
   }
 
+  // index the frame, the input buffer holds the data up to the current file position
+  if (m_samplePos >= 0)
+  {
+    if (m_seekIndex.IsEmpty())
+      m_seekIndex.Reset(mxhouse->frame.header.samplerate);
+    m_seekIndex.Add(m_samplePos, m_file.GetPosition() - m_InputBufferPos + (mxhouse->stream.this_frame - m_InputBuffer));
+  }
+  AdvanceSamplePos();
+
   m_dll.mad_synth_frame( &mxhouse->synth, &mxhouse->frame );
   
   mxstat->framepcmsize = mxhouse->synth.pcm.length * mxhouse->synth.pcm.channels * (int)(BITSPERSAMPLE >> 3);
@@ -536,6 +600,12 @@ madx_sig MP3Codec::madx_read(madx_house *mxhouse, madx_stat *mxstat, int maxwrit
   return(FLUSH_BUFFER);
 }
 
+void MP3Codec::AdvanceSamplePos()
+{
+  if (m_samplePos >= 0)
+    m_samplePos += 32 * MAD_NSBSAMPLES(&mxhouse.frame.header);
+}
+
 void MP3Codec::madx_deinit( madx_house *mxhouse )
 {
   if (!m_dll.IsLoaded())
@@ -59,6 +59,7 @@ public:
   virtual bool Init(const CStdString &strFile, unsigned int filecache);
   virtual void DeInit();
   virtual bool CanSeek();
+  virtual bool UsesSeekIndex() {return true;}
   virtual int64_t Seek(int64_t iSeekTime);
   virtual int ReadPCM(BYTE *pBuffer, int size, int *actualsize);
   virtual bool CanInit();
@@ -77,6 +78,7 @@ private:
 
   void OnFileReaderClearEvent();
   void FlushDecoder();
+  void AdvanceSamplePos();
   int Read(int size, bool init = false);
 
   /* TODO decoder vars */
@@ -112,6 +114,8 @@ private:
 
   // Seeking helpers
   MUSIC_INFO::CVBRMP3SeekHelper m_seekInfo;
+  int64_t m_samplePos;    // sample position of the next frame, -1 after a seek by bitrate
+  int64_t m_seekTarget;   // drop decoded samples before this one after a seek through the index
 
   // Gapless playback
   bool m_IgnoreFirst;     // Ignore first samples if this is true (for gapless playback)
@@ -31,6 +31,8 @@
 #include "utils/MathUtils.h"
 
 #include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "utils/JobManager.h"
 #include "cores/AudioEngine/AEFactory.h"
 #include "cores/AudioEngine/Utils/AEUtil.h"
 #include "cores/AudioEngine/Interfaces/AEStream.h"
@@ -60,13 +62,17 @@ PAPlayer::PAPlayer(IPlayerCallback& callback) :
   m_upcomingCrossfadeMS(0),
   m_currentStream      (NULL ),
   m_audioCallback      (NULL ),
-  m_FileItem           (new CFileItem())
+  m_FileItem           (new CFileItem()),
+  m_queueJobID         (0    ),
+  m_transitionTime     (0    ),
+  m_transitions        (0    )
 {
   m_playerGUIData.m_codec[20] = 0;
 }
 
 PAPlayer::~PAPlayer()
 {
+  CancelQueuedFile();
   if (!m_isPaused)
     SoftStop(true, true);
   CloseAllStreams(false);
@@ -230,6 +236,9 @@ void PAPlayer::CloseAllStreams(bool fade/* = true */)
 
 bool PAPlayer::OpenFile(const CFileItem& file, const CPlayerOptions &options)
 {
+  /* the file being opened replaces whatever was queued */
+  CancelQueuedFile();
+
   m_defaultCrossfadeMS = g_guiSettings.GetInt("musicplayer.crossfade") * 1000;
 
   if (m_streams.size() > 1 || !m_defaultCrossfadeMS || m_isPaused)
@@ -287,7 +296,126 @@ void PAPlayer::UpdateCrossfadeTime(const CFileItem& file)
 
 bool PAPlayer::QueueNextFile(const CFileItem &file)
 {
-  return QueueNextFileEx(file);
+  /*
+    open and decode the file ahead on a job worker so slow sources don't
+    stall the caller or the transition, the player thread adds the stream
+    once it is ready
+  */
+  CancelQueuedFile();
+
+  CSingleLock lock(m_queueSection);
+  m_queued.reset(new CQueuedFile(file, true));
+  m_queueJobID = CJobManager::GetInstance().AddJob(new CQueueNextFileJob(m_queued), NULL, CJob::PRIORITY_HIGH);
+  return true;
+}
+
+void PAPlayer::CancelQueuedFile()
+{
+  CSingleLock lock(m_queueSection);
+  if (m_queueJobID)
+    CJobManager::GetInstance().CancelJob(m_queueJobID);
+  m_queueJobID = 0;
+
+  if (m_queued)
+  {
+    /* a running job sees the flag and drops its stream when it finishes */
+    CSingleLock queuedLock(m_queued->m_section);
+    m_queued->m_cancelled = true;
+  }
+  m_queued.reset();
+}
+
+void PAPlayer::ProcessQueuedFile()
+{
+  CSingleLock lock(m_queueSection);
+  if (!m_queued)
+    return;
+
+  CQueuedFilePtr queued = m_queued;
+  StreamInfo *si;
+  {
+    CSingleLock queuedLock(queued->m_section);
+    if (!queued->m_done)
+      return;
+    si = queued->m_si;
+    queued->m_si = NULL;
+  }
+  m_queued.reset();
+  m_queueJobID = 0;
+  lock.Leave();
+
+  if (!si)
+  {
+    CLog::Log(LOGWARNING, "PAPlayer::ProcessQueuedFile - Failed to queue %s", queued->m_file->GetPath().c_str());
+    m_callback.OnQueueNextItem();
+    return;
+  }
+
+  AddStream(si, *queued->m_file, queued->m_fadeIn);
+}
+
+PAPlayer::CQueuedFile::CQueuedFile(const CFileItem &file, bool fadeIn) :
+  m_file     (new CFileItem(file)),
+  m_fadeIn   (fadeIn),
+  m_done     (false),
+  m_cancelled(false),
+  m_si       (NULL)
+{
+}
+
+PAPlayer::CQueuedFile::~CQueuedFile()
+{
+  /* the stream was never handed to the player */
+  if (m_si)
+  {
+    m_si->m_decoder.Destroy();
+    delete m_si;
+  }
+  delete m_file;
+}
+
+bool PAPlayer::CQueueNextFileJob::IsCancelled() const
+{
+  CSingleLock lock(m_queued->m_section);
+  return m_queued->m_cancelled;
+}
+
+bool PAPlayer::CQueueNextFileJob::DoWork()
+{
+  const CFileItem &file = *m_queued->m_file;
+  StreamInfo *si = new StreamInfo();
+  bool success = si->m_decoder.Create(file, (file.m_lStartOffset * 1000) / 75);
+  if (!success)
+    CLog::Log(LOGWARNING, "PAPlayer::CQueueNextFileJob::DoWork - Failed to create the decoder");
+  else
+  {
+    /* decode ahead until the pcm buffer is full or the file ends */
+    si->m_decoder.Start();
+    while(success && si->m_decoder.GetStatus() == STATUS_QUEUING && !IsCancelled())
+    {
+      int ret = si->m_decoder.ReadSamples(PACKET_SIZE);
+      if (ret == RET_ERROR)
+      {
+        CLog::Log(LOGINFO, "PAPlayer::CQueueNextFileJob::DoWork - Error reading samples");
+        success = false;
+      }
+      else if (ret == RET_SLEEP)
+        ::Sleep(1);
+    }
+    success = success && si->m_decoder.GetStatus() != STATUS_NO_FILE;
+  }
+
+  /* hand the stream over, the player thread picks it up */
+  CSingleLock lock(m_queued->m_section);
+  if (!success || m_queued->m_cancelled)
+  {
+    si->m_decoder.Destroy();
+    delete si;
+    si = NULL;
+  }
+  m_queued->m_si   = si;
+  m_queued->m_done = true;
+  return success;
 }
 
 bool PAPlayer::QueueNextFileEx(const CFileItem &file, bool fadeIn/* = true */)
@@ -324,6 +452,12 @@ bool PAPlayer::QueueNextFileEx(const CFileItem &file, bool fadeIn/* = true */)
     CThread::Sleep(1);
   }
 
+  AddStream(si, file, fadeIn);
+  return true;
+}
+
+void PAPlayer::AddStream(StreamInfo *si, const CFileItem &file, bool fadeIn)
+{
   UpdateCrossfadeTime(file);
 
   /* init the streaminfo struct */
@@ -341,6 +475,9 @@ bool PAPlayer::QueueNextFileEx(const CFileItem &file, bool fadeIn/* = true */)
   si->m_volume             = (fadeIn && m_upcomingCrossfadeMS) ? 0.0f : 1.0f;
   si->m_fadeOutTriggered   = false;
   si->m_isSlaved           = false;
+  si->m_readyTime          = XbmcThreads::SystemClockMillis();
+  si->m_underruns          = 0;
+  si->m_underrun           = false;
 
   int64_t streamTotalTime = si->m_decoder.TotalTime();
   if (si->m_endOffset)
@@ -364,8 +501,6 @@ bool PAPlayer::QueueNextFileEx(const CFileItem &file, bool fadeIn/* = true */)
   UpdateStreamInfoPlayNextAtFrame(m_currentStream, m_upcomingCrossfadeMS);
 
   *m_FileItem = file;
-
-  return true;
 }
 
 void PAPlayer::UpdateStreamInfoPlayNextAtFrame(StreamInfo *si, unsigned int crossFadingTime)
@@ -462,6 +597,9 @@ void PAPlayer::Process()
       m_signalSpeedChange = false;
     }
 
+    /* add the stream the queue job prepared on our own thread */
+    ProcessQueuedFile();
+
     double delay  = 100.0;
     double buffer = 100.0;
     ProcessStreams(delay, buffer);
@@ -535,6 +673,10 @@ inline void PAPlayer::ProcessStreams(double &delay, double &buffer)
             si->m_prepareTriggered = true;
           }
           m_currentStream = NULL;
+
+          /* nothing is ready to follow, remember when so we can tell how late the next stream is */
+          if (!m_isFinished)
+            m_transitionTime = XbmcThreads::SystemClockMillis();
         }
         else
         {
@@ -543,6 +685,8 @@ inline void PAPlayer::ProcessStreams(double &delay, double &buffer)
         }
       }
 
+      CLog::Log(LOGDEBUG, "PAPlayer::ProcessStreams - Stream finishing after %u underruns", si->m_underruns);
+
       /* unregister the audio callback */
       si->m_stream->UnRegisterAudioCallback();
       si->m_decoder.Destroy();      
@@ -599,6 +743,15 @@ inline bool PAPlayer::ProcessStream(StreamInfo *si, double &delay, double &buffe
       si->m_stream->Resume();
     si->m_stream->FadeVolume(0.0f, 1.0f, m_upcomingCrossfadeMS);
     m_callback.OnPlayBackStarted();
+
+    /* report how well the stream was prepared for the transition */
+    unsigned int now = XbmcThreads::SystemClockMillis();
+    if (m_transitionTime)
+      CLog::Log(LOGWARNING, "PAPlayer::ProcessStream - Transition %u: next stream started %u ms late", m_transitions, now - m_transitionTime);
+    else if (m_transitions)
+      CLog::Log(LOGDEBUG, "PAPlayer::ProcessStream - Transition %u: next stream was ready %u ms ahead", m_transitions, now - si->m_readyTime);
+    m_transitionTime = 0;
+    ++m_transitions;
   }
 
   /* if we have not started yet and the stream has been primed */
@@ -655,9 +808,21 @@ inline bool PAPlayer::ProcessStream(StreamInfo *si, double &delay, double &buffe
   if (si->m_started)
   {
     if (si->m_stream->IsBuffering())
+    {
       delay = 0.0;
+
+      /* count each time the stream runs dry, not every pass while it refills */
+      if (!si->m_underrun)
+      {
+        si->m_underrun = true;
+        ++si->m_underruns;
+      }
+    }
     else
+    {
+      si->m_underrun = false;
       delay = std::min(delay , si->m_stream->GetDelay());
+    }
     buffer = std::min(buffer, si->m_stream->GetCacheTotal());
   }
 
@@ -22,11 +22,14 @@
  */
 
 #include <list>
+#include <boost/shared_ptr.hpp>
 
 #include "cores/IPlayer.h"
 #include "threads/Thread.h"
 #include "AudioDecoder.h"
 #include "threads/SharedSection.h"
+#include "threads/CriticalSection.h"
+#include "utils/Job.h"
 
 #include "cores/IAudioCallback.h"
 #include "cores/AudioEngine/Utils/AEChannelInfo.h"
@@ -120,8 +123,44 @@ private:
     float             m_volume;              /* the initial volume level to set the stream to on creation */
 
     bool              m_isSlaved;            /* true if the stream has been slaved to another */
+
+    unsigned int      m_readyTime;           /* when the stream was ready to play */
+    unsigned int      m_underruns;           /* number of times the stream ran dry while playing */
+    bool              m_underrun;            /* true while the stream is refilling after an underrun */
   } StreamInfo;
 
+  /*
+    the next queued file, shared between the player and the job decoding it
+    so the job never has to call back into a player that may be gone
+  */
+  class CQueuedFile
+  {
+  public:
+    CQueuedFile(const CFileItem &file, bool fadeIn);
+    ~CQueuedFile();
+
+    CCriticalSection m_section;              /* lock for the state below */
+    CFileItem*  m_file;
+    bool        m_fadeIn;
+    bool        m_done;                      /* true once the job has finished */
+    bool        m_cancelled;                 /* true if the player no longer wants the stream */
+    StreamInfo* m_si;                        /* the decoded stream, NULL if it failed, owned until taken */
+  };
+  typedef boost::shared_ptr<CQueuedFile> CQueuedFilePtr;
+
+  /* opens and decodes ahead the next queued file on a job worker */
+  class CQueueNextFileJob : public CJob
+  {
+  public:
+    CQueueNextFileJob(const CQueuedFilePtr &queued) : m_queued(queued) {}
+    virtual bool DoWork();
+    virtual const char *GetType() const { return "paplayerqueue"; };
+
+  private:
+    bool IsCancelled() const;
+    CQueuedFilePtr m_queued;
+  };
+
   typedef std::list<StreamInfo*> StreamList;
 
   bool                m_signalSpeedChange;   /* true if OnPlaybackSpeedChange needs to be called */
@@ -141,7 +180,16 @@ private:
   StreamList          m_streams;             /* playing streams */  
   StreamList          m_finishing;           /* finishing streams */
 
+  CCriticalSection    m_queueSection;        /* lock for the queue job */
+  unsigned int        m_queueJobID;          /* the job opening the next file, 0 if none */
+  CQueuedFilePtr      m_queued;              /* the file the queue job is opening */
+  unsigned int        m_transitionTime;      /* when the last stream ran out with nothing ready to follow */
+  unsigned int        m_transitions;         /* number of track transitions */
+
   bool QueueNextFileEx(const CFileItem &file, bool fadeIn = true);
+  void CancelQueuedFile();
+  void ProcessQueuedFile();
+  void AddStream(StreamInfo *si, const CFileItem &file, bool fadeIn);
   void SoftStart(bool wait = false);
   void SoftStop(bool wait = false, bool close = true);
   void CloseAllStreams(bool fade = true);
@@ -0,0 +1,152 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+
+#include "system.h"
+#include "SeekIndex.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+/* bump when the serialized layout changes, older entries are then rebuilt */
+#define SEEK_INDEX_VERSION 1
+
+CSeekIndex::CSeekIndex()
+{
+  Reset(0);
+}
+
+void CSeekIndex::Reset(unsigned int interval)
+{
+  m_points.clear();
+  m_interval     = interval;
+  m_totalSamples = 0;
+  m_complete     = false;
+}
+
+void CSeekIndex::Add(uint64_t sample, int64_t offset)
+{
+  if (m_complete)
+    return;
+
+  if (!m_points.empty() && sample < m_points.back().sample + m_interval)
+    return;
+
+  Point point;
+  point.sample = sample;
+  point.offset = offset;
+  m_points.push_back(point);
+}
+
+void CSeekIndex::SetComplete(uint64_t totalSamples)
+{
+  if (m_points.empty() || m_complete)
+    return;
+
+  m_totalSamples = totalSamples;
+  m_complete     = true;
+}
+
+bool CSeekIndex::Lookup(uint64_t sample, Point &point) const
+{
+  if (m_points.empty())
+    return false;
+
+  /* past the last point we only know the file is contiguous up to the next interval */
+  if (!m_complete && sample >= m_points.back().sample + m_interval)
+    return false;
+
+  if (m_complete && sample > m_totalSamples)
+    sample = m_totalSamples;
+
+  /* the last point at or before sample */
+  size_t lo = 0, hi = m_points.size();
+  while (hi - lo > 1)
+  {
+    size_t mid = (lo + hi) / 2;
+    if (m_points[mid].sample <= sample)
+      lo = mid;
+    else
+      hi = mid;
+  }
+
+  if (m_points[lo].sample > sample)
+    return false;
+
+  point = m_points[lo];
+  return true;
+}
+
+CStdString CSeekIndex::Serialize() const
+{
+  /* version;interval;total;then the distance to the previous point for every point */
+  CStdString data;
+  data.Format("%i;%u;%"PRIu64, SEEK_INDEX_VERSION, m_interval, m_totalSamples);
+
+  uint64_t sample = 0;
+  int64_t  offset = 0;
+  CStdString point;
+  for (std::vector<Point>::const_iterator it = m_points.begin(); it != m_points.end(); ++it)
+  {
+    point.Format(";%"PRIu64",%"PRId64, it->sample - sample, it->offset - offset);
+    data += point;
+    sample = it->sample;
+    offset = it->offset;
+  }
+
+  return data;
+}
+
+bool CSeekIndex::Deserialize(const CStdString &data)
+{
+  Reset(0);
+
+  const char *pos = data.c_str();
+  char *end;
+  if (strtol(pos, &end, 10) != SEEK_INDEX_VERSION || *end != ';')
+    return false;
+
+  m_interval = strtoul(end + 1, &end, 10);
+  if (*end != ';')
+    return false;
+  m_totalSamples = (uint64_t)strtoll(end + 1, &end, 10);
+
+  Point point;
+  point.sample = 0;
+  point.offset = 0;
+  while (*end == ';')
+  {
+    point.sample += (uint64_t)strtoll(end + 1, &end, 10);
+    if (*end != ',')
+      break;
+    point.offset += strtoll(end + 1, &end, 10);
+    m_points.push_back(point);
+  }
+
+  if (*end != '\0' || m_points.empty())
+  {
+    Reset(0);
+    return false;
+  }
+
+  /* only complete indexes are stored */
+  m_complete = true;
+  return true;
+}
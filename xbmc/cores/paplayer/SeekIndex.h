@@ -0,0 +1,80 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+
+#include <stdint.h>
+#include <vector>
+#include "utils/StdString.h"
+
+/*!
+ \brief Frame boundaries of a file, recorded while it is decoded.
+
+ Codecs add a point (the sample position and byte offset of a frame start)
+ roughly every interval samples while they decode from the start of the
+ file. Seek then jumps to the last point before the target and decodes
+ forward from there instead of bisecting or guessing from the bitrate. Once
+ decoding reaches the end of the file the index is complete and may be
+ stored in the music database so later plays can seek straight away.
+ */
+class CSeekIndex
+{
+public:
+  struct Point
+  {
+    uint64_t sample;  // first sample of the frame, per channel
+    int64_t  offset;  // byte offset of the frame in the file
+  };
+
+  CSeekIndex();
+
+  /*! \brief Drop all points and start a new index
+   \param interval the minimum distance in samples between two points
+   */
+  void Reset(unsigned int interval);
+
+  /*! \brief Record a frame boundary
+   Points must come in decode order and decoding must have been contiguous
+   since the previous point, boundaries closer than the interval are ignored.
+   */
+  void Add(uint64_t sample, int64_t offset);
+
+  /*! \brief Mark the index as covering the whole file */
+  void SetComplete(uint64_t totalSamples);
+
+  /*! \brief Find the point to start decoding from to reach sample
+   \return false if sample lies beyond the part of the file the index covers
+   */
+  bool Lookup(uint64_t sample, Point &point) const;
+
+  bool IsEmpty() const    { return m_points.empty(); }
+  bool IsComplete() const { return m_complete; }
+
+  CStdString Serialize() const;
+  bool Deserialize(const CStdString &data);
+
+private:
+  std::vector<Point> m_points;
+  unsigned int       m_interval;
+  uint64_t           m_totalSamples;
+  bool               m_complete;
+};
@@ -29,6 +29,8 @@
 #include "threads/SingleLock.h"
 #include "utils/TimeUtils.h"
 #include "SpecialProtocol.h"
+
+#include <algorithm>
 #ifdef _WIN32
 #include "PlatformDefs.h" //for PRIdS, PRId64
 #endif
@@ -253,4 +255,184 @@ void CSimpleFileCache::EndOfInput()
   m_hDataAvailEvent->Set();
 }
 
+bool CSimpleFileCache::IsCachedPosition(int64_t iFilePosition)
+{
+  return iFilePosition >= m_nStartPosition && iFilePosition <= m_nStartPosition + m_nWritePosition;
+}
+
+int64_t CSimpleFileCache::CachedDataEndPos()
+{
+  return m_nStartPosition + m_nWritePosition;
+}
+
+CCacheStrategy *CSimpleFileCache::CreateNew()
+{
+  return new CSimpleFileCache();
+}
+
+CMultiRangeCache::CMultiRangeCache(CCacheStrategy *impl, unsigned int maxRanges)
+  : m_current(0)
+  , m_maxRanges(std::max(maxRanges, 1u))
+  , m_useCounter(0)
+  , m_rangeHits(0)
+  , m_rangeMisses(0)
+{
+  m_ranges.push_back(impl);
+  m_lastUse.push_back(0);
+}
+
+CMultiRangeCache::~CMultiRangeCache()
+{
+  Close();
+  for (std::vector<CCacheStrategy*>::iterator it = m_ranges.begin(); it != m_ranges.end(); ++it)
+    delete *it;
+}
+
+CCacheStrategy *CMultiRangeCache::GetCurrent()
+{
+  CSingleLock lock(m_sync);
+  return m_ranges[m_current];
+}
+
+int CMultiRangeCache::Open()
+{
+  CSingleLock lock(m_sync);
+
+  // extra ranges are only created once the file is seeked
+  while (m_ranges.size() > 1)
+  {
+    delete m_ranges.back();
+    m_ranges.pop_back();
+    m_lastUse.pop_back();
+  }
+  m_current = 0;
+  m_rangeHits = 0;
+  m_rangeMisses = 0;
+  ClearEndOfInput();
+
+  return m_ranges[0]->Open();
+}
+
+void CMultiRangeCache::Close()
+{
+  CSingleLock lock(m_sync);
+  for (std::vector<CCacheStrategy*>::iterator it = m_ranges.begin(); it != m_ranges.end(); ++it)
+    (*it)->Close();
+}
+
+int CMultiRangeCache::WriteToCache(const char *pBuffer, size_t iSize)
+{
+  return GetCurrent()->WriteToCache(pBuffer, iSize);
+}
+
+int CMultiRangeCache::ReadFromCache(char *pBuffer, size_t iMaxSize)
+{
+  int iRead = GetCurrent()->ReadFromCache(pBuffer, iMaxSize);
+  if (iRead > 0)
+    m_space.Set();
+  return iRead;
+}
+
+int64_t CMultiRangeCache::WaitForData(unsigned int iMinAvail, unsigned int iMillis)
+{
+  return GetCurrent()->WaitForData(iMinAvail, iMillis);
+}
+
+int64_t CMultiRangeCache::Seek(int64_t iFilePosition)
+{
+  // other ranges are only switched to on Reset, as the source has to follow
+  return GetCurrent()->Seek(iFilePosition);
+}
+
+int CMultiRangeCache::FindRange(int64_t iFilePosition)
+{
+  // prefer the range that holds the most data past the position
+  int found = -1;
+  for (unsigned int i = 0; i < m_ranges.size(); i++)
+  {
+    if (m_ranges[i]->IsCachedPosition(iFilePosition)
+    && (found < 0 || m_ranges[i]->CachedDataEndPos() > m_ranges[found]->CachedDataEndPos()))
+      found = i;
+  }
+  return found;
+}
+
+void CMultiRangeCache::Reset(int64_t iSourcePosition)
+{
+  CSingleLock lock(m_sync);
+
+  int range = FindRange(iSourcePosition);
+  if (range >= 0)
+  {
+    m_current = range;
+    m_lastUse[m_current] = ++m_useCounter;
+    m_ranges[m_current]->Seek(iSourcePosition);
+    m_rangeHits++;
+    return;
+  }
+
+  m_rangeMisses++;
+  if (m_ranges.size() < m_maxRanges)
+  {
+    CCacheStrategy *cache = m_ranges[0]->CreateNew();
+    if (cache && cache->Open() == CACHE_RC_OK)
+    {
+      m_ranges.push_back(cache);
+      m_lastUse.push_back(0);
+      m_current = m_ranges.size() - 1;
+      m_lastUse[m_current] = ++m_useCounter;
+      cache->Reset(iSourcePosition);
+      return;
+    }
+    delete cache;
+  }
+
+  // recycle the least recently used range
+  unsigned int oldest = 0;
+  for (unsigned int i = 1; i < m_ranges.size(); i++)
+  {
+    if (m_lastUse[i] < m_lastUse[oldest])
+      oldest = i;
+  }
+  m_current = oldest;
+  m_lastUse[m_current] = ++m_useCounter;
+  m_ranges[m_current]->ClearEndOfInput();
+  m_ranges[m_current]->Reset(iSourcePosition);
+}
+
+void CMultiRangeCache::EndOfInput()
+{
+  GetCurrent()->EndOfInput();
+}
+
+bool CMultiRangeCache::IsEndOfInput()
+{
+  return GetCurrent()->IsEndOfInput();
+}
+
+void CMultiRangeCache::ClearEndOfInput()
+{
+  GetCurrent()->ClearEndOfInput();
+}
+
+bool CMultiRangeCache::IsCachedPosition(int64_t iFilePosition)
+{
+  CSingleLock lock(m_sync);
+  return FindRange(iFilePosition) >= 0;
+}
+
+int64_t CMultiRangeCache::CachedDataEndPos()
+{
+  return GetCurrent()->CachedDataEndPos();
+}
+
+int64_t CMultiRangeCache::CachedDataEndPosIfSeekTo(int64_t iFilePosition)
+{
+  CSingleLock lock(m_sync);
+  int range = FindRange(iFilePosition);
+  if (range >= 0)
+    return m_ranges[range]->CachedDataEndPos();
+  return iFilePosition;
+}
+
 }
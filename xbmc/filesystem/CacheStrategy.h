@@ -32,6 +32,8 @@
 #include "threads/CriticalSection.h"
 #include "threads/Event.h"
 
+#include <vector>
+
 namespace XFILE {
 
 #define CACHE_RC_OK  0
@@ -58,6 +60,13 @@ public:
   virtual bool IsEndOfInput();
   virtual void ClearEndOfInput();
 
+  virtual bool IsCachedPosition(int64_t iFilePosition) { return false; }
+  virtual int64_t CachedDataEndPos() { return -1; }
+  /* position the source has to continue from if the cache was reset to the given position */
+  virtual int64_t CachedDataEndPosIfSeekTo(int64_t iFilePosition) { return iFilePosition; }
+  /* a new, empty strategy of the same kind, NULL if not supported */
+  virtual CCacheStrategy *CreateNew() { return NULL; }
+
   CEvent m_space;
 protected:
   bool  m_bEndOfInput;
@@ -81,6 +90,10 @@ public:
   virtual void Reset(int64_t iSourcePosition);
   virtual void EndOfInput();
 
+  virtual bool IsCachedPosition(int64_t iFilePosition);
+  virtual int64_t CachedDataEndPos();
+  virtual CCacheStrategy *CreateNew();
+
   int64_t  GetAvailableRead();
 
 protected:
@@ -92,6 +105,54 @@ protected:
   volatile int64_t m_nReadPosition;
 };
 
+/**
+ * Keeps several independently cached ranges of a file (for instance the
+ * current play window, the index at the end and the header), so that a
+ * short excursion elsewhere in the file doesn't throw away the data cached
+ * around the play position.  Only one range (the current one) is read and
+ * written at a time; resetting to a position another range holds switches
+ * to that range, otherwise the least recently used range is recycled.
+ */
+class CMultiRangeCache : public CCacheStrategy {
+public:
+  CMultiRangeCache(CCacheStrategy *impl, unsigned int maxRanges);
+  virtual ~CMultiRangeCache();
+
+  virtual int Open();
+  virtual void Close();
+
+  virtual int WriteToCache(const char *pBuffer, size_t iSize);
+  virtual int ReadFromCache(char *pBuffer, size_t iMaxSize);
+  virtual int64_t WaitForData(unsigned int iMinAvail, unsigned int iMillis);
+
+  virtual int64_t Seek(int64_t iFilePosition);
+  virtual void Reset(int64_t iSourcePosition);
+
+  virtual void EndOfInput();
+  virtual bool IsEndOfInput();
+  virtual void ClearEndOfInput();
+
+  virtual bool IsCachedPosition(int64_t iFilePosition);
+  virtual int64_t CachedDataEndPos();
+  virtual int64_t CachedDataEndPosIfSeekTo(int64_t iFilePosition);
+
+  unsigned int GetRangeHits() const { return m_rangeHits; }
+  unsigned int GetRangeMisses() const { return m_rangeMisses; }
+
+protected:
+  CCacheStrategy *GetCurrent();
+  int FindRange(int64_t iFilePosition);
+
+  std::vector<CCacheStrategy*> m_ranges;
+  std::vector<unsigned int>    m_lastUse;
+  unsigned int     m_current;
+  unsigned int     m_maxRanges;
+  unsigned int     m_useCounter;
+  unsigned int     m_rangeHits;   ///< resets served by a range that already held the position
+  unsigned int     m_rangeMisses; ///< resets that had to start a new range
+  CCriticalSection m_sync;
+};
+
 }
 
 #endif
@@ -220,3 +220,19 @@ void CCircularCache::Reset(int64_t pos)
   m_cur = pos;
 }
 
+bool CCircularCache::IsCachedPosition(int64_t pos)
+{
+  CSingleLock lock(m_sync);
+  return (uint64_t)pos >= m_beg && (uint64_t)pos <= m_end;
+}
+
+int64_t CCircularCache::CachedDataEndPos()
+{
+  CSingleLock lock(m_sync);
+  return m_end;
+}
+
+CCacheStrategy *CCircularCache::CreateNew()
+{
+  return new CCircularCache(m_size - m_size_back, m_size_back);
+}
@@ -44,6 +44,10 @@ public:
     virtual int64_t Seek(int64_t pos) ;
     virtual void Reset(int64_t pos) ;
 
+    virtual bool IsCachedPosition(int64_t pos);
+    virtual int64_t CachedDataEndPos();
+    virtual CCacheStrategy *CreateNew();
+
 protected:
     uint64_t          m_beg;       /**< index in file (not buffer) of beginning of valid data */
     uint64_t          m_end;       /**< index in file (not buffer) of end of valid data */
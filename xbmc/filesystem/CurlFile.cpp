@@ -30,6 +30,7 @@
 
 #include <vector>
 #include <climits>
+#include <algorithm>
 
 #ifdef _LINUX
 #include <errno.h>
@@ -94,6 +95,24 @@ extern "C" size_t header_callback(void *ptr, size_t size, size_t nmemb, void *st
   return state->HeaderCallback(ptr, size, nmemb);
 }
 
+/* curl calls this routine with data for a segment in segmented mode */
+extern "C" size_t segment_write_callback(char *buffer,
+               size_t size,
+               size_t nitems,
+               void *userp)
+{
+  if(userp == NULL) return 0;
+
+  CCurlFile::CReadState::CSegment *segment = (CCurlFile::CReadState::CSegment *)userp;
+  return segment->WriteCallback(buffer, size, nitems);
+}
+
+/* headers of segments are of no interest, the main request already gave us those */
+extern "C" size_t segment_header_callback(void *ptr, size_t size, size_t nmemb, void *stream)
+{
+  return size * nmemb;
+}
+
 /* fix for silly behavior of realloc */
 static inline void* realloc_simple(void *ptr, size_t size)
 {
@@ -199,6 +218,11 @@ CCurlFile::CReadState::CReadState()
   m_cancelled = false;
   m_bFirstLoop = true;
   m_headerdone = false;
+  m_segmentCount = 0;
+  m_segmentSize = 0;
+  m_fetchPos = 0;
+  m_segmentsFetched = 0;
+  m_segmentSeeks = 0;
 }
 
 CCurlFile::CReadState::~CReadState()
@@ -246,6 +270,10 @@ bool CCurlFile::CReadState::Seek(int64_t pos)
     m_filePos = pos;
     return true;
   }
+
+  if(m_segmentCount)
+    return SeekSegments(pos);
+
   return false;
 }
 
@@ -285,7 +313,9 @@ long CCurlFile::CReadState::Connect(unsigned int size)
 
 void CCurlFile::CReadState::Disconnect()
 {
-  if(m_multiHandle && m_easyHandle)
+  if(m_segmentCount)
+    StopSegments();
+  else if(m_multiHandle && m_easyHandle)
     g_curlInterface.multi_remove_handle(m_multiHandle, m_easyHandle);
 
   m_buffer.Clear();
@@ -892,6 +922,13 @@ bool CCurlFile::Open(const CURL& url)
   if (CURLE_OK == g_curlInterface.easy_getinfo(m_state->m_easyHandle, CURLINFO_EFFECTIVE_URL,&efurl) && efurl)
     m_url = efurl;
 
+  // large files from servers that accept ranges can be fetched over several connections
+  if(m_seekable && m_multisession && g_advancedSettings.m_curlSegments > 1
+  && m_state->m_httpheader.GetValue("Accept-Ranges").Equals("bytes")
+  && m_state->m_fileSize > (int64_t)g_advancedSettings.m_curlSegmentSize * 2
+  && m_contentencoding.IsEmpty() && m_postdata.IsEmpty())
+    m_state->StartSegments(m_url, g_advancedSettings.m_curlSegments, g_advancedSettings.m_curlSegmentSize);
+
   return true;
 }
 
@@ -1200,6 +1237,9 @@ unsigned int CCurlFile::CReadState::Read(void* lpBuf, int64_t uiBufSize)
 /* use to attempt to fill the read buffer up to requested number of bytes */
 bool CCurlFile::CReadState::FillBuffer(unsigned int want)
 {
+  if (m_segmentCount)
+    return FillSegments(want);
+
   int retry=0;
   fd_set fdread;
   fd_set fdwrite;
@@ -1348,6 +1388,287 @@ bool CCurlFile::CReadState::FillBuffer(unsigned int want)
   return true;
 }
 
+CCurlFile::CReadState::CSegment::CSegment(int64_t start, int64_t end)
+{
+  m_easyHandle = NULL;
+  m_start = start;
+  m_end = end;
+  m_offset = 0;
+  m_done = false;
+  m_retries = 0;
+}
+
+size_t CCurlFile::CReadState::CSegment::WriteCallback(char *buffer, size_t size, size_t nitems)
+{
+  size_t amount = size * nitems;
+  if (m_data.empty())
+  {
+    // a server that ignores the range would hand us the wrong data
+    long response = 0;
+    g_curlInterface.easy_getinfo(m_easyHandle, CURLINFO_RESPONSE_CODE, &response);
+    if (response != 206)
+    {
+      CLog::Log(LOGERROR, "CCurlFile::CSegment - range request failed with response %ld", response);
+      return 0;
+    }
+  }
+
+  if ((int64_t)(m_data.size() + amount) > m_end - m_start)
+  {
+    CLog::Log(LOGERROR, "CCurlFile::CSegment - got more data than requested for range %"PRId64"-%"PRId64, m_start, m_end);
+    return 0;
+  }
+  m_data.insert(m_data.end(), buffer, buffer + amount);
+  return amount;
+}
+
+bool CCurlFile::CReadState::StartSegments(const CStdString &url, unsigned int count, unsigned int size)
+{
+  // the main request keeps running to the end of the file, so stop it. data it has
+  // already delivered stays in the read and overflow buffers and is read first.
+  if(m_multiHandle && m_easyHandle)
+    g_curlInterface.multi_remove_handle(m_multiHandle, m_easyHandle);
+
+  m_segmentUrl = url;
+  m_segmentCount = count;
+  m_segmentSize = size;
+  m_fetchPos = m_filePos + m_buffer.getMaxReadSize() + m_overflowSize;
+  m_segmentsFetched = 0;
+  m_segmentSeeks = 0;
+  m_stillRunning = 1;
+
+  CLog::Log(LOGDEBUG, "CCurlFile::StartSegments - fetching %s with %u segments of %u bytes", url.c_str(), count, size);
+  return true;
+}
+
+void CCurlFile::CReadState::StopSegments()
+{
+  while (!m_segments.empty())
+  {
+    ReleaseSegment(m_segments.front());
+    m_segments.pop_front();
+  }
+
+  for (std::vector<CURL_HANDLE*>::iterator it = m_segmentHandles.begin(); it != m_segmentHandles.end(); ++it)
+    g_curlInterface.easy_release(&(*it), NULL);
+  m_segmentHandles.clear();
+
+  CLog::Log(LOGDEBUG, "CCurlFile::StopSegments - fetched %u segments, %u seeks served from prefetched data", m_segmentsFetched, m_segmentSeeks);
+  m_segmentCount = 0;
+  m_stillRunning = 0;
+}
+
+bool CCurlFile::CReadState::QueueSegment(CSegment* segment)
+{
+  CURL_HANDLE* h;
+  if (!m_segmentHandles.empty())
+  {
+    h = m_segmentHandles.back();
+    m_segmentHandles.pop_back();
+  }
+  else
+  {
+    // copies all the options (headers, authentication, cookies...) of the main request
+    h = NULL;
+    g_curlInterface.easy_duplicate(m_easyHandle, NULL, &h, NULL);
+    if (!h)
+      return false;
+    g_curlInterface.easy_setopt(h, CURLOPT_URL, m_segmentUrl.c_str());
+    g_curlInterface.easy_setopt(h, CURLOPT_RESUME_FROM_LARGE, (curl_off_t)0);
+    g_curlInterface.easy_setopt(h, CURLOPT_WRITEFUNCTION, segment_write_callback);
+    g_curlInterface.easy_setopt(h, CURLOPT_HEADERFUNCTION, segment_header_callback);
+  }
+
+  CStdString range;
+  range.Format("%"PRId64"-%"PRId64, segment->m_start + (int64_t)segment->m_data.size(), segment->m_end - 1);
+  g_curlInterface.easy_setopt(h, CURLOPT_RANGE, range.c_str());
+  g_curlInterface.easy_setopt(h, CURLOPT_WRITEDATA, segment);
+
+  segment->m_easyHandle = h;
+  segment->m_done = false;
+  g_curlInterface.multi_add_handle(m_multiHandle, h);
+  return true;
+}
+
+void CCurlFile::CReadState::ReleaseSegment(CSegment* segment)
+{
+  if (segment->m_easyHandle)
+  {
+    // removing a running transfer closes its connection, finished ones stay cached by the multi handle
+    g_curlInterface.multi_remove_handle(m_multiHandle, segment->m_easyHandle);
+    m_segmentHandles.push_back(segment->m_easyHandle);
+    segment->m_easyHandle = NULL;
+  }
+  delete segment;
+}
+
+bool CCurlFile::CReadState::SeekSegments(int64_t pos)
+{
+  m_buffer.Clear();
+  free(m_overflowBuffer);
+  m_overflowBuffer = NULL;
+  m_overflowSize = 0;
+
+  // drop everything before the segment holding the new position
+  while (!m_segments.empty() && m_segments.front()->m_end <= pos)
+  {
+    ReleaseSegment(m_segments.front());
+    m_segments.pop_front();
+  }
+
+  if (!m_segments.empty() && m_segments.front()->m_start <= pos)
+  {
+    CSegment* segment = m_segments.front();
+    segment->m_offset = (size_t)(pos - segment->m_start);
+    m_segmentSeeks++;
+  }
+  else
+  { // nothing prefetched, restart the segments at the new position
+    while (!m_segments.empty())
+    {
+      ReleaseSegment(m_segments.front());
+      m_segments.pop_front();
+    }
+    m_fetchPos = pos;
+  }
+
+  m_filePos = pos;
+  m_stillRunning = 1;
+  return true;
+}
+
+bool CCurlFile::CReadState::FillSegments(unsigned int want)
+{
+  fd_set fdread;
+  fd_set fdwrite;
+  fd_set fdexcep;
+
+  while ((unsigned int)m_buffer.getMaxReadSize() < want && m_buffer.getMaxWriteSize() > 0)
+  {
+    if (m_cancelled)
+      return false;
+
+    /* data from the main request comes first */
+    if (m_overflowSize)
+    {
+      unsigned amount = XMIN((unsigned int)m_buffer.getMaxWriteSize(), m_overflowSize);
+      m_buffer.WriteData(m_overflowBuffer, amount);
+
+      if (amount < m_overflowSize)
+        memmove(m_overflowBuffer, m_overflowBuffer+amount,m_overflowSize-amount);
+
+      m_overflowSize -= amount;
+      continue;
+    }
+
+    /* keep the configured number of segments in flight ahead of the read position */
+    while (m_segments.size() < m_segmentCount && m_fetchPos < m_fileSize)
+    {
+      CSegment* segment = new CSegment(m_fetchPos, std::min(m_fetchPos + (int64_t)m_segmentSize, m_fileSize));
+      if (!QueueSegment(segment))
+      {
+        delete segment;
+        break;
+      }
+      m_segments.push_back(segment);
+      m_fetchPos = segment->m_end;
+    }
+
+    if (m_segments.empty())
+    {
+      if (m_fetchPos < m_fileSize)
+      { // nothing could be queued, don't let the reader take this for the end of file
+        CLog::Log(LOGERROR, "%s - failed to queue segment at %"PRId64", aborting", __FUNCTION__, m_fetchPos);
+        return false;
+      }
+      // end of file
+      m_stillRunning = 0;
+      return true;
+    }
+
+    /* move whatever the head segment has to the read buffer */
+    CSegment* head = m_segments.front();
+    if (head->m_offset < head->m_data.size())
+    {
+      unsigned int amount = XMIN((unsigned int)m_buffer.getMaxWriteSize(), (unsigned int)(head->m_data.size() - head->m_offset));
+      m_buffer.WriteData(&head->m_data[head->m_offset], amount);
+      head->m_offset += amount;
+      continue;
+    }
+
+    if (head->m_done && head->m_start + (int64_t)head->m_data.size() >= head->m_end)
+    {
+      ReleaseSegment(head);
+      m_segments.pop_front();
+      m_segmentsFetched++;
+      continue;
+    }
+
+    CURLMcode result = g_curlInterface.multi_perform(m_multiHandle, &m_stillRunning);
+    if (result == CURLM_CALL_MULTI_PERFORM)
+      continue;
+    if (result != CURLM_OK)
+    {
+      CLog::Log(LOGERROR, "%s - curl multi perform failed with code %d, aborting", __FUNCTION__, result);
+      return false;
+    }
+
+    int msgs;
+    CURLMsg* msg;
+    while ((msg = g_curlInterface.multi_info_read(m_multiHandle, &msgs)))
+    {
+      if (msg->msg != CURLMSG_DONE)
+        continue;
+
+      for (std::deque<CSegment*>::iterator it = m_segments.begin(); it != m_segments.end(); ++it)
+      {
+        CSegment* segment = *it;
+        if (segment->m_easyHandle != msg->easy_handle)
+          continue;
+
+        g_curlInterface.multi_remove_handle(m_multiHandle, segment->m_easyHandle);
+        segment->m_done = true;
+        if (msg->data.result != CURLE_OK || segment->m_start + (int64_t)segment->m_data.size() < segment->m_end)
+        {
+          CLog::Log(LOGWARNING, "%s: segment %"PRId64"-%"PRId64" failed with code %i", __FUNCTION__, segment->m_start, segment->m_end, msg->data.result);
+          if (msg->data.result == CURLE_WRITE_ERROR || ++segment->m_retries > g_advancedSettings.m_curlretries)
+            return false;
+
+          // resume the range from where it stopped
+          m_segmentHandles.push_back(segment->m_easyHandle);
+          segment->m_easyHandle = NULL;
+          if (!QueueSegment(segment))
+            return false;
+        }
+        break;
+      }
+    }
+
+    /* wait until data is available or a timeout occurs */
+    if (!head->m_done && head->m_offset >= head->m_data.size())
+    {
+      int maxfd = -1;
+      FD_ZERO(&fdread);
+      FD_ZERO(&fdwrite);
+      FD_ZERO(&fdexcep);
+
+      g_curlInterface.multi_fdset(m_multiHandle, &fdread, &fdwrite, &fdexcep, &maxfd);
+
+      long timeout = 0;
+      if (CURLM_OK != g_curlInterface.multi_timeout(m_multiHandle, &timeout) || timeout == -1)
+        timeout = 200;
+
+      struct timeval t = { timeout / 1000, (timeout % 1000) * 1000 };
+      if (SOCKET_ERROR == dllselect(maxfd + 1, &fdread, &fdwrite, &fdexcep, &t))
+      {
+        CLog::Log(LOGERROR, "%s - curl failed with socket error", __FUNCTION__);
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
 void CCurlFile::ClearRequestHeaders()
 {
   m_requestheaders.clear();
@@ -23,6 +23,8 @@
 #include "IFile.h"
 #include "utils/RingBuffer.h"
 #include <map>
+#include <deque>
+#include <vector>
 #include "utils/HttpHeader.h"
 
 namespace XCURL
@@ -117,6 +119,39 @@ namespace XFILE
 
           long         Connect(unsigned int size);
           void         Disconnect();
+
+          /* segmented mode, where the data is fetched with several concurrent range
+             requests on the multi handle, prefetching ahead of the read position */
+          class CSegment
+          {
+          public:
+            CSegment(int64_t start, int64_t end);
+            XCURL::CURL_HANDLE* m_easyHandle;
+            int64_t           m_start;    // first byte of the range
+            int64_t           m_end;      // one past the last byte of the range
+            std::vector<char> m_data;     // data received so far
+            size_t            m_offset;   // data already moved to the read buffer
+            bool              m_done;
+            int               m_retries;
+
+            size_t WriteCallback(char *buffer, size_t size, size_t nitems);
+          };
+
+          std::deque<CSegment*>            m_segments;       // in file order, head is being read
+          std::vector<XCURL::CURL_HANDLE*> m_segmentHandles; // idle handles, kept for connection reuse
+          unsigned int    m_segmentCount;     // concurrent segments, 0 if not segmented
+          unsigned int    m_segmentSize;
+          int64_t         m_fetchPos;         // start of the next segment to queue
+          CStdString      m_segmentUrl;
+          unsigned int    m_segmentsFetched;
+          unsigned int    m_segmentSeeks;     // seeks served from prefetched segments
+
+          bool         StartSegments(const CStdString &url, unsigned int count, unsigned int size);
+          void         StopSegments();
+          bool         FillSegments(unsigned int want);
+          bool         SeekSegments(int64_t pos);
+          bool         QueueSegment(CSegment* segment);
+          void         ReleaseSegment(CSegment* segment);
       };
 
     protected:
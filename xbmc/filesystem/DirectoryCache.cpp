@@ -20,19 +20,33 @@
  */
 
 #include "DirectoryCache.h"
+#include "File.h"
+#include "settings/AdvancedSettings.h"
 #include "settings/Settings.h"
 #include "FileItem.h"
 #include "threads/SingleLock.h"
+#include "utils/Archive.h"
+#include "utils/PersistentCacheFile.h"
 #include "utils/log.h"
 #include "utils/URIUtils.h"
 #include "climits"
 
+#include <algorithm>
+
 using namespace std;
 using namespace XFILE;
 
+#define PERSISTENT_CACHE_PATH     "special://temp/dircache/"
+#define PERSISTENT_CACHE_EXT      ".fi"
+#define PERSISTENT_CACHE_VERSION  1
+// listings of directories modified less than this many seconds ago aren't persisted,
+// as a change within the granularity of the modification time would go unnoticed.
+#define PERSISTENT_CACHE_MIN_AGE  2
+
 CDirectoryCache::CDir::CDir(DIR_CACHE_TYPE cacheType)
 {
   m_cacheType = cacheType;
+  m_persisted = false;
   m_lastAccess = 0;
   m_Items = new CFileItemList;
   m_Items->SetFastLookup(true);
@@ -51,6 +65,13 @@ void CDirectoryCache::CDir::SetLastAccess(unsigned int &accessCounter)
 CDirectoryCache::CDirectoryCache(void)
 {
   m_accessCounter = 0;
+  m_diskInitialized = false;
+  m_diskSize = 0;
+  m_diskHits = 0;
+  m_diskMisses = 0;
+  m_diskStale = 0;
+  m_diskWrites = 0;
+  m_diskEvictions = 0;
 #ifdef _DEBUG
   m_cacheHits = 0;
   m_cacheMisses = 0;
@@ -83,7 +104,22 @@ bool CDirectoryCache::GetDirectory(const CStdString& strPath, CFileItemList &ite
       return true;
     }
   }
-  return false;
+
+  // a persisted listing is as good as one cached once, so it's only for callers that
+  // accept those (DIR_FLAG_READ_CACHE)
+  if (!retrieveAll || !UsePersistentCache(storedPath))
+    return false;
+
+  int64_t modifiedTime = GetModifiedTime(storedPath);
+  if (!modifiedTime)
+  {
+    m_diskMisses++;
+    return false;
+  }
+
+  // don't hold the lock while we read from disk
+  lock.Leave();
+  return LoadPersistent(storedPath, modifiedTime, items);
 }
 
 void CDirectoryCache::SetDirectory(const CStdString& strPath, const CFileItemList &items, DIR_CACHE_TYPE cacheType)
@@ -107,11 +143,33 @@ void CDirectoryCache::SetDirectory(const CStdString& strPath, const CFileItemLis
   CStdString storedPath = URIUtils::SubstitutePath(strPath);
   URIUtils::RemoveSlashAtEnd(storedPath);
 
-  ClearDirectory(storedPath);
+  AddToCache(storedPath, items, cacheType, false);
+
+  if (!UsePersistentCache(storedPath))
+    return;
+
+  int64_t modifiedTime = GetModifiedTime(storedPath);
+  lock.Leave();
+
+  // without the time of the directory a persisted copy can't be validated, drop it
+  if (modifiedTime)
+    SavePersistent(storedPath, items, modifiedTime);
+  else
+    ClearPersistent(storedPath);
+}
+
+void CDirectoryCache::AddToCache(const CStdString& storedPath, const CFileItemList &items, DIR_CACHE_TYPE cacheType, bool persisted)
+{
+  CSingleLock lock (m_cs);
+
+  iCache i = m_cache.find(storedPath);
+  if (i != m_cache.end())
+    Delete(i);
 
   CheckIfFull();
 
   CDir* dir = new CDir(cacheType);
+  dir->m_persisted = persisted;
   dir->m_Items->Copy(items);
   dir->SetLastAccess(m_accessCounter);
   m_cache.insert(pair<CStdString, CDir*>(storedPath, dir));
@@ -134,6 +192,9 @@ void CDirectoryCache::ClearDirectory(const CStdString& strPath)
   iCache i = m_cache.find(storedPath);
   if (i != m_cache.end())
     Delete(i);
+  lock.Leave();
+
+  ClearPersistent(storedPath);
 }
 
 void CDirectoryCache::ClearSubPaths(const CStdString& strPath)
@@ -152,6 +213,9 @@ void CDirectoryCache::ClearSubPaths(const CStdString& strPath)
     else
       i++;
   }
+  lock.Leave();
+
+  ClearPersistentSubPaths(storedPath);
 }
 
 void CDirectoryCache::AddFile(const CStdString& strFile)
@@ -170,6 +234,10 @@ void CDirectoryCache::AddFile(const CStdString& strFile)
     dir->m_Items->Add(item);
     dir->SetLastAccess(m_accessCounter);
   }
+  lock.Leave();
+
+  // the persisted listing is now out of date
+  ClearPersistent(strPath);
 }
 
 bool CDirectoryCache::FileExists(const CStdString& strFile, bool& bInCache)
@@ -261,6 +329,273 @@ void CDirectoryCache::Delete(iCache it)
   m_cache.erase(it);
 }
 
+bool CDirectoryCache::UsePersistentCache(const CStdString& storedPath) const
+{
+  if (!g_advancedSettings.m_dirCacheDiskSize)
+    return false;
+
+  // only network shares that report a modified time for their directories are worth it
+  return URIUtils::IsSmb(storedPath) || URIUtils::IsNfs(storedPath) || URIUtils::IsAfp(storedPath);
+}
+
+int64_t CDirectoryCache::GetModifiedTime(const CStdString& storedPath) const
+{
+  // take the date of the folder from a listing of its parent rather than asking the
+  // server.  A persisted parent listing may predate changes to the folder, so only
+  // one fetched in this session will do.
+  CStdString parentPath = URIUtils::GetParentPath(storedPath);
+  URIUtils::RemoveSlashAtEnd(parentPath);
+  ciCache i = m_cache.find(parentPath);
+  if (i == m_cache.end() || i->second->m_persisted)
+    return 0;
+
+  CStdString folderPath(storedPath);
+  URIUtils::AddSlashAtEnd(folderPath);
+  CFileItemPtr folder = i->second->m_Items->Get(folderPath);
+  if (!folder || !folder->m_bIsFolder || !folder->m_dateTime.IsValid())
+    return 0;
+
+  time_t modifiedTime;
+  folder->m_dateTime.GetAsTime(modifiedTime);
+  return modifiedTime;
+}
+
+void CDirectoryCache::InitPersistent()
+{
+  {
+    CSingleLock lock (m_cs);
+    if (m_diskInitialized)
+      return;
+  }
+
+  // list the cache files before taking the lock, another thread may list them too
+  CFileItemList items;
+  bool listed = CDirectory::GetDirectory(PERSISTENT_CACHE_PATH, items, PERSISTENT_CACHE_EXT, DIR_FLAG_NO_FILE_DIRS | DIR_FLAG_BYPASS_CACHE);
+
+  CSingleLock lock (m_cs);
+  if (m_diskInitialized)
+    return;
+  m_diskInitialized = true;
+  if (!listed)
+    return;
+
+  // seed the access order from the file dates, so that the oldest listings are evicted first
+  items.Sort(SORT_METHOD_DATE, SortOrderAscending);
+  for (int i = 0; i < items.Size(); i++)
+  {
+    if (items[i]->m_bIsFolder)
+      continue;
+    CDiskEntry &entry = m_diskCache[items[i]->GetPath()];
+    entry.m_size = items[i]->m_dwSize;
+    entry.m_lastAccess = m_accessCounter++;
+    m_diskSize += entry.m_size;
+  }
+  CLog::Log(LOGDEBUG, "%s - %u persisted listings using %"PRId64" bytes", __FUNCTION__, (unsigned int)m_diskCache.size(), m_diskSize);
+
+  vector<CStdString> evicted;
+  CheckIfPersistentFull("", evicted);
+  lock.Leave();
+
+  DeleteFiles(evicted);
+}
+
+bool CDirectoryCache::LoadPersistent(const CStdString& storedPath, int64_t modifiedTime, CFileItemList &items)
+{
+  InitPersistent();
+
+  CPersistentCacheFile cacheFile(PERSISTENT_CACHE_PATH, PERSISTENT_CACHE_EXT, PERSISTENT_CACHE_VERSION);
+  CStdString file = cacheFile.GetFile(storedPath);
+
+  CSingleLock lock (m_cs);
+  if (m_diskCache.find(file) == m_diskCache.end())
+  {
+    m_diskMisses++;
+    return false;
+  }
+  lock.Leave();
+
+  bool valid = false;
+  CArchive *ar = cacheFile.Load(storedPath);
+  if (ar)
+  {
+    int64_t cachedTime = 0;
+    *ar >> cachedTime;
+    if (cachedTime == modifiedTime)
+    {
+      *ar >> items;
+      valid = true;
+    }
+    cacheFile.Close();
+  }
+
+  lock.Enter();
+  if (!valid)
+  { // directory has changed since we listed it
+    m_diskStale++;
+    return false;
+  }
+
+  m_diskHits++;
+  iDiskCache entry = m_diskCache.find(file);
+  if (entry != m_diskCache.end())
+  {
+    entry->second.m_path = storedPath;
+    entry->second.m_lastAccess = m_accessCounter++;
+  }
+
+  // promote to the memory tier, so that FileExists() checks are fast
+  AddToCache(storedPath, items, DIR_CACHE_ONCE, true);
+  return true;
+}
+
+void CDirectoryCache::SavePersistent(const CStdString& storedPath, const CFileItemList &items, int64_t modifiedTime)
+{
+  if (time(NULL) - modifiedTime < PERSISTENT_CACHE_MIN_AGE)
+  {
+    ClearPersistent(storedPath);
+    return;
+  }
+
+  InitPersistent();
+
+  CPersistentCacheFile cacheFile(PERSISTENT_CACHE_PATH, PERSISTENT_CACHE_EXT, PERSISTENT_CACHE_VERSION);
+  CArchive *ar = cacheFile.Store(storedPath);
+  if (!ar)
+    return;
+  *ar << modifiedTime;
+  *ar << const_cast<CFileItemList&>(items);
+  bool stored = cacheFile.Close();
+
+  CStdString file = cacheFile.GetFile(storedPath);
+  CSingleLock lock (m_cs);
+  iDiskCache entry = m_diskCache.find(file);
+  if (entry != m_diskCache.end())
+  {
+    m_diskSize -= entry->second.m_size;
+    m_diskCache.erase(entry);
+  }
+  if (!stored)
+    return;
+
+  CDiskEntry &newEntry = m_diskCache[file];
+  newEntry.m_path = storedPath;
+  newEntry.m_size = cacheFile.GetSize();
+  newEntry.m_lastAccess = m_accessCounter++;
+  m_diskSize += newEntry.m_size;
+  m_diskWrites++;
+
+  vector<CStdString> evicted;
+  CheckIfPersistentFull(file, evicted);
+  lock.Leave();
+
+  DeleteFiles(evicted);
+}
+
+void CDirectoryCache::ClearPersistent(const CStdString& storedPath)
+{
+  CPersistentCacheFile cacheFile(PERSISTENT_CACHE_PATH, PERSISTENT_CACHE_EXT, PERSISTENT_CACHE_VERSION);
+  CStdString file = cacheFile.GetFile(storedPath);
+
+  CSingleLock lock (m_cs);
+  if (!m_diskInitialized)
+    return;
+
+  iDiskCache entry = m_diskCache.find(file);
+  if (entry == m_diskCache.end())
+    return;
+  m_diskSize -= entry->second.m_size;
+  m_diskCache.erase(entry);
+  lock.Leave();
+
+  CFile::Delete(file);
+}
+
+void CDirectoryCache::ClearPersistentSubPaths(const CStdString& storedPath)
+{
+  CSingleLock lock (m_cs);
+  if (!m_diskInitialized || !UsePersistentCache(storedPath))
+    return;
+
+  // listings persisted in an earlier session don't know their path yet
+  vector<CStdString> unknown;
+  for (iDiskCache i = m_diskCache.begin(); i != m_diskCache.end(); ++i)
+  {
+    if (i->second.m_path.IsEmpty())
+      unknown.push_back(i->first);
+  }
+  lock.Leave();
+
+  // so fetch it from the file
+  map<CStdString, CStdString> paths;
+  CPersistentCacheFile cacheFile(PERSISTENT_CACHE_PATH, PERSISTENT_CACHE_EXT, PERSISTENT_CACHE_VERSION);
+  for (vector<CStdString>::const_iterator i = unknown.begin(); i != unknown.end(); ++i)
+  {
+    CStdString path;
+    if (cacheFile.Open(*i, path))
+      paths[*i] = path;
+    cacheFile.Close();
+  }
+
+  lock.Enter();
+  vector<CStdString> deleted;
+  iDiskCache i = m_diskCache.begin();
+  while (i != m_diskCache.end())
+  {
+    CDiskEntry &entry = i->second;
+    if (entry.m_path.IsEmpty() && paths.find(i->first) != paths.end())
+      entry.m_path = paths[i->first];
+    if (entry.m_path.IsEmpty() || strncmp(entry.m_path.c_str(), storedPath.c_str(), storedPath.GetLength()) == 0)
+    {
+      deleted.push_back(i->first);
+      m_diskSize -= entry.m_size;
+      m_diskCache.erase(i++);
+    }
+    else
+      i++;
+  }
+  lock.Leave();
+
+  DeleteFiles(deleted);
+}
+
+void CDirectoryCache::CheckIfPersistentFull(const CStdString& keepFile, vector<CStdString>& evicted)
+{
+  CSingleLock lock (m_cs);
+
+  // evict least recently used listings until we're back within budget
+  while (m_diskSize > (int64_t)g_advancedSettings.m_dirCacheDiskSize)
+  {
+    iDiskCache lastAccessed = m_diskCache.end();
+    for (iDiskCache i = m_diskCache.begin(); i != m_diskCache.end(); i++)
+    {
+      if (i->first != keepFile && (lastAccessed == m_diskCache.end() || i->second.m_lastAccess < lastAccessed->second.m_lastAccess))
+        lastAccessed = i;
+    }
+    if (lastAccessed == m_diskCache.end())
+      break;
+
+    evicted.push_back(lastAccessed->first);
+    m_diskSize -= lastAccessed->second.m_size;
+    m_diskCache.erase(lastAccessed);
+    m_diskEvictions++;
+  }
+}
+
+void CDirectoryCache::DeleteFiles(const vector<CStdString>& files)
+{
+  for (vector<CStdString>::const_iterator i = files.begin(); i != files.end(); ++i)
+    CFile::Delete(*i);
+}
+
+void CDirectoryCache::PrintPersistentStats() const
+{
+  CSingleLock lock (m_cs);
+  if (!m_diskInitialized)
+    return;
+  CLog::Log(LOGDEBUG, "%s - persistent cache: %u hits, %u misses, %u stale, %u writes, %u evictions, %u listings using %"PRId64" bytes",
+            __FUNCTION__, m_diskHits, m_diskMisses, m_diskStale, m_diskWrites, m_diskEvictions, (unsigned int)m_diskCache.size(), m_diskSize);
+}
+
 #ifdef _DEBUG
 void CDirectoryCache::PrintStats() const
 {
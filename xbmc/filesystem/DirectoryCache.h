@@ -26,6 +26,7 @@
 
 #include <map>
 #include <set>
+#include <vector>
 
 class CFileItem;
 
@@ -44,6 +45,7 @@ namespace XFILE
 
       CFileItemList* m_Items;
       DIR_CACHE_TYPE m_cacheType;
+      bool m_persisted; ///< the listing was read from the persistent tier
     private:
       unsigned int m_lastAccess;
     };
@@ -58,13 +60,41 @@ namespace XFILE
     void Clear();
     void AddFile(const CStdString& strFile);
     bool FileExists(const CStdString& strPath, bool& bInCache);
+    void PrintPersistentStats() const;
 #ifdef _DEBUG
     void PrintStats() const;
 #endif
   protected:
+    /*! \brief An entry of the persistent (on-disk) cache tier.
+     The persistent tier holds listings of network shares across sessions.  Each
+     listing is stored together with the modification time of the directory at
+     the time it was listed, and is only used while that time is unchanged.  The
+     time is taken from the listing of the parent directory, so a listing can only
+     be persisted or served while its parent was listed in this session.
+     */
+    class CDiskEntry
+    {
+    public:
+      CDiskEntry() : m_size(0), m_lastAccess(0) {};
+      CStdString m_path;   ///< directory this entry caches (empty if not yet known)
+      int64_t m_size;      ///< size of the cache file in bytes
+      unsigned int m_lastAccess;
+    };
+
     void InitCache(std::set<CStdString>& dirs);
     void ClearCache(std::set<CStdString>& dirs);
     void CheckIfFull();
+    void AddToCache(const CStdString& storedPath, const CFileItemList &items, DIR_CACHE_TYPE cacheType, bool persisted);
+
+    bool UsePersistentCache(const CStdString& storedPath) const;
+    bool LoadPersistent(const CStdString& storedPath, int64_t modifiedTime, CFileItemList &items);
+    void SavePersistent(const CStdString& storedPath, const CFileItemList &items, int64_t modifiedTime);
+    void ClearPersistent(const CStdString& storedPath);
+    void ClearPersistentSubPaths(const CStdString& storedPath);
+    void InitPersistent();
+    void CheckIfPersistentFull(const CStdString& keepFile, std::vector<CStdString>& evicted);
+    int64_t GetModifiedTime(const CStdString& storedPath) const;
+    static void DeleteFiles(const std::vector<CStdString>& files);
 
     std::map<CStdString, CDir*> m_cache;
     typedef std::map<CStdString, CDir*>::iterator iCache;
@@ -75,6 +105,17 @@ namespace XFILE
 
     unsigned int m_accessCounter;
 
+    std::map<CStdString, CDiskEntry> m_diskCache; ///< persistent tier, keyed by cache file
+    typedef std::map<CStdString, CDiskEntry>::iterator iDiskCache;
+    bool m_diskInitialized;
+    int64_t m_diskSize;
+
+    unsigned int m_diskHits;
+    unsigned int m_diskMisses;
+    unsigned int m_diskStale;
+    unsigned int m_diskWrites;
+    unsigned int m_diskEvictions;
+
 #ifdef _DEBUG
     unsigned int m_cacheHits;
     unsigned int m_cacheMisses;
@@ -36,6 +36,7 @@ using namespace AUTOPTR;
 using namespace XFILE;
 
 #define READ_CACHE_CHUNK_SIZE (64*1024)
+#define READ_CACHE_CHUNK_MAX   (1024*1024)
 
 class CWriteRate
 {
@@ -86,11 +87,19 @@ CFileCache::CFileCache() : CThread("CFileCache")
    m_seekPos = 0;
    m_readPos = 0;
    m_writePos = 0;
+   m_fileSize = 0;
    if (g_advancedSettings.m_cacheMemBufferSize == 0)
      m_pCache = new CSimpleFileCache();
    else
-     m_pCache = new CCircularCache(g_advancedSettings.m_cacheMemBufferSize
-                                 , std::max<unsigned int>( g_advancedSettings.m_cacheMemBufferSize / 4, 1024 * 1024));
+   {
+     // each range gets its own buffer, so they split the memory between them
+     unsigned int ranges = std::max(g_advancedSettings.m_cacheRanges, 1);
+     unsigned int front = g_advancedSettings.m_cacheMemBufferSize / ranges;
+     unsigned int back = std::max<unsigned int>(front / 4, std::min<unsigned int>(front, 1024 * 1024));
+     m_pCache = new CCircularCache(front, back);
+     if (ranges > 1)
+       m_pCache = new CMultiRangeCache(m_pCache, ranges);
+   }
    m_seekPossible = 0;
    m_cacheFull = false;
 }
@@ -102,6 +111,7 @@ CFileCache::CFileCache(CCacheStrategy *pCache, bool bDeleteCache) : CThread("CFi
   m_seekPos = 0;
   m_readPos = 0;
   m_writePos = 0;
+  m_fileSize = 0;
   m_nSeekResult = 0;
   m_chunkSize = 0;
 }
@@ -165,12 +175,22 @@ bool CFileCache::Open(const CURL& url)
   // check if source can seek
   m_seekPossible = m_source.IoControl(IOCTRL_SEEK_POSSIBLE, NULL);
   m_chunkSize = CFile::GetChunkSize(m_source.GetChunkSize(), READ_CACHE_CHUNK_SIZE);
+  m_chunkSizeMax = std::max(m_chunkSize, READ_CACHE_CHUNK_MAX / m_chunkSize * m_chunkSize);
+  m_fileSize = m_source.GetLength();
 
   m_readPos = 0;
   m_writePos = 0;
   m_writeRate = 1024 * 1024;
   m_writeRateActual = 0;
+  m_readRateActual = 0;
+  m_readRateStamp = XbmcThreads::SystemClockMillis();
+  m_readRatePos = 0;
   m_cacheFull = false;
+  m_seekCount = 0;
+  m_seekCached = 0;
+  m_seekSource = 0;
+  m_bytesSource = 0;
+  m_readsSource = 0;
   m_seekEvent.Reset();
   m_seekEnded.Reset();
 
@@ -187,8 +207,8 @@ void CFileCache::Process()
     return;
   }
 
-  // create our read buffer
-  auto_aptr<char> buffer(new char[m_chunkSize]);
+  // create our read buffer, large enough for the biggest read ahead
+  auto_aptr<char> buffer(new char[m_chunkSizeMax]);
   if (buffer.get() == NULL)
   {
     CLog::Log(LOGERROR, "%s - failed to allocate read buffer", __FUNCTION__);
@@ -204,29 +224,57 @@ void CFileCache::Process()
     if (m_seekEvent.WaitMSec(0))
     {
       m_seekEvent.Reset();
-      CLog::Log(LOGDEBUG,"%s, request seek on source to %"PRId64, __FUNCTION__, m_seekPos);
-      m_nSeekResult = m_source.Seek(m_seekPos, SEEK_SET);
-      if (m_nSeekResult != m_seekPos)
+
+      // the cache may already hold data from the new position on (in another range),
+      // in which case the source only has to continue from the end of that data
+      int64_t cacheMaxPos = m_pCache->CachedDataEndPosIfSeekTo(m_seekPos);
+      bool cacheReachEOF = m_fileSize > 0 && cacheMaxPos >= m_fileSize;
+      bool sourceSeekFailed = false;
+      if (!cacheReachEOF)
       {
-        CLog::Log(LOGERROR,"%s, error %d seeking. seek returned %"PRId64, __FUNCTION__, (int)GetLastError(), m_nSeekResult);
-        m_seekPossible = m_source.IoControl(IOCTRL_SEEK_POSSIBLE, NULL);
+        CLog::Log(LOGDEBUG,"%s, request seek on source to %"PRId64, __FUNCTION__, cacheMaxPos);
+        m_nSeekResult = m_source.Seek(cacheMaxPos, SEEK_SET);
+        if (m_nSeekResult != cacheMaxPos)
+        {
+          CLog::Log(LOGERROR,"%s, error %d seeking. seek returned %"PRId64, __FUNCTION__, (int)GetLastError(), m_nSeekResult);
+          m_seekPossible = m_source.IoControl(IOCTRL_SEEK_POSSIBLE, NULL);
+          sourceSeekFailed = true;
+        }
+        else
+          m_seekSource++;
       }
-      else
+
+      if (!sourceSeekFailed)
       {
         m_pCache->Reset(m_seekPos);
-        average.Reset(m_seekPos);
-        limiter.Reset(m_seekPos);
-        m_writePos = m_seekPos;
+        m_nSeekResult = m_seekPos;
+        average.Reset(cacheMaxPos);
+        limiter.Reset(cacheMaxPos);
+        m_writePos = cacheMaxPos;
         m_readPos = m_seekPos;
         m_cacheFull = false;
       }
 
       m_seekEnded.Set();
+
+      if (!sourceSeekFailed && cacheReachEOF)
+      { // everything up to the end is cached already, wait for the next seek
+        m_pCache->EndOfInput();
+        if (AbortableWait(m_seekEvent) == WAIT_SIGNALED)
+        {
+          m_pCache->ClearEndOfInput();
+          m_seekEvent.Set();
+          continue;
+        }
+        break;
+      }
     }
 
     while (m_writeRate)
     {
-      if (m_writePos - m_readPos < m_writeRate)
+      // always allow the reader's consumption rate to be cached ahead, even if
+      // the requested rate is lower
+      if (m_writePos - m_readPos < std::max(m_writeRate, m_readRateActual))
       {
         limiter.Reset(m_writePos);
         break;
@@ -242,7 +290,12 @@ void CFileCache::Process()
       }
     }
 
-    int iRead = m_source.Read(buffer.get(), m_chunkSize);
+    int iRead = m_source.Read(buffer.get(), GetReadAheadChunk());
+    if (iRead > 0)
+    {
+      m_bytesSource += iRead;
+      m_readsSource++;
+    }
     if (iRead == 0)
     {
       CLog::Log(LOGINFO, "CFileCache::Process - Hit eof.");
@@ -340,6 +393,15 @@ retry:
   if (iRc > 0)
   {
     m_readPos += iRc;
+
+    // measure how fast the reader consumes data
+    unsigned int now = XbmcThreads::SystemClockMillis();
+    if (now - m_readRateStamp >= 1000)
+    {
+      m_readRateActual = (unsigned)(1000 * (m_readPos - m_readRatePos) / (now - m_readRateStamp));
+      m_readRateStamp = now;
+      m_readRatePos = m_readPos;
+    }
     return (int)iRc;
   }
 
@@ -387,6 +449,10 @@ int64_t CFileCache::Seek(int64_t iFilePosition, int iWhence)
   if (iTarget == m_readPos)
     return m_readPos;
 
+  m_seekCount++;
+  m_readRateStamp = XbmcThreads::SystemClockMillis();
+  m_readRatePos = iTarget;
+
   if ((m_nSeekResult = m_pCache->Seek(iTarget)) != iTarget)
   {
     if (m_seekPossible == 0)
@@ -417,16 +483,39 @@ int64_t CFileCache::Seek(int64_t iFilePosition, int iWhence)
     m_seekEvent.Reset();
   }
   else
+  {
     m_readPos = iTarget;
+    m_seekCached++;
+  }
 
   return m_nSeekResult;
 }
 
+unsigned CFileCache::GetReadAheadChunk() const
+{
+  // aim for about a quarter second of data per source read, so fast sources are
+  // read in large blocks while slow ones still react quickly to seek requests
+  unsigned rate = std::max(m_writeRateActual, m_readRateActual);
+  unsigned chunks = std::max(rate / 4 / m_chunkSize, 1u);
+  return std::min(chunks * m_chunkSize, m_chunkSizeMax);
+}
+
 void CFileCache::Close()
 {
   StopThread();
 
   CSingleLock lock(m_sync);
+  if (m_readsSource || m_seekCount)
+  {
+    CLog::Log(LOGDEBUG, "CFileCache::Close - %u seeks (%u cached, %u on source), %u source reads of %"PRId64" bytes, read rate %u, write rate %u",
+              m_seekCount, m_seekCached, m_seekSource, m_readsSource, m_bytesSource, m_readRateActual, m_writeRateActual);
+    CMultiRangeCache *ranges = dynamic_cast<CMultiRangeCache*>(m_pCache);
+    if (ranges)
+      CLog::Log(LOGDEBUG, "CFileCache::Close - %u seeks served by other cached ranges, %u new ranges", ranges->GetRangeHits(), ranges->GetRangeMisses());
+    m_readsSource = 0;
+    m_seekCount = 0;
+  }
+
   if (m_pCache)
     m_pCache->Close();
 
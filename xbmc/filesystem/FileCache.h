@@ -73,11 +73,25 @@ namespace XFILE
     int64_t      m_seekPos;
     int64_t      m_readPos;
     int64_t      m_writePos;
+    int64_t      m_fileSize;
     unsigned     m_chunkSize;
+    unsigned     m_chunkSizeMax;
     unsigned     m_writeRate;
     unsigned     m_writeRateActual;
+    unsigned     m_readRateActual;    // consumption rate of the reader
+    unsigned     m_readRateStamp;
+    int64_t      m_readRatePos;
     bool         m_cacheFull;
     CCriticalSection m_sync;
+
+    // statistics, logged on close
+    unsigned     m_seekCount;         // seeks requested by the reader
+    unsigned     m_seekCached;        // seeks served from the current cached range
+    unsigned     m_seekSource;        // seeks that needed a seek on the source
+    int64_t      m_bytesSource;       // bytes read from the source
+    unsigned     m_readsSource;       // reads done on the source
+
+    unsigned     GetReadAheadChunk() const;
   };
 
 }
@@ -0,0 +1,177 @@
+/*
+ *      Copyright (C) 2005-2011 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "filesystem/DirectoryCache.h"
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
+#include "settings/AdvancedSettings.h"
+#include "FileItem.h"
+
+#include <boost/test/unit_test.hpp>
+#include <stdlib.h>
+#include <time.h>
+
+using namespace XFILE;
+
+#define TEST_SHARE  "smb://server/share"
+#define TEST_FOLDER "smb://server/share/folder/"
+
+/* points special://temp at an empty directory and enables the persistent tier */
+struct SPersistentCache
+{
+  CStdString tempPath;
+
+  SPersistentCache()
+  {
+    char path[] = "/tmp/xbmc-dircache-XXXXXX";
+    BOOST_REQUIRE(mkdtemp(path));
+    tempPath = path;
+    tempPath += "/";
+    CSpecialProtocol::SetTempPath(tempPath);
+    g_advancedSettings.m_dirCacheDiskSize = 1024 * 1024;
+  }
+
+  ~SPersistentCache()
+  {
+    g_advancedSettings.m_dirCacheDiskSize = 0;
+    CFileItemList items;
+    CDirectory::GetDirectory("special://temp/dircache/", items, "", DIR_FLAG_BYPASS_CACHE);
+    for (int i = 0; i < items.Size(); i++)
+      CFile::Delete(items[i]->GetPath());
+    CDirectory::Remove("special://temp/dircache/");
+    CDirectory::Remove(tempPath);
+  }
+};
+
+/* a listing of the share that dates the folder, as the server would return it */
+static void ListShare(CDirectoryCache &cache, time_t folderTime)
+{
+  CFileItemList items;
+  CFileItemPtr folder(new CFileItem(TEST_FOLDER, true));
+  folder->m_dateTime = CDateTime(folderTime);
+  items.Add(folder);
+  cache.SetDirectory(TEST_SHARE, items, DIR_CACHE_ONCE);
+}
+
+static void ListFolder(CDirectoryCache &cache, DIR_CACHE_TYPE cacheType = DIR_CACHE_ONCE)
+{
+  CFileItemList items;
+  items.Add(CFileItemPtr(new CFileItem(TEST_FOLDER "movie.mkv", false)));
+  items.Add(CFileItemPtr(new CFileItem(TEST_FOLDER "movie.nfo", false)));
+  cache.SetDirectory(TEST_FOLDER, items, cacheType);
+}
+
+BOOST_FIXTURE_TEST_CASE(TestDirectoryCachePersistence, SPersistentCache)
+{
+  time_t folderTime = time(NULL) - 3600;
+  {
+    CDirectoryCache session;
+    ListShare(session, folderTime);
+    ListFolder(session);
+  }
+
+  /* a new session reads the folder back while its date is unchanged */
+  CDirectoryCache session;
+  ListShare(session, folderTime);
+  CFileItemList items;
+  BOOST_REQUIRE(session.GetDirectory(TEST_FOLDER, items, true));
+  BOOST_REQUIRE_EQUAL(items.Size(), 2);
+  BOOST_CHECK(items[0]->GetPath() == TEST_FOLDER "movie.mkv");
+  BOOST_CHECK(items[1]->GetPath() == TEST_FOLDER "movie.nfo");
+  BOOST_CHECK(!items[0]->m_bIsFolder);
+}
+
+BOOST_FIXTURE_TEST_CASE(TestDirectoryCacheStale, SPersistentCache)
+{
+  time_t folderTime = time(NULL) - 3600;
+  {
+    CDirectoryCache session;
+    ListShare(session, folderTime);
+    ListFolder(session);
+  }
+
+  CFileItemList items;
+  {
+    /* without a listing of the share there is no date to check the folder against */
+    CDirectoryCache session;
+    BOOST_CHECK(!session.GetDirectory(TEST_FOLDER, items, true));
+  }
+
+  /* the folder changed since it was persisted */
+  CDirectoryCache session;
+  ListShare(session, folderTime + 60);
+  BOOST_CHECK(!session.GetDirectory(TEST_FOLDER, items, true));
+}
+
+BOOST_FIXTURE_TEST_CASE(TestDirectoryCacheFlags, SPersistentCache)
+{
+  time_t folderTime = time(NULL) - 3600;
+  {
+    CDirectoryCache session;
+    ListShare(session, folderTime);
+    ListFolder(session);
+  }
+
+  /* a persisted listing is only for callers that accept cached listings */
+  CDirectoryCache session;
+  ListShare(session, folderTime);
+  CFileItemList items;
+  BOOST_CHECK(!session.GetDirectory(TEST_FOLDER, items, false));
+
+  /* listings that are never cached aren't persisted either, and replace an older one */
+  ListFolder(session, DIR_CACHE_NEVER);
+  session.ClearDirectory(TEST_FOLDER);
+  {
+    CDirectoryCache next;
+    ListShare(next, folderTime);
+    BOOST_CHECK(!next.GetDirectory(TEST_FOLDER, items, true));
+  }
+
+  /* clearing the share drops the persisted folder */
+  ListFolder(session);
+  session.ClearSubPaths(TEST_SHARE);
+  CDirectoryCache next;
+  ListShare(next, folderTime);
+  BOOST_CHECK(!next.GetDirectory(TEST_FOLDER, items, true));
+}
+
+BOOST_FIXTURE_TEST_CASE(TestDirectoryBypassCache, SPersistentCache)
+{
+  /* a fetch that bypasses the cache sees a file added after the folder was cached */
+  CStdString folder = tempPath + "bypass/";
+  BOOST_REQUIRE(CDirectory::Create(folder));
+
+  CFileItemList items;
+  BOOST_REQUIRE(CDirectory::GetDirectory(folder, items));
+  BOOST_CHECK_EQUAL(items.Size(), 0);
+
+  CFile file;
+  BOOST_REQUIRE(file.OpenForWrite(folder + "new.txt", true));
+  file.Close();
+
+  items.Clear();
+  BOOST_REQUIRE(CDirectory::GetDirectory(folder, items, "", DIR_FLAG_READ_CACHE | DIR_FLAG_BYPASS_CACHE));
+  BOOST_CHECK_EQUAL(items.Size(), 1);
+
+  CFile::Delete(folder + "new.txt");
+  CDirectory::Remove(folder);
+}
@@ -141,7 +141,7 @@ void CGUIBaseContainer::ProcessItem(float posX, float posY, CGUIListItemPtr& ite
   g_graphicsContext.SetOrigin(posX, posY);
 
   if (m_bInvalidated)
-    item->SetInvalid();
+    item->SetLayoutsInvalid();
   if (focused)
   {
     if (!item->GetFocusedLayout())
@@ -139,8 +139,11 @@ void CGUIControl::DoProcess(unsigned int currentTime, CDirtyRegionList &dirtyreg
 
   if (IsVisible())
   {
+    GUIPROFILER_PROCESS_BEGIN(this);
     Process(currentTime, dirtyregions);
+    GUIPROFILER_PROCESS_END(this);
     m_bInvalidated = false;
+    g_windowManager.CountControl(CGUIWindowManager::CONTROL_PROCESSED);
   }
 
   changed |=  m_controlIsDirty;
@@ -178,6 +181,7 @@ void CGUIControl::DoRender()
     GUIPROFILER_RENDER_BEGIN(this);
     Render();
     GUIPROFILER_RENDER_END(this);
+    g_windowManager.CountControl(CGUIWindowManager::CONTROL_RENDERED);
   }
   if (m_hasCamera)
     g_graphicsContext.RestoreCameraPosition();
@@ -189,6 +193,15 @@ void CGUIControl::Render()
   m_hasRendered = true;
 }
 
+void CGUIControl::SkipRender()
+{
+  if (IsVisible())
+  {
+    m_hasRendered = true;
+    g_windowManager.CountControl(CGUIWindowManager::CONTROL_CULLED);
+  }
+}
+
 bool CGUIControl::OnAction(const CAction &action)
 {
   if (HasFocus())
@@ -458,6 +471,12 @@ CRect CGUIControl::CalcRenderRegion() const
   return CRect(tl.x, tl.y, br.x, br.y);
 }
 
+bool CGUIControl::HidesRegion(const CRect &region) const
+{
+  CRect opaque = GetOpaqueRegion();
+  return !opaque.IsEmpty() && !region.IsEmpty() && opaque.Contains(region);
+}
+
 void CGUIControl::SetNavigation(int up, int down, int left, int right, int back)
 {
   m_actionUp.SetNavigation(up);
@@ -82,6 +82,10 @@ public:
   virtual void Process(unsigned int currentTime, CDirtyRegionList &dirtyregions);
   virtual void DoRender();
   virtual void Render();
+  /*! \brief Skip rendering the control this frame, as none of it would be seen
+   Leaves the control as though it had been rendered, so that animations carry on.
+   */
+  virtual void SkipRender();
 
   bool HasRendered() const { return m_hasRendered; };
 
@@ -176,6 +180,15 @@ public:
    Called during process to update m_renderRegion
    */
   virtual CRect CalcRenderRegion() const;
+  /*! \brief return the region in screen coordinates that this control hides completely
+   Nothing underneath the control within this region can be seen. Controls that don't
+   know that they're opaque return an empty region.
+   */
+  virtual CRect GetOpaqueRegion() const { return CRect(); };
+  /*! \brief return whether this control hides everything within a region in screen coordinates
+   \sa GetOpaqueRegion
+   */
+  bool HidesRegion(const CRect &region) const;
 
   virtual void SetNavigation(int up, int down, int left, int right, int back = 0);
   virtual void SetTabNavigation(int next, int prev);
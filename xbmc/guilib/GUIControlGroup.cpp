@@ -100,6 +100,7 @@ void CGUIControlGroup::Process(unsigned int currentTime, CDirtyRegionList &dirty
   g_graphicsContext.SetOrigin(pos.x, pos.y);
 
   CRect rect;
+  m_opaqueRegion = CRect();
   for (iControls it = m_children.begin(); it != m_children.end(); ++it)
   {
     CGUIControl *control = *it;
@@ -108,6 +109,12 @@ void CGUIControlGroup::Process(unsigned int currentTime, CDirtyRegionList &dirty
     control->DoProcess(currentTime, dirtyregions);
     if (control->IsVisible() || (oldDirty != dirtyregions.size())) // visible or dirty (was visible?)
       rect.Union(control->GetRenderRegion());
+    if (control->IsVisible())
+    {
+      CRect opaque = control->GetOpaqueRegion();
+      if (opaque.Area() > m_opaqueRegion.Area())
+        m_opaqueRegion = opaque;
+    }
   }
 
   g_graphicsContext.RestoreOrigin();
@@ -119,12 +126,32 @@ void CGUIControlGroup::Render()
 {
   CPoint pos(GetPosition());
   g_graphicsContext.SetOrigin(pos.x, pos.y);
+
+  // children outside of the area being rendered, or below one that hides all of it, can't be seen
+  const CRect &scissors = g_graphicsContext.GetScissors();
+  iControls firstSeen = m_children.begin();
+  if (!scissors.IsEmpty())
+  {
+    for (iControls it = m_children.end(); it != m_children.begin();)
+    {
+      --it;
+      if ((*it)->HidesRegion(scissors))
+      {
+        firstSeen = it;
+        break;
+      }
+    }
+  }
+
   CGUIControl *focusedControl = NULL;
   for (iControls it = m_children.begin(); it != m_children.end(); ++it)
   {
     CGUIControl *control = *it;
+    const CRect &region = control->GetRenderRegion();
     if (m_renderFocusedLast && control->HasFocus())
       focusedControl = control;
+    else if (it < firstSeen || (!scissors.IsEmpty() && !region.IsEmpty() && !region.Intersects(scissors)))
+      control->SkipRender();
     else
       control->DoRender();
   }
@@ -134,6 +161,20 @@ void CGUIControlGroup::Render()
   g_graphicsContext.RestoreOrigin();
 }
 
+void CGUIControlGroup::SkipRender()
+{
+  if (!IsVisible())
+    return;
+  CGUIControl::SkipRender();
+  for (iControls it = m_children.begin(); it != m_children.end(); ++it)
+    (*it)->SkipRender();
+}
+
+CRect CGUIControlGroup::GetOpaqueRegion() const
+{
+  return IsVisible() ? m_opaqueRegion : CRect();
+}
+
 bool CGUIControlGroup::OnAction(const CAction &action)
 {
   ASSERT(false);  // unimplemented
@@ -43,6 +43,8 @@ public:
 
   virtual void Process(unsigned int currentTime, CDirtyRegionList &dirtyregions);
   virtual void Render();
+  virtual void SkipRender();
+  virtual CRect GetOpaqueRegion() const;
   virtual bool OnAction(const CAction &action);
   virtual bool OnMessage(CGUIMessage& message);
   virtual bool SendControlMessage(CGUIMessage& message);
@@ -114,5 +116,6 @@ protected:
   bool m_defaultAlways;
   int m_focusedControl;
   bool m_renderFocusedLast;
+  CRect m_opaqueRegion; ///< largest region hidden by one of our children, in screen coordinates
 };
 
@@ -22,11 +22,13 @@
 #include "GUIControlProfiler.h"
 #include "utils/XBMCTinyXML.h"
 #include "utils/TimeUtils.h"
+#include "TextureManager.h"
+#include "utils/log.h"
 
 bool CGUIControlProfiler::m_bIsRunning = false;
 
 CGUIControlProfilerItem::CGUIControlProfilerItem(CGUIControlProfiler *pProfiler, CGUIControlProfilerItem *pParent, CGUIControl *pControl)
-: m_pProfiler(pProfiler), m_pParent(pParent), m_pControl(pControl), m_visTime(0), m_renderTime(0)
+: m_pProfiler(pProfiler), m_pParent(pParent), m_pControl(pControl), m_visTime(0), m_renderTime(0), m_processTime(0)
 {
   if (m_pControl)
   {
@@ -54,6 +56,7 @@ void CGUIControlProfilerItem::Reset(CGUIControlProfiler *pProfiler)
 
   m_visTime = 0;
   m_renderTime = 0;
+  m_processTime = 0;
   const unsigned int dwSize = m_vecChildren.size();
   for (unsigned int i=0; i<dwSize; ++i)
     delete m_vecChildren[i];
@@ -82,6 +85,16 @@ void CGUIControlProfilerItem::EndRender(void)
   m_renderTime += (unsigned int)(m_pProfiler->m_fPerfScale * (CurrentHostCounter() - m_i64RenderStart));
 }
 
+void CGUIControlProfilerItem::BeginProcess(void)
+{
+  m_i64ProcessStart = CurrentHostCounter();
+}
+
+void CGUIControlProfilerItem::EndProcess(void)
+{
+  m_processTime += (unsigned int)(m_pProfiler->m_fPerfScale * (CurrentHostCounter() - m_i64ProcessStart));
+}
+
 void CGUIControlProfilerItem::SaveToXML(TiXmlElement *parent)
 {
   TiXmlElement *xmlControl = new TiXmlElement("control");
@@ -188,7 +201,8 @@ void CGUIControlProfilerItem::SaveToXML(TiXmlElement *parent)
   // Note time is stored in 1/100 milliseconds but reported in ms
   unsigned int vis = m_visTime / 100;
   unsigned int rend = m_renderTime / 100;
-  if (vis || rend)
+  unsigned int proc = m_processTime / 100;
+  if (vis || rend || proc)
   {
     CStdString val;
     TiXmlElement *elem = new TiXmlElement("rendertime");
@@ -202,6 +216,12 @@ void CGUIControlProfilerItem::SaveToXML(TiXmlElement *parent)
     val.Format("%u", vis);
     text = new TiXmlText(val.c_str());
     elem->LinkEndChild(text);
+
+    elem = new TiXmlElement("processtime");
+    xmlControl->LinkEndChild(elem);
+    val.Format("%u", proc);
+    text = new TiXmlText(val.c_str());
+    elem->LinkEndChild(text);
   }
 
   if (m_vecChildren.size())
@@ -288,6 +308,18 @@ void CGUIControlProfiler::EndRender(CGUIControl *pControl)
   item->EndRender();
 }
 
+void CGUIControlProfiler::BeginProcess(CGUIControl *pControl)
+{
+  CGUIControlProfilerItem *item = FindOrAddControl(pControl);
+  item->BeginProcess();
+}
+
+void CGUIControlProfiler::EndProcess(CGUIControl *pControl)
+{
+  CGUIControlProfilerItem *item = FindOrAddControl(pControl);
+  item->EndProcess();
+}
+
 CGUIControlProfilerItem *CGUIControlProfiler::FindOrAddControl(CGUIControl *pControl)
 {
   if (m_pLastItem)
@@ -321,20 +353,51 @@ void CGUIControlProfiler::EndFrame(void)
   m_iFrameCount++;
   if (m_iFrameCount >= m_iMaxFrameCount)
   {
-    const unsigned int dwSize = m_ItemHead.m_vecChildren.size();
-    for (unsigned int i=0; i<dwSize; ++i)
-    {
-      CGUIControlProfilerItem *p = m_ItemHead.m_vecChildren[i];
-      m_ItemHead.m_visTime += p->m_visTime;
-      m_ItemHead.m_renderTime += p->m_renderTime;
-    }
-
-    m_bIsRunning = false;
+    Stop();
     if (SaveResults())
       m_ItemHead.Reset(this);
   }
 }
 
+void CGUIControlProfiler::Stop(void)
+{
+  if (!m_bIsRunning)
+    return;
+
+  const unsigned int dwSize = m_ItemHead.m_vecChildren.size();
+  for (unsigned int i=0; i<dwSize; ++i)
+  {
+    CGUIControlProfilerItem *p = m_ItemHead.m_vecChildren[i];
+    m_ItemHead.m_visTime += p->m_visTime;
+    m_ItemHead.m_renderTime += p->m_renderTime;
+    m_ItemHead.m_processTime += p->m_processTime;
+  }
+
+  m_bIsRunning = false;
+}
+
+void CGUIControlProfiler::LogSummary(unsigned int frames) const
+{
+  if (!frames)
+    return;
+
+  // the top level items are the windows, times are in 1/100 ms
+  CLog::Log(LOGNOTICE, "GUI profile over %u frames (average ms per frame):", frames);
+  const unsigned int dwSize = m_ItemHead.m_vecChildren.size();
+  for (unsigned int i=0; i<dwSize; ++i)
+  {
+    const CGUIControlProfilerItem *p = m_ItemHead.m_vecChildren[i];
+    CLog::Log(LOGNOTICE, "  window %d: process %.3f, render %.3f, visibility %.3f", p->m_controlID,
+              p->m_processTime / (100.0f * frames),
+              p->m_renderTime / (100.0f * frames),
+              p->m_visTime / (100.0f * frames));
+  }
+  CLog::Log(LOGNOTICE, "  total: process %.3f, render %.3f, visibility %.3f",
+            m_ItemHead.m_processTime / (100.0f * frames),
+            m_ItemHead.m_renderTime / (100.0f * frames),
+            m_ItemHead.m_visTime / (100.0f * frames));
+}
+
 bool CGUIControlProfiler::SaveResults(void)
 {
   if (m_strOutputFile.IsEmpty())
@@ -351,6 +414,14 @@ bool CGUIControlProfiler::SaveResults(void)
   root->SetAttribute("timeunit", "ms");
   doc.LinkEndChild(root);
 
+  TiXmlElement *textures = new TiXmlElement("textures");
+  textures->SetAttribute("residentbytes", (int)g_TextureManager.GetMemoryUsage());
+  textures->SetAttribute("unusedbytes", (int)g_TextureManager.GetUnusedMemoryUsage());
+  textures->SetAttribute("hits", (int)g_TextureManager.GetHits());
+  textures->SetAttribute("loads", (int)g_TextureManager.GetLoads());
+  textures->SetAttribute("evictions", (int)g_TextureManager.GetEvictions());
+  root->LinkEndChild(textures);
+
   m_ItemHead.SaveToXML(root);
   return doc.SaveFile(m_strOutputFile);
 }
@@ -40,8 +40,10 @@ public:
   CGUIControl::GUICONTROLTYPES m_ControlType;
   unsigned int m_visTime;
   unsigned int m_renderTime;
+  unsigned int m_processTime;
   int64_t m_i64VisStart;
   int64_t m_i64RenderStart;
+  int64_t m_i64ProcessStart;
 
   CGUIControlProfilerItem(CGUIControlProfiler *pProfiler, CGUIControlProfilerItem *pParent, CGUIControl *pControl);
   ~CGUIControlProfilerItem(void);
@@ -51,8 +53,10 @@ public:
   void EndVisibility(void);
   void BeginRender(void);
   void EndRender(void);
+  void BeginProcess(void);
+  void EndProcess(void);
   void SaveToXML(TiXmlElement *parent);
-  unsigned int GetTotalTime(void) const { return m_visTime + m_renderTime; };
+  unsigned int GetTotalTime(void) const { return m_visTime + m_renderTime + m_processTime; };
 
   CGUIControlProfilerItem *AddControl(CGUIControl *pControl);
   CGUIControlProfilerItem *FindOrAddControl(CGUIControl *pControl, bool recurse);
@@ -65,11 +69,16 @@ public:
   static bool IsRunning(void);
 
   void Start(void);
+  void Stop(void);
   void EndFrame(void);
   void BeginVisibility(CGUIControl *pControl);
   void EndVisibility(CGUIControl *pControl);
   void BeginRender(CGUIControl *pControl);
   void EndRender(CGUIControl *pControl);
+  void BeginProcess(CGUIControl *pControl);
+  void EndProcess(CGUIControl *pControl);
+  void LogSummary(unsigned int frames) const;
+  int GetFrameCount(void) const { return m_iFrameCount; };
   int GetMaxFrameCount(void) const { return m_iMaxFrameCount; };
   void SetMaxFrameCount(int iMaxFrameCount) { m_iMaxFrameCount = iMaxFrameCount; };
   void SetOutputFile(const CStdString &strOutputFile) { m_strOutputFile = strOutputFile; };
@@ -98,5 +107,7 @@ private:
 #define GUIPROFILER_VISIBILITY_END(x) { if (CGUIControlProfiler::IsRunning()) CGUIControlProfiler::Instance().EndVisibility(x); }
 #define GUIPROFILER_RENDER_BEGIN(x) { if (CGUIControlProfiler::IsRunning()) CGUIControlProfiler::Instance().BeginRender(x); }
 #define GUIPROFILER_RENDER_END(x) { if (CGUIControlProfiler::IsRunning()) CGUIControlProfiler::Instance().EndRender(x); }
+#define GUIPROFILER_PROCESS_BEGIN(x) { if (CGUIControlProfiler::IsRunning()) CGUIControlProfiler::Instance().BeginProcess(x); }
+#define GUIPROFILER_PROCESS_END(x) { if (CGUIControlProfiler::IsRunning()) CGUIControlProfiler::Instance().EndProcess(x); }
 
 #endif
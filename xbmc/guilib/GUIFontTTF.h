@@ -172,6 +172,9 @@ private:
 #elif defined(HAS_DX)
 #include "GUIFontTTFDX.h"
 #define CGUIFontTTF CGUIFontTTFDX
+#elif defined(HAS_HEADLESS)
+#include "GUIFontTTFNull.h"
+#define CGUIFontTTF CGUIFontTTFNull
 #endif
 
 #endif
@@ -0,0 +1,128 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+
+#include "system.h"
+#include "GUIFont.h"
+#include "GUIFontTTFNull.h"
+#include "GUIFontManager.h"
+#include "Texture.h"
+#include "utils/log.h"
+#include "windowing/WindowingFactory.h"
+
+// stuff for freetype
+#include <ft2build.h>
+#include FT_FREETYPE_H
+#include FT_GLYPH_H
+#include FT_OUTLINE_H
+
+using namespace std;
+
+#if defined(HAS_HEADLESS)
+
+
+CGUIFontTTFNull::CGUIFontTTFNull(const CStdString& strFileName)
+: CGUIFontTTFBase(strFileName)
+{
+}
+
+CGUIFontTTFNull::~CGUIFontTTFNull(void)
+{
+}
+
+void CGUIFontTTFNull::Begin()
+{
+  if (m_nestedBeginCount == 0)
+  {
+    m_bTextureLoaded = true;
+    m_vertex_count = 0;
+  }
+  // Keep track of the nested begin/end calls.
+  m_nestedBeginCount++;
+}
+
+void CGUIFontTTFNull::End()
+{
+  if (m_nestedBeginCount == 0)
+    return;
+
+  if (--m_nestedBeginCount > 0)
+    return;
+
+  // the GL backend draws the whole batch in one call
+  g_Windowing.AddDrawCall(m_vertex_count / 4);
+}
+
+CBaseTexture* CGUIFontTTFNull::ReallocTexture(unsigned int& newHeight)
+{
+  newHeight = CBaseTexture::PadPow2(newHeight);
+
+  CBaseTexture* newTexture = new CTexture(m_textureWidth, newHeight, XB_FMT_A8);
+
+  if (!newTexture || newTexture->GetPixels() == NULL)
+  {
+    CLog::Log(LOGERROR, "GUIFontTTFNull::CacheCharacter: Error creating new cache texture for size %f", m_height);
+    return NULL;
+  }
+  m_textureHeight = newTexture->GetHeight();
+  m_textureWidth = newTexture->GetWidth();
+
+  memset(newTexture->GetPixels(), 0, m_textureHeight * newTexture->GetPitch());
+  if (m_texture)
+  {
+    unsigned char* src = (unsigned char*) m_texture->GetPixels();
+    unsigned char* dst = (unsigned char*) newTexture->GetPixels();
+    for (unsigned int y = 0; y < m_texture->GetHeight(); y++)
+    {
+      memcpy(dst, src, m_texture->GetPitch());
+      src += m_texture->GetPitch();
+      dst += newTexture->GetPitch();
+    }
+    delete m_texture;
+  }
+
+  return newTexture;
+}
+
+bool CGUIFontTTFNull::CopyCharToTexture(FT_BitmapGlyph bitGlyph, Character* ch)
+{
+  FT_Bitmap bitmap = bitGlyph->bitmap;
+
+  unsigned char* source = (unsigned char*) bitmap.buffer;
+  unsigned char* target = (unsigned char*) m_texture->GetPixels() + (m_posY + ch->offsetY) * m_texture->GetPitch() + m_posX + bitGlyph->left;
+
+  for (int y = 0; y < bitmap.rows; y++)
+  {
+    memcpy(target, source, bitmap.width);
+    source += bitmap.width;
+    target += m_texture->GetPitch();
+  }
+
+  // the glyph cache is never uploaded, so there is nothing to invalidate
+  return TRUE;
+}
+
+void CGUIFontTTFNull::DeleteHardwareTexture()
+{
+  m_bTextureLoaded = false;
+}
+
+#endif
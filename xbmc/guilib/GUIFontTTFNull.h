@@ -0,0 +1,56 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+
+/*!
+\file GUIFontTTFNull.h
+\brief
+*/
+
+#ifndef CGUILIB_GUIFONTTTF_NULL_H
+#define CGUILIB_GUIFONTTTF_NULL_H
+#pragma once
+
+
+#include "GUIFontTTF.h"
+
+
+/*!
+ \ingroup textures
+ \brief Font renderer for headless builds that only counts what would be drawn
+ */
+class CGUIFontTTFNull : public CGUIFontTTFBase
+{
+public:
+  CGUIFontTTFNull(const CStdString& strFileName);
+  virtual ~CGUIFontTTFNull(void);
+
+  virtual void Begin();
+  virtual void End();
+
+protected:
+  virtual CBaseTexture* ReallocTexture(unsigned int& newHeight);
+  virtual bool CopyCharToTexture(FT_BitmapGlyph bitGlyph, Character *ch);
+  virtual void DeleteHardwareTexture();
+
+};
+
+#endif
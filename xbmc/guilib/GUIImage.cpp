@@ -24,6 +24,8 @@
 #include "utils/log.h"
 #include "utils/TimeUtils.h"
 
+#include <math.h>
+
 using namespace std;
 
 CGUIImage::CGUIImage(int parentID, int controlID, float posX, float posY, float width, float height, const CTextureInfo& texture)
@@ -164,6 +166,17 @@ void CGUIImage::Process(unsigned int currentTime, CDirtyRegionList &dirtyregions
     MarkDirtyRegion();
 
   CGUIControl::Process(currentTime, dirtyregions);
+
+  // we only hide what's behind us if we're drawn as a solid rectangle on screen,
+  // and then only the pixels we cover entirely
+  m_opaqueRegion = CRect();
+  if (m_fadingTextures.empty() && m_texture.IsOpaque() &&
+      m_cachedTransform.alpha == 1.0f && m_cachedTransform.IsAxisAligned())
+  {
+    CRect opaque(ceilf(m_renderRegion.x1), ceilf(m_renderRegion.y1), floorf(m_renderRegion.x2), floorf(m_renderRegion.y2));
+    if (opaque.Width() > 0 && opaque.Height() > 0)
+      m_opaqueRegion = opaque;
+  }
 }
 
 void CGUIImage::Render()
@@ -287,6 +300,11 @@ CRect CGUIImage::CalcRenderRegion() const
   return CGUIControl::CalcRenderRegion().Intersect(region);
 }
 
+CRect CGUIImage::GetOpaqueRegion() const
+{
+  return IsVisible() ? m_opaqueRegion : CRect();
+}
+
 const CStdString &CGUIImage::GetFileName() const
 {
   return m_texture.GetFileName();
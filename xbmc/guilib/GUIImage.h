@@ -94,6 +94,7 @@ public:
   float GetTextureHeight() const;
 
   virtual CRect CalcRenderRegion() const;
+  virtual CRect GetOpaqueRegion() const;
 
 #ifdef _DEBUG
   virtual void DumpTextureUse();
@@ -119,5 +120,6 @@ protected:
   unsigned int m_crossFadeTime;
   unsigned int m_currentFadeTime;
   unsigned int m_lastRenderTime;
+  CRect m_opaqueRegion; ///< region of the screen we hide completely, if any
 };
 #endif
@@ -25,6 +25,7 @@
 
 #include <map>
 #include <set>
+#include <vector>
 
 // forward definitions
 class TiXmlElement;
@@ -47,12 +48,17 @@ public:
    Replaces any instances of <include file="foo">bar</include> with the value of the include
    "bar" from the include file "foo".
    \param node an XML Element - all child elements are traversed.
+   \param conditional [out] set to true if an include depended on a condition, i.e. the result may differ between loads.
    */
-  void ResolveIncludes(TiXmlElement *node);
+  void ResolveIncludes(TiXmlElement *node, bool *conditional = NULL);
   const INFO::CSkinVariableString* CreateSkinVariable(const CStdString& name, int context);
 
+  /*! \brief Retrieve the include files loaded so far
+   */
+  const std::vector<CStdString> &GetFiles() const { return m_files; };
+
 private:
-  void ResolveIncludesForNode(TiXmlElement *node);
+  void ResolveIncludesForNode(TiXmlElement *node, bool *conditional);
   CStdString ResolveConstant(const CStdString &constant) const;
   bool HasIncludeFile(const CStdString &includeFile) const;
   std::map<CStdString, TiXmlElement> m_includes;
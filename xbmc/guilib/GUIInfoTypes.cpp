@@ -175,10 +175,16 @@ CStdString CGUIInfoLabel::GetItemLabel(const CGUIListItem *item, bool preferImag
     if (portion.m_info)
     {
       CStdString infoLabel;
-      if (preferImages)
-        infoLabel = g_infoManager.GetItemImage((const CFileItem *)item, portion.m_info, fallback);
-      else
-        infoLabel = g_infoManager.GetItemLabel((const CFileItem *)item, portion.m_info, fallback);
+      // formatting the labels of every item whenever a list is updated adds up, so reuse them until the item changes
+      if (!item->GetCachedInfoLabel(portion.m_info, preferImages, infoLabel))
+      {
+        if (preferImages)
+          infoLabel = g_infoManager.GetItemImage((const CFileItem *)item, portion.m_info, fallback);
+        else
+          infoLabel = g_infoManager.GetItemLabel((const CFileItem *)item, portion.m_info, fallback);
+        if (g_infoManager.IsItemOnlyInfo(portion.m_info))
+          item->SetCachedInfoLabel(portion.m_info, preferImages, infoLabel);
+      }
       if (!infoLabel.IsEmpty())
         label += portion.GetLabel(infoLabel);
     }
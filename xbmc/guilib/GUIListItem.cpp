@@ -21,6 +21,7 @@
 
 #include "GUIListItem.h"
 #include "GUIListItemLayout.h"
+#include "threads/Atomics.h"
 #include "utils/Archive.h"
 #include "utils/CharsetConverter.h"
 #include "utils/Variant.h"
@@ -31,6 +32,8 @@ CGUIListItem::CGUIListItem(const CGUIListItem& item)
 {
   m_layout = NULL;
   m_focusedLayout = NULL;
+  m_version = 0;
+  m_infoLabelsVersion = 0;
   *this = item;
   SetInvalid();
 }
@@ -46,6 +49,8 @@ CGUIListItem::CGUIListItem(void)
   m_overlayIcon = ICON_OVERLAY_NONE;
   m_layout = NULL;
   m_focusedLayout = NULL;
+  m_version = 0;
+  m_infoLabelsVersion = 0;
 }
 
 CGUIListItem::CGUIListItem(const CStdString& strLabel)
@@ -60,6 +65,8 @@ CGUIListItem::CGUIListItem(const CStdString& strLabel)
   m_overlayIcon = ICON_OVERLAY_NONE;
   m_layout = NULL;
   m_focusedLayout = NULL;
+  m_version = 0;
+  m_infoLabelsVersion = 0;
 }
 
 CGUIListItem::~CGUIListItem(void)
@@ -342,14 +349,48 @@ CGUIListItemLayout *CGUIListItem::GetFocusedLayout()
 }
 
 void CGUIListItem::SetInvalid()
+{
+  SetInfoChanged();
+  SetLayoutsInvalid();
+}
+
+void CGUIListItem::SetInfoChanged()
+{
+  AtomicIncrement(&m_version);
+}
+
+void CGUIListItem::SetLayoutsInvalid()
 {
   if (m_layout) m_layout->SetInvalid();
   if (m_focusedLayout) m_focusedLayout->SetInvalid();
 }
 
+bool CGUIListItem::GetCachedInfoLabel(int info, bool image, CStdString &label) const
+{
+  // only the GUI thread uses the cache, so it is safe to clear it here
+  if (m_infoLabelsVersion != m_version)
+  {
+    m_infoLabels.clear();
+    m_infoLabelsVersion = m_version;
+    return false;
+  }
+
+  map<int, CStdString>::const_iterator i = m_infoLabels.find(image ? -info : info);
+  if (i == m_infoLabels.end())
+    return false;
+  label = i->second;
+  return true;
+}
+
+void CGUIListItem::SetCachedInfoLabel(int info, bool image, const CStdString &label) const
+{
+  m_infoLabels[image ? -info : info] = label;
+}
+
 void CGUIListItem::SetProperty(const CStdString &strKey, const CVariant &value)
 {
   m_mapProperties[strKey] = value;
+  SetInfoChanged();
 }
 
 CVariant CGUIListItem::GetProperty(const CStdString &strKey) const
@@ -374,12 +415,16 @@ void CGUIListItem::ClearProperty(const CStdString &strKey)
 {
   PropertyMap::iterator iter = m_mapProperties.find(strKey);
   if (iter != m_mapProperties.end())
+  {
     m_mapProperties.erase(iter);
+    SetInfoChanged();
+  }
 }
 
 void CGUIListItem::ClearProperties()
 {
   m_mapProperties.clear();
+  SetInfoChanged();
 }
 
 void CGUIListItem::IncrementProperty(const CStdString &strKey, int nVal)
@@ -113,8 +113,28 @@ public:
 
   void FreeIcons();
   void FreeMemory(bool immediately = false);
+
+  /*! \brief Mark the item as changed, so that its layouts are updated
+   \sa SetLayoutsInvalid
+   */
   void SetInvalid();
 
+  /*! \brief Have the layouts of the item updated without the item itself having changed,
+   e.g. as the container it is shown in has. Info labels that only depend on the item are
+   taken from the cache rather than evaluated again.
+   \sa SetInvalid, GetCachedInfoLabel
+   */
+  void SetLayoutsInvalid();
+
+  /*! \brief Retrieve the value of an info label for this item, as cached by SetCachedInfoLabel
+   \param info the info label
+   \param image whether the image rather than the label of the info is wanted
+   \param label [out] the value of the info label
+   \return true if the value is cached and the item hasn't changed since
+   */
+  bool GetCachedInfoLabel(int info, bool image, CStdString &label) const;
+  void SetCachedInfoLabel(int info, bool image, const CStdString &label) const;
+
   bool m_bIsFolder;     ///< is item a folder or a file
 
   void SetProperty(const CStdString &strKey, const CVariant &value);
@@ -140,6 +160,12 @@ public:
 
   CVariant   GetProperty(const CStdString &strKey) const;
 
+  /*! \brief Note that the info of the item changed, so that its cached info labels are evaluated again
+   Call it once the change is complete, e.g. after filling in a tag.
+   \sa GetCachedInfoLabel
+   */
+  void SetInfoChanged();
+
 protected:
   CStdString m_strLabel2;     // text of column2
   CStdString m_strThumbnailImage; // filename of thumbnail
@@ -163,6 +189,10 @@ protected:
 private:
   CStdStringW m_sortLabel;    // text for sorting. Need to be UTF16 for proper sorting
   CStdString m_strLabel;      // text of column1
+
+  volatile long m_version;    // changed whenever the item is, atomically as the item may be changed from other threads
+  mutable std::map<int, CStdString> m_infoLabels;  // cached info labels, keyed by info (negated for images)
+  mutable long m_infoLabelsVersion;                // version of the item the cached info labels are of
 };
 #endif
 
@@ -99,7 +99,8 @@ void CGUIRSSControl::Process(unsigned int currentTime, CDirtyRegionList &dirtyre
 void CGUIRSSControl::Render()
 {
   // only render the control if they are enabled
-  if (g_guiSettings.GetBool("lookandfeel.enablerssfeeds") && g_rssManager.IsActive())
+  static CSettingHandle enableRSS("lookandfeel.enablerssfeeds");
+  if (g_guiSettings.GetBool(enableRSS) && g_rssManager.IsActive())
   {
     CSingleLock lock(m_criticalSection);
     // Create RSS background/worker thread if needed
@@ -22,6 +22,7 @@
 #include "GUITexture.h"
 #include "GraphicContext.h"
 #include "TextureManager.h"
+#include "Texture.h"
 #include "GUILargeTextureManager.h"
 #include "utils/MathUtils.h"
 
@@ -551,6 +552,20 @@ bool CGUITextureBase::ReadyToRender() const
   return m_texture.size() > 0;
 }
 
+bool CGUITextureBase::IsOpaque() const
+{
+  if (!m_visible || !m_texture.size() || m_diffuse.size())
+    return false;
+  if (m_alpha != 0xFF || (m_diffuseColor >> 24) != 0xFF)
+    return false;
+  for (vector<CBaseTexture *>::const_iterator i = m_texture.m_textures.begin(); i != m_texture.m_textures.end(); ++i)
+  {
+    if ((*i)->HasAlpha())
+      return false;
+  }
+  return true;
+}
+
 void CGUITextureBase::OrientateTexture(CRect &rect, float width, float height, int orientation)
 {
   switch (orientation & 3)
@@ -120,6 +120,10 @@ public:
   bool IsAllocated() const { return m_isAllocated != NO; };
   bool FailedToAlloc() const { return m_isAllocated == NORMAL_FAILED || m_isAllocated == LARGE_FAILED; };
   bool ReadyToRender() const;
+  /*! \brief Whether the texture completely hides what is behind its render rect
+   True for visible textures without a diffuse texture or any transparency.
+   */
+  bool IsOpaque() const;
 protected:
   bool CalculateSize();
   void LoadDiffuseImage();
@@ -181,6 +185,9 @@ protected:
 #elif defined(HAS_DX)
 #include "GUITextureD3D.h"
 #define CGUITexture CGUITextureD3D
+#elif defined(HAS_HEADLESS)
+#include "GUITextureNull.h"
+#define CGUITexture CGUITextureNull
 #endif
 
 #endif
@@ -0,0 +1,64 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+
+#include "system.h"
+#if defined(HAS_HEADLESS)
+#include "GUITextureNull.h"
+#endif
+#include "Texture.h"
+#include "windowing/WindowingFactory.h"
+
+#if defined(HAS_HEADLESS)
+
+CGUITextureNull::CGUITextureNull(float posX, float posY, float width, float height, const CTextureInfo &texture)
+: CGUITextureBase(posX, posY, width, height, texture)
+{
+  m_quads = 0;
+}
+
+void CGUITextureNull::Begin(color_t color)
+{
+  CBaseTexture* texture = m_texture.m_textures[m_currentFrame];
+  texture->LoadToGPU();
+  if (m_diffuse.size())
+    m_diffuse.m_textures[0]->LoadToGPU();
+  m_quads = 0;
+}
+
+void CGUITextureNull::End()
+{
+  g_Windowing.AddDrawCall(m_quads);
+}
+
+void CGUITextureNull::Draw(float *x, float *y, float *z, const CRect &texture, const CRect &diffuse, int orientation)
+{
+  m_quads++;
+}
+
+void CGUITextureNull::DrawQuad(const CRect &rect, color_t color, CBaseTexture *texture, const CRect *texCoords)
+{
+  if (texture)
+    texture->LoadToGPU();
+  g_Windowing.AddDrawCall(1);
+}
+
+#endif
@@ -0,0 +1,52 @@
+/*!
+\file GUITextureNull.h
+\brief
+*/
+
+#ifndef GUILIB_GUITEXTURENULL_H
+#define GUILIB_GUITEXTURENULL_H
+
+#pragma once
+
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+
+#include "GUITexture.h"
+
+/*!
+ \ingroup textures
+ \brief Texture renderer for headless builds that only counts what would be drawn
+ */
+class CGUITextureNull : public CGUITextureBase
+{
+public:
+  CGUITextureNull(float posX, float posY, float width, float height, const CTextureInfo& texture);
+  static void DrawQuad(const CRect &coords, color_t color, CBaseTexture *texture = NULL, const CRect *texCoords = NULL);
+protected:
+  void Begin(color_t color);
+  void Draw(float *x, float *y, float *z, const CRect &texture, const CRect &diffuse, int orientation);
+  void End();
+private:
+  unsigned int m_quads;
+};
+
+#endif
@@ -27,6 +27,8 @@
 #include "GUIControlFactory.h"
 #include "GUIControlGroup.h"
 #include "GUIControlProfiler.h"
+#include "GUIWindowCache.h"
+#include "TextureManager.h"
 #include "settings/Settings.h"
 #ifdef PRE_SKIN_VERSION_9_10_COMPATIBILITY
 #include "GUIEditControl.h"
@@ -48,6 +50,8 @@
 #include "utils/PerformanceSample.h"
 #endif
 
+#include <set>
+
 using namespace std;
 
 CGUIWindow::CGUIWindow(int id, const CStdString &xmlFile)
@@ -60,6 +64,7 @@ CGUIWindow::CGUIWindow(int id, const CStdString &xmlFile)
   m_isDialog = false;
   m_needsScaling = true;
   m_windowLoaded = false;
+  m_loadedCompiled = false;
   m_loadOnDemand = true;
   m_closing = false;
   m_active = false;
@@ -102,13 +107,17 @@ bool CGUIWindow::Load(const CStdString& strFileName, bool bContainsPath)
     strPath = g_SkinInfo->GetSkinPath(strFileName, &m_coordsRes);
   }
 
+  m_loadedCompiled = false;
   bool ret = LoadXML(strPath.c_str(), strLowerPath.c_str());
 
 #ifdef _DEBUG
   int64_t end, freq;
   end = CurrentHostCounter();
   freq = CurrentHostFrequency();
-  CLog::Log(LOGDEBUG,"Load %s: %.2fms", GetProperty("xmlfile").c_str(), 1000.f * (end - start) / freq);
+  float time = 1000.f * (end - start) / freq;
+  CLog::Log(LOGDEBUG,"Load %s: %.2fms%s", GetProperty("xmlfile").c_str(), time, m_loadedCompiled ? " (compiled)" : "");
+  if (ret)
+    CGUIWindowCache::Get().AddLoadTime(strPath, time, m_loadedCompiled);
 #endif
   return ret;
 }
@@ -116,17 +125,61 @@ bool CGUIWindow::Load(const CStdString& strFileName, bool bContainsPath)
 bool CGUIWindow::LoadXML(const CStdString &strPath, const CStdString &strLowerPath)
 {
   CXBMCTinyXML xmlDoc;
-  if ( !xmlDoc.LoadFile(strPath) && !xmlDoc.LoadFile(CStdString(strPath).ToLower()) && !xmlDoc.LoadFile(strLowerPath))
+  if (CGUIWindowCache::Get().Load(strPath, xmlDoc))
   {
-    CLog::Log(LOGERROR, "unable to load:%s, Line %d\n%s", strPath.c_str(), xmlDoc.ErrorRow(), xmlDoc.ErrorDesc());
-    SetID(WINDOW_INVALID);
-    return false;
+    m_loadedCompiled = true;
+    return Load(xmlDoc, true);
   }
 
+  CStdString loadedPath = strPath;
+  if (!xmlDoc.LoadFile(loadedPath))
+  {
+    loadedPath = CStdString(strPath).ToLower();
+    if (!xmlDoc.LoadFile(loadedPath))
+    {
+      loadedPath = strLowerPath;
+      if (!xmlDoc.LoadFile(loadedPath))
+      {
+        CLog::Log(LOGERROR, "unable to load:%s, Line %d\n%s", strPath.c_str(), xmlDoc.ErrorRow(), xmlDoc.ErrorDesc());
+        SetID(WINDOW_INVALID);
+        return false;
+      }
+    }
+  }
+
+  // resolve the includes here rather than in Load() so that the result can be cached
+  TiXmlElement* pRootElement = xmlDoc.RootElement();
+  if (pRootElement && strcmpi(pRootElement->Value(), "window") == 0)
+  {
+    bool conditional = false;
+    g_SkinInfo->ResolveIncludes(pRootElement, &conditional);
+    if (!conditional)
+      CGUIWindowCache::Get().Save(strPath, loadedPath, xmlDoc);
+    return Load(xmlDoc, true);
+  }
   return Load(xmlDoc);
 }
 
-bool CGUIWindow::Load(CXBMCTinyXML &xmlDoc)
+// collect the textures named in a window (or include), skipping those that depend on info labels
+static void GetTexturesFromXML(const TiXmlElement *element, set<CStdString> &textures)
+{
+  for (const TiXmlElement *child = element->FirstChildElement(); child; child = child->NextSiblingElement())
+  {
+    CStdString tag(child->Value());
+    if (tag.ToLower().Find("texture") >= 0 && child->FirstChild())
+    {
+      CStdString texture(child->FirstChild()->Value());
+      if (!texture.IsEmpty() && texture.Find('$') < 0)
+        textures.insert(texture);
+      const char *diffuse = child->Attribute("diffuse");
+      if (diffuse && *diffuse && !strchr(diffuse, '$'))
+        textures.insert(diffuse);
+    }
+    GetTexturesFromXML(child, textures);
+  }
+}
+
+bool CGUIWindow::Load(CXBMCTinyXML &xmlDoc, bool resolved /* = false */)
 {
   TiXmlElement* pRootElement = xmlDoc.RootElement();
   if (strcmpi(pRootElement->Value(), "window"))
@@ -140,7 +193,13 @@ bool CGUIWindow::Load(CXBMCTinyXML &xmlDoc)
   g_graphicsContext.SetScalingResolution(m_coordsRes, m_needsScaling);
 
   // Resolve any includes that may be present
-  g_SkinInfo->ResolveIncludes(pRootElement);
+  if (!resolved)
+    g_SkinInfo->ResolveIncludes(pRootElement);
+
+  // get the bundled textures unpacking while we create the controls that need them
+  set<CStdString> textures;
+  GetTexturesFromXML(pRootElement, textures);
+  g_TextureManager.PrefetchTextures(vector<CStdString>(textures.begin(), textures.end()));
   // now load in the skin file
   SetDefaults();
 
@@ -339,6 +398,14 @@ void CGUIWindow::Render()
     Close(true);
 }
 
+void CGUIWindow::SkipRender()
+{
+  CGUIControlGroup::SkipRender();
+  // we may finish closing while hidden behind another window
+  if (m_closing && !CGUIControlGroup::IsAnimating(ANIM_TYPE_WINDOW_CLOSE))
+    Close(true);
+}
+
 void CGUIWindow::Close_Internal(bool forceClose /*= false*/, int nextWindowID /*= 0*/, bool enableSound /*= true*/)
 {
   CSingleLock lock(g_graphicsContext);
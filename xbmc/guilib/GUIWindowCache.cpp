@@ -0,0 +1,259 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "GUIWindowCache.h"
+#include "addons/Skin.h"
+#include "filesystem/File.h"
+#include "settings/AdvancedSettings.h"
+#include "threads/SingleLock.h"
+#include "utils/PersistentCacheFile.h"
+#include "utils/XBMCTinyXML.h"
+#include "utils/log.h"
+
+using namespace std;
+using namespace XFILE;
+
+#define WINDOW_CACHE_PATH     "special://temp/skincache/"
+#define WINDOW_CACHE_EXT      ".bin"
+#define WINDOW_CACHE_VERSION  1
+
+// sanity limits for reading back a cache file, which may be truncated or corrupt
+#define WINDOW_CACHE_MAX_DEPTH    256
+#define WINDOW_CACHE_MAX_CHILDREN 65536
+
+enum WindowCacheNode
+{
+  NODE_END = 0,
+  NODE_ELEMENT,
+  NODE_TEXT,
+  NODE_CDATA
+};
+
+CGUIWindowCache::CGUIWindowCache()
+{
+  m_hits = 0;
+  m_misses = 0;
+}
+
+CGUIWindowCache& CGUIWindowCache::Get()
+{
+  static CGUIWindowCache windowCache;
+  return windowCache;
+}
+
+int64_t CGUIWindowCache::GetModifiedTime(const CStdString &file)
+{
+  struct __stat64 buffer;
+  if (CFile::Stat(file, &buffer) != 0)
+    return 0;
+  return buffer.st_mtime;
+}
+
+bool CGUIWindowCache::Load(const CStdString &windowFile, CXBMCTinyXML &xmlDoc)
+{
+  if (!g_SkinInfo || !g_advancedSettings.m_guiCacheWindows)
+    return false;
+
+  CPersistentCacheFile cacheFile(WINDOW_CACHE_PATH, WINDOW_CACHE_EXT, WINDOW_CACHE_VERSION);
+  CArchive *ar = cacheFile.Load(windowFile);
+  if (!ar)
+  {
+    CSingleLock lock(m_cs);
+    m_misses++;
+    return false;
+  }
+
+  CStdString skinID, skinVersion, loadedFile;
+  int64_t modifiedTime;
+  *ar >> skinID;
+  *ar >> skinVersion;
+  *ar >> loadedFile;
+  *ar >> modifiedTime;
+  // the skin may have been updated
+  bool valid = skinID == g_SkinInfo->ID() &&
+               skinVersion == g_SkinInfo->Version().c_str() &&
+               modifiedTime && modifiedTime == GetModifiedTime(loadedFile);
+
+  vector<CStdString> includeFiles;
+  int count = 0;
+  if (valid)
+    *ar >> count;
+  for (int i = 0; i < count && valid; i++)
+  {
+    CStdString includeFile;
+    *ar >> includeFile;
+    *ar >> modifiedTime;
+    valid = modifiedTime && modifiedTime == GetModifiedTime(includeFile);
+    includeFiles.push_back(includeFile);
+  }
+
+  if (valid)
+  {
+    xmlDoc.Clear();
+    valid = LoadNode(*ar, &xmlDoc, 0) && xmlDoc.RootElement();
+  }
+  cacheFile.Close();
+
+  if (valid)
+  { // the window may refer to skin variables from include files that aren't loaded yet
+    for (vector<CStdString>::const_iterator i = includeFiles.begin(); i != includeFiles.end(); ++i)
+      g_SkinInfo->LoadIncludeFile(*i);
+  }
+
+  CSingleLock lock(m_cs);
+  if (valid)
+    m_hits++;
+  else
+    m_misses++;
+  return valid;
+}
+
+void CGUIWindowCache::Save(const CStdString &windowFile, const CStdString &loadedFile, const CXBMCTinyXML &xmlDoc)
+{
+  if (!g_SkinInfo || !g_advancedSettings.m_guiCacheWindows || !xmlDoc.RootElement())
+    return;
+
+  int64_t modifiedTime = GetModifiedTime(loadedFile);
+  if (!modifiedTime)
+    return;
+
+  CPersistentCacheFile cacheFile(WINDOW_CACHE_PATH, WINDOW_CACHE_EXT, WINDOW_CACHE_VERSION);
+  CArchive *ar = cacheFile.Store(windowFile);
+  if (!ar)
+    return;
+
+  vector<CStdString> includeFiles;
+  g_SkinInfo->GetIncludeFiles(includeFiles);
+
+  *ar << g_SkinInfo->ID();
+  *ar << CStdString(g_SkinInfo->Version().c_str());
+  *ar << loadedFile;
+  *ar << modifiedTime;
+  *ar << (int)includeFiles.size();
+  for (vector<CStdString>::const_iterator i = includeFiles.begin(); i != includeFiles.end(); ++i)
+  {
+    *ar << *i;
+    *ar << GetModifiedTime(*i);
+  }
+  SaveNode(*ar, xmlDoc.RootElement());
+  *ar << (char)NODE_END;
+  cacheFile.Close();
+}
+
+void CGUIWindowCache::SaveNode(CArchive &ar, const TiXmlNode *node)
+{
+  if (node->Type() == TiXmlNode::TINYXML_TEXT)
+  {
+    const TiXmlText *text = node->ToText();
+    ar << (char)(text->CDATA() ? NODE_CDATA : NODE_TEXT);
+    ar << CStdString(text->ValueStr());
+    return;
+  }
+  if (node->Type() != TiXmlNode::TINYXML_ELEMENT)
+    return; // comments and the like aren't needed
+
+  const TiXmlElement *element = node->ToElement();
+  ar << (char)NODE_ELEMENT;
+  ar << CStdString(element->ValueStr());
+
+  int count = 0;
+  for (const TiXmlAttribute *attribute = element->FirstAttribute(); attribute; attribute = attribute->Next())
+    count++;
+  ar << count;
+  for (const TiXmlAttribute *attribute = element->FirstAttribute(); attribute; attribute = attribute->Next())
+  {
+    ar << CStdString(attribute->Name());
+    ar << CStdString(attribute->ValueStr());
+  }
+
+  for (const TiXmlNode *child = element->FirstChild(); child; child = child->NextSibling())
+    SaveNode(ar, child);
+  ar << (char)NODE_END;
+}
+
+bool CGUIWindowCache::LoadNode(CArchive &ar, TiXmlNode *parent, int depth)
+{
+  if (depth > WINDOW_CACHE_MAX_DEPTH)
+    return false;
+
+  for (int children = 0; children < WINDOW_CACHE_MAX_CHILDREN; children++)
+  {
+    char type = NODE_END;
+    ar >> type;
+    if (type == NODE_END)
+      return true;
+
+    CStdString value;
+    ar >> value;
+    if (type == NODE_TEXT || type == NODE_CDATA)
+    {
+      TiXmlText text(value);
+      text.SetCDATA(type == NODE_CDATA);
+      parent->InsertEndChild(text);
+    }
+    else if (type == NODE_ELEMENT)
+    {
+      TiXmlElement *element = new TiXmlElement(value);
+      parent->LinkEndChild(element);
+
+      int count = 0;
+      ar >> count;
+      if (count < 0 || count > WINDOW_CACHE_MAX_CHILDREN)
+        return false;
+      for (int i = 0; i < count; i++)
+      {
+        CStdString name, attribute;
+        ar >> name;
+        ar >> attribute;
+        element->SetAttribute(name, attribute);
+      }
+      if (!LoadNode(ar, element, depth + 1))
+        return false;
+    }
+    else
+      return false;
+  }
+  return false;
+}
+
+void CGUIWindowCache::AddLoadTime(const CStdString &windowFile, float time, bool compiled)
+{
+  CSingleLock lock(m_cs);
+  CLoadTime &loadTime = m_loadTimes[windowFile];
+  loadTime.m_time = time;
+  loadTime.m_compiled = compiled;
+}
+
+void CGUIWindowCache::PrintStats() const
+{
+  CSingleLock lock(m_cs);
+  if (!m_hits && !m_misses)
+    return;
+
+  float total = 0;
+  for (map<CStdString, CLoadTime>::const_iterator i = m_loadTimes.begin(); i != m_loadTimes.end(); ++i)
+  {
+    CLog::Log(LOGDEBUG, "%s: %s %.2fms%s", __FUNCTION__, i->first.c_str(), i->second.m_time, i->second.m_compiled ? " (compiled)" : "");
+    total += i->second.m_time;
+  }
+  CLog::Log(LOGDEBUG, "%s: %u windows loaded in %.2fms, %u compiled, %u parsed",
+            __FUNCTION__, (unsigned int)m_loadTimes.size(), total, m_hits, m_misses);
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "utils/StdString.h"
+#include "threads/CriticalSection.h"
+
+#include <map>
+
+class CArchive;
+class CXBMCTinyXML;
+class TiXmlNode;
+
+/*!
+ \ingroup windows
+ \brief Cache of compiled skin windows
+
+ Loading a window parses its XML and then resolves the includes, defaults and constants
+ of the skin, copying elements from the include files into the window. The result only
+ changes when the skin or one of its files does, so the resolved tree is stored in a
+ compact binary form in special://temp/skincache/ and loaded from there next time,
+ skipping both the XML parser and the include resolution.
+
+ Windows with conditional includes are not cached, as their tree depends on the state
+ at load time. The cache is turned off with <gui><cachewindows>false</cachewindows></gui>
+ in advancedsettings.xml.
+ */
+class CGUIWindowCache
+{
+public:
+  CGUIWindowCache();
+
+  static CGUIWindowCache& Get();
+
+  /*!
+   \brief Load the compiled tree of a window
+   \param windowFile the path of the window XML
+   \param xmlDoc [out] receives the window with its includes resolved
+   \return true if an up to date compiled window was found
+   */
+  bool Load(const CStdString &windowFile, CXBMCTinyXML &xmlDoc);
+
+  /*!
+   \brief Store the compiled tree of a window
+   \param windowFile the path of the window XML
+   \param loadedFile the file the XML was actually loaded from
+   \param xmlDoc the window with its includes resolved
+   */
+  void Save(const CStdString &windowFile, const CStdString &loadedFile, const CXBMCTinyXML &xmlDoc);
+
+  /*!
+   \brief Account for the time taken to load a window, debug builds only
+   \param windowFile the path of the window XML
+   \param time the time in ms it took to load the window and create its controls
+   \param compiled whether the window was loaded from the cache
+   */
+  void AddLoadTime(const CStdString &windowFile, float time, bool compiled);
+
+  void PrintStats() const;
+
+private:
+  static int64_t GetModifiedTime(const CStdString &file);
+  static void SaveNode(CArchive &ar, const TiXmlNode *node);
+  static bool LoadNode(CArchive &ar, TiXmlNode *parent, int depth);
+
+  struct CLoadTime
+  {
+    float m_time;
+    bool m_compiled;
+  };
+  std::map<CStdString, CLoadTime> m_loadTimes; ///< most recent load time of each window
+
+  CCriticalSection m_cs;
+
+  unsigned int m_hits;
+  unsigned int m_misses;
+};
@@ -44,6 +44,8 @@ CGUIWindowManager::CGUIWindowManager(void)
   m_bShowOverlay = true;
   m_iNested = 0;
   m_initialized = false;
+  for (int i = 0; i < NUM_CONTROL_COUNTS; i++)
+    m_controlCounts[i] = m_lastControlCounts[i] = 0;
 }
 
 CGUIWindowManager::~CGUIWindowManager(void)
@@ -497,6 +499,9 @@ void CGUIWindowManager::Process(unsigned int currentTime)
 
   CDirtyRegionList dirtyregions;
 
+  m_lastControlCounts[CONTROL_PROCESSED] = m_controlCounts[CONTROL_PROCESSED];
+  m_controlCounts[CONTROL_PROCESSED] = 0;
+
   CGUIWindow* pWindow = GetWindow(GetActiveWindow());
   if (pWindow)
     pWindow->DoProcess(currentTime, dirtyregions);
@@ -523,20 +528,45 @@ void CGUIWindowManager::MarkDirty()
 
 void CGUIWindowManager::RenderPass()
 {
+  // we render the dialogs based on their render order.
+  vector<CGUIWindow *> renderList = m_activeDialogs;
+  stable_sort(renderList.begin(), renderList.end(), RenderOrderSortFunction);
+
+  // anything below a dialog that hides all of the region being rendered can't be seen
+  const CRect &scissors = g_graphicsContext.GetScissors();
+  iDialog firstSeen = renderList.begin();
+  bool windowHidden = false;
+  for (iDialog it = renderList.end(); it != renderList.begin();)
+  {
+    --it;
+    if ((*it)->IsDialogRunning() && (*it)->HidesRegion(scissors))
+    {
+      firstSeen = it;
+      windowHidden = true;
+      break;
+    }
+  }
+
   CGUIWindow* pWindow = GetWindow(GetActiveWindow());
   if (pWindow)
   {
-    pWindow->ClearBackground();
-    pWindow->DoRender();
+    if (windowHidden)
+      pWindow->SkipRender();
+    else
+    {
+      if (!pWindow->HidesRegion(scissors))
+        pWindow->ClearBackground();
+      pWindow->DoRender();
+    }
   }
 
-  // we render the dialogs based on their render order.
-  vector<CGUIWindow *> renderList = m_activeDialogs;
-  stable_sort(renderList.begin(), renderList.end(), RenderOrderSortFunction);
-  
   for (iDialog it = renderList.begin(); it != renderList.end(); ++it)
   {
-    if ((*it)->IsDialogRunning())
+    if (!(*it)->IsDialogRunning())
+      continue;
+    if (it < firstSeen)
+      (*it)->SkipRender();
+    else
       (*it)->DoRender();
   }
 }
@@ -548,6 +578,12 @@ bool CGUIWindowManager::Render()
 
   CDirtyRegionList dirtyRegions = m_tracker.GetDirtyRegions();
 
+  for (int i = CONTROL_RENDERED; i <= CONTROL_CULLED; i++)
+  {
+    m_lastControlCounts[i] = m_controlCounts[i];
+    m_controlCounts[i] = 0;
+  }
+
   bool hasRendered = false;
   // If we visualize the regions we will always render the entire viewport
   if (g_advancedSettings.m_guiVisualizeDirtyRegions || g_advancedSettings.m_guiAlgorithmDirtyRegions == DIRTYREGION_SOLVER_FILL_VIEWPORT_ALWAYS)
@@ -87,6 +87,17 @@ public:
    */
   bool Render();
 
+  enum CONTROL_COUNT { CONTROL_PROCESSED = 0, CONTROL_RENDERED, CONTROL_CULLED, NUM_CONTROL_COUNTS };
+
+  /*! \brief Count a control processed, rendered, or skipped as it couldn't be seen, in this frame
+   */
+  void CountControl(CONTROL_COUNT count) { m_controlCounts[count]++; };
+
+  /*! \brief Get the number of controls processed, rendered or skipped in the last frame
+   Controls are counted once for each dirty region they're rendered in.
+   */
+  unsigned int GetControlCount(CONTROL_COUNT count) const { return m_lastControlCounts[count]; };
+
   /*! \brief Per-frame updating of the current window and any dialogs
    FrameMove is called every frame to update the current window and any dialogs
    on screen. It should only be called from the application thread.
@@ -166,6 +177,9 @@ private:
   bool m_initialized;
 
   CDirtyRegionTracker m_tracker;
+
+  unsigned int m_controlCounts[NUM_CONTROL_COUNTS];     ///< controls counted so far in this frame
+  unsigned int m_lastControlCounts[NUM_CONTROL_COUNTS]; ///< controls counted in the last frame
 };
 
 /*!
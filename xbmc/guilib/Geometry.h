@@ -93,6 +93,16 @@ public:
     return false;
   };
 
+  bool Contains(const CRect &rect) const
+  {
+    return x1 <= rect.x1 && y1 <= rect.y1 && rect.x2 <= x2 && rect.y2 <= y2;
+  };
+
+  bool Intersects(const CRect &rect) const
+  {
+    return x1 < rect.x2 && rect.x1 < x2 && y1 < rect.y2 && rect.y1 < y2;
+  };
+
   inline const CRect &operator -=(const CPoint &point) XBMC_FORCE_INLINE
   {
     x1 -= point.x;
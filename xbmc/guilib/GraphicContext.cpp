@@ -39,8 +39,8 @@ using namespace std;
 
 extern bool g_fullScreen;
 
-/* quick access to a skin setting, fine unless we starts clearing video settings */
-static CSettingInt* g_guiSkinzoom = NULL;
+/* quick access to a skin setting */
+static CSettingHandle g_guiSkinzoom("lookandfeel.skinzoom");
 
 CGraphicContext::CGraphicContext(void) :
   m_iScreenHeight(576),
@@ -586,12 +586,8 @@ void CGraphicContext::SetScalingResolution(const RESOLUTION_INFO &res, bool need
       fToHeight = (float)g_settings.m_ResInfo[m_Resolution].Overscan.bottom - fToPosY;
     }
 
-    if(!g_guiSkinzoom) // lookup gui setting if we didn't have it already
-      g_guiSkinzoom = (CSettingInt*)g_guiSettings.GetSetting("lookandfeel.skinzoom");
-
     float fZoom = 1.0f;
-    if(g_guiSkinzoom)
-      fZoom *= (100 + g_guiSkinzoom->GetData()) * 0.01f;
+    fZoom *= (100 + g_guiSettings.GetInt(g_guiSkinzoom)) * 0.01f;
 
     fZoom -= 1.0f;
     fToPosX -= fToWidth * fZoom * 0.5f;
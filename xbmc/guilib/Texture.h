@@ -129,4 +129,7 @@ protected:
 #elif defined(HAS_DX)
 #include "TextureDX.h"
 #define CTexture CDXTexture
+#elif defined(HAS_HEADLESS)
+#include "TextureNull.h"
+#define CTexture CNullTexture
 #endif
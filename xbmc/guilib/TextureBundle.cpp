@@ -104,6 +104,19 @@ int CTextureBundle::LoadAnim(const CStdString& Filename, CBaseTexture*** ppTextu
   }
 }
 
+void CTextureBundle::PrefetchTexture(const CStdString& Filename)
+{
+  // xpr bundles are only read on demand
+  if (m_useXBT)
+    m_tbXBT.PrefetchTexture(Filename);
+}
+
+void CTextureBundle::PrintStats() const
+{
+  if (m_useXBT)
+    m_tbXBT.PrintStats();
+}
+
 void CTextureBundle::Cleanup()
 {
   m_tbXBT.Cleanup();
@@ -42,6 +42,9 @@ public:
 
   int LoadAnim(const CStdString& Filename, CBaseTexture*** ppTextures, int &width, int &height, int& nLoops, int** ppDelays);
 
+  void PrefetchTexture(const CStdString& Filename);
+  void PrintStats() const;
+
 private:
   CTextureBundleXPR m_tbXPR;
   CTextureBundleXBT m_tbXBT;
@@ -31,15 +31,90 @@
 #include "utils/EndianSwap.h"
 #include "utils/URIUtils.h"
 #include "XBTF.h"
+#include "threads/SingleLock.h"
+#include "utils/JobManager.h"
+#include "utils/TimeUtils.h"
 #include <lzo/lzo1x.h>
+#include <algorithm>
 
 #ifdef _WIN32
 #pragma comment(lib,"liblzo2.lib")
 #endif
 
+// don't keep more than this many bytes of unpacked textures around waiting to be loaded,
+// the oldest are dropped to make room as they are the least likely to still be wanted
+#define XBT_PREFETCH_MAX_SIZE (64 * 1024 * 1024)
+
+class CXBTFUnpackJob : public CJob
+{
+public:
+  CXBTFUnpackJob(const CTextureBundleXBT::CPrefetchPtr &prefetch) : m_prefetch(prefetch) {}
+  virtual const char *GetType() const { return "xbtunpack"; }
+  virtual bool DoWork()
+  {
+    m_prefetch->Unpack();
+    return true;
+  }
+private:
+  CTextureBundleXBT::CPrefetchPtr m_prefetch;
+};
+
+CTextureBundleXBT::CPrefetch::CPrefetch(const CXBTFFrame& frame, const unsigned char* packed)
+  : m_frame(frame), m_packed(packed), m_unpacked(NULL), m_jobID(0)
+{
+}
+
+CTextureBundleXBT::CPrefetch::~CPrefetch()
+{
+  delete[] m_unpacked;
+}
+
+void CTextureBundleXBT::CPrefetch::Unpack()
+{
+  CSingleLock lock(m_section);
+  if (!m_packed)
+    return;
+
+  unsigned char *unpacked = new unsigned char[(size_t)m_frame.GetUnpackedSize()];
+  lzo_uint s = (lzo_uint)m_frame.GetUnpackedSize();
+  if (lzo1x_decompress(m_packed, (lzo_uint)m_frame.GetPackedSize(), unpacked, &s, NULL) == LZO_E_OK &&
+      s == m_frame.GetUnpackedSize())
+    m_unpacked = unpacked;
+  else
+    delete[] unpacked;
+  m_packed = NULL;
+}
+
+unsigned char* CTextureBundleXBT::CPrefetch::Take()
+{
+  // don't wait for a job that is still queued behind other work, drop it and unpack here
+  CJobManager::GetInstance().CancelJob(m_jobID);
+
+  // waits for the job if it's unpacking right now
+  CSingleLock lock(m_section);
+  if (m_packed)
+    Unpack();
+  unsigned char *unpacked = m_unpacked;
+  m_unpacked = NULL;
+  return unpacked;
+}
+
+void CTextureBundleXBT::CPrefetch::Cancel()
+{
+  // waits for the job if it's unpacking right now
+  CSingleLock lock(m_section);
+  m_packed = NULL;
+}
+
 CTextureBundleXBT::CTextureBundleXBT(void)
 {
   m_themeBundle = false;
+  m_prefetchedSize = 0;
+  m_loadCount = 0;
+  m_prefetchHits = 0;
+  m_prefetchCount = 0;
+  m_prefetchEvicted = 0;
+  m_loadTime = 0;
 }
 
 CTextureBundleXBT::~CTextureBundleXBT(void)
@@ -191,8 +266,117 @@ int CTextureBundleXBT::LoadAnim(const CStdString& Filename, CBaseTexture*** ppTe
   return nTextures;
 }
 
+void CTextureBundleXBT::PrefetchTexture(const CStdString& Filename)
+{
+  CXBTFFile* file = m_XBTFReader.Find(Normalize(Filename));
+  if (!file)
+    return;
+
+  CSingleLock lock(m_section);
+  for (size_t i = 0; i < file->GetFrames().size(); i++)
+  {
+    const CXBTFFrame& frame = file->GetFrames()[i];
+    // unpacked frames are copied straight from the mapped bundle, nothing to gain there
+    const unsigned char* packed = m_XBTFReader.GetData(frame);
+    if (!packed || !frame.IsPacked() || m_prefetched.find(frame.GetOffset()) != m_prefetched.end())
+      continue;
+
+    if (frame.GetUnpackedSize() > XBT_PREFETCH_MAX_SIZE)
+      continue;
+    while (m_prefetchedSize + frame.GetUnpackedSize() > XBT_PREFETCH_MAX_SIZE)
+      EvictPrefetched();
+
+    CPrefetchPtr prefetch(new CPrefetch(frame, packed));
+    m_prefetched[frame.GetOffset()] = prefetch;
+    m_prefetchOrder.push_back(frame.GetOffset());
+    m_prefetchedSize += frame.GetUnpackedSize();
+    m_prefetchCount++;
+    prefetch->m_jobID = CJobManager::GetInstance().AddJob(new CXBTFUnpackJob(prefetch), NULL, CJob::PRIORITY_NORMAL);
+  }
+}
+
+unsigned char* CTextureBundleXBT::TakePrefetched(const CXBTFFrame& frame)
+{
+  CSingleLock lock(m_section);
+  std::map<uint64_t, CPrefetchPtr>::iterator it = m_prefetched.find(frame.GetOffset());
+  if (it == m_prefetched.end())
+    return NULL;
+
+  CPrefetchPtr prefetch = it->second;
+  m_prefetched.erase(it);
+  m_prefetchOrder.erase(std::find(m_prefetchOrder.begin(), m_prefetchOrder.end(), frame.GetOffset()));
+  m_prefetchedSize -= frame.GetUnpackedSize();
+  lock.Leave();
+
+  unsigned char *unpacked = prefetch->Take();
+  if (unpacked)
+  {
+    lock.Enter();
+    m_prefetchHits++;
+  }
+  return unpacked;
+}
+
+void CTextureBundleXBT::EvictPrefetched()
+{
+  CSingleLock lock(m_section);
+  std::map<uint64_t, CPrefetchPtr>::iterator it = m_prefetched.find(m_prefetchOrder.front());
+  m_prefetchOrder.pop_front();
+
+  // the unpacked frame goes with the last reference, which may be the job's
+  it->second->Cancel();
+  m_prefetchedSize -= it->second->m_frame.GetUnpackedSize();
+  m_prefetched.erase(it);
+  m_prefetchEvicted++;
+}
+
+void CTextureBundleXBT::ClearPrefetched()
+{
+  CSingleLock lock(m_section);
+  // the jobs read straight from the mapped bundle, so stop them before it goes away
+  for (std::map<uint64_t, CPrefetchPtr>::iterator it = m_prefetched.begin(); it != m_prefetched.end(); ++it)
+    it->second->Cancel();
+  m_prefetched.clear();
+  m_prefetchOrder.clear();
+  m_prefetchedSize = 0;
+}
+
+void CTextureBundleXBT::PrintStats() const
+{
+  if (!m_loadCount)
+    return;
+
+  CLog::Log(LOGDEBUG, "%s - %sbundle: loaded %u textures in %.2fms, %u of %u prefetched frames used, %u dropped unused",
+            __FUNCTION__, m_themeBundle ? "theme " : "", m_loadCount,
+            1000.f * m_loadTime / CurrentHostFrequency(), m_prefetchHits, m_prefetchCount, m_prefetchEvicted);
+}
+
 bool CTextureBundleXBT::ConvertFrameToTexture(const CStdString& name, CXBTFFrame& frame, CBaseTexture** ppTexture)
 {
+  int64_t start = CurrentHostCounter();
+  m_loadCount++;
+
+  // unpacked in the background already?
+  squish::u8 *prefetched = frame.IsPacked() ? TakePrefetched(frame) : NULL;
+  if (prefetched)
+  {
+    *ppTexture = new CTexture();
+    (*ppTexture)->LoadFromMemory(frame.GetWidth(), frame.GetHeight(), 0, frame.GetFormat(), frame.HasAlpha(), prefetched);
+    delete[] prefetched;
+    m_loadTime += CurrentHostCounter() - start;
+    return true;
+  }
+
+  // no need to copy unpacked frames out of a mapped bundle
+  const unsigned char* mapped = m_XBTFReader.GetData(frame);
+  if (mapped && !frame.IsPacked())
+  {
+    *ppTexture = new CTexture();
+    (*ppTexture)->LoadFromMemory(frame.GetWidth(), frame.GetHeight(), 0, frame.GetFormat(), frame.HasAlpha(), const_cast<unsigned char*>(mapped));
+    m_loadTime += CurrentHostCounter() - start;
+    return true;
+  }
+
   // found texture - allocate the necessary buffers
   squish::u8 *buffer = new squish::u8[(size_t)frame.GetPackedSize()];
   if (buffer == NULL)
@@ -238,11 +422,19 @@ bool CTextureBundleXBT::ConvertFrameToTexture(const CStdString& name, CXBTFFrame
 
   delete[] buffer;
 
+  m_loadTime += CurrentHostCounter() - start;
   return true;
 }
 
 void CTextureBundleXBT::Cleanup()
 {
+  ClearPrefetched();
+  m_loadCount = 0;
+  m_prefetchHits = 0;
+  m_prefetchCount = 0;
+  m_prefetchEvicted = 0;
+  m_loadTime = 0;
+
   if (m_XBTFReader.IsOpen())
   {
     m_XBTFReader.Close();
@@ -23,7 +23,10 @@
 
 #include "utils/StdString.h"
 #include <map>
+#include <deque>
+#include <boost/shared_ptr.hpp>
 #include "XBTFReader.h"
+#include "threads/CriticalSection.h"
 
 class CBaseTexture;
 
@@ -45,14 +48,55 @@ public:
   int LoadAnim(const CStdString& Filename, CBaseTexture*** ppTextures,
                 int &width, int &height, int& nLoops, int** ppDelays);
 
+  /*! \brief Start unpacking the frames of a texture in the background
+   The unpacked frames are picked up by the next LoadTexture() or LoadAnim() of the texture.
+   */
+  void PrefetchTexture(const CStdString& Filename);
+
+  void PrintStats() const;
+
+  /*! \brief A frame that is (being) unpacked in the background
+   Shared with the unpacking job, as we may go away before it is done.
+   */
+  class CPrefetch
+  {
+  public:
+    CPrefetch(const CXBTFFrame& frame, const unsigned char* packed);
+    ~CPrefetch();
+    void Unpack();
+    unsigned char* Take();
+    void Cancel();
+
+    CXBTFFrame           m_frame;
+    const unsigned char* m_packed;   ///< points into the mapped bundle, NULL once unpacked or cancelled
+    unsigned char*       m_unpacked;
+    unsigned int         m_jobID;
+    CCriticalSection     m_section;  ///< held for the whole unpack
+  };
+  typedef boost::shared_ptr<CPrefetch> CPrefetchPtr;
+
 private:
   bool OpenBundle();
   bool ConvertFrameToTexture(const CStdString& name, CXBTFFrame& frame, CBaseTexture** ppTexture);
+  unsigned char* TakePrefetched(const CXBTFFrame& frame);
+  void EvictPrefetched();
+  void ClearPrefetched();
 
   time_t m_TimeStamp;
 
   bool m_themeBundle;
   CXBTFReader m_XBTFReader;
+
+  std::map<uint64_t, CPrefetchPtr> m_prefetched; ///< frames being unpacked, by offset
+  std::deque<uint64_t> m_prefetchOrder;          ///< offsets of the prefetched frames, oldest first
+  uint64_t m_prefetchedSize;
+  CCriticalSection m_section;
+
+  unsigned int m_loadCount;
+  unsigned int m_prefetchHits;
+  unsigned int m_prefetchCount;
+  unsigned int m_prefetchEvicted;
+  int64_t      m_loadTime;
 };
 
 
@@ -34,7 +34,9 @@
 #include "filesystem/File.h"
 #include "filesystem/Directory.h"
 #include "URL.h"
+#include "settings/AdvancedSettings.h"
 #include <assert.h>
+#include <algorithm>
 
 using namespace std;
 
@@ -128,6 +130,7 @@ CTextureMap::CTextureMap()
   m_textureName = "";
   m_referenceCount = 0;
   m_memUsage = 0;
+  m_lastUsed = 0;
 }
 
 CTextureMap::CTextureMap(const CStdString& textureName, int width, int height, int loops)
@@ -136,6 +139,7 @@ CTextureMap::CTextureMap(const CStdString& textureName, int width, int height, i
   m_textureName = textureName;
   m_referenceCount = 0;
   m_memUsage = 0;
+  m_lastUsed = 0;
 }
 
 CTextureMap::~CTextureMap()
@@ -216,6 +220,11 @@ CGUITextureManager::CGUITextureManager(void)
 {
   // we set the theme bundle to be the first bundle (thus prioritizing it)
   m_TexBundle[0].SetThemeBundle(true);
+  m_generation = 0;
+  m_unusedMemUsage = 0;
+  m_hits = 0;
+  m_loads = 0;
+  m_evictions = 0;
 }
 
 CGUITextureManager::~CGUITextureManager(void)
@@ -227,14 +236,13 @@ const CTextureArray& CGUITextureManager::GetTexture(const CStdString& strTexture
 {
   static CTextureArray emptyTexture;
   //  CLog::Log(LOGINFO, " refcount++ for  GetTexture(%s)\n", strTextureName.c_str());
-  for (int i = 0; i < (int)m_vecTextures.size(); ++i)
+  iTextures i = m_textures.find(strTextureName);
+  if (i != m_textures.end())
   {
-    CTextureMap *pMap = m_vecTextures[i];
-    if (pMap->GetName() == strTextureName)
-    {
-      //CLog::Log(LOGDEBUG, "Total memusage %u", GetMemoryUsage());
-      return pMap->GetTexture();
-    }
+    CTextureMap *pMap = i->second;
+    if (!pMap->IsUsed())
+      m_unusedMemUsage -= pMap->GetMemoryUsage();
+    return pMap->GetTexture();
   }
   return emptyTexture;
 }
@@ -266,14 +274,10 @@ bool CGUITextureManager::HasTexture(const CStdString &textureName, CStdString *p
 
   // Check our loaded and bundled textures - we store in bundles using \\.
   CStdString bundledName = CTextureBundle::Normalize(textureName);
-  for (int i = 0; i < (int)m_vecTextures.size(); ++i)
+  if (m_textures.find(textureName) != m_textures.end())
   {
-    CTextureMap *pMap = m_vecTextures[i];
-    if (pMap->GetName() == textureName)
-    {
-      if (size) *size = 1;
-      return true;
-    }
+    if (size) *size = 1;
+    return true;
   }
 
   for (int i = 0; i < 2; i++)
@@ -301,7 +305,10 @@ int CGUITextureManager::Load(const CStdString& strTextureName, bool checkBundleO
     return 0;
 
   if (size) // we found the texture
+  {
+    m_hits++;
     return size;
+  }
 
   if (checkBundleOnly && bundle == -1)
     return 0;
@@ -385,7 +392,7 @@ int CGUITextureManager::Load(const CStdString& strTextureName, bool checkBundleO
     OutputDebugString(temp);
 #endif
 
-    m_vecTextures.push_back(pMap);
+    AddTexture(pMap);
     return 1;
   } // of if (strPath.Right(4).ToLower()==".gif")
 
@@ -412,7 +419,7 @@ int CGUITextureManager::Load(const CStdString& strTextureName, bool checkBundleO
 
   CTextureMap* pMap = new CTextureMap(strTextureName, width, height, 0);
   pMap->Add(pTexture, 100);
-  m_vecTextures.push_back(pMap);
+  AddTexture(pMap);
 
 #ifdef _DEBUG_TEXTURES
   int64_t end, freq;
@@ -427,29 +434,48 @@ int CGUITextureManager::Load(const CStdString& strTextureName, bool checkBundleO
 }
 
 
+void CGUITextureManager::AddTexture(CTextureMap *pMap)
+{
+  // nothing refers to it until GetTexture()
+  pMap->SetLastUsed(m_generation);
+  m_unusedMemUsage += pMap->GetMemoryUsage();
+  m_textures[pMap->GetName()] = pMap;
+  m_loads++;
+}
+
 void CGUITextureManager::ReleaseTexture(const CStdString& strTextureName)
 {
   CSingleLock lock(g_graphicsContext);
 
-  ivecTextures i;
-  i = m_vecTextures.begin();
-  while (i != m_vecTextures.end())
+  iTextures i = m_textures.find(strTextureName);
+  if (i == m_textures.end())
   {
-    CTextureMap* pMap = *i;
-    if (pMap->GetName() == strTextureName)
-    {
-      if (pMap->Release())
-      {
-        //CLog::Log(LOGINFO, "  cleanup:%s", strTextureName.c_str());
-        // add to our textures to free
-        m_unusedTextures.push_back(pMap);
-        i = m_vecTextures.erase(i);
-      }
-      return;
+    CLog::Log(LOGWARNING, "%s: Unable to release texture %s", __FUNCTION__, strTextureName.c_str());
+    return;
+  }
+
+  CTextureMap* pMap = i->second;
+  bool wasUsed = pMap->IsUsed();
+  if (pMap->Release())
+  {
+    if (pMap->IsEmpty())
+    { // nothing worth keeping
+      if (!wasUsed)
+        m_unusedMemUsage -= pMap->GetMemoryUsage();
+      m_unusedTextures.push_back(pMap);
+      m_textures.erase(i);
+    }
+    else if (wasUsed)
+    { // keep it around until FreeUnusedTextures() needs the room
+      pMap->SetLastUsed(m_generation);
+      m_unusedMemUsage += pMap->GetMemoryUsage();
     }
-    ++i;
   }
-  CLog::Log(LOGWARNING, "%s: Unable to release texture %s", __FUNCTION__, strTextureName.c_str());
+}
+
+static bool LessRecentlyUsed(const CTextureMap *left, const CTextureMap *right)
+{
+  return left->GetLastUsed() < right->GetLastUsed();
 }
 
 void CGUITextureManager::FreeUnusedTextures()
@@ -458,21 +484,46 @@ void CGUITextureManager::FreeUnusedTextures()
   for (ivecTextures i = m_unusedTextures.begin(); i != m_unusedTextures.end(); ++i)
     delete *i;
   m_unusedTextures.clear();
+
+  // anything released from here on is more recent than what we evict now
+  m_generation++;
+
+  uint32_t budget = (uint32_t)g_advancedSettings.m_guiTextureCacheSize * 1024 * 1024;
+  if (m_unusedMemUsage <= budget)
+    return;
+
+  // evict the textures that have been unused the longest until we're within budget
+  vector<CTextureMap*> unused;
+  for (iTextures i = m_textures.begin(); i != m_textures.end(); ++i)
+  {
+    if (!i->second->IsUsed())
+      unused.push_back(i->second);
+  }
+  sort(unused.begin(), unused.end(), LessRecentlyUsed);
+
+  for (ivecTextures i = unused.begin(); i != unused.end() && m_unusedMemUsage > budget; ++i)
+  {
+    CTextureMap *pMap = *i;
+    m_unusedMemUsage -= pMap->GetMemoryUsage();
+    m_textures.erase(pMap->GetName());
+    delete pMap;
+    m_evictions++;
+  }
 }
 
 void CGUITextureManager::Cleanup()
 {
   CSingleLock lock(g_graphicsContext);
 
-  ivecTextures i;
-  i = m_vecTextures.begin();
-  while (i != m_vecTextures.end())
+  for (iTextures i = m_textures.begin(); i != m_textures.end(); ++i)
   {
-    CTextureMap* pMap = *i;
-    CLog::Log(LOGWARNING, "%s: Having to cleanup texture %s", __FUNCTION__, pMap->GetName().c_str());
+    CTextureMap* pMap = i->second;
+    if (pMap->IsUsed())
+      CLog::Log(LOGWARNING, "%s: Having to cleanup texture %s", __FUNCTION__, pMap->GetName().c_str());
     delete pMap;
-    i = m_vecTextures.erase(i);
   }
+  m_textures.clear();
+  m_unusedMemUsage = 0;
   for (int i = 0; i < 2; i++)
     m_TexBundle[i].Cleanup();
   FreeUnusedTextures();
@@ -481,12 +532,12 @@ void CGUITextureManager::Cleanup()
 void CGUITextureManager::Dump() const
 {
   CStdString strLog;
-  strLog.Format("total texturemaps size:%i\n", m_vecTextures.size());
+  strLog.Format("total texturemaps size:%i\n", m_textures.size());
   OutputDebugString(strLog.c_str());
 
-  for (int i = 0; i < (int)m_vecTextures.size(); ++i)
+  for (ciTextures i = m_textures.begin(); i != m_textures.end(); ++i)
   {
-    const CTextureMap* pMap = m_vecTextures[i];
+    const CTextureMap* pMap = i->second;
     if (!pMap->IsEmpty())
       pMap->Dump();
   }
@@ -496,30 +547,31 @@ void CGUITextureManager::Flush()
 {
   CSingleLock lock(g_graphicsContext);
 
-  ivecTextures i;
-  i = m_vecTextures.begin();
-  while (i != m_vecTextures.end())
+  iTextures i = m_textures.begin();
+  while (i != m_textures.end())
   {
-    CTextureMap* pMap = *i;
+    CTextureMap* pMap = i->second;
     pMap->Flush();
     if (pMap->IsEmpty() )
     {
       delete pMap;
-      i = m_vecTextures.erase(i);
+      m_textures.erase(i++);
     }
     else
     {
       ++i;
     }
   }
+  // whatever was unused has been flushed
+  m_unusedMemUsage = 0;
 }
 
 unsigned int CGUITextureManager::GetMemoryUsage() const
 {
   unsigned int memUsage = 0;
-  for (int i = 0; i < (int)m_vecTextures.size(); ++i)
+  for (ciTextures i = m_textures.begin(); i != m_textures.end(); ++i)
   {
-    memUsage += m_vecTextures[i]->GetMemoryUsage();
+    memUsage += i->second->GetMemoryUsage();
   }
   return memUsage;
 }
@@ -577,6 +629,22 @@ CStdString CGUITextureManager::GetTexturePath(const CStdString &textureName, boo
   return "";
 }
 
+void CGUITextureManager::PrefetchTextures(const std::vector<CStdString> &textures)
+{
+  for (std::vector<CStdString>::const_iterator it = textures.begin(); it != textures.end(); ++it)
+  {
+    int bundle = -1, size = 0;
+    if (HasTexture(*it, NULL, &bundle, &size) && !size && bundle >= 0)
+      m_TexBundle[bundle].PrefetchTexture(*it);
+  }
+}
+
+void CGUITextureManager::PrintBundleStats() const
+{
+  for (int i = 0; i < 2; i++)
+    m_TexBundle[i].PrintStats();
+}
+
 void CGUITextureManager::GetBundledTexturesFromPath(const CStdString& texturePath, std::vector<CStdString> &items)
 {
   m_TexBundle[0].GetTexturesFromPath(texturePath, items);
@@ -28,6 +28,7 @@
 #define GUILIB_TEXTUREMANAGER_H
 
 #include <vector>
+#include <map>
 #include "TextureBundle.h"
 #include "threads/CriticalSection.h"
 
@@ -85,6 +86,10 @@ public:
   uint32_t GetMemoryUsage() const;
   void Flush();
   bool IsEmpty() const;
+  bool IsUsed() const { return m_referenceCount > 0; };
+
+  void SetLastUsed(unsigned int generation) { m_lastUsed = generation; };
+  unsigned int GetLastUsed() const { return m_lastUsed; };
 protected:
   void FreeTexture();
 
@@ -92,6 +97,7 @@ protected:
   CTextureArray m_texture;
   unsigned int m_referenceCount;
   uint32_t m_memUsage;
+  unsigned int m_lastUsed; ///< generation in which the texture was last released
 };
 
 /*!
@@ -119,15 +125,37 @@ public:
   CStdString GetTexturePath(const CStdString& textureName, bool directory = false);
   void GetBundledTexturesFromPath(const CStdString& texturePath, std::vector<CStdString> &items);
 
+  /*! \brief Start unpacking bundled textures in the background ahead of their Load()
+   \param textures names of the textures, as they will be passed to Load()
+   */
+  void PrefetchTextures(const std::vector<CStdString> &textures);
+  void PrintBundleStats() const;
+
   void AddTexturePath(const CStdString &texturePath);    ///< Add a new path to the paths to check when loading media
   void SetTexturePath(const CStdString &texturePath);    ///< Set a single path as the path to check when loading media (clear then add)
   void RemoveTexturePath(const CStdString &texturePath); ///< Remove a path from the paths to check when loading media
 
   void FreeUnusedTextures(); ///< Free textures (called from app thread only)
+
+  uint32_t GetUnusedMemoryUsage() const { return m_unusedMemUsage; }; ///< memory used by resident textures that nothing refers to
+  unsigned int GetHits() const { return m_hits; };           ///< number of Load()s served from resident textures
+  unsigned int GetLoads() const { return m_loads; };         ///< number of Load()s that had to load the texture
+  unsigned int GetEvictions() const { return m_evictions; }; ///< number of unused textures freed
 protected:
-  std::vector<CTextureMap*> m_vecTextures;
+  void AddTexture(CTextureMap *pMap);
+
+  std::map<CStdString, CTextureMap*> m_textures;
+  typedef std::map<CStdString, CTextureMap*>::iterator iTextures;
+  typedef std::map<CStdString, CTextureMap*>::const_iterator ciTextures;
   std::vector<CTextureMap*> m_unusedTextures;
   typedef std::vector<CTextureMap*>::iterator ivecTextures;
+
+  // released textures are kept around, up to the budget, in case they are needed again
+  unsigned int m_generation;
+  uint32_t m_unusedMemUsage;
+  unsigned int m_hits;
+  unsigned int m_loads;
+  unsigned int m_evictions;
   // we have 2 texture bundles (one for the base textures, one for the theme)
   CTextureBundle m_TexBundle[2];
 
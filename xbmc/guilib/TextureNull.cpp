@@ -0,0 +1,68 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+
+#include "system.h"
+#include "TextureNull.h"
+
+#if defined(HAS_HEADLESS)
+
+/************************************************************************/
+/*    CNullTexture                                                      */
+/************************************************************************/
+CNullTexture::CNullTexture(unsigned int width, unsigned int height, unsigned int format)
+: CBaseTexture(width, height, format)
+{
+}
+
+CNullTexture::~CNullTexture()
+{
+  DestroyTextureObject();
+}
+
+void CNullTexture::CreateTextureObject()
+{
+}
+
+void CNullTexture::DestroyTextureObject()
+{
+}
+
+void CNullTexture::LoadToGPU()
+{
+  if (!m_pixels)
+  {
+    // nothing to load - probably same image (no change)
+    return;
+  }
+
+  // there is no GPU, but keep the memory behaviour of the real backends
+  delete [] m_pixels;
+  m_pixels = NULL;
+
+  m_loadedToGPU = true;
+}
+
+void CNullTexture::BindToUnit(unsigned int unit)
+{
+}
+
+#endif
@@ -242,6 +242,13 @@ public:
     return (color_t)(colour * alpha);
   }
 
+  // true if rectangles in the z = 0 plane stay rectangles parallel to the screen
+  inline bool IsAxisAligned() const XBMC_FORCE_INLINE
+  {
+    return m[0][1] == 0.0f && m[0][2] == 0.0f && m[1][0] == 0.0f &&
+           m[1][2] == 0.0f && m[2][0] == 0.0f && m[2][1] == 0.0f;
+  }
+
   float m[3][4];
   float alpha;
   bool identity;
@@ -29,6 +29,9 @@
 
 #include <string.h>
 #include "PlatformDefs.h"
+#ifndef _WIN32
+#include <sys/mman.h>
+#endif
 
 #define READ_STR(str, size, file) \
   if (!fread(str, size, 1, file)) \
@@ -47,6 +50,8 @@
 CXBTFReader::CXBTFReader()
 {
   m_file = NULL;
+  m_mapped = NULL;
+  m_mappedSize = 0;
 }
 
 bool CXBTFReader::IsOpen() const
@@ -136,11 +141,33 @@ bool CXBTFReader::Open(const CStdString& fileName)
     return false;
   }
 
+#ifndef _WIN32
+  // map the bundle, so frames can be read without seeking and from several threads at once.
+  // if that fails we simply keep reading through m_file
+  struct stat fileStat;
+  if (fstat(fileno(m_file), &fileStat) == 0 && fileStat.st_size > 0)
+  {
+    void* mapped = mmap(NULL, (size_t)fileStat.st_size, PROT_READ, MAP_PRIVATE, fileno(m_file), 0);
+    if (mapped != MAP_FAILED)
+    {
+      m_mapped = (unsigned char*)mapped;
+      m_mappedSize = (size_t)fileStat.st_size;
+    }
+  }
+#endif
+
   return true;
 }
 
 void CXBTFReader::Close()
 {
+#ifndef _WIN32
+  if (m_mapped)
+    munmap(m_mapped, m_mappedSize);
+#endif
+  m_mapped = NULL;
+  m_mappedSize = 0;
+
   if (m_file)
   {
     fclose(m_file);
@@ -189,6 +216,14 @@ bool CXBTFReader::Load(const CXBTFFrame& frame, unsigned char* buffer)
   {
     return false;
   }
+
+  const unsigned char* data = GetData(frame);
+  if (data)
+  {
+    memcpy(buffer, data, (size_t)frame.GetPackedSize());
+    return true;
+  }
+
 #if defined(TARGET_DARWIN) || defined(__FreeBSD__) || defined(__ANDROID__)
     if (fseeko(m_file, (off_t)frame.GetOffset(), SEEK_SET) == -1)
 #else
@@ -206,6 +241,16 @@ bool CXBTFReader::Load(const CXBTFFrame& frame, unsigned char* buffer)
   return true;
 }
 
+const unsigned char* CXBTFReader::GetData(const CXBTFFrame& frame) const
+{
+  if (!m_mapped || frame.GetOffset() + frame.GetPackedSize() > m_mappedSize)
+  {
+    return NULL;
+  }
+
+  return m_mapped + frame.GetOffset();
+}
+
 std::vector<CXBTFFile>& CXBTFReader::GetFiles()
 {
   return m_xbtf.GetFiles();
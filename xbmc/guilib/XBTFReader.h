@@ -38,12 +38,20 @@ public:
   bool Exists(const CStdString& name);
   CXBTFFile* Find(const CStdString& name);
   bool Load(const CXBTFFrame& frame, unsigned char* buffer);
+
+  /*! \brief Direct access to the (packed) data of a frame
+   Only available while the bundle is memory mapped, and valid until Close().
+   \return pointer to the frame data, or NULL if the bundle isn't mapped
+   */
+  const unsigned char* GetData(const CXBTFFrame& frame) const;
   std::vector<CXBTFFile>&  GetFiles();
 
 private:
   CXBTF      m_xbtf;
   CStdString m_fileName;
   FILE*      m_file;
+  unsigned char* m_mapped;
+  size_t     m_mappedSize;
   std::map<CStdString, CXBTFFile> m_filesMap;
 };
 
@@ -87,6 +87,11 @@
 #include "cdrip/CDDARipper.h"
 #endif
 
+#if !defined(TARGET_DARWIN)
+#include "cores/AudioEngine/Engines/SoftAE/SoftAEBenchmark.h"
+#include "utils/JobManager.h"
+#endif
+
 #include <vector>
 #include "xbmc/settings/AdvancedSettings.h"
 
@@ -211,6 +216,9 @@ const BUILT_IN commands[] = {
 #endif
   { "VideoLibrary.Search",        false,  "Brings up a search dialog which will search the library" },
   { "toggledebug",                false,  "Enables/disables debug mode" },
+#if !defined(TARGET_DARWIN)
+  { "AEBenchmark",                false,  "Measures audio mixer CPU usage through the NULL sink, optionally specify seconds per run" },
+#endif
 };
 
 bool CBuiltins::HasCommand(const CStdString& execString)
@@ -1576,6 +1584,13 @@ int CBuiltins::Execute(const CStdString& execString)
     g_guiSettings.SetBool("debug.showloginfo", !debug);
     g_advancedSettings.SetDebugMode(!debug);
   }
+#if !defined(TARGET_DARWIN)
+  else if (execute.Equals("aebenchmark"))
+  {
+    unsigned int seconds = params.size() ? atoi(params[0].c_str()) : 10;
+    CJobManager::GetInstance().AddJob(new CSoftAEBenchmark(seconds), NULL);
+  }
+#endif
   else
     return -1;
   return 0;
@@ -300,10 +300,15 @@ void CFileItemHandler::HandleFileItem(const char *ID, bool allowFile, const char
 
   if (resultname)
   {
+    // move rather than copy the object into the result
+    CVariant &list = result[resultname];
     if (append)
-      result[resultname].append(object);
+    {
+      list.append(CVariant());
+      list[list.size() - 1].swap(object);
+    }
     else
-      result[resultname] = object;
+      list.swap(object);
   }
 }
 
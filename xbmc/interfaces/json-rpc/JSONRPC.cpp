@@ -162,7 +162,22 @@ JSONRPC_STATUS CJSONRPC::NotifyAll(const CStdString &method, ITransportLayer *tr
 
 CStdString CJSONRPC::MethodCall(const CStdString &inputString, ITransportLayer *transport, IClient *client)
 {
-  CVariant inputroot, outputroot, result;
+  CVariant outputroot;
+  CStdString str = HandleRequest(inputString, transport, client, outputroot) ? CJSONVariantWriter::Write(outputroot, g_advancedSettings.m_jsonOutputCompact) : "";
+  return str;
+}
+
+CJSONVariantStream* CJSONRPC::MethodCallStream(const CStdString &inputString, ITransportLayer *transport, IClient *client)
+{
+  CVariant outputroot;
+  if (!HandleRequest(inputString, transport, client, outputroot))
+    return NULL;
+  return new CJSONVariantStream(outputroot, g_advancedSettings.m_jsonOutputCompact);
+}
+
+bool CJSONRPC::HandleRequest(const CStdString &inputString, ITransportLayer *transport, IClient *client, CVariant &outputroot)
+{
+  CVariant inputroot, result;
   bool hasResponse = false;
 
   CLog::Log(LOGDEBUG, "JSONRPC: Incoming request: %s", inputString.c_str());
@@ -174,7 +189,7 @@ CStdString CJSONRPC::MethodCall(const CStdString &inputString, ITransportLayer *
       if (inputroot.size() <= 0)
       {
         CLog::Log(LOGERROR, "JSONRPC: Empty batch call\n");
-        BuildResponse(inputroot, InvalidRequest, CVariant(), outputroot);
+        BuildResponse(inputroot, InvalidRequest, result, outputroot);
         hasResponse = true;
       }
       else
@@ -184,7 +199,9 @@ CStdString CJSONRPC::MethodCall(const CStdString &inputString, ITransportLayer *
           CVariant response;
           if (HandleMethodCall(*itr, response, transport, client))
           {
-            outputroot.append(response);
+            // move rather than copy the response, which can be large
+            outputroot.append(CVariant());
+            outputroot[outputroot.size() - 1].swap(response);
             hasResponse = true;
           }
         }
@@ -196,12 +213,11 @@ CStdString CJSONRPC::MethodCall(const CStdString &inputString, ITransportLayer *
   else
   {
     CLog::Log(LOGERROR, "JSONRPC: Failed to parse '%s'\n", inputString.c_str());
-    BuildResponse(inputroot, ParseError, CVariant(), outputroot);
+    BuildResponse(inputroot, ParseError, result, outputroot);
     hasResponse = true;
   }
 
-  CStdString str = hasResponse ? CJSONVariantWriter::Write(outputroot, g_advancedSettings.m_jsonOutputCompact) : "";
-  return str;
+  return hasResponse;
 }
 
 bool CJSONRPC::HandleMethodCall(const CVariant& request, CVariant& response, ITransportLayer *transport, IClient *client)
@@ -242,7 +258,7 @@ inline bool CJSONRPC::IsProperJSONRPC(const CVariant& inputroot)
   return inputroot.isObject() && inputroot.isMember("jsonrpc") && inputroot["jsonrpc"].isString() && inputroot["jsonrpc"] == CVariant("2.0") && inputroot.isMember("method") && inputroot["method"].isString() && (!inputroot.isMember("params") || inputroot["params"].isArray() || inputroot["params"].isObject());
 }
 
-inline void CJSONRPC::BuildResponse(const CVariant& request, JSONRPC_STATUS code, const CVariant& result, CVariant& response)
+inline void CJSONRPC::BuildResponse(const CVariant& request, JSONRPC_STATUS code, CVariant& result, CVariant& response)
 {
   response["jsonrpc"] = "2.0";
   response["id"] = request.isObject() && request.isMember("id") ? request["id"] : CVariant();
@@ -250,7 +266,7 @@ inline void CJSONRPC::BuildResponse(const CVariant& request, JSONRPC_STATUS code
   switch (code)
   {
     case OK:
-      response["result"] = result;
+      response["result"].swap(result);
       break;
     case ACK:
       response["result"] = "OK";
@@ -263,7 +279,7 @@ inline void CJSONRPC::BuildResponse(const CVariant& request, JSONRPC_STATUS code
       response["error"]["code"] = InvalidParams;
       response["error"]["message"] = "Invalid params.";
       if (!result.isNull())
-        response["error"]["data"] = result;
+        response["error"]["data"].swap(result);
       break;
     case MethodNotFound:
       response["error"]["code"] = MethodNotFound;
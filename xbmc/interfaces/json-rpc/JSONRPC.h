@@ -30,6 +30,8 @@
 #include "interfaces/IAnnouncer.h"
 #include "utils/StdString.h"
 
+class CJSONVariantStream;
+
 namespace JSONRPC
 {
   /*!
@@ -63,6 +65,20 @@ namespace JSONRPC
      */
     static CStdString MethodCall(const CStdString &inputString, ITransportLayer *transport, IClient *client);
 
+    /*
+     \brief Handles an incoming JSON-RPC request, leaving the serialization of the response to the caller
+     \param inputString received JSON-RPC request
+     \param transport Transport protocol on which the request arrived
+     \param client Client which sent the request
+     \return JSON-RPC response to be read a part at a time, which the caller has to delete,
+     or NULL if there is no response to be sent back
+
+     Same as MethodCall() but lets the transport send the beginning of a large
+     response while the rest is still being serialized. The method itself still
+     builds its whole result before anything can be sent.
+     */
+    static CJSONVariantStream* MethodCallStream(const CStdString &inputString, ITransportLayer *transport, IClient *client);
+
     static JSONRPC_STATUS Introspect(const CStdString &method, ITransportLayer *transport, IClient *client, const CVariant& parameterObject, CVariant &result);
     static JSONRPC_STATUS Version(const CStdString &method, ITransportLayer *transport, IClient *client, const CVariant& parameterObject, CVariant &result);
     static JSONRPC_STATUS Permission(const CStdString &method, ITransportLayer *transport, IClient *client, const CVariant& parameterObject, CVariant &result);
@@ -73,10 +89,11 @@ namespace JSONRPC
   
   private:
     static void setup();
+    static bool HandleRequest(const CStdString &inputString, ITransportLayer *transport, IClient *client, CVariant &outputroot);
     static bool HandleMethodCall(const CVariant& request, CVariant& response, ITransportLayer *transport, IClient *client);
     static inline bool IsProperJSONRPC(const CVariant& inputroot);
 
-    inline static void BuildResponse(const CVariant& request, JSONRPC_STATUS code, const CVariant& result, CVariant& response);
+    inline static void BuildResponse(const CVariant& request, JSONRPC_STATUS code, CVariant& result, CVariant& response);
 
     static bool m_initialized;
   };
@@ -21,6 +21,7 @@
 
 #include "ServiceDescription.h"
 #include "JSONServiceDescription.h"
+#include "threads/SingleLock.h"
 #include "utils/log.h"
 #include "utils/StdString.h"
 #include "utils/JSONVariantParser.h"
@@ -39,10 +40,17 @@
 using namespace std;
 using namespace JSONRPC;
 
+// number of validated parameter sets remembered per method
+#define CHECKED_PARAMETERS_PER_METHOD 4
+// parameters with more values than this aren't remembered
+#define CHECKED_PARAMETERS_MAX_VALUES 64
+
 std::map<std::string, CVariant> CJSONServiceDescription::m_notifications = std::map<std::string, CVariant>();
 CJSONServiceDescription::CJsonRpcMethodMap CJSONServiceDescription::m_actionMap;
 std::map<std::string, JSONSchemaTypeDefinition> CJSONServiceDescription::m_types = std::map<std::string, JSONSchemaTypeDefinition>();
 CJSONServiceDescription::IncompleteSchemaDefinitionMap CJSONServiceDescription::m_incompleteDefinitions = CJSONServiceDescription::IncompleteSchemaDefinitionMap();
+std::map<std::string, std::vector<CJSONServiceDescription::CheckedParameters> > CJSONServiceDescription::m_checkedParameters;
+CCriticalSection CJSONServiceDescription::m_checkedParametersSection;
 
 JsonRpcMethodMap CJSONServiceDescription::m_methodMaps[] = {
 // JSON-RPC
@@ -579,9 +587,19 @@ bool JSONSchemaTypeDefinition::Parse(const CVariant &value, bool isParameter /*
 
 JSONRPC_STATUS JSONSchemaTypeDefinition::Check(const CVariant &value, CVariant &outputValue, CVariant &errorData) const
 {
-  if (!name.empty())
-    errorData["name"] = name;
-  SchemaValueTypeToJson(type, errorData["type"]);
+  JSONRPC_STATUS status = check(value, outputValue, errorData);
+  // the error data is only of interest if the check failed, so don't bother otherwise
+  if (status != OK)
+  {
+    if (!name.empty())
+      errorData["name"] = name;
+    SchemaValueTypeToJson(type, errorData["type"]);
+  }
+  return status;
+}
+
+JSONRPC_STATUS JSONSchemaTypeDefinition::check(const CVariant &value, CVariant &outputValue, CVariant &errorData) const
+{
   CStdString errorMessage;
 
   // Let's check the type of the provided parameter
@@ -666,7 +684,7 @@ JSONRPC_STATUS JSONSchemaTypeDefinition::Check(const CVariant &value, CVariant &
       outputValue = value;
     else if (items.size() == 1)
     {
-      JSONSchemaTypeDefinition itemType = items.at(0);
+      const JSONSchemaTypeDefinition &itemType = items.at(0);
 
       // Loop through all array elements
       for (unsigned int arrayIndex = 0; arrayIndex < value.size(); arrayIndex++)
@@ -1196,6 +1214,10 @@ JSONRPC_STATUS JsonRpcMethod::Check(const CVariant &requestParameters, ITranspor
     {
       methodCall = method;
 
+      // Clients tend to repeat the same calls, e.g. when polling
+      if (CJSONServiceDescription::getCheckedParameters(name, requestParameters, outputParameters))
+        return OK;
+
       // Count the number of actually handled (present)
       // parameters
       unsigned int handled = 0;
@@ -1223,6 +1245,7 @@ JSONRPC_STATUS JsonRpcMethod::Check(const CVariant &requestParameters, ITranspor
         return InvalidParams;
       }
 
+      CJSONServiceDescription::addCheckedParameters(name, requestParameters, outputParameters);
       return OK;
     }
     else
@@ -1269,7 +1292,7 @@ JSONRPC_STATUS JsonRpcMethod::checkParameter(const CVariant &requestParameters,
   if (ParameterExists(requestParameters, type.name, position))
   {
     // Get the parameter
-    CVariant parameterValue = GetParameter(requestParameters, type.name, position);
+    const CVariant &parameterValue = GetParameter(requestParameters, type.name, position);
 
     // Evaluate the type of the parameter
     JSONRPC_STATUS status = type.Check(parameterValue, outputParameters[type.name], errorData["stack"]);
@@ -1775,6 +1798,69 @@ JSONRPC_STATUS CJSONServiceDescription::CheckCall(const char* const method, cons
   return MethodNotFound;
 }
 
+bool CJSONServiceDescription::getCheckedParameters(const std::string &method, const CVariant &requestParameters, CVariant &outputParameters)
+{
+  CSingleLock lock(m_checkedParametersSection);
+  std::map<std::string, std::vector<CheckedParameters> >::const_iterator checked = m_checkedParameters.find(method);
+  if (checked == m_checkedParameters.end())
+    return false;
+
+  for (std::vector<CheckedParameters>::const_iterator iter = checked->second.begin(); iter != checked->second.end(); iter++)
+  {
+    if (iter->requestParameters == requestParameters)
+    {
+      outputParameters = iter->outputParameters;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+void CJSONServiceDescription::addCheckedParameters(const std::string &method, const CVariant &requestParameters, const CVariant &outputParameters)
+{
+  // Large parameters are unlikely to be repeated and
+  // comparing them would take as long as checking them
+  unsigned int values = 0;
+  if (!countValues(requestParameters, values))
+    return;
+
+  CheckedParameters checked;
+  checked.requestParameters = requestParameters;
+  checked.outputParameters = outputParameters;
+
+  CSingleLock lock(m_checkedParametersSection);
+  std::vector<CheckedParameters> &methodParameters = m_checkedParameters[method];
+  if (methodParameters.size() >= CHECKED_PARAMETERS_PER_METHOD)
+    methodParameters.erase(methodParameters.begin());
+  methodParameters.push_back(checked);
+}
+
+bool CJSONServiceDescription::countValues(const CVariant &value, unsigned int &values)
+{
+  if (++values > CHECKED_PARAMETERS_MAX_VALUES)
+    return false;
+
+  if (value.isArray())
+  {
+    for (CVariant::const_iterator_array iter = value.begin_array(); iter != value.end_array(); iter++)
+    {
+      if (!countValues(*iter, values))
+        return false;
+    }
+  }
+  else if (value.isObject())
+  {
+    for (CVariant::const_iterator_map iter = value.begin_map(); iter != value.end_map(); iter++)
+    {
+      if (!countValues(iter->second, values))
+        return false;
+    }
+  }
+
+  return true;
+}
+
 JSONSchemaTypeDefinition* CJSONServiceDescription::GetType(const std::string &identification)
 {
   std::map<std::string, JSONSchemaTypeDefinition>::iterator iter = m_types.find(identification);
@@ -25,6 +25,7 @@
 #include <limits>
 
 #include "JSONUtils.h"
+#include "threads/CriticalSection.h"
 
 namespace JSONRPC
 {
@@ -206,6 +207,9 @@ namespace JSONRPC
      \brief Type definition for additional properties
      */
     JSONSchemaTypeDefinition* additionalProperties;
+
+  private:
+    JSONRPC_STATUS check(const CVariant &value, CVariant &outputValue, CVariant &errorData) const;
   };
 
   /*! 
@@ -386,6 +390,14 @@ namespace JSONRPC
 
     static void getReferencedTypes(const JSONSchemaTypeDefinition &type, std::vector<std::string> &referencedTypes);
 
+    /*!
+     \brief Look up the result of a previous check of the same parameters
+     \return true if the parameters have been checked before and outputParameters was set
+     */
+    static bool getCheckedParameters(const std::string &method, const CVariant &requestParameters, CVariant &outputParameters);
+    static void addCheckedParameters(const std::string &method, const CVariant &requestParameters, const CVariant &outputParameters);
+    static bool countValues(const CVariant &value, unsigned int &values);
+
     class CJsonRpcMethodMap
     {
     public:
@@ -421,5 +433,14 @@ namespace JSONRPC
 
     typedef std::map<std::string, std::vector<IncompleteSchemaDefinition> > IncompleteSchemaDefinitionMap;
     static IncompleteSchemaDefinitionMap m_incompleteDefinitions;
+
+    typedef struct CheckedParameters
+    {
+      CVariant requestParameters;
+      CVariant outputParameters;
+    } CheckedParameters;
+
+    static std::map<std::string, std::vector<CheckedParameters> > m_checkedParameters;
+    static CCriticalSection m_checkedParametersSection;
   };
 }
@@ -81,7 +81,7 @@ namespace JSONRPC
      the given object is not an array) or for a parameter at the 
      given position (if the given object is an array).
      */
-    static inline bool ParameterExists(const CVariant &parameterObject, std::string key, unsigned int position) { return IsValueMember(parameterObject, key) || (parameterObject.isArray() && parameterObject.size() > position); }
+    static inline bool ParameterExists(const CVariant &parameterObject, const std::string &key, unsigned int position) { return IsValueMember(parameterObject, key) || (parameterObject.isArray() && parameterObject.size() > position); }
 
     /*!
      \brief Checks if the given object contains a value
@@ -91,7 +91,7 @@ namespace JSONRPC
      \return True if the given object contains a member with 
      the given key otherwise false
      */
-    static inline bool IsValueMember(const CVariant &value, std::string key) { return value.isObject() && value.isMember(key); }
+    static inline bool IsValueMember(const CVariant &value, const std::string &key) { return value.isObject() && value.isMember(key); }
     
     /*!
      \brief Returns the json value of a parameter
@@ -105,7 +105,7 @@ namespace JSONRPC
      the given object is not an array) or of the parameter at the 
      given position (if the given object is an array).
      */
-    static inline CVariant GetParameter(const CVariant &parameterObject, std::string key, unsigned int position) { return IsValueMember(parameterObject, key) ? parameterObject[key] : parameterObject[position]; }
+    static inline const CVariant& GetParameter(const CVariant &parameterObject, const std::string &key, unsigned int position) { return IsValueMember(parameterObject, key) ? parameterObject[key] : parameterObject[position]; }
     
     /*!
      \brief Returns the json value of a parameter or the given
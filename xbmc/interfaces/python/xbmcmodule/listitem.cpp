@@ -626,6 +626,7 @@ namespace PYXBMC
         self->item->GetPictureInfoTag()->SetLoaded(true);
       }
     }
+    self->item->SetInfoChanged();
     PyXBMCGUIUnlock();
 
     Py_INCREF(Py_None);
@@ -37,6 +37,8 @@
 #include "Artist.h"
 #include "Album.h"
 #include "Song.h"
+#include "cores/paplayer/ReplayGain.h"
+#include "cores/paplayer/SeekIndex.h"
 #include "guilib/GUIWindowManager.h"
 #include "dialogs/GUIDialogOK.h"
 #include "dialogs/GUIDialogProgress.h"
@@ -196,6 +198,14 @@ bool CMusicDatabase::CreateTables()
     m_pDS->exec("CREATE TRIGGER delete_album AFTER DELETE ON album FOR EACH ROW BEGIN DELETE FROM art WHERE media_id=old.idAlbum AND media_type='album'; END");
     m_pDS->exec("CREATE TRIGGER delete_artist AFTER DELETE ON artist FOR EACH ROW BEGIN DELETE FROM art WHERE media_id=old.idArtist AND media_type='artist'; END");
 
+    CLog::Log(LOGINFO, "create replaygain table");
+    m_pDS->exec("CREATE TABLE replaygain ( idReplayGain integer primary key, strFileName text, iStartOffset integer, iTrackGain integer, fTrackPeak float, iAlbumGain integer, fAlbumPeak float, iHasGainInfo integer)\n");
+    m_pDS->exec("CREATE UNIQUE INDEX ix_replaygain ON replaygain ( strFileName(255), iStartOffset )\n");
+
+    CLog::Log(LOGINFO, "create seekindex table");
+    m_pDS->exec("CREATE TABLE seekindex ( idSeekIndex integer primary key, strFileName text, iFileSize integer, strIndex text)\n");
+    m_pDS->exec("CREATE UNIQUE INDEX ix_seekindex ON seekindex ( strFileName(255) )\n");
+
     // we create views last to ensure all indexes are rolled in
     CreateViews();
 
@@ -1750,6 +1760,105 @@ bool CMusicDatabase::GetSongsByPath(const CStdString& strPath1, CSongMap& songs,
   return false;
 }
 
+bool CMusicDatabase::SetReplayGain(const CStdString& strFileName, int startOffset, const CReplayGain &gain)
+{
+  try
+  {
+    if (NULL == m_pDB.get()) return false;
+    if (NULL == m_pDS.get()) return false;
+
+    CStdString strSQL=PrepareSQL("replace into replaygain (idReplayGain, strFileName, iStartOffset, iTrackGain, fTrackPeak, iAlbumGain, fAlbumPeak, iHasGainInfo) values (NULL, '%s', %i, %i, %f, %i, %f, %i)",
+                                 strFileName.c_str(), startOffset, gain.iTrackGain, gain.fTrackPeak, gain.iAlbumGain, gain.fAlbumPeak, gain.iHasGainInfo);
+    m_pDS->exec(strSQL.c_str());
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s(%s) failed", __FUNCTION__, strFileName.c_str());
+  }
+
+  return false;
+}
+
+bool CMusicDatabase::GetReplayGain(const CStdString& strFileName, int startOffset, CReplayGain &gain)
+{
+  try
+  {
+    if (NULL == m_pDB.get()) return false;
+    if (NULL == m_pDS.get()) return false;
+
+    CStdString strSQL=PrepareSQL("select * from replaygain where strFileName='%s' and iStartOffset=%i", strFileName.c_str(), startOffset);
+    if (!m_pDS->query(strSQL.c_str())) return false;
+    if (m_pDS->num_rows() == 0)
+    {
+      m_pDS->close();
+      return false;
+    }
+    gain.iTrackGain   = m_pDS->fv("iTrackGain").get_asInt();
+    gain.fTrackPeak   = m_pDS->fv("fTrackPeak").get_asFloat();
+    gain.iAlbumGain   = m_pDS->fv("iAlbumGain").get_asInt();
+    gain.fAlbumPeak   = m_pDS->fv("fAlbumPeak").get_asFloat();
+    gain.iHasGainInfo = m_pDS->fv("iHasGainInfo").get_asInt();
+    m_pDS->close();
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s(%s) failed", __FUNCTION__, strFileName.c_str());
+  }
+
+  return false;
+}
+
+bool CMusicDatabase::SetSeekIndex(const CStdString& strFileName, int64_t fileSize, const CSeekIndex &index)
+{
+  try
+  {
+    if (NULL == m_pDB.get()) return false;
+    if (NULL == m_pDS.get()) return false;
+
+    CStdString strSQL=PrepareSQL("replace into seekindex (idSeekIndex, strFileName, iFileSize, strIndex) values (NULL, '%s', %lld, '%s')",
+                                 strFileName.c_str(), (long long)fileSize, index.Serialize().c_str());
+    m_pDS->exec(strSQL.c_str());
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s(%s) failed", __FUNCTION__, strFileName.c_str());
+  }
+
+  return false;
+}
+
+bool CMusicDatabase::GetSeekIndex(const CStdString& strFileName, int64_t fileSize, CSeekIndex &index)
+{
+  try
+  {
+    if (NULL == m_pDB.get()) return false;
+    if (NULL == m_pDS.get()) return false;
+
+    CStdString strSQL=PrepareSQL("select * from seekindex where strFileName='%s'", strFileName.c_str());
+    if (!m_pDS->query(strSQL.c_str())) return false;
+    if (m_pDS->num_rows() == 0)
+    {
+      m_pDS->close();
+      return false;
+    }
+    // a file that changed size since has been retagged or replaced
+    bool ret = false;
+    if (m_pDS->fv("iFileSize").get_asInt64() == fileSize)
+      ret = index.Deserialize(m_pDS->fv("strIndex").get_asString());
+    m_pDS->close();
+    return ret;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s(%s) failed", __FUNCTION__, strFileName.c_str());
+  }
+
+  return false;
+}
+
 void CMusicDatabase::EmptyCache()
 {
   m_artistCache.erase(m_artistCache.begin(), m_artistCache.end());
@@ -2004,10 +2113,12 @@ bool CMusicDatabase::CleanupSongsByIds(const CStdString &strSongIds)
       return true;
     }
     CStdString strSongsToDelete = "";
+    CStdString strFilesToDelete = "";
     while (!m_pDS->eof())
     { // get the full song path
       CStdString strFileName;
       URIUtils::AddFileToFolder(m_pDS->fv("path.strPath").get_asString(), m_pDS->fv("song.strFileName").get_asString(), strFileName);
+      CStdString strSongFile = strFileName;
 
       //  Special case for streams inside an ogg file. (oggstream)
       //  The last dir in the path is the ogg file that
@@ -2024,6 +2135,7 @@ bool CMusicDatabase::CleanupSongsByIds(const CStdString &strSongIds)
       if (!CFile::Exists(strFileName))
       { // file no longer exists, so add to deletion list
         strSongsToDelete += m_pDS->fv("song.idSong").get_asString() + ",";
+        strFilesToDelete += PrepareSQL("'%s',", strSongFile.c_str());
       }
       m_pDS->next();
     }
@@ -2041,6 +2153,10 @@ bool CMusicDatabase::CleanupSongsByIds(const CStdString &strSongIds)
       m_pDS->exec(strSQL.c_str());
       strSQL = "delete from karaokedata where idSong in " + strSongsToDelete;
       m_pDS->exec(strSQL.c_str());
+      strSQL = "delete from replaygain where strFileName in (" + strFilesToDelete.TrimRight(",") + ")";
+      m_pDS->exec(strSQL.c_str());
+      strSQL = "delete from seekindex where strFileName in (" + strFilesToDelete + ")";
+      m_pDS->exec(strSQL.c_str());
       m_pDS->close();
     }
     return true;
@@ -2090,6 +2206,47 @@ bool CMusicDatabase::CleanupSongs()
   return false;
 }
 
+bool CMusicDatabase::CleanupSeekIndex()
+{
+  try
+  {
+    // seek indexes are only stored for library songs, drop those of songs that have gone.
+    // the table is keyed by the full filename, so collect the library's files first
+    set<CStdString> files;
+    if (!m_pDS->query("select path.strPath, song.strFileName from song join path on song.idPath=path.idPath")) return false;
+    while (!m_pDS->eof())
+    {
+      CStdString strFileName;
+      URIUtils::AddFileToFolder(m_pDS->fv("path.strPath").get_asString(), m_pDS->fv("song.strFileName").get_asString(), strFileName);
+      files.insert(strFileName);
+      m_pDS->next();
+    }
+    m_pDS->close();
+
+    if (!m_pDS->query("select idSeekIndex, strFileName from seekindex")) return false;
+    CStdString strIdsToDelete;
+    while (!m_pDS->eof())
+    {
+      if (files.find(m_pDS->fv("strFileName").get_asString()) == files.end())
+        strIdsToDelete += m_pDS->fv("idSeekIndex").get_asString() + ",";
+      m_pDS->next();
+    }
+    m_pDS->close();
+
+    if (!strIdsToDelete.IsEmpty())
+    {
+      CStdString strSQL = "delete from seekindex where idSeekIndex in (" + strIdsToDelete.TrimRight(",") + ")";
+      m_pDS->exec(strSQL.c_str());
+    }
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "Exception in CMusicDatabase::CleanupSeekIndex()");
+  }
+  return false;
+}
+
 bool CMusicDatabase::CleanupAlbums()
 {
   try
@@ -2260,7 +2417,7 @@ int CMusicDatabase::Cleanup(CGUIDialogProgress *pDlgProgress)
     pDlgProgress->StartModal();
     pDlgProgress->ShowProgressBar(true);
   }
-  if (!CleanupSongs())
+  if (!CleanupSongs() || !CleanupSeekIndex())
   {
     RollbackTransaction();
     return ERROR_REORG_SONGS;
@@ -3541,6 +3698,18 @@ bool CMusicDatabase::UpdateOldVersion(int version)
     g_settings.Save();
   }
 
+  if (version < 28)
+  {
+    m_pDS->exec("CREATE TABLE replaygain ( idReplayGain integer primary key, strFileName text, iStartOffset integer, iTrackGain integer, fTrackPeak float, iAlbumGain integer, fAlbumPeak float, iHasGainInfo integer)\n");
+    m_pDS->exec("CREATE UNIQUE INDEX ix_replaygain ON replaygain ( strFileName(255), iStartOffset )\n");
+  }
+
+  if (version < 29)
+  {
+    m_pDS->exec("CREATE TABLE seekindex ( idSeekIndex integer primary key, strFileName text, iFileSize integer, strIndex text)\n");
+    m_pDS->exec("CREATE UNIQUE INDEX ix_seekindex ON seekindex ( strFileName(255) )\n");
+  }
+
   // always recreate the views after any table change
   CreateViews();
 
@@ -31,6 +31,8 @@
 
 class CArtist;
 class CFileItem;
+class CReplayGain;
+class CSeekIndex;
 
 namespace dbiplus
 {
@@ -123,6 +125,24 @@ public:
   bool GetSongByKaraokeNumber( int number, CSong& song );
   bool SetKaraokeSongDelay( int idSong, int delay );
   bool GetSongsByPath(const CStdString& strPath, CSongMap& songs, bool bAppendToMap = false);
+
+  /*! \brief Store the gain measured for a file by the loudness analysis of the scanner
+   Kept by filename rather than idSong so a rescan of the folder doesn't lose it.
+   \param strFileName the full path of the file
+   \param startOffset the start offset of the song within the file (for cuesheets)
+   \param gain the track and album gain and peaks, as flagged in iHasGainInfo
+   */
+  bool SetReplayGain(const CStdString& strFileName, int startOffset, const CReplayGain &gain);
+  bool GetReplayGain(const CStdString& strFileName, int startOffset, CReplayGain &gain);
+
+  /*! \brief Store the seek index built by a codec that decoded a library song through to the end
+   Entries of songs that are no longer in the library are dropped by Cleanup().
+   \param strFileName the full path of the file
+   \param fileSize the size of the file, so a replaced file doesn't get a stale index
+   \param index the complete seek index
+   */
+  bool SetSeekIndex(const CStdString& strFileName, int64_t fileSize, const CSeekIndex &index);
+  bool GetSeekIndex(const CStdString& strFileName, int64_t fileSize, CSeekIndex &index);
   bool Search(const CStdString& search, CFileItemList &items);
 
   bool GetAlbumFromSong(int idSong, CAlbum &album);
@@ -275,7 +295,7 @@ protected:
   std::map<CStdString, CAlbum> m_albumCache;
 
   virtual bool CreateTables();
-  virtual int GetMinVersion() const { return 27; };
+  virtual int GetMinVersion() const { return 29; };
   const char *GetBaseDBName() const { return "MyMusic"; };
 
   int AddSong(const CSong& song, bool bCheck = true, int idAlbum = -1);
@@ -307,6 +327,7 @@ private:
   void GetFileItemFromDataset(const dbiplus::sql_record* const record, CFileItem* item, const CStdString& strMusicDBbasePath);
   bool CleanupSongs();
   bool CleanupSongsByIds(const CStdString &strSongIds);
+  bool CleanupSeekIndex();
   bool CleanupPaths();
   bool CleanupAlbums();
   bool CleanupArtists();
@@ -38,6 +38,7 @@
 #include "guilib/GUIKeyboardFactory.h"
 #include "filesystem/File.h"
 #include "filesystem/Directory.h"
+#include "filesystem/DirectoryCache.h"
 #include "settings/AdvancedSettings.h"
 #include "settings/GUISettings.h"
 #include "settings/Settings.h"
@@ -151,6 +152,10 @@ void CMusicInfoScanner::Process()
 
       tick = XbmcThreads::SystemClockMillis() - tick;
       CLog::Log(LOGNOTICE, "My Music: Scanning for music info using worker thread, operation took %s", StringUtils::SecondsToTimeString(tick / 1000).c_str());
+      g_directoryCache.PrintPersistentStats();
+#ifdef _DEBUG
+      g_directoryCache.PrintStats();
+#endif
     }
     bool bCanceled;
     if (m_scanType == 1) // load album info
@@ -558,6 +563,10 @@ int CMusicInfoScanner::RetrieveMusicInfo(CFileItemList& items, const CStdString&
   }
   m_musicDatabase.CommitTransaction();
 
+  // measure the loudness of any songs that lack replaygain info
+  if (g_advancedSettings.m_bMusicLibraryAnalyseReplayGain && !m_replayGainAnalyser.Analyse(albums, m_musicDatabase, m_bStop))
+    return numAdded;
+
   // Download info & artwork
   bool bCanceled;
   for (set<long>::iterator it = artistsToScan.begin(); it != artistsToScan.end(); ++it)
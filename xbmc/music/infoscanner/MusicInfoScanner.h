@@ -22,6 +22,7 @@
 #include "threads/Thread.h"
 #include "music/MusicDatabase.h"
 #include "MusicAlbumInfo.h"
+#include "ReplayGainAnalyser.h"
 
 class CAlbum;
 class CArtist;
@@ -126,6 +127,7 @@ protected:
   bool m_needsCleanup;
   int m_scanType; // 0 - load from files, 1 - albums, 2 - artists
   CMusicDatabase m_musicDatabase;
+  CReplayGainAnalyser m_replayGainAnalyser;
 
   std::set<CStdString> m_pathsToScan;
   std::set<CAlbum> m_albumsToScan;
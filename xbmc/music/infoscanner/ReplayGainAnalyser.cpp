@@ -0,0 +1,286 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+
+#include "ReplayGainAnalyser.h"
+#include "music/MusicDatabase.h"
+#include "cores/paplayer/CodecFactory.h"
+#include "cores/AudioEngine/Utils/AEConvert.h"
+#include "cores/AudioEngine/Utils/AELoudness.h"
+#include "threads/SingleLock.h"
+#include "utils/JobManager.h"
+#include "utils/log.h"
+#include <math.h>
+#include <string.h>
+
+using namespace std;
+using namespace MUSIC_INFO;
+
+/* ReplayGain 2.0 reference loudness */
+#define REPLAY_GAIN_REFERENCE_LUFS -18.0
+
+/* bytes decoded per ReadPCM call */
+#define ANALYSE_BUFFER_SIZE 32768
+
+class CReplayGainJob : public CJob
+{
+public:
+  CReplayGainJob(unsigned int album, const CSong &song, const volatile bool &stop) :
+    m_stop(stop)
+  {
+    m_result.album       = album;
+    m_result.strFileName = song.strFileName;
+    m_result.startOffset = song.iStartOffset;
+    m_result.tagged      = false;
+    m_result.loudness    = -HUGE_VAL;
+    m_result.peak        = 0.0f;
+    m_result.fileSize    = 0;
+    m_endOffset          = song.iEndOffset;
+  }
+
+  virtual const char *GetType() const { return "replaygain"; }
+
+  virtual bool DoWork()
+  {
+    ICodec *codec = CodecFactory::CreateCodecDemux(m_result.strFileName, "", 0);
+    if (!codec || !codec->Init(m_result.strFileName, 0))
+    {
+      CLog::Log(LOGERROR, "CReplayGainJob::DoWork - unable to open %s", m_result.strFileName.c_str());
+      delete codec;
+      return false;
+    }
+
+    bool ret = Measure(codec);
+    codec->DeInit();
+    delete codec;
+    return ret;
+  }
+
+  const CReplayGainAnalyser::Result &GetResult() const { return m_result; }
+
+private:
+  bool Measure(ICodec *codec)
+  {
+    if (codec->m_replayGain.iHasGainInfo & (REPLAY_GAIN_HAS_TRACK_INFO | REPLAY_GAIN_HAS_ALBUM_INFO))
+    {
+      m_result.tagged = true;
+      return true;
+    }
+
+    CAEChannelInfo layout = codec->GetChannelInfo();
+    CAELoudness meter;
+    if (!meter.Initialize(layout, codec->m_SampleRate))
+      return false;
+
+    CAEConvert::AEConvertToFn convert = NULL;
+    if (codec->m_DataFormat != AE_FMT_FLOAT)
+    {
+      convert = CAEConvert::ToFloat(codec->m_DataFormat);
+      if (!convert)
+        return false;
+    }
+
+    /* offsets of songs in cuesheets are in 1/75th of a second */
+    const unsigned int channels = layout.Count();
+    const unsigned int bytesPerSample = codec->m_BitsPerSample >> 3;
+    const unsigned int frameSize = bytesPerSample * channels;
+    int64_t framesLeft = -1;
+    if (m_result.startOffset)
+      codec->Seek((int64_t)m_result.startOffset * 1000 / 75);
+    if (m_endOffset)
+      framesLeft = (int64_t)(m_endOffset - m_result.startOffset) * codec->m_SampleRate / 75;
+
+    if (!frameSize)
+      return false;
+
+    BYTE   *buffer  = new BYTE[ANALYSE_BUFFER_SIZE];
+    float  *samples = new float[ANALYSE_BUFFER_SIZE / bytesPerSample];
+    bool    ret = true;
+    while (framesLeft)
+    {
+      if (m_stop)
+      {
+        ret = false;
+        break;
+      }
+
+      int size = 0;
+      int result = codec->ReadPCM(buffer, ANALYSE_BUFFER_SIZE - ANALYSE_BUFFER_SIZE % frameSize, &size);
+      if (result == READ_ERROR)
+      {
+        ret = false;
+        break;
+      }
+
+      unsigned int frames = size / frameSize;
+      if (framesLeft > 0 && frames > framesLeft)
+        frames = (unsigned int)framesLeft;
+      if (framesLeft > 0)
+        framesLeft -= frames;
+
+      if (convert)
+        convert(buffer, frames * channels, samples);
+      else
+        memcpy(samples, buffer, frames * frameSize);
+      meter.AddFrames(samples, frames);
+
+      if (result == READ_EOF)
+        break;
+    }
+    delete[] buffer;
+    delete[] samples;
+
+    if (!ret)
+      return false;
+
+    m_result.loudness = meter.GetIntegrated();
+    m_result.peak     = meter.GetTruePeak();
+    m_result.blocks   = meter.GetBlocks();
+
+    /* decoding the whole file has indexed it, save playback the trouble */
+    if (!m_result.startOffset && !m_endOffset && codec->UsesSeekIndex() && codec->m_seekIndex.IsComplete())
+    {
+      m_result.fileSize  = codec->m_file.GetLength();
+      m_result.seekIndex = codec->m_seekIndex;
+    }
+    return true;
+  }
+
+  CReplayGainAnalyser::Result m_result;
+  int                         m_endOffset;
+  const volatile bool        &m_stop;
+};
+
+CReplayGainAnalyser::CReplayGainAnalyser() :
+  m_jobsDone(true, true),
+  m_pending (0),
+  m_stop    (false)
+{
+}
+
+CReplayGainAnalyser::~CReplayGainAnalyser()
+{
+  /* jobs hold a reference to m_stop, never leave before they are done */
+  m_stop = true;
+  m_jobsDone.Wait();
+}
+
+static int GainFromLoudness(double loudness)
+{
+  return (int)floor((REPLAY_GAIN_REFERENCE_LUFS - loudness) * 100.0 + 0.5);
+}
+
+bool CReplayGainAnalyser::Analyse(const VECALBUMS &albums, CMusicDatabase &database, const volatile bool &stop)
+{
+  m_results.clear();
+  m_stop = false;
+
+  for (unsigned int i = 0; i < albums.size(); ++i)
+  {
+    /* the album gain needs every song of the album, so only skip albums that are complete */
+    bool measured = true;
+    for (VECSONGS::const_iterator song = albums[i].songs.begin(); song != albums[i].songs.end() && measured; ++song)
+    {
+      CReplayGain gain;
+      measured = database.GetReplayGain(song->strFileName, song->iStartOffset, gain);
+    }
+    if (measured)
+      continue;
+
+    for (VECSONGS::const_iterator song = albums[i].songs.begin(); song != albums[i].songs.end(); ++song)
+    {
+      CSingleLock lock(m_section);
+      m_pending++;
+      m_jobsDone.Reset();
+      lock.Leave();
+      CJobManager::GetInstance().AddJob(new CReplayGainJob(i, *song, m_stop), this);
+    }
+  }
+
+  while (!m_jobsDone.WaitMSec(100))
+  {
+    if (stop)
+      m_stop = true;
+  }
+
+  if (m_stop)
+    return false;
+
+  /* the album loudness is gated over the blocks of all its measured songs */
+  database.BeginTransaction();
+  for (unsigned int i = 0; i < albums.size(); ++i)
+  {
+    vector<double> blocks;
+    float peak = 0.0f;
+    for (vector<Result>::const_iterator it = m_results.begin(); it != m_results.end(); ++it)
+    {
+      if (it->album != i || it->tagged)
+        continue;
+      blocks.insert(blocks.end(), it->blocks.begin(), it->blocks.end());
+      peak = max(peak, it->peak);
+    }
+    double album = CAELoudness::GetIntegrated(blocks);
+
+    for (vector<Result>::const_iterator it = m_results.begin(); it != m_results.end(); ++it)
+    {
+      if (it->album != i)
+        continue;
+
+      /* tagged and undecodable files get an empty entry so they aren't decoded on every scan */
+      CReplayGain gain;
+      if (!it->tagged && it->loudness != -HUGE_VAL)
+      {
+        gain.iTrackGain    = GainFromLoudness(it->loudness);
+        gain.fTrackPeak    = it->peak;
+        gain.iHasGainInfo |= REPLAY_GAIN_HAS_TRACK_INFO | REPLAY_GAIN_HAS_TRACK_PEAK;
+      }
+      if (!it->tagged && album != -HUGE_VAL)
+      {
+        gain.iAlbumGain    = GainFromLoudness(album);
+        gain.fAlbumPeak    = peak;
+        gain.iHasGainInfo |= REPLAY_GAIN_HAS_ALBUM_INFO | REPLAY_GAIN_HAS_ALBUM_PEAK;
+      }
+      database.SetReplayGain(it->strFileName, it->startOffset, gain);
+      if (it->seekIndex.IsComplete())
+        database.SetSeekIndex(it->strFileName, it->fileSize, it->seekIndex);
+
+      if (gain.iHasGainInfo & REPLAY_GAIN_HAS_TRACK_INFO)
+        CLog::Log(LOGDEBUG, "%s - %s: %.2f LUFS, peak %.3f, album %.2f LUFS", __FUNCTION__, it->strFileName.c_str(), it->loudness, it->peak, album);
+    }
+  }
+
+  database.CommitTransaction();
+
+  m_results.clear();
+  return true;
+}
+
+void CReplayGainAnalyser::OnJobComplete(unsigned int jobID, bool success, CJob *job)
+{
+  /*
+    failures are kept too, they carry no loudness and are stored without a
+    gain so the album counts as measured and isn't decoded again next scan
+  */
+  CSingleLock lock(m_section);
+  m_results.push_back(((CReplayGainJob *)job)->GetResult());
+  if (--m_pending == 0)
+    m_jobsDone.Set();
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+
+#include <vector>
+#include "cores/paplayer/SeekIndex.h"
+#include "music/Album.h"
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
+#include "utils/Job.h"
+
+class CMusicDatabase;
+
+namespace MUSIC_INFO
+{
+/*!
+ \brief Measures the loudness of songs without ReplayGain tags during a library scan.
+
+ Every song is decoded by the paplayer codecs on a low priority job and run
+ through an EBU R128 meter. The track gain is the difference to the -18 LUFS
+ ReplayGain 2.0 reference, the album gain is measured over the blocks of all
+ songs of the album. Results go to the replaygain table of the music database,
+ where CAudioDecoder picks them up for files that carry no gain of their own.
+ Songs that span a whole file also get the seek index their codec built on the way.
+ */
+class CReplayGainAnalyser : public IJobCallback
+{
+public:
+  CReplayGainAnalyser();
+  virtual ~CReplayGainAnalyser();
+
+  /*! \brief Analyse the albums that don't have a stored gain yet
+   Blocks until all songs are measured or stop is set.
+   \param albums the albums found in the folder being scanned
+   \param database an open music database to store the results in
+   \param stop polled while waiting, set to abort the analysis
+   \return false if the analysis was aborted
+   */
+  bool Analyse(const VECALBUMS &albums, CMusicDatabase &database, const volatile bool &stop);
+
+  virtual void OnJobComplete(unsigned int jobID, bool success, CJob *job);
+
+  /* what a job measured for one song */
+  struct Result
+  {
+    unsigned int        album;
+    CStdString          strFileName;
+    int                 startOffset;
+    bool                tagged;     /* the file has gain tags, nothing was measured */
+    double              loudness;
+    float               peak;
+    std::vector<double> blocks;
+    int64_t             fileSize;
+    CSeekIndex          seekIndex;  /* complete if the whole file was decoded */
+  };
+
+private:
+  CCriticalSection    m_section;
+  CEvent              m_jobsDone;
+  unsigned int        m_pending;
+  volatile bool       m_stop;
+  std::vector<Result> m_results;
+};
+}
@@ -25,13 +25,20 @@
 #include <memory.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
+#include <errno.h>
+#ifndef _WIN32
+#include <poll.h>
+#include <fcntl.h>
+#endif
 
 #include "settings/AdvancedSettings.h"
 #include "interfaces/json-rpc/JSONRPC.h"
 #include "interfaces/AnnouncementManager.h"
 #include "utils/log.h"
 #include "utils/Variant.h"
+#include "utils/JSONVariantWriter.h"
 #include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
 #include "websocket/WebSocketManager.h"
 
 static const char     bt_service_name[] = "XBMC JSON-RPC";
@@ -57,6 +64,95 @@ using namespace ANNOUNCEMENT;
 
 #define RECEIVEBUFFER 1024
 
+// announcements are dropped for a client that has this much data queued
+#define SENDQUEUE_DROP_ANNOUNCEMENTS (256 * 1024)
+// a client that has this much data queued isn't reading, and is disconnected
+#define SENDQUEUE_DISCONNECT         (16 * 1024 * 1024)
+// responses are serialized and queued in parts of this size
+#define RESPONSE_CHUNK_SIZE          (64 * 1024)
+// serializing a response stops until the client has read some once this much of it is queued
+#define RESPONSE_QUEUE_MAX           (1024 * 1024)
+// a client that doesn't read any of a response for this long is disconnected
+#define RESPONSE_SEND_TIMEOUT        10000
+
+namespace
+{
+  struct CPollSocket
+  {
+    CPollSocket(SOCKET socket, bool write = false, bool read = true)
+    {
+      m_socket = socket;
+      m_write = write;
+      m_read = read;
+      m_readable = m_writable = false;
+    }
+    SOCKET m_socket;
+    bool   m_write;
+    bool   m_read;
+    bool   m_readable;
+    bool   m_writable;
+  };
+
+  // wait for any of the sockets to become readable or writable, as requested
+  int PollSockets(std::vector<CPollSocket> &sockets, int timeout)
+  {
+#ifndef _WIN32
+    std::vector<struct pollfd> fds(sockets.size());
+    for (unsigned int i = 0; i < sockets.size(); i++)
+    {
+      fds[i].fd      = sockets[i].m_socket;
+      fds[i].events  = (sockets[i].m_read ? POLLIN : 0) | (sockets[i].m_write ? POLLOUT : 0);
+      fds[i].revents = 0;
+    }
+
+    int res = poll(&fds[0], fds.size(), timeout);
+    if (res < 0 && errno == EINTR)
+      return 0;
+
+    for (unsigned int i = 0; res > 0 && i < sockets.size(); i++)
+    {
+      // errors and hangups show up as readable, so that recv() reports them
+      sockets[i].m_readable = (fds[i].revents & (POLLIN | POLLERR | POLLHUP | POLLNVAL)) != 0;
+      sockets[i].m_writable = (fds[i].revents & POLLOUT) != 0;
+    }
+    return res;
+#else
+    SOCKET max_fd = 0;
+    fd_set rfds, wfds;
+    struct timeval to = { timeout / 1000, (timeout % 1000) * 1000 };
+    FD_ZERO(&rfds);
+    FD_ZERO(&wfds);
+
+    for (unsigned int i = 0; i < sockets.size(); i++)
+    {
+      if (sockets[i].m_read)
+        FD_SET(sockets[i].m_socket, &rfds);
+      if (sockets[i].m_write)
+        FD_SET(sockets[i].m_socket, &wfds);
+      if ((intptr_t)sockets[i].m_socket > (intptr_t)max_fd)
+        max_fd = sockets[i].m_socket;
+    }
+
+    int res = select((intptr_t)max_fd+1, &rfds, &wfds, NULL, &to);
+    for (unsigned int i = 0; res > 0 && i < sockets.size(); i++)
+    {
+      sockets[i].m_readable = FD_ISSET(sockets[i].m_socket, &rfds) != 0;
+      sockets[i].m_writable = FD_ISSET(sockets[i].m_socket, &wfds) != 0;
+    }
+    return res;
+#endif
+  }
+
+  bool WouldBlock()
+  {
+#ifdef _WIN32
+    return WSAGetLastError() == WSAEWOULDBLOCK;
+#else
+    return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+#endif
+  }
+}
+
 CTCPServer *CTCPServer::ServerInstance = NULL;
 
 bool CTCPServer::StartServer(int port, bool nonlocal)
@@ -91,6 +187,7 @@ CTCPServer::CTCPServer(int port, bool nonlocal) : CThread("CTCPServer")
   m_port = port;
   m_nonlocal = nonlocal;
   m_sdpd = NULL;
+  m_wakePipe[0] = m_wakePipe[1] = -1;
 }
 
 void CTCPServer::Process()
@@ -99,42 +196,46 @@ void CTCPServer::Process()
 
   while (!m_bStop)
   {
-    SOCKET          max_fd = 0;
-    fd_set          rfds;
-    struct timeval  to     = {1, 0};
-    FD_ZERO(&rfds);
-
+    // only this thread changes m_connections, so needs no lock to read it
+    std::vector<CPollSocket> sockets;
     for (std::vector<SOCKET>::iterator it = m_servers.begin(); it != m_servers.end(); it++)
-    {
-      FD_SET(*it, &rfds);
-      if ((intptr_t)*it > (intptr_t)max_fd)
-        max_fd = *it;
-    }
-
+      sockets.push_back(CPollSocket(*it));
+    // the next request of a client is only read once its response is queued
     for (unsigned int i = 0; i < m_connections.size(); i++)
-    {
-      FD_SET(m_connections[i]->m_socket, &rfds);
-      if ((intptr_t)m_connections[i]->m_socket > (intptr_t)max_fd)
-        max_fd = m_connections[i]->m_socket;
-    }
+      sockets.push_back(CPollSocket(m_connections[i]->m_socket, m_connections[i]->HasPendingData(), !m_connections[i]->IsResponding()));
+    if (m_wakePipe[0] >= 0)
+      sockets.push_back(CPollSocket(m_wakePipe[0]));
 
-    int res = select((intptr_t)max_fd+1, &rfds, NULL, NULL, &to);
+    int res = PollSockets(sockets, 1000);
     if (res < 0)
     {
-      CLog::Log(LOGERROR, "JSONRPC Server: Select failed");
+      CLog::Log(LOGERROR, "JSONRPC Server: Poll failed");
       Sleep(1000);
       Initialize();
     }
     else if (res > 0)
     {
+#ifndef _WIN32
+      if (m_wakePipe[0] >= 0 && sockets.back().m_readable)
+      {
+        char buffer[64];
+        while (read(m_wakePipe[0], buffer, sizeof(buffer)) > 0) ;
+      }
+#endif
+
       for (int i = m_connections.size() - 1; i >= 0; i--)
       {
-        int socket = m_connections[i]->m_socket;
-        if (FD_ISSET(socket, &rfds))
+        const CPollSocket &socket = sockets[m_servers.size() + i];
+        if (socket.m_writable)
+          m_connections[i]->Flush();
+        m_connections[i]->ContinueResponse();
+
+        bool disconnect = false;
+        if (socket.m_readable && !m_connections[i]->IsResponding())
         {
           char buffer[RECEIVEBUFFER] = {};
           int  nread = 0;
-          nread = recv(socket, (char*)&buffer, RECEIVEBUFFER, 0);
+          nread = recv(socket.m_socket, (char*)&buffer, RECEIVEBUFFER, 0);
           if (nread > 0)
           {
             std::string response;
@@ -149,6 +250,7 @@ void CTCPServer::Process()
               {
                 // Replace the CTCPClient with a CWebSocketClient
                 CWebSocketClient *websocketClient = new CWebSocketClient(websocket, *(m_connections[i]));
+                CSingleLock lock(m_connectionsSection);
                 delete m_connections[i];
                 m_connections.erase(m_connections.begin() + i);
                 m_connections.insert(m_connections.begin() + i, websocketClient);
@@ -159,29 +261,54 @@ void CTCPServer::Process()
               m_connections[i]->PushBuffer(this, buffer, nread);
 
           }
-          if (nread <= 0)
+          if (nread == 0 || (nread < 0 && !WouldBlock()))
           {
             CLog::Log(LOGINFO, "JSONRPC Server: Disconnection detected");
-            m_connections[i]->Disconnect();
-            delete m_connections[i];
-            m_connections.erase(m_connections.begin() + i);
+            disconnect = true;
           }
         }
+
+        if (!disconnect && m_connections[i]->HasFailed())
+        {
+          CLog::Log(LOGINFO, "JSONRPC Server: Disconnecting client that stopped reading");
+          disconnect = true;
+        }
+
+        if (disconnect)
+        {
+          CSingleLock lock(m_connectionsSection);
+          m_connections[i]->Disconnect();
+          delete m_connections[i];
+          m_connections.erase(m_connections.begin() + i);
+        }
       }
 
-      for (std::vector<SOCKET>::iterator it = m_servers.begin(); it != m_servers.end(); it++)
+      for (unsigned int i = 0; i < m_servers.size(); i++)
       {
-        if (FD_ISSET(*it, &rfds))
+        if (sockets[i].m_readable)
         {
           CLog::Log(LOGDEBUG, "JSONRPC Server: New connection detected");
           CTCPClient *newconnection = new CTCPClient();
-          newconnection->m_socket = accept(*it, (sockaddr*)&newconnection->m_cliaddr, &newconnection->m_addrlen);
+          newconnection->m_socket = accept(m_servers[i], (sockaddr*)&newconnection->m_cliaddr, &newconnection->m_addrlen);
 
           if (newconnection->m_socket == INVALID_SOCKET)
+          {
             CLog::Log(LOGERROR, "JSONRPC Server: Accept of new connection failed");
+            delete newconnection;
+          }
           else
           {
+            // a client that doesn't read mustn't hold up the others
+#ifdef _WIN32
+            unsigned long nonblocking = 1;
+            ioctlsocket(newconnection->m_socket, FIONBIO, &nonblocking);
+#else
+            fcntl(newconnection->m_socket, F_SETFL, fcntl(newconnection->m_socket, F_GETFL) | O_NONBLOCK);
+#endif
+            newconnection->m_host = this;
+
             CLog::Log(LOGINFO, "JSONRPC Server: New connection added");
+            CSingleLock lock(m_connectionsSection);
             m_connections.push_back(newconnection);
           }
         }
@@ -192,6 +319,18 @@ void CTCPServer::Process()
   Deinitialize();
 }
 
+void CTCPServer::Wake()
+{
+#ifndef _WIN32
+  if (m_wakePipe[1] >= 0)
+  {
+    char c = 0;
+    if (write(m_wakePipe[1], &c, 1) < 0)
+      CLog::Log(LOGDEBUG, "JSONRPC Server: Failed to wake server thread");
+  }
+#endif
+}
+
 bool CTCPServer::PrepareDownload(const char *path, CVariant &details, std::string &protocol)
 {
   return false;
@@ -209,8 +348,10 @@ int CTCPServer::GetCapabilities()
 
 void CTCPServer::Announce(AnnouncementFlag flag, const char *sender, const char *message, const CVariant &data)
 {
-  std::string str = IJSONRPCAnnouncer::AnnouncementToJSONRPC(flag, sender, message, data, g_advancedSettings.m_jsonOutputCompact);
+  // serialized once, and shared by the queues of all the clients
+  BufferPtr str(new std::string(IJSONRPCAnnouncer::AnnouncementToJSONRPC(flag, sender, message, data, g_advancedSettings.m_jsonOutputCompact)));
 
+  CSingleLock lock(m_connectionsSection);
   for (unsigned int i = 0; i < m_connections.size(); i++)
   {
     {
@@ -219,7 +360,7 @@ void CTCPServer::Announce(AnnouncementFlag flag, const char *sender, const char
         continue;
     }
 
-    m_connections[i]->Send(str.c_str(), str.size());
+    m_connections[i]->SendAnnouncement(str);
   }
 }
 
@@ -234,6 +375,16 @@ bool CTCPServer::Initialize()
 
   if(started)
   {
+#ifndef _WIN32
+    if (pipe(m_wakePipe) == 0)
+    {
+      fcntl(m_wakePipe[0], F_SETFL, fcntl(m_wakePipe[0], F_GETFL) | O_NONBLOCK);
+      fcntl(m_wakePipe[1], F_SETFL, fcntl(m_wakePipe[1], F_GETFL) | O_NONBLOCK);
+    }
+    else
+      m_wakePipe[0] = m_wakePipe[1] = -1;
+#endif
+
     CAnnouncementManager::AddAnnouncer(this);
     CLog::Log(LOGINFO, "JSONRPC Server: Successfully initialized");
     return true;
@@ -463,6 +614,7 @@ bool CTCPServer::InitializeTCP()
 
 void CTCPServer::Deinitialize()
 {
+  CSingleLock lock(m_connectionsSection);
   for (unsigned int i = 0; i < m_connections.size(); i++)
   {
     m_connections[i]->Disconnect();
@@ -470,6 +622,7 @@ void CTCPServer::Deinitialize()
   }
 
   m_connections.clear();
+  lock.Leave();
 
   for (unsigned int i = 0; i < m_servers.size(); i++)
     closesocket(m_servers[i]);
@@ -483,6 +636,15 @@ void CTCPServer::Deinitialize()
 #endif
 
   CAnnouncementManager::RemoveAnnouncer(this);
+
+#ifndef _WIN32
+  for (unsigned int i = 0; i < 2; i++)
+  {
+    if (m_wakePipe[i] >= 0)
+      close(m_wakePipe[i]);
+    m_wakePipe[i] = -1;
+  }
+#endif
 }
 
 CTCPServer::CTCPClient::CTCPClient()
@@ -494,6 +656,15 @@ CTCPServer::CTCPClient::CTCPClient()
   m_endBrackets = 0;
   m_beginChar = 0;
   m_endChar = 0;
+  m_host = NULL;
+  m_sendOffset = 0;
+  m_sendQueued = 0;
+  m_dropped = 0;
+  m_failed = false;
+  m_responding = false;
+  m_response = NULL;
+  m_responseSize = 0;
+  m_responseStart = 0;
 
   m_addrlen = sizeof(m_cliaddr);
 }
@@ -509,6 +680,11 @@ CTCPServer::CTCPClient& CTCPServer::CTCPClient::operator=(const CTCPClient& clie
   return *this;
 }
 
+CTCPServer::CTCPClient::~CTCPClient()
+{
+  delete m_response;
+}
+
 int CTCPServer::CTCPClient::GetPermissionFlags()
 {
   return OPERATION_PERMISSION_ALL;
@@ -527,12 +703,96 @@ bool CTCPServer::CTCPClient::SetAnnouncementFlags(int flags)
 
 void CTCPServer::CTCPClient::Send(const char *data, unsigned int size)
 {
-  unsigned int sent = 0;
-  do
+  Queue(BufferPtr(new std::string(data, size)));
+}
+
+void CTCPServer::CTCPClient::SendAnnouncement(const BufferPtr &data)
+{
+  CSingleLock lock (m_critSection);
+  if (!DropAnnouncement())
+    Queue(data);
+}
+
+bool CTCPServer::CTCPClient::DropAnnouncement()
+{
+  CSingleLock lock (m_critSection);
+  // while a response waits for the client, announcements would end up in the middle of it
+  if (m_sendQueued < SENDQUEUE_DROP_ANNOUNCEMENTS && !m_responding)
+    return false;
+
+  if (m_dropped++ == 0)
+    CLog::Log(LOGWARNING, "JSONRPC Server: Client isn't keeping up, dropping announcements");
+  return true;
+}
+
+void CTCPServer::CTCPClient::Queue(const BufferPtr &data)
+{
+  CSingleLock lock (m_critSection);
+  if (m_failed || m_socket == INVALID_SOCKET || data->empty())
+    return;
+
+  if (m_sendQueued >= SENDQUEUE_DISCONNECT)
+  { // the server thread will disconnect it
+    m_failed = true;
+    if (m_host)
+      m_host->Wake();
+    return;
+  }
+
+  bool wasEmpty = m_sendQueue.empty();
+  m_sendQueue.push_back(data);
+  m_sendQueued += data->size();
+  if (wasEmpty)
   {
-    CSingleLock lock (m_critSection);
-    sent += send(m_socket, data, size - sent, 0);
-  } while (sent < size);
+    Flush();
+    // have the server thread send the rest once the socket takes it
+    if (!m_sendQueue.empty() && m_host)
+      m_host->Wake();
+  }
+}
+
+void CTCPServer::CTCPClient::Flush()
+{
+  CSingleLock lock (m_critSection);
+  while (!m_sendQueue.empty() && !m_failed)
+  {
+    const std::string &data = *m_sendQueue.front();
+    int sent = send(m_socket, data.c_str() + m_sendOffset, data.size() - m_sendOffset, 0);
+    if (sent < 0)
+    {
+      if (!WouldBlock())
+        m_failed = true;
+      break;
+    }
+
+    m_sendOffset += sent;
+    m_sendQueued -= sent;
+    if (m_response)
+      m_responseTimeout.Set(RESPONSE_SEND_TIMEOUT);
+    if (m_sendOffset >= data.size())
+    {
+      m_sendQueue.pop_front();
+      m_sendOffset = 0;
+    }
+  }
+}
+
+bool CTCPServer::CTCPClient::HasPendingData()
+{
+  CSingleLock lock (m_critSection);
+  return !m_sendQueue.empty();
+}
+
+bool CTCPServer::CTCPClient::IsResponding()
+{
+  CSingleLock lock (m_critSection);
+  return m_responding;
+}
+
+bool CTCPServer::CTCPClient::HasFailed()
+{
+  CSingleLock lock (m_critSection);
+  return m_failed;
 }
 
 void CTCPServer::CTCPClient::PushBuffer(CTCPServer *host, const char *buffer, int length)
@@ -563,20 +823,86 @@ void CTCPServer::CTCPClient::PushBuffer(CTCPServer *host, const char *buffer, in
         m_endBrackets++;
       if (m_beginBrackets > 0 && m_endBrackets > 0 && m_beginBrackets == m_endBrackets)
       {
-        std::string line = CJSONRPC::MethodCall(m_buffer, host, this);
-        Send(line.c_str(), line.size());
+        unsigned int start = XbmcThreads::SystemClockMillis();
+        CJSONVariantStream *response = CJSONRPC::MethodCallStream(m_buffer, host, this);
         m_beginChar = m_beginBrackets = m_endBrackets = 0;
         m_buffer.clear();
+        if (response)
+        {
+          CLog::Log(LOGDEBUG, "JSONRPC Server: Handled request in %ums", XbmcThreads::SystemClockMillis() - start);
+          SendResponse(response);
+          if (IsResponding())
+          { // the rest waits for the response to be queued, so the responses stay in order
+            m_pendingInput.assign(buffer + i + 1, length - i - 1);
+            return;
+          }
+        }
       }
     }
   }
 }
 
+void CTCPServer::CTCPClient::SendResponse(CJSONVariantStream *response)
+{
+  CSingleLock lock (m_critSection);
+  delete m_response;
+  m_response = response;
+  m_responseSize = 0;
+  m_responseStart = XbmcThreads::SystemClockMillis();
+  m_responseTimeout.Set(RESPONSE_SEND_TIMEOUT);
+  // keep announcements from ending up in the middle of the response
+  m_responding = true;
+  ContinueResponse();
+}
+
+void CTCPServer::CTCPClient::ContinueResponse()
+{
+  CSingleLock lock (m_critSection);
+  if (!m_response)
+    return;
+
+  // the response is queued in parts which are sent as they are serialized,
+  // and serializing stops whenever too much is queued for the client
+  std::string data;
+  while (!m_failed && m_sendQueued < RESPONSE_QUEUE_MAX)
+  {
+    if (!m_response->Read(data, RESPONSE_CHUNK_SIZE))
+    {
+      CLog::Log(LOGDEBUG, "JSONRPC Server: Sent response of %u bytes in %ums",
+                m_responseSize, XbmcThreads::SystemClockMillis() - m_responseStart);
+      delete m_response;
+      m_response = NULL;
+      m_responding = false;
+
+      std::string input;
+      input.swap(m_pendingInput);
+      lock.Leave();
+      if (!input.empty())
+        CTCPClient::PushBuffer(m_host, input.c_str(), input.size());
+      return;
+    }
+    Send(data.c_str(), data.size());
+    m_responseSize += data.size();
+  }
+
+  if (!m_failed && m_responseTimeout.IsTimePast())
+  { // the server thread will disconnect it
+    CLog::Log(LOGWARNING, "JSONRPC Server: Client isn't reading its response, disconnecting");
+    m_failed = true;
+  }
+}
+
 void CTCPServer::CTCPClient::Disconnect()
 {
   if (m_socket > 0)
   {
     CSingleLock lock (m_critSection);
+    if (m_dropped)
+      CLog::Log(LOGINFO, "JSONRPC Server: Dropped %u announcements for client", m_dropped);
+    // whatever the socket still takes, e.g. a websocket close frame
+    Flush();
+    m_sendQueue.clear();
+    m_sendQueued = 0;
     shutdown(m_socket, SHUT_RDWR);
     closesocket(m_socket);
     m_socket = INVALID_SOCKET;
@@ -595,6 +921,18 @@ void CTCPServer::CTCPClient::Copy(const CTCPClient& client)
   m_beginChar         = client.m_beginChar;
   m_endChar           = client.m_endChar;
   m_buffer            = client.m_buffer;
+  m_host              = client.m_host;
+  m_sendQueue         = client.m_sendQueue;
+  m_sendOffset        = client.m_sendOffset;
+  m_sendQueued        = client.m_sendQueued;
+  m_dropped           = client.m_dropped;
+  m_failed            = client.m_failed;
+  m_pendingInput      = client.m_pendingInput;
+  // the response stays with the client it was sent to
+  m_responding        = false;
+  m_response          = NULL;
+  m_responseSize      = 0;
+  m_responseStart     = 0;
 }
 
 CTCPServer::CWebSocketClient::CWebSocketClient(CWebSocket *websocket)
@@ -641,6 +979,33 @@ void CTCPServer::CWebSocketClient::Send(const char *data, unsigned int size)
     CTCPClient::Send(frames.at(index)->GetFrameData(), (unsigned int)frames.at(index)->GetFrameLength());
 }
 
+void CTCPServer::CWebSocketClient::SendResponse(CJSONVariantStream *response)
+{
+  // every Send() is a message of its own, so the response has to be sent in one go
+  std::string data, part;
+  while (response->Read(part, RESPONSE_CHUNK_SIZE))
+    data.append(part);
+  delete response;
+  Send(data.c_str(), data.size());
+  CLog::Log(LOGDEBUG, "JSONRPC Server: Sent response of %u bytes", (unsigned int)data.size());
+}
+
+void CTCPServer::CWebSocketClient::SendAnnouncement(const BufferPtr &data)
+{
+  // the framing is specific to the client, so this is where the buffer stops being shared
+  CSingleLock lock (m_critSection);
+  if (DropAnnouncement())
+    return;
+
+  const CWebSocketMessage *msg = m_websocket->Send(WebSocketTextFrame, data->c_str(), data->size());
+  if (msg == NULL || !msg->IsComplete())
+    return;
+
+  std::vector<const CWebSocketFrame *> frames = msg->GetFrames();
+  for (unsigned int index = 0; index < frames.size(); index++)
+    Queue(BufferPtr(new std::string(frames.at(index)->GetFrameData(), (unsigned int)frames.at(index)->GetFrameLength())));
+}
+
 void CTCPServer::CWebSocketClient::PushBuffer(CTCPServer *host, const char *buffer, int length)
 {
   bool send;
@@ -21,15 +21,21 @@
  */
 
 #include <vector>
+#include <deque>
+#include <string>
 #include <sys/socket.h>
+#include <boost/shared_ptr.hpp>
 
 #include "interfaces/json-rpc/IClient.h"
 #include "interfaces/json-rpc/IJSONRPCAnnouncer.h"
 #include "interfaces/json-rpc/ITransportLayer.h"
 #include "threads/CriticalSection.h"
+#include "threads/SystemClock.h"
 #include "threads/Thread.h"
 #include "websocket/WebSocket.h"
 
+class CJSONVariantStream;
+
 namespace JSONRPC
 {
   class CTCPServer : public ITransportLayer, public JSONRPC::IJSONRPCAnnouncer, public CThread
@@ -51,6 +57,9 @@ namespace JSONRPC
     bool InitializeBlue();
     bool InitializeTCP();
     void Deinitialize();
+    void Wake();
+
+    typedef boost::shared_ptr<const std::string> BufferPtr;
 
     class CTCPClient : public IClient
     {
@@ -60,26 +69,63 @@ namespace JSONRPC
       //when adding a member variable, make sure to copy it in CTCPClient::Copy
       CTCPClient(const CTCPClient& client);
       CTCPClient& operator=(const CTCPClient& client);
-      virtual ~CTCPClient() { };
+      virtual ~CTCPClient();
 
       virtual int  GetPermissionFlags();
       virtual int  GetAnnouncementFlags();
       virtual bool SetAnnouncementFlags(int flags);
 
       virtual void Send(const char *data, unsigned int size);
+      /*!
+       \brief Queue an announcement, which is shared between all clients and dropped if the client is too far behind
+       */
+      virtual void SendAnnouncement(const BufferPtr &data);
+      /*!
+       \brief Send a JSON-RPC response, the first parts of which go out while the rest is serialized
+       Takes ownership of the response. What doesn't fit in the send queue is serialized by
+       ContinueResponse() once the client has read enough of it.
+       */
+      virtual void SendResponse(CJSONVariantStream *response);
       virtual void PushBuffer(CTCPServer *host, const char *buffer, int length);
       virtual void Disconnect();
 
       virtual bool IsNew() const { return m_new; }
 
+      /*!
+       \brief Send as much of the queued data as the socket takes without blocking
+       */
+      void Flush();
+      /*!
+       \brief Queue more of a pending response if the client has read enough of it
+       */
+      void ContinueResponse();
+      bool HasPendingData();
+      bool IsResponding();  ///< true while a response is pending, requests aren't read meanwhile
+      bool HasFailed(); ///< true if the client has stopped reading or its socket failed
+
       SOCKET           m_socket;
       sockaddr_storage m_cliaddr;
       socklen_t        m_addrlen;
       CCriticalSection m_critSection;
+      CTCPServer      *m_host;
 
     protected:
       void Copy(const CTCPClient& client);
+      void Queue(const BufferPtr &data);
+      bool DropAnnouncement(); ///< true if the client is too far behind to be sent announcements
     private:
+      std::deque<BufferPtr> m_sendQueue;
+      unsigned int m_sendOffset;  ///< offset of the unsent data in the front buffer
+      unsigned int m_sendQueued;  ///< bytes queued in total
+      unsigned int m_dropped;     ///< announcements dropped as the client was too far behind
+      bool m_failed;
+      bool m_responding;          ///< a response is being queued, announcements are dropped meanwhile
+      CJSONVariantStream *m_response;  ///< the rest of the response being sent
+      unsigned int m_responseSize;     ///< bytes of the response queued so far
+      unsigned int m_responseStart;
+      XbmcThreads::EndTime m_responseTimeout; ///< restarted whenever the client reads some of the response
+      std::string m_pendingInput;      ///< received after the request being answered, handled once it is
+
       bool m_new;
       int m_announcementflags;
       int m_beginBrackets, m_endBrackets;
@@ -97,6 +143,8 @@ namespace JSONRPC
       ~CWebSocketClient();
 
       virtual void Send(const char *data, unsigned int size);
+      virtual void SendAnnouncement(const BufferPtr &data);
+      virtual void SendResponse(CJSONVariantStream *response);
       virtual void PushBuffer(CTCPServer *host, const char *buffer, int length);
       virtual void Disconnect();
 
@@ -107,7 +155,9 @@ namespace JSONRPC
     };
 
     std::vector<CTCPClient*> m_connections;
+    CCriticalSection m_connectionsSection; ///< held while m_connections is changed, or used by other threads
     std::vector<SOCKET> m_servers;
+    int m_wakePipe[2]; ///< written to when data is queued for a client, to have the server poll for writing
     int m_port;
     bool m_nonlocal;
     void* m_sdpd;
@@ -305,6 +305,10 @@ int CWebServer::HandleRequest(IHTTPRequestHandler *handler, const HTTPRequest &r
       ret = CreateMemoryDownloadResponse(request.connection, handler->GetHTTPResponseData(), handler->GetHTTPResonseDataLength(), true, true, response);
       break;
 
+    case HTTPStreamDownload:
+      ret = CreateStreamDownloadResponse(request.connection, handler, response);
+      break;
+
     case HTTPError:
       ret = CreateErrorResponse(request.connection, handler->GetHTTPResonseCode(), request.method, response);
       break;
@@ -326,7 +330,9 @@ int CWebServer::HandleRequest(IHTTPRequestHandler *handler, const HTTPRequest &r
 
   MHD_queue_response(request.connection, handler->GetHTTPResonseCode(), response);
   MHD_destroy_response(response);
-  delete handler;
+  // a streamed response still needs the handler, it is deleted along with the response
+  if (handler->GetHTTPResponseType() != HTTPStreamDownload)
+    delete handler;
 
   return MHD_YES;
 }
@@ -435,6 +441,22 @@ int CWebServer::CreateMemoryDownloadResponse(struct MHD_Connection *connection,
   return MHD_NO;
 }
 
+int CWebServer::CreateStreamDownloadResponse(struct MHD_Connection *connection, IHTTPRequestHandler *handler, struct MHD_Response *&response)
+{
+  // without a known size MHD sends the response chunked
+#ifdef MHD_SIZE_UNKNOWN
+  response = MHD_create_response_from_callback (MHD_SIZE_UNKNOWN,
+#else
+  response = MHD_create_response_from_callback (-1,
+#endif
+                                                 16 * 1024,
+                                                 &CWebServer::StreamReaderCallback, handler,
+                                                 &CWebServer::StreamReaderFreeCallback);
+  if (response)
+    return MHD_YES;
+  return MHD_NO;
+}
+
 int CWebServer::SendErrorResponse(struct MHD_Connection *connection, int errorType, HTTPMethod method)
 {
   struct MHD_Response *response = NULL;
@@ -479,6 +501,27 @@ void CWebServer::ContentReaderFreeCallback(void *cls)
   delete file;
 }
 
+#if (MHD_VERSION >= 0x00090200)
+ssize_t CWebServer::StreamReaderCallback (void *cls, uint64_t pos, char *buf, size_t max)
+#elif (MHD_VERSION >= 0x00040001)
+int CWebServer::StreamReaderCallback(void *cls, uint64_t pos, char *buf, int max)
+#else   //libmicrohttpd < 0.4.0
+int CWebServer::StreamReaderCallback(void *cls, size_t pos, char *buf, int max)
+#endif
+{
+  IHTTPRequestHandler *handler = (IHTTPRequestHandler *)cls;
+  size_t res = handler->ReadHTTPResponseData(buf, max);
+  if (res == 0)
+    return -1;
+  return res;
+}
+
+void CWebServer::StreamReaderFreeCallback(void *cls)
+{
+  IHTTPRequestHandler *handler = (IHTTPRequestHandler *)cls;
+  delete handler;
+}
+
 struct MHD_Daemon* CWebServer::StartMHD(unsigned int flags, int port)
 {
   // WARNING: when using MHD_USE_THREAD_PER_CONNECTION, set MHD_OPTION_CONNECTION_TIMEOUT to something higher than 1
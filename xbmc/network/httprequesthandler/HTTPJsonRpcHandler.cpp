@@ -21,6 +21,8 @@
 
 #include "HTTPJsonRpcHandler.h"
 #include "network/WebServer.h"
+#include "threads/SystemClock.h"
+#include "utils/JSONVariantWriter.h"
 #include "utils/log.h"
 #include "interfaces/json-rpc/JSONRPC.h"
 #include "interfaces/json-rpc/JSONUtils.h"
@@ -31,6 +33,20 @@
 using namespace std;
 using namespace JSONRPC;
 
+CHTTPJsonRpcHandler::CHTTPJsonRpcHandler()
+{
+  m_responseStream = NULL;
+  m_responseOffset = 0;
+  m_responseSize = 0;
+  m_requestTime = 0;
+  m_firstPartTime = 0;
+}
+
+CHTTPJsonRpcHandler::~CHTTPJsonRpcHandler()
+{
+  delete m_responseStream;
+}
+
 bool CHTTPJsonRpcHandler::CheckHTTPRequest(const HTTPRequest &request)
 {
   return (request.url.compare("/jsonrpc") == 0);
@@ -50,7 +66,8 @@ int CHTTPJsonRpcHandler::HandleHTTPRequest(const HTTPRequest &request)
     }
 
     CHTTPClient client;
-    m_response = CJSONRPC::MethodCall(m_request, request.webserver, &client);
+    m_requestTime = XbmcThreads::SystemClockMillis();
+    m_responseStream = CJSONRPC::MethodCallStream(m_request, request.webserver, &client);
 
     m_responseHeaderFields.insert(pair<string, string>("Content-Type", "application/json"));
 
@@ -59,12 +76,38 @@ int CHTTPJsonRpcHandler::HandleHTTPRequest(const HTTPRequest &request)
   else
     m_response = PAGE_JSONRPC_INFO;
   
-  m_responseType = HTTPMemoryDownloadNoFreeCopy;
+  // the response is serialized as MHD sends it, rather than all at once up front
+  m_responseType = m_responseStream ? HTTPStreamDownload : HTTPMemoryDownloadNoFreeCopy;
   m_responseCode = MHD_HTTP_OK;
 
   return MHD_YES;
 }
 
+size_t CHTTPJsonRpcHandler::ReadHTTPResponseData(char *buffer, size_t size)
+{
+  while (m_responseOffset >= m_response.size())
+  {
+    if (m_responseStream == NULL || !m_responseStream->Read(m_response, size))
+    {
+      if (m_responseStream)
+        CLog::Log(LOGDEBUG, "JSONRPC: Sent response of %u bytes, first part after %ums, complete after %ums",
+                  (unsigned int)m_responseSize, m_firstPartTime - m_requestTime, XbmcThreads::SystemClockMillis() - m_requestTime);
+      delete m_responseStream;
+      m_responseStream = NULL;
+      return 0;
+    }
+    m_responseOffset = 0;
+    if (m_responseSize == 0)
+      m_firstPartTime = XbmcThreads::SystemClockMillis();
+    m_responseSize += m_response.size();
+  }
+
+  size_t length = min(size, m_response.size() - m_responseOffset);
+  memcpy(buffer, m_response.c_str() + m_responseOffset, length);
+  m_responseOffset += length;
+  return length;
+}
+
 #if (MHD_VERSION >= 0x00040001)
 bool CHTTPJsonRpcHandler::appendPostData(const char *data, size_t size)
 #else
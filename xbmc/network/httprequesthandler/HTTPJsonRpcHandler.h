@@ -23,10 +23,13 @@
 #include "IHTTPRequestHandler.h"
 #include "interfaces/json-rpc/IClient.h"
 
+class CJSONVariantStream;
+
 class CHTTPJsonRpcHandler : public IHTTPRequestHandler
 {
 public:
-  CHTTPJsonRpcHandler() { };
+  CHTTPJsonRpcHandler();
+  virtual ~CHTTPJsonRpcHandler();
   
   virtual IHTTPRequestHandler* GetInstance() { return new CHTTPJsonRpcHandler(); }
   virtual bool CheckHTTPRequest(const HTTPRequest &request);
@@ -34,6 +37,7 @@ public:
 
   virtual void* GetHTTPResponseData() const { return (void *)m_response.c_str(); };
   virtual size_t GetHTTPResonseDataLength() const { return m_response.size(); }
+  virtual size_t ReadHTTPResponseData(char *buffer, size_t size);
 
   virtual int GetPriority() const { return 2; }
 
@@ -48,6 +52,12 @@ private:
   std::string m_request;
   std::string m_response;
 
+  CJSONVariantStream *m_responseStream; ///< the response of a method call, m_response holds its current part
+  size_t m_responseOffset;              ///< how much of m_response has been sent
+  size_t m_responseSize;
+  unsigned int m_requestTime;
+  unsigned int m_firstPartTime;
+
   class CHTTPClient : public JSONRPC::IClient
   {
   public:
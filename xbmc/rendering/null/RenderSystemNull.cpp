@@ -0,0 +1,167 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+
+#include "system.h"
+
+#ifdef HAS_HEADLESS
+
+#include "RenderSystemNull.h"
+
+CRenderSystemNull::CRenderSystemNull() : CRenderSystemBase()
+{
+  m_enumRenderingSystem = RENDERING_SYSTEM_NULL;
+  m_width = 0;
+  m_height = 0;
+  m_drawCalls = 0;
+  m_quads = 0;
+  m_lastDrawCalls = 0;
+  m_lastQuads = 0;
+}
+
+CRenderSystemNull::~CRenderSystemNull()
+{
+  DestroyRenderSystem();
+}
+
+bool CRenderSystemNull::InitRenderSystem()
+{
+  m_bVSync = false;
+  m_maxTextureSize = 4096;
+  m_renderCaps = RENDER_CAPS_NPOT | RENDER_CAPS_DXT | RENDER_CAPS_DXT_NPOT | RENDER_CAPS_BGRA;
+
+  m_RenderVendor = "XBMC";
+  m_RenderRenderer = "Null";
+  m_RenderVersion = "1.0";
+  m_RenderVersionMajor = 1;
+  m_RenderVersionMinor = 0;
+
+  m_bRenderCreated = true;
+  return true;
+}
+
+bool CRenderSystemNull::DestroyRenderSystem()
+{
+  m_bRenderCreated = false;
+  return true;
+}
+
+bool CRenderSystemNull::ResetRenderSystem(int width, int height, bool fullScreen, float refreshRate)
+{
+  m_width = width;
+  m_height = height;
+
+  CRect rect(0, 0, (float)width, (float)height);
+  SetViewPort(rect);
+  return true;
+}
+
+bool CRenderSystemNull::BeginRender()
+{
+  return m_bRenderCreated;
+}
+
+bool CRenderSystemNull::EndRender()
+{
+  return m_bRenderCreated;
+}
+
+bool CRenderSystemNull::PresentRender(const CDirtyRegionList& dirty)
+{
+  m_lastDrawCalls = m_drawCalls;
+  m_lastQuads = m_quads;
+  m_drawCalls = 0;
+  m_quads = 0;
+  return m_bRenderCreated;
+}
+
+bool CRenderSystemNull::ClearBuffers(color_t color)
+{
+  return m_bRenderCreated;
+}
+
+bool CRenderSystemNull::IsExtSupported(const char* extension)
+{
+  return false;
+}
+
+void CRenderSystemNull::SetVSync(bool vsync)
+{
+  // there's no display to sync to
+  m_bVSync = false;
+}
+
+void CRenderSystemNull::SetViewPort(CRect& viewPort)
+{
+  m_viewPort = viewPort;
+}
+
+void CRenderSystemNull::GetViewPort(CRect& viewPort)
+{
+  viewPort = m_viewPort;
+}
+
+void CRenderSystemNull::SetScissors(const CRect &rect)
+{
+}
+
+void CRenderSystemNull::ResetScissors()
+{
+}
+
+void CRenderSystemNull::CaptureStateBlock()
+{
+}
+
+void CRenderSystemNull::ApplyStateBlock()
+{
+}
+
+void CRenderSystemNull::SetCameraPosition(const CPoint &camera, int screenWidth, int screenHeight)
+{
+}
+
+void CRenderSystemNull::ApplyHardwareTransform(const TransformMatrix &matrix)
+{
+}
+
+void CRenderSystemNull::RestoreHardwareTransform()
+{
+}
+
+bool CRenderSystemNull::TestRender()
+{
+  return true;
+}
+
+void CRenderSystemNull::Project(float &x, float &y, float &z)
+{
+  // the z = 0 plane is the screen, as it is with the GL camera setup
+  z = 0;
+}
+
+void CRenderSystemNull::GetFrameStats(unsigned int &drawCalls, unsigned int &quads) const
+{
+  drawCalls = m_lastDrawCalls;
+  quads = m_lastQuads;
+}
+
+#endif
@@ -0,0 +1,85 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "rendering/RenderSystem.h"
+
+/*!
+ \brief Render system that draws nothing
+
+ Used for headless builds, where the GUI is processed and rendered as usual to
+ measure its cost, but no display or GPU is needed. Textures and fonts are
+ still decoded and laid out, only the final drawing is skipped.
+ */
+class CRenderSystemNull : public CRenderSystemBase
+{
+public:
+  CRenderSystemNull();
+  virtual ~CRenderSystemNull();
+
+  virtual bool InitRenderSystem();
+  virtual bool DestroyRenderSystem();
+  virtual bool ResetRenderSystem(int width, int height, bool fullScreen, float refreshRate);
+
+  virtual bool BeginRender();
+  virtual bool EndRender();
+  virtual bool PresentRender(const CDirtyRegionList& dirty);
+  virtual bool ClearBuffers(color_t color);
+  virtual bool IsExtSupported(const char* extension);
+
+  virtual void SetVSync(bool vsync);
+
+  virtual void SetViewPort(CRect& viewPort);
+  virtual void GetViewPort(CRect& viewPort);
+
+  virtual void SetScissors(const CRect &rect);
+  virtual void ResetScissors();
+
+  virtual void CaptureStateBlock();
+  virtual void ApplyStateBlock();
+
+  virtual void SetCameraPosition(const CPoint &camera, int screenWidth, int screenHeight);
+  virtual void ApplyHardwareTransform(const TransformMatrix &matrix);
+  virtual void RestoreHardwareTransform();
+
+  virtual bool TestRender();
+
+  virtual void Project(float &x, float &y, float &z);
+
+  /*! \brief Count a draw call, along with the number of quads it draws
+   */
+  void AddDrawCall(unsigned int quads) { m_drawCalls++; m_quads += quads; };
+
+  /*! \brief Get the number of draw calls and quads of the last frame presented
+   */
+  void GetFrameStats(unsigned int &drawCalls, unsigned int &quads) const;
+
+protected:
+  int m_width;
+  int m_height;
+  CRect m_viewPort;
+
+  unsigned int m_drawCalls;
+  unsigned int m_quads;
+  unsigned int m_lastDrawCalls;
+  unsigned int m_lastQuads;
+};
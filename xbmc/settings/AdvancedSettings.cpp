@@ -51,11 +51,16 @@ void CAdvancedSettings::Initialize()
   m_audioApplyDrc = true;
   m_dvdplayerIgnoreDTSinWAV = false;
   m_audioResample = 0;
+  m_audioResampleQuality = 2;
+  m_audioPolyphaseResampler = false;
   m_allowTranscode44100 = false;
   m_audioForceDirectSound = false;
   m_audioAudiophile = false;
   m_allChannelStereo = false;
   m_audioSinkBufferDurationMsec = 50;
+  m_audioNullSinkPeriodMsec = 0;
+  m_audioNullSinkJitterMsec = 0.0f;
+  m_audioNullSinkDriftPpm = 0.0f;
 
   //default hold time of 25 ms, this allows a 20 hertz sine to pass undistorted
   m_limiterHold = 0.025f;
@@ -98,6 +103,7 @@ void CAdvancedSettings::Initialize()
   m_videoVDPAUScaling = false;
   m_videoNonLinStretchRatio = 0.5f;
   m_videoEnableHighQualityHwScalers = false;
+  m_videoProbeCacheSize = 0;
   m_videoAutoScaleMaxFps = 30.0f;
   m_videoAllowMpeg4VDPAU = false;
   m_videoAllowMpeg4VAAPI = false;  
@@ -198,6 +204,7 @@ void CAdvancedSettings::Initialize()
   m_bMusicLibraryHideAllItems = false;
   m_bMusicLibraryAllItemsOnBottom = false;
   m_bMusicLibraryAlbumsSortByArtistThenYear = false;
+  m_bMusicLibraryAnalyseReplayGain = false;
   m_iMusicLibraryRecentlyAddedItems = 25;
   m_strMusicLibraryAlbumFormat = "";
   m_strMusicLibraryAlbumFormatRight = "";
@@ -242,6 +249,8 @@ void CAdvancedSettings::Initialize()
   m_curlconnecttimeout = 10;
   m_curllowspeedtime = 20;
   m_curlretries = 2;
+  m_curlSegments = 0;
+  m_curlSegmentSize = 1024 * 1024;
   m_curlDisableIPV6 = false;      //Certain hardware/OS combinations have trouble
                                   //with ipv6.
 
@@ -282,6 +291,8 @@ void CAdvancedSettings::Initialize()
   m_measureRefreshrate = false;
 
   m_cacheMemBufferSize = 1024 * 1024 * 20;
+  m_cacheRanges = 1;
+  m_dirCacheDiskSize = 0;
 
   m_jsonOutputCompact = true;
   m_jsonTcpPort = 9090;
@@ -292,6 +303,8 @@ void CAdvancedSettings::Initialize()
   m_guiVisualizeDirtyRegions = false;
   m_guiAlgorithmDirtyRegions = 0;
   m_guiDirtyRegionNoFlipTimeout = -1;
+  m_guiTextureCacheSize = 16;
+  m_guiCacheWindows = true;
   m_logEnableAirtunes = false;
   m_airTunesPort = 36666;
   m_airPlayPort = 36667;
@@ -367,12 +380,18 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
     XMLUtils::GetInt(pElement, "percentseekbackwardbig", m_musicPercentSeekBackwardBig, -100, 0);
 
     XMLUtils::GetInt(pElement, "resample", m_audioResample, 0, 192000);
+    XMLUtils::GetInt(pElement, "resamplequality", m_audioResampleQuality, 0, 3);
+    XMLUtils::GetBoolean(pElement, "polyphaseresampler", m_audioPolyphaseResampler);
     XMLUtils::GetBoolean(pElement, "allowtranscode44100", m_allowTranscode44100);
     XMLUtils::GetBoolean(pElement, "forceDirectSound", m_audioForceDirectSound);
     XMLUtils::GetBoolean(pElement, "audiophile", m_audioAudiophile);
     XMLUtils::GetBoolean(pElement, "allchannelstereo", m_allChannelStereo);
     XMLUtils::GetString(pElement, "transcodeto", m_audioTranscodeTo);
     XMLUtils::GetInt(pElement, "audiosinkbufferdurationmsec", m_audioSinkBufferDurationMsec);
+    // make the NULL sink behave like a device with a coarse and jittery delay and a drifting clock
+    XMLUtils::GetInt(pElement, "nullsinkperiodmsec", m_audioNullSinkPeriodMsec, 0, 500);
+    XMLUtils::GetFloat(pElement, "nullsinkjittermsec", m_audioNullSinkJitterMsec, 0.0f, 100.0f);
+    XMLUtils::GetFloat(pElement, "nullsinkdriftppm", m_audioNullSinkDriftPpm, -10000.0f, 10000.0f);
 
     TiXmlElement* pAudioExcludes = pElement->FirstChildElement("excludefromlisting");
     if (pAudioExcludes)
@@ -465,6 +484,7 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
     XMLUtils::GetBoolean(pElement,"vdpauscaling",m_videoVDPAUScaling);
     XMLUtils::GetFloat(pElement, "nonlinearstretchratio", m_videoNonLinStretchRatio, 0.01f, 1.0f);
     XMLUtils::GetBoolean(pElement,"enablehighqualityhwscalers", m_videoEnableHighQualityHwScalers);
+    XMLUtils::GetInt(pElement, "probecachesize", m_videoProbeCacheSize, 0, 100000);
     XMLUtils::GetFloat(pElement,"autoscalemaxfps",m_videoAutoScaleMaxFps, 0.0f, 1000.0f);
     XMLUtils::GetBoolean(pElement,"allowmpeg4vdpau",m_videoAllowMpeg4VDPAU);
     XMLUtils::GetBoolean(pElement,"allowmpeg4vaapi",m_videoAllowMpeg4VAAPI);    
@@ -605,6 +625,7 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
     XMLUtils::GetBoolean(pElement, "prioritiseapetags", m_prioritiseAPEv2tags);
     XMLUtils::GetBoolean(pElement, "allitemsonbottom", m_bMusicLibraryAllItemsOnBottom);
     XMLUtils::GetBoolean(pElement, "albumssortbyartistthenyear", m_bMusicLibraryAlbumsSortByArtistThenYear);
+    XMLUtils::GetBoolean(pElement, "analysereplaygain", m_bMusicLibraryAnalyseReplayGain);
     XMLUtils::GetString(pElement, "albumformat", m_strMusicLibraryAlbumFormat);
     XMLUtils::GetString(pElement, "albumformatright", m_strMusicLibraryAlbumFormatRight);
     XMLUtils::GetString(pElement, "itemseparator", m_musicItemSeparator);
@@ -661,7 +682,11 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
     XMLUtils::GetInt(pElement, "curllowspeedtime", m_curllowspeedtime, 1, 1000);
     XMLUtils::GetInt(pElement, "curlretries", m_curlretries, 0, 10);
     XMLUtils::GetBoolean(pElement,"disableipv6", m_curlDisableIPV6);
+    XMLUtils::GetInt(pElement, "curlsegments", m_curlSegments, 0, 16);
+    XMLUtils::GetUInt(pElement, "curlsegmentsize", m_curlSegmentSize);
     XMLUtils::GetUInt(pElement, "cachemembuffersize", m_cacheMemBufferSize);
+    XMLUtils::GetInt(pElement, "cacheranges", m_cacheRanges, 1, 8);
+    XMLUtils::GetUInt(pElement, "dircachesize", m_dirCacheDiskSize);
   }
 
   pElement = pRootElement->FirstChildElement("jsonrpc");
@@ -973,6 +998,8 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
     XMLUtils::GetBoolean(pElement, "visualizedirtyregions", m_guiVisualizeDirtyRegions);
     XMLUtils::GetInt(pElement, "algorithmdirtyregions",     m_guiAlgorithmDirtyRegions);
     XMLUtils::GetInt(pElement, "nofliptimeout",             m_guiDirtyRegionNoFlipTimeout);
+    XMLUtils::GetInt(pElement, "texturecachesize",          m_guiTextureCacheSize, 0, 1024);
+    XMLUtils::GetBoolean(pElement, "cachewindows",          m_guiCacheWindows);
   }
 
   // load in the GUISettings overrides:
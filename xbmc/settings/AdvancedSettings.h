@@ -105,11 +105,16 @@ class CAdvancedSettings
     float m_audioPlayCountMinimumPercent;
     bool m_dvdplayerIgnoreDTSinWAV;
     int m_audioResample;
+    int m_audioResampleQuality;
+    bool m_audioPolyphaseResampler;
     bool m_allowTranscode44100;
     bool m_audioForceDirectSound;
     bool m_audioAudiophile;
     bool m_allChannelStereo;
     int m_audioSinkBufferDurationMsec;
+    int m_audioNullSinkPeriodMsec;
+    float m_audioNullSinkJitterMsec;
+    float m_audioNullSinkDriftPpm;
     CStdString m_audioTranscodeTo;
     float m_limiterHold;
     float m_limiterRelease;
@@ -148,6 +153,7 @@ class CAdvancedSettings
     bool  m_videoVDPAUScaling;
     float m_videoNonLinStretchRatio;
     bool  m_videoEnableHighQualityHwScalers;
+    int   m_videoProbeCacheSize; ///< number of demuxer probe results kept in special://temp, 0 to disable
     float m_videoAutoScaleMaxFps;
     bool  m_videoAllowMpeg4VDPAU;
     bool  m_videoAllowMpeg4VAAPI;
@@ -234,6 +240,7 @@ class CAdvancedSettings
     int m_iMusicLibraryRecentlyAddedItems;
     bool m_bMusicLibraryAllItemsOnBottom;
     bool m_bMusicLibraryAlbumsSortByArtistThenYear;
+    bool m_bMusicLibraryAnalyseReplayGain;
     CStdString m_strMusicLibraryAlbumFormat;
     CStdString m_strMusicLibraryAlbumFormatRight;
     bool m_prioritiseAPEv2tags;
@@ -284,6 +291,8 @@ class CAdvancedSettings
     int m_curllowspeedtime;
     int m_curlretries;
     bool m_curlDisableIPV6;
+    int m_curlSegments;              ///< concurrent range requests for http streams, 0 or 1 to disable
+    unsigned int m_curlSegmentSize;
 
     bool m_fullScreen;
     bool m_startFullScreen;
@@ -327,8 +336,12 @@ class CAdvancedSettings
     bool m_guiVisualizeDirtyRegions;
     int  m_guiAlgorithmDirtyRegions;
     int  m_guiDirtyRegionNoFlipTimeout;
+    int  m_guiTextureCacheSize; ///< MB of released textures kept resident for reuse
+    bool m_guiCacheWindows;     ///< keep compiled skin windows in special://temp/skincache
 
     unsigned int m_cacheMemBufferSize;
+    int m_cacheRanges;               ///< independently cached ranges per file, sharing m_cacheMemBufferSize
+    unsigned int m_dirCacheDiskSize; ///< size in bytes of the persistent directory cache, 0 to disable
 
     bool m_jsonOutputCompact;
     unsigned int m_jsonTcpPort;
@@ -27,6 +27,8 @@
 #include "Application.h"
 #include "ApplicationMessenger.h"
 #include "utils/log.h"
+#include "utils/GUIBenchmark.h"
+#include "cores/dvdplayer/DVDSyncTest.h"
 #ifdef TARGET_WINDOWS
 #include "WIN32Util.h"
 #endif
@@ -108,6 +110,11 @@ void CAppParamParser::DisplayHelp()
   printf("  --test\t\tEnable test mode. [FILE] required.\n");
   printf("  --settings=<filename>\t\tLoads specified file after advancedsettings.xml replacing any settings specified\n");
   printf("  \t\t\t\tspecified file must exist in special://xbmc/system/\n");
+  printf("  --gui-benchmark=<filename>\tRuns the builtins in the specified file, saves GUI\n");
+  printf("  \t\t\t\tprofiling results to special://home/guibenchmark.xml and quits\n");
+  printf("  --sync-test[=<speed>]\tPlays [FILE] through the NULL audio sink with the clock running\n");
+  printf("  \t\t\t\t<speed> times real time, saves a/v sync statistics to\n");
+  printf("  \t\t\t\tspecial://home/synctest.csv and quits\n");
   exit(0);
 }
 
@@ -138,6 +145,12 @@ void CAppParamParser::ParseArg(const CStdString &arg)
     m_testmode = true;
   else if (arg.substr(0, 11) == "--settings=")
     g_advancedSettings.AddSettingsFile(arg.substr(11));
+  else if (arg.substr(0, 16) == "--gui-benchmark=")
+    CGUIBenchmark::Get().SetScript(arg.substr(16));
+  else if (arg == "--sync-test")
+    CDVDSyncTest::Get().Enable(1.0);
+  else if (arg.substr(0, 12) == "--sync-test=")
+    CDVDSyncTest::Get().Enable(atof(arg.substr(12).c_str()));
   else if (arg.length() != 0 && arg[0] != '-')
   {
     if (m_testmode)
@@ -22,6 +22,7 @@
 #include "GUISettings.h"
 #include <limits.h>
 #include <float.h>
+#include <algorithm>
 #include "Settings.h"
 #include "dialogs/GUIDialogFileBrowser.h"
 #include "storage/MediaManager.h"
@@ -48,6 +49,7 @@
 #include "utils/Weather.h"
 #include "LangInfo.h"
 #include "utils/XMLUtils.h"
+#include "threads/SingleLock.h"
 #if defined(TARGET_DARWIN)
   #include "osx/DarwinUtils.h"
 #endif
@@ -234,8 +236,17 @@ void CSettingsGroup::GetCategories(vecSettingsCategory &vecCategories)
 }
 
 // Settings are case sensitive
+CSettingHandle::CSettingHandle(const char *strSetting)
+{
+  m_strSetting = strSetting;
+  m_strSetting.ToLower();
+  m_setting = NULL;
+  m_generation = 0;
+}
+
 CGUISettings::CGUISettings(void)
 {
+  m_generation = 1;
 }
 
 void CGUISettings::Initialize()
@@ -993,6 +1004,7 @@ void CGUISettings::SetBool(const char *strSetting, bool bSetting)
   if (it != settingsMap.end())
   { // old category
     ((CSettingBool*)(*it).second)->SetData(bSetting);
+    OnSettingChanged((*it).second);
     return ;
   }
   // Assert here and write debug output
@@ -1006,6 +1018,7 @@ void CGUISettings::ToggleBool(const char *strSetting)
   if (it != settingsMap.end())
   { // old category
     ((CSettingBool*)(*it).second)->SetData(!((CSettingBool *)(*it).second)->GetData());
+    OnSettingChanged((*it).second);
     return ;
   }
   // Assert here and write debug output
@@ -1041,6 +1054,7 @@ void CGUISettings::SetFloat(const char *strSetting, float fSetting)
   if (it != settingsMap.end())
   {
     ((CSettingFloat *)(*it).second)->SetData(fSetting);
+    OnSettingChanged((*it).second);
     return ;
   }
   // Assert here and write debug output
@@ -1112,6 +1126,7 @@ void CGUISettings::SetInt(const char *strSetting, int iSetting)
   if (it != settingsMap.end())
   {
     ((CSettingInt *)(*it).second)->SetData(iSetting);
+    OnSettingChanged((*it).second);
     return ;
   }
   // Assert here and write debug output
@@ -1147,28 +1162,7 @@ const CStdString &CGUISettings::GetString(const char *strSetting, bool bPrompt /
   ASSERT(settingsMap.size());
   constMapIter it = settingsMap.find(CStdString(strSetting).ToLower());
   if (it != settingsMap.end())
-  {
-    CSettingString* result = ((CSettingString *)(*it).second);
-    if (result->GetData() == "select folder" || result->GetData() == "select writable folder")
-    {
-      CStdString strData = "";
-      if (bPrompt)
-      {
-        VECSOURCES shares;
-        g_mediaManager.GetLocalDrives(shares);
-        if (CGUIDialogFileBrowser::ShowAndGetDirectory(shares,g_localizeStrings.Get(result->GetLabel()),strData,result->GetData() == "select writable folder"))
-        {
-          result->SetData(strData);
-          g_settings.Save();
-        }
-        else
-          return StringUtils::EmptyString;
-      }
-      else
-        return StringUtils::EmptyString;
-    }
-    return result->GetData();
-  }
+    return GetStringData((*it).second, bPrompt);
   // Assert here and write debug output
   CLog::Log(LOGDEBUG,"Error: Requested setting (%s) was not found.  It must be case-sensitive", strSetting);
   //ASSERT(false);
@@ -1183,6 +1177,7 @@ void CGUISettings::SetString(const char *strSetting, const char *strData)
   if (it != settingsMap.end())
   {
     ((CSettingString *)(*it).second)->SetData(strData);
+    OnSettingChanged((*it).second);
     return ;
   }
   // Assert here and write debug output
@@ -1190,6 +1185,30 @@ void CGUISettings::SetString(const char *strSetting, const char *strData)
   CLog::Log(LOGDEBUG,"Error: Requested setting (%s) was not found.  It must be case-sensitive", strSetting);
 }
 
+const CStdString &CGUISettings::GetStringData(CSetting *setting, bool bPrompt) const
+{
+  CSettingString* result = (CSettingString *)setting;
+  if (result->GetData() == "select folder" || result->GetData() == "select writable folder")
+  {
+    CStdString strData = "";
+    if (bPrompt)
+    {
+      VECSOURCES shares;
+      g_mediaManager.GetLocalDrives(shares);
+      if (CGUIDialogFileBrowser::ShowAndGetDirectory(shares,g_localizeStrings.Get(result->GetLabel()),strData,result->GetData() == "select writable folder"))
+      {
+        result->SetData(strData);
+        g_settings.Save();
+      }
+      else
+        return StringUtils::EmptyString;
+    }
+    else
+      return StringUtils::EmptyString;
+  }
+  return result->GetData();
+}
+
 CSetting *CGUISettings::GetSetting(const char *strSetting)
 {
   ASSERT(settingsMap.size());
@@ -1200,6 +1219,120 @@ CSetting *CGUISettings::GetSetting(const char *strSetting)
     return NULL;
 }
 
+CSetting *CGUISettings::GetSetting(const CSettingHandle &handle) const
+{
+  CSingleLock lock(handle.m_section);
+  if (handle.m_generation == m_generation)
+    return handle.m_setting;
+
+  // handles may be queried every frame, before the settings are initialized
+  if (settingsMap.empty())
+    return NULL;
+
+  constMapIter it = settingsMap.find(handle.m_strSetting);
+  if (it == settingsMap.end())
+    CLog::Log(LOGERROR,"Error: Requested setting (%s) was not found.  It must be case-sensitive", handle.m_strSetting.c_str());
+
+  // a missing setting is remembered as well, so it is only reported once
+  handle.m_setting = it != settingsMap.end() ? (*it).second : NULL;
+  handle.m_generation = m_generation;
+  return handle.m_setting;
+}
+
+bool CGUISettings::GetBool(const CSettingHandle &handle) const
+{
+  CSetting *setting = GetSetting(handle);
+  return setting ? ((CSettingBool *)setting)->GetData() : false;
+}
+
+void CGUISettings::SetBool(const CSettingHandle &handle, bool bSetting)
+{
+  CSetting *setting = GetSetting(handle);
+  if (setting)
+  {
+    ((CSettingBool *)setting)->SetData(bSetting);
+    OnSettingChanged(setting);
+  }
+}
+
+float CGUISettings::GetFloat(const CSettingHandle &handle) const
+{
+  CSetting *setting = GetSetting(handle);
+  return setting ? ((CSettingFloat *)setting)->GetData() : 0.0f;
+}
+
+void CGUISettings::SetFloat(const CSettingHandle &handle, float fSetting)
+{
+  CSetting *setting = GetSetting(handle);
+  if (setting)
+  {
+    ((CSettingFloat *)setting)->SetData(fSetting);
+    OnSettingChanged(setting);
+  }
+}
+
+int CGUISettings::GetInt(const CSettingHandle &handle) const
+{
+  CSetting *setting = GetSetting(handle);
+  return setting ? ((CSettingInt *)setting)->GetData() : 0;
+}
+
+void CGUISettings::SetInt(const CSettingHandle &handle, int iSetting)
+{
+  CSetting *setting = GetSetting(handle);
+  if (setting)
+  {
+    ((CSettingInt *)setting)->SetData(iSetting);
+    OnSettingChanged(setting);
+  }
+}
+
+const CStdString &CGUISettings::GetString(const CSettingHandle &handle, bool bPrompt /* = true */) const
+{
+  CSetting *setting = GetSetting(handle);
+  return setting ? GetStringData(setting, bPrompt) : StringUtils::EmptyString;
+}
+
+void CGUISettings::SetString(const CSettingHandle &handle, const char *strData)
+{
+  CSetting *setting = GetSetting(handle);
+  if (setting)
+  {
+    ((CSettingString *)setting)->SetData(strData);
+    OnSettingChanged(setting);
+  }
+}
+
+void CGUISettings::RegisterCallback(const CSettingHandle &handle, ISettingCallback *callback)
+{
+  CSingleLock lock(m_callbackSection);
+  m_callbacks[handle.m_strSetting].push_back(callback);
+}
+
+void CGUISettings::UnregisterCallback(ISettingCallback *callback)
+{
+  CSingleLock lock(m_callbackSection);
+  for (mapCallbacks::iterator it = m_callbacks.begin(); it != m_callbacks.end(); ++it)
+  {
+    vector<ISettingCallback*> &callbacks = (*it).second;
+    callbacks.erase(remove(callbacks.begin(), callbacks.end(), callback), callbacks.end());
+  }
+}
+
+void CGUISettings::OnSettingChanged(const CSetting *setting)
+{
+  vector<ISettingCallback*> callbacks;
+  { // call them outside of our lock, as they may well query settings themselves
+    CSingleLock lock(m_callbackSection);
+    mapCallbacks::const_iterator it = m_callbacks.find(setting->GetSetting());
+    if (it == m_callbacks.end())
+      return;
+    callbacks = (*it).second;
+  }
+  for (vector<ISettingCallback*>::iterator it = callbacks.begin(); it != callbacks.end(); ++it)
+    (*it)->OnSettingChanged(setting);
+}
+
 // get all the settings beginning with the term "strGroup"
 void CGUISettings::GetSettingsGroup(CSettingsCategory* cat, vecSettings &settings)
 {
@@ -1363,6 +1496,7 @@ void CGUISettings::SaveXML(TiXmlNode *pRootNode)
 
 void CGUISettings::Clear()
 {
+  m_generation++;
   for (mapIter it = settingsMap.begin(); it != settingsMap.end(); it++)
     delete (*it).second;
   settingsMap.clear();
@@ -25,6 +25,7 @@
 #include <map>
 #include "guilib/Resolution.h"
 #include "addons/IAddon.h"
+#include "threads/CriticalSection.h"
 
 class TiXmlNode;
 class TiXmlElement;
@@ -449,6 +450,43 @@ private:
 
 typedef std::vector<CSetting *> vecSettings;
 
+/*!
+ \brief Handle to a setting, for code that queries a setting often
+
+ Looking a setting up by name lower cases the name and searches the settings map on every
+ call. A handle does that once, and from then on refers to the setting directly. Handles
+ are meant to be static or members, e.g.
+
+   static CSettingHandle subtitleAlign("subtitles.align");
+   int align = g_guiSettings.GetInt(subtitleAlign);
+
+ A handle resolves itself again once the settings have been cleared. Handles may be shared
+ between threads, they lock while looking at or updating the cached setting.
+ */
+class CSettingHandle
+{
+public:
+  explicit CSettingHandle(const char *strSetting);
+  const CStdString &GetName() const { return m_strSetting; };
+private:
+  friend class CGUISettings;
+  CStdString m_strSetting;
+  mutable CSetting *m_setting;        ///< the setting, valid while m_generation matches CGUISettings'
+  mutable unsigned int m_generation;
+  mutable CCriticalSection m_section;
+};
+
+/*!
+ \brief Interface for being told about changes to a setting
+ \sa CGUISettings::RegisterCallback
+ */
+class ISettingCallback
+{
+public:
+  virtual ~ISettingCallback() {};
+  virtual void OnSettingChanged(const CSetting *setting) = 0;
+};
+
 class CGUISettings
 {
 public:
@@ -492,6 +530,28 @@ public:
 
   CSetting *GetSetting(const char *strSetting);
 
+  bool GetBool(const CSettingHandle &handle) const;
+  void SetBool(const CSettingHandle &handle, bool bSetting);
+  float GetFloat(const CSettingHandle &handle) const;
+  void SetFloat(const CSettingHandle &handle, float fSetting);
+  int GetInt(const CSettingHandle &handle) const;
+  void SetInt(const CSettingHandle &handle, int iSetting);
+  const CStdString &GetString(const CSettingHandle &handle, bool bPrompt=true) const;
+  void SetString(const CSettingHandle &handle, const char *strData);
+  CSetting *GetSetting(const CSettingHandle &handle) const;
+
+  /*! \brief Register a callback to be told when a setting changes
+   \param handle the setting to watch.
+   \param callback the callback, which must be unregistered before it is destroyed.
+   */
+  void RegisterCallback(const CSettingHandle &handle, ISettingCallback *callback);
+  void UnregisterCallback(ISettingCallback *callback);
+
+  /*! \brief Tell the callbacks of a setting that it has changed
+   Called by the Set* functions, and by anything that changes a setting via its CSetting.
+   */
+  void OnSettingChanged(const CSetting *setting);
+
   void GetSettingsGroup(CSettingsCategory* cat, vecSettings &settings);
   void LoadXML(TiXmlElement *pRootElement, bool hideSettings = false);
   void SaveXML(TiXmlNode *pRootNode);
@@ -509,11 +569,19 @@ public:
   void Clear();
 
 private:
+  const CStdString &GetStringData(CSetting *setting, bool bPrompt) const;
+
   typedef std::map<CStdString, CSetting*>::iterator mapIter;
   typedef std::map<CStdString, CSetting*>::const_iterator constMapIter;
   std::map<CStdString, CSetting*> settingsMap;
   std::vector<CSettingsGroup *> settingsGroups;
   void LoadFromXML(TiXmlElement *pRootElement, mapIter &it, bool advanced = false);
+
+  unsigned int m_generation; ///< incremented by Clear(), invalidating all handles
+
+  typedef std::map<CStdString, std::vector<ISettingCallback*> > mapCallbacks;
+  mapCallbacks m_callbacks;
+  CCriticalSection m_callbackSection;
 };
 
 extern CGUISettings g_guiSettings;
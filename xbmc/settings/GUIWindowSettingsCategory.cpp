@@ -1041,6 +1041,7 @@ void CGUIWindowSettingsCategory::CheckForUpdates()
 void CGUIWindowSettingsCategory::OnSettingChanged(CBaseSettingControl *pSettingControl)
 {
   CStdString strSetting = pSettingControl->GetSetting()->GetSetting();
+  g_guiSettings.OnSettingChanged(pSettingControl->GetSetting());
 
   // ok, now check the various special things we need to do
   if (pSettingControl->GetSetting()->GetType() == SETTINGS_TYPE_ADDON)
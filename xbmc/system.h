@@ -251,6 +251,14 @@
 #define HAS_GLES 1
 #endif
 
+// Headless build. No display and no GL, the GUI renders into the null backend
+#ifdef HAVE_HEADLESS
+#undef HAS_GL
+#undef HAS_GLX
+#undef HAS_SDL_OPENGL
+#define HAS_HEADLESS
+#endif
+
 #ifdef HAS_DVD_DRIVE
 #define HAS_CDDA_RIPPER
 #endif
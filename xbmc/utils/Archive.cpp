@@ -485,6 +485,23 @@ CArchive& CArchive::operator>>(std::vector<int>& iArray)
   return *this;
 }
 
+void CArchive::Write(const void* data, int size)
+{
+  if (size <= 0)
+    return;
+
+  FlushBuffer();
+  m_pFile->Write(data, size);
+}
+
+bool CArchive::Read(void* data, int size)
+{
+  if (size <= 0)
+    return true;
+
+  return m_pFile->Read(data, size) == (unsigned int)size;
+}
+
 void CArchive::FlushBuffer()
 {
   if (m_BufferPos > 0)
@@ -78,6 +78,10 @@ public:
   CArchive& operator>>(std::vector<std::string>& strArray);
   CArchive& operator>>(std::vector<int>& iArray);
 
+  // raw blocks, e.g. binary data that strings don't survive
+  void Write(const void* data, int size);
+  bool Read(void* data, int size);
+
   bool IsLoading();
   bool IsStoring();
 
@@ -0,0 +1,123 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+
+#include "GUIBenchmark.h"
+#include "ApplicationMessenger.h"
+#include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
+#include "guilib/GUIControlProfiler.h"
+#include "interfaces/Builtins.h"
+#include "utils/log.h"
+
+#include <limits.h>
+
+using namespace XFILE;
+
+CGUIBenchmark& CGUIBenchmark::Get()
+{
+  static CGUIBenchmark s_benchmark;
+  return s_benchmark;
+}
+
+CGUIBenchmark::CGUIBenchmark()
+{
+  m_line = 0;
+  m_wait = 0;
+  m_frames = 0;
+  m_started = false;
+}
+
+bool CGUIBenchmark::Load()
+{
+  CFile file;
+  if (!file.Open(m_strScript))
+  {
+    CLog::Log(LOGERROR, "%s - unable to open benchmark script %s", __FUNCTION__, m_strScript.c_str());
+    return false;
+  }
+
+  char line[1024];
+  while (file.ReadString(line, sizeof(line)))
+  {
+    CStdString strLine(line);
+    strLine.Trim();
+    if (strLine.IsEmpty() || strLine[0] == '#')
+      continue;
+    m_lines.push_back(strLine);
+  }
+  file.Close();
+
+  CLog::Log(LOGNOTICE, "%s - running %u lines from %s", __FUNCTION__, (unsigned int)m_lines.size(), m_strScript.c_str());
+  return true;
+}
+
+void CGUIBenchmark::Process()
+{
+  if (!IsActive())
+    return;
+
+  if (!m_started)
+  {
+    m_started = true;
+    if (!Load())
+    {
+      m_strScript.Empty();
+      CApplicationMessenger::Get().Quit();
+      return;
+    }
+    // we stop the profiler ourselves once the script is done
+    CGUIControlProfiler::Instance().SetMaxFrameCount(INT_MAX);
+    CGUIControlProfiler::Instance().Start();
+  }
+
+  m_frames++;
+  if (m_wait > 0)
+  {
+    m_wait--;
+    return;
+  }
+
+  while (m_line < m_lines.size() && m_wait == 0)
+  {
+    const CStdString &strLine = m_lines[m_line++];
+    if (strLine.Left(5).Equals("wait "))
+      m_wait = strtoul(strLine.Mid(5).c_str(), NULL, 10);
+    else if (CBuiltins::Execute(strLine) != 0)
+      CLog::Log(LOGWARNING, "%s - failed to execute '%s'", __FUNCTION__, strLine.c_str());
+  }
+
+  if (m_line >= m_lines.size() && m_wait == 0)
+    Finish();
+}
+
+void CGUIBenchmark::Finish()
+{
+  CGUIControlProfiler &profiler = CGUIControlProfiler::Instance();
+  profiler.Stop();
+  profiler.LogSummary(m_frames);
+  profiler.SetOutputFile(CSpecialProtocol::TranslatePath("special://home/guibenchmark.xml"));
+  if (!profiler.SaveResults())
+    CLog::Log(LOGERROR, "%s - unable to save %s", __FUNCTION__, profiler.GetOutputFile().c_str());
+
+  m_strScript.Empty();
+  CApplicationMessenger::Get().Quit();
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+
+#include "utils/StdString.h"
+
+#include <vector>
+
+/*!
+ \brief Drives the GUI through a scripted sequence of builtins and reports the
+ per-window Process/Render times collected by CGUIControlProfiler.
+
+ The script is a plain text file with one builtin per line, e.g.
+ "ActivateWindow(Videos)" or "Action(Down)". A line of the form "wait <n>"
+ lets <n> frames pass before the next line is run, and lines starting with '#'
+ are ignored. Once the script has finished the profile is written to
+ special://home/guibenchmark.xml, a summary is logged and XBMC quits.
+ */
+class CGUIBenchmark
+{
+public:
+  static CGUIBenchmark& Get();
+
+  /*!
+   \brief Set the script to run once the GUI is up.
+   \param strScript path to the benchmark script
+   */
+  void SetScript(const CStdString &strScript) { m_strScript = strScript; }
+  bool IsActive() const { return !m_strScript.IsEmpty(); }
+
+  /*!
+   \brief Advance the benchmark by one frame. Called from the application's FrameMove.
+   */
+  void Process();
+
+private:
+  CGUIBenchmark();
+  CGUIBenchmark(const CGUIBenchmark&);
+  CGUIBenchmark const& operator=(CGUIBenchmark const&);
+
+  bool Load();
+  void Finish();
+
+  CStdString              m_strScript;
+  std::vector<CStdString> m_lines;
+  unsigned int            m_line;
+  unsigned int            m_wait;
+  unsigned int            m_frames;
+  bool                    m_started;
+};
@@ -135,3 +135,143 @@ bool CJSONVariantWriter::InternalWrite(yajl_gen g, const CVariant &value)
 
   return success;
 }
+
+CJSONVariantStream::CJSONVariantStream(CVariant &value, bool compact)
+{
+  m_value.swap(value);
+  m_error = false;
+
+#if YAJL_MAJOR == 2
+  m_gen = yajl_gen_alloc(NULL);
+  yajl_gen_config(m_gen, yajl_gen_beautify, compact ? 0 : 1);
+  yajl_gen_config(m_gen, yajl_gen_indent_string, "\t");
+#else
+  yajl_gen_config conf = { compact ? 0 : 1, "\t" };
+  m_gen = yajl_gen_alloc(&conf, NULL);
+#endif
+
+  CFrame frame;
+  frame.m_value = &m_value;
+  frame.m_opened = false;
+  m_stack.push_back(frame);
+}
+
+CJSONVariantStream::~CJSONVariantStream()
+{
+  yajl_gen_free(m_gen);
+}
+
+bool CJSONVariantStream::Read(string &data, unsigned int size)
+{
+  data.clear();
+  if (m_error)
+    return false;
+
+  // Set locale to classic ("C") to ensure valid JSON numbers
+  std::string currentLocale = setlocale(LC_NUMERIC, NULL);
+  setlocale(LC_NUMERIC, "C");
+
+  const unsigned char * buffer;
+#if YAJL_MAJOR == 2
+  size_t length = 0;
+#else
+  unsigned int length = 0;
+#endif
+  while (!m_stack.empty() && length < size)
+  {
+    if (!WriteNext())
+    {
+      m_error = true;
+      break;
+    }
+    yajl_gen_get_buf(m_gen, &buffer, &length);
+  }
+
+  setlocale(LC_NUMERIC, currentLocale.c_str());
+
+  if (m_error)
+    return false;
+
+  // only drops the output, the generator keeps its state for the next part
+  yajl_gen_get_buf(m_gen, &buffer, &length);
+  data.assign((const char *)buffer, length);
+  yajl_gen_clear(m_gen);
+
+  return !data.empty();
+}
+
+bool CJSONVariantStream::WriteNext()
+{
+  CFrame &frame = m_stack.back();
+  CVariant &value = *frame.m_value;
+  bool done = false;
+
+  if (value.isArray())
+  {
+    if (!frame.m_opened)
+    {
+      if (yajl_gen_array_open(m_gen) != yajl_gen_status_ok)
+        return false;
+      frame.m_opened = true;
+      frame.m_array = value.begin_array();
+    }
+    else if (frame.m_array != value.end_array())
+    {
+      CFrame child;
+      child.m_value = &*frame.m_array++;
+      child.m_opened = false;
+      m_stack.push_back(child); // invalidates frame
+      return true;
+    }
+    else
+    {
+      if (yajl_gen_array_close(m_gen) != yajl_gen_status_ok)
+        return false;
+      done = true;
+    }
+  }
+  else if (value.isObject())
+  {
+    if (!frame.m_opened)
+    {
+      if (yajl_gen_map_open(m_gen) != yajl_gen_status_ok)
+        return false;
+      frame.m_opened = true;
+      frame.m_map = value.begin_map();
+    }
+    else if (frame.m_map != value.end_map())
+    {
+#if YAJL_MAJOR == 2
+      if (yajl_gen_string(m_gen, (const unsigned char*)frame.m_map->first.c_str(), (size_t)frame.m_map->first.length()) != yajl_gen_status_ok)
+#else
+      if (yajl_gen_string(m_gen, (const unsigned char*)frame.m_map->first.c_str(), frame.m_map->first.length()) != yajl_gen_status_ok)
+#endif
+        return false;
+      CFrame child;
+      child.m_value = &(frame.m_map++)->second;
+      child.m_opened = false;
+      m_stack.push_back(child); // invalidates frame
+      return true;
+    }
+    else
+    {
+      if (yajl_gen_map_close(m_gen) != yajl_gen_status_ok)
+        return false;
+      done = true;
+    }
+  }
+  else
+  {
+    if (!CJSONVariantWriter::InternalWrite(m_gen, value))
+      return false;
+    done = true;
+  }
+
+  if (done)
+  { // release what has been written
+    CVariant written;
+    written.swap(value);
+    m_stack.pop_back();
+  }
+  return true;
+}
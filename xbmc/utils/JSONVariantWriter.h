@@ -22,6 +22,7 @@
 
 #include "system.h"
 #include "Variant.h"
+#include <vector>
 #include <yajl/yajl_gen.h>
 #ifdef HAVE_YAJL_YAJL_VERSION_H
 #include <yajl/yajl_version.h>
@@ -29,8 +30,53 @@
 
 class CJSONVariantWriter
 {
+  friend class CJSONVariantStream;
 public:
   static std::string Write(const CVariant &value, bool compact);
 private:
   static bool InternalWrite(yajl_gen g, const CVariant &value);
 };
+
+/*!
+ \brief Serializes a CVariant a part at a time
+
+ Unlike CJSONVariantWriter::Write() the JSON isn't produced in one go: every call
+ to Read() continues where the previous one stopped. The value is taken over on
+ construction and every part of it is released as soon as it has been written, so
+ a large value and its serialized form are never both fully in memory.
+ */
+class CJSONVariantStream
+{
+public:
+  /*!
+   \brief Prepare to serialize a value
+   \param value the value to serialize, which is left null
+   \param compact whether to leave out whitespace
+   */
+  CJSONVariantStream(CVariant &value, bool compact);
+  ~CJSONVariantStream();
+
+  /*!
+   \brief Serialize the next part of the value
+   \param data [out] the next part of the JSON
+   \param size the amount of data wanted, which may be exceeded by a single long string
+   \return false once the value has been written completely
+   */
+  bool Read(std::string &data, unsigned int size);
+
+private:
+  bool WriteNext();
+
+  struct CFrame
+  {
+    CVariant *m_value;
+    bool m_opened;
+    CVariant::iterator_array m_array;
+    CVariant::iterator_map m_map;
+  };
+
+  CVariant m_value;
+  std::vector<CFrame> m_stack;
+  yajl_gen m_gen;
+  bool m_error;
+};
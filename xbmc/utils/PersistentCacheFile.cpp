@@ -0,0 +1,131 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+
+#include "PersistentCacheFile.h"
+#include "filesystem/Directory.h"
+#include "utils/Crc32.h"
+
+using namespace XFILE;
+
+CPersistentCacheFile::CPersistentCacheFile(const CStdString &directory, const CStdString &extension, int version)
+  : m_directory(directory), m_extension(extension), m_version(version)
+{
+  m_archive = NULL;
+  m_size = 0;
+}
+
+CPersistentCacheFile::~CPersistentCacheFile()
+{
+  Close();
+}
+
+CStdString CPersistentCacheFile::GetFile(const CStdString &key) const
+{
+  Crc32 crc;
+  crc.ComputeFromLowerCase(key);
+
+  CStdString cacheFile;
+  cacheFile.Format("%s%08x%s", m_directory.c_str(), (unsigned __int32)crc, m_extension.c_str());
+  return cacheFile;
+}
+
+CArchive *CPersistentCacheFile::Load(const CStdString &key)
+{
+  CStdString storedKey;
+  if (!Open(GetFile(key), storedKey))
+    return NULL;
+
+  // the crc may collide
+  if (storedKey != key)
+  {
+    Close();
+    return NULL;
+  }
+  return m_archive;
+}
+
+CArchive *CPersistentCacheFile::Open(const CStdString &file, CStdString &key)
+{
+  Close();
+  if (!m_file.Open(file))
+    return NULL;
+
+  m_archive = new CArchive(&m_file, CArchive::load);
+  int version = 0;
+  *m_archive >> version;
+  if (version != m_version)
+  {
+    Close();
+    return NULL;
+  }
+  *m_archive >> key;
+  return m_archive;
+}
+
+CArchive *CPersistentCacheFile::Store(const CStdString &key)
+{
+  Close();
+  m_cacheFile = GetFile(key);
+  CStdString tempFile = m_cacheFile + ".tmp";
+  if (!m_file.OpenForWrite(tempFile, true))
+  {
+    // the cache directory may not exist yet
+    if (!CDirectory::Create(m_directory) || !m_file.OpenForWrite(tempFile, true))
+    {
+      m_cacheFile.Empty();
+      return NULL;
+    }
+  }
+
+  m_archive = new CArchive(&m_file, CArchive::store);
+  *m_archive << m_version;
+  *m_archive << key;
+  return m_archive;
+}
+
+bool CPersistentCacheFile::Close()
+{
+  if (!m_archive)
+    return false;
+
+  m_archive->Close();
+  delete m_archive;
+  m_archive = NULL;
+
+  bool stored = false;
+  if (!m_cacheFile.IsEmpty())
+  {
+    m_size = m_file.GetLength();
+    m_file.Close();
+
+    CStdString tempFile = m_cacheFile + ".tmp";
+    CFile::Delete(m_cacheFile);
+    stored = CFile::Rename(tempFile, m_cacheFile);
+    if (!stored)
+      CFile::Delete(tempFile);
+    m_cacheFile.Empty();
+  }
+  else
+    m_file.Close();
+
+  return stored;
+}
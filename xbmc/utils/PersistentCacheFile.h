@@ -0,0 +1,90 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+
+#include "StdString.h"
+#include "filesystem/File.h"
+#include "utils/Archive.h"
+
+/*!
+ \brief An entry of an on-disk cache, kept in a file named by the crc of its key.
+
+ The file starts with a version and the key. Load() checks both, so entries
+ in an older format or with a colliding crc are treated as missing. Store()
+ writes to a temporary file that Close() renames into place, so a reader
+ never sees a partially written entry.
+
+ \code
+ CPersistentCacheFile entry("special://temp/mycache/", ".bin", MY_CACHE_VERSION);
+ CArchive *ar = entry.Store(key);
+ if (ar)
+ {
+   *ar << data;
+   entry.Close();
+ }
+ \endcode
+ */
+class CPersistentCacheFile
+{
+public:
+  CPersistentCacheFile(const CStdString &directory, const CStdString &extension, int version);
+  ~CPersistentCacheFile();
+
+  /*! \brief The cache file of a key */
+  CStdString GetFile(const CStdString &key) const;
+
+  /*! \brief Open the entry of a key for reading
+   \return the archive positioned after the header, NULL if there is no valid entry
+   */
+  CArchive *Load(const CStdString &key);
+
+  /*! \brief Open a cache file for reading without knowing its key, e.g. to list the cache
+   \param file the cache file
+   \param key set to the key stored in the file
+   \return the archive positioned after the header, NULL if the file isn't a valid entry
+   */
+  CArchive *Open(const CStdString &file, CStdString &key);
+
+  /*! \brief Start writing the entry of a key, which replaces the entry on Close()
+   \return the archive positioned after the header, NULL if the file couldn't be created
+   */
+  CArchive *Store(const CStdString &key);
+
+  /*! \brief Finish reading or writing
+   \return true if a stored entry was put in place
+   */
+  bool Close();
+
+  /*! \brief The size of the last entry stored */
+  int64_t GetSize() const { return m_size; };
+
+private:
+  CStdString      m_directory;
+  CStdString      m_extension;
+  int             m_version;
+
+  XFILE::CFile    m_file;
+  CArchive       *m_archive;
+  CStdString      m_cacheFile;  ///< the file being stored, empty while loading
+  int64_t         m_size;
+};
@@ -0,0 +1,388 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+
+#include "system.h"
+#include "RealFFT.h"
+#include "threads/CriticalSection.h"
+#include "threads/SingleLock.h"
+#include <math.h>
+#include <map>
+
+#ifdef __SSE__
+#include <xmmintrin.h>
+#endif
+
+#ifdef __ARM_NEON__
+#include <arm_neon.h>
+#endif
+
+#ifndef M_PI
+#define M_PI 3.1415926535897932384626433832795
+#endif
+
+/* rows of the twiddle table are padded to whole vectors */
+#define ROW_LENGTH(h) (((h) + 3) & ~3)
+
+/*
+  one radix-4 pass made of two radix-2 decimation in time stages, the first
+  with twiddle w1 = W(2h)^j, the second with w2 = W(4h)^j and W(4h)^(j+h) = -i * w2
+*/
+static void Radix4Scalar(float *re, float *im, unsigned int n, unsigned int h, const float *tw)
+{
+  const float *w1r = tw;
+  const float *w1i = tw + ROW_LENGTH(h);
+  const float *w2r = tw + ROW_LENGTH(h) * 2;
+  const float *w2i = tw + ROW_LENGTH(h) * 3;
+  for (unsigned int b = 0; b < n; b += 4 * h)
+  {
+    for (unsigned int j = 0; j < h; ++j)
+    {
+      unsigned int i0 = b + j, i1 = i0 + h, i2 = i1 + h, i3 = i2 + h;
+
+      float tr = re[i1] * w1r[j] - im[i1] * w1i[j];
+      float ti = re[i1] * w1i[j] + im[i1] * w1r[j];
+      float b0r = re[i0] + tr, b0i = im[i0] + ti;
+      float b1r = re[i0] - tr, b1i = im[i0] - ti;
+
+      tr = re[i3] * w1r[j] - im[i3] * w1i[j];
+      ti = re[i3] * w1i[j] + im[i3] * w1r[j];
+      float b2r = re[i2] + tr, b2i = im[i2] + ti;
+      float b3r = re[i2] - tr, b3i = im[i2] - ti;
+
+      float ur = b2r * w2r[j] - b2i * w2i[j];
+      float ui = b2r * w2i[j] + b2i * w2r[j];
+      /* v = -i * b3 * w2 */
+      float vi = -(b3r * w2r[j] - b3i * w2i[j]);
+      float vr =   b3r * w2i[j] + b3i * w2r[j];
+
+      re[i0] = b0r + ur; im[i0] = b0i + ui;
+      re[i2] = b0r - ur; im[i2] = b0i - ui;
+      re[i1] = b1r + vr; im[i1] = b1i + vi;
+      re[i3] = b1r - vr; im[i3] = b1i - vi;
+    }
+  }
+}
+
+/* h must be a multiple of 4 */
+static void Radix4(float *re, float *im, unsigned int n, unsigned int h, const float *tw)
+{
+#if defined(__SSE__)
+  const float *w1r = tw;
+  const float *w1i = tw + h;
+  const float *w2r = tw + h * 2;
+  const float *w2i = tw + h * 3;
+  for (unsigned int b = 0; b < n; b += 4 * h)
+  {
+    float *r = re + b, *i = im + b;
+    for (unsigned int j = 0; j < h; j += 4)
+    {
+      __m128 wr = _mm_load_ps(w1r + j), wi = _mm_load_ps(w1i + j);
+
+      __m128 ar = _mm_loadu_ps(r + j + h), ai = _mm_loadu_ps(i + j + h);
+      __m128 tr = _mm_sub_ps(_mm_mul_ps(ar, wr), _mm_mul_ps(ai, wi));
+      __m128 ti = _mm_add_ps(_mm_mul_ps(ar, wi), _mm_mul_ps(ai, wr));
+      ar = _mm_loadu_ps(r + j); ai = _mm_loadu_ps(i + j);
+      __m128 b0r = _mm_add_ps(ar, tr), b0i = _mm_add_ps(ai, ti);
+      __m128 b1r = _mm_sub_ps(ar, tr), b1i = _mm_sub_ps(ai, ti);
+
+      ar = _mm_loadu_ps(r + j + 3 * h); ai = _mm_loadu_ps(i + j + 3 * h);
+      tr = _mm_sub_ps(_mm_mul_ps(ar, wr), _mm_mul_ps(ai, wi));
+      ti = _mm_add_ps(_mm_mul_ps(ar, wi), _mm_mul_ps(ai, wr));
+      ar = _mm_loadu_ps(r + j + 2 * h); ai = _mm_loadu_ps(i + j + 2 * h);
+      __m128 b2r = _mm_add_ps(ar, tr), b2i = _mm_add_ps(ai, ti);
+      __m128 b3r = _mm_sub_ps(ar, tr), b3i = _mm_sub_ps(ai, ti);
+
+      wr = _mm_load_ps(w2r + j); wi = _mm_load_ps(w2i + j);
+      __m128 ur = _mm_sub_ps(_mm_mul_ps(b2r, wr), _mm_mul_ps(b2i, wi));
+      __m128 ui = _mm_add_ps(_mm_mul_ps(b2r, wi), _mm_mul_ps(b2i, wr));
+      __m128 vi = _mm_sub_ps(_mm_mul_ps(b3i, wi), _mm_mul_ps(b3r, wr));
+      __m128 vr = _mm_add_ps(_mm_mul_ps(b3r, wi), _mm_mul_ps(b3i, wr));
+
+      _mm_storeu_ps(r + j        , _mm_add_ps(b0r, ur)); _mm_storeu_ps(i + j        , _mm_add_ps(b0i, ui));
+      _mm_storeu_ps(r + j + 2 * h, _mm_sub_ps(b0r, ur)); _mm_storeu_ps(i + j + 2 * h, _mm_sub_ps(b0i, ui));
+      _mm_storeu_ps(r + j + h    , _mm_add_ps(b1r, vr)); _mm_storeu_ps(i + j + h    , _mm_add_ps(b1i, vi));
+      _mm_storeu_ps(r + j + 3 * h, _mm_sub_ps(b1r, vr)); _mm_storeu_ps(i + j + 3 * h, _mm_sub_ps(b1i, vi));
+    }
+  }
+#elif defined(__ARM_NEON__)
+  const float *w1r = tw;
+  const float *w1i = tw + h;
+  const float *w2r = tw + h * 2;
+  const float *w2i = tw + h * 3;
+  for (unsigned int b = 0; b < n; b += 4 * h)
+  {
+    float *r = re + b, *i = im + b;
+    for (unsigned int j = 0; j < h; j += 4)
+    {
+      float32x4_t wr = vld1q_f32(w1r + j), wi = vld1q_f32(w1i + j);
+
+      float32x4_t ar = vld1q_f32(r + j + h), ai = vld1q_f32(i + j + h);
+      float32x4_t tr = vmlsq_f32(vmulq_f32(ar, wr), ai, wi);
+      float32x4_t ti = vmlaq_f32(vmulq_f32(ar, wi), ai, wr);
+      ar = vld1q_f32(r + j); ai = vld1q_f32(i + j);
+      float32x4_t b0r = vaddq_f32(ar, tr), b0i = vaddq_f32(ai, ti);
+      float32x4_t b1r = vsubq_f32(ar, tr), b1i = vsubq_f32(ai, ti);
+
+      ar = vld1q_f32(r + j + 3 * h); ai = vld1q_f32(i + j + 3 * h);
+      tr = vmlsq_f32(vmulq_f32(ar, wr), ai, wi);
+      ti = vmlaq_f32(vmulq_f32(ar, wi), ai, wr);
+      ar = vld1q_f32(r + j + 2 * h); ai = vld1q_f32(i + j + 2 * h);
+      float32x4_t b2r = vaddq_f32(ar, tr), b2i = vaddq_f32(ai, ti);
+      float32x4_t b3r = vsubq_f32(ar, tr), b3i = vsubq_f32(ai, ti);
+
+      wr = vld1q_f32(w2r + j); wi = vld1q_f32(w2i + j);
+      float32x4_t ur = vmlsq_f32(vmulq_f32(b2r, wr), b2i, wi);
+      float32x4_t ui = vmlaq_f32(vmulq_f32(b2r, wi), b2i, wr);
+      float32x4_t vi = vmlsq_f32(vmulq_f32(b3i, wi), b3r, wr);
+      float32x4_t vr = vmlaq_f32(vmulq_f32(b3r, wi), b3i, wr);
+
+      vst1q_f32(r + j        , vaddq_f32(b0r, ur)); vst1q_f32(i + j        , vaddq_f32(b0i, ui));
+      vst1q_f32(r + j + 2 * h, vsubq_f32(b0r, ur)); vst1q_f32(i + j + 2 * h, vsubq_f32(b0i, ui));
+      vst1q_f32(r + j + h    , vaddq_f32(b1r, vr)); vst1q_f32(i + j + h    , vaddq_f32(b1i, vi));
+      vst1q_f32(r + j + 3 * h, vsubq_f32(b1r, vr)); vst1q_f32(i + j + 3 * h, vsubq_f32(b1i, vi));
+    }
+  }
+#else
+  Radix4Scalar(re, im, n, h, tw);
+#endif
+}
+
+/*
+  turn the n point complex transform of the even/odd packed input into bins
+  0 to n of the 2n point real transform:
+    E = (Z[k] + conj(Z[n-k])) / 2, O = -i (Z[k] - conj(Z[n-k])) / 2
+    X[k] = E + W^k O, X[n-k] = conj(E - W^k O)
+*/
+static inline void SplitScalar(float *re, float *im, unsigned int n, unsigned int k, const float *wr, const float *wi)
+{
+  float er =  0.5f * (re[k] + re[n - k]);
+  float ei =  0.5f * (im[k] - im[n - k]);
+  float or_ = 0.5f * (im[k] + im[n - k]);
+  float oi = -0.5f * (re[k] - re[n - k]);
+  float tr = wr[k] * or_ - wi[k] * oi;
+  float ti = wr[k] * oi  + wi[k] * or_;
+  re[k]     = er + tr; im[k]     = ei + ti;
+  re[n - k] = er - tr; im[n - k] = ti - ei;
+}
+
+static void Split(float *re, float *im, unsigned int n, const float *wr, const float *wi)
+{
+  unsigned int k = 1;
+#if defined(__SSE__)
+  const __m128 half = _mm_set_ps1(0.5f);
+  /* the k block must stay below the mirrored block */
+  for (; k + 3 < n - k - 3; k += 4)
+  {
+    __m128 ar = _mm_loadu_ps(re + k), ai = _mm_loadu_ps(im + k);
+    __m128 br = _mm_loadu_ps(re + n - k - 3), bi = _mm_loadu_ps(im + n - k - 3);
+    br = _mm_shuffle_ps(br, br, _MM_SHUFFLE(0, 1, 2, 3));
+    bi = _mm_shuffle_ps(bi, bi, _MM_SHUFFLE(0, 1, 2, 3));
+
+    __m128 er = _mm_mul_ps(half, _mm_add_ps(ar, br));
+    __m128 ei = _mm_mul_ps(half, _mm_sub_ps(ai, bi));
+    __m128 or_ = _mm_mul_ps(half, _mm_add_ps(ai, bi));
+    __m128 oi = _mm_mul_ps(half, _mm_sub_ps(br, ar));
+    __m128 w_r = _mm_loadu_ps(wr + k), w_i = _mm_loadu_ps(wi + k);
+    __m128 tr = _mm_sub_ps(_mm_mul_ps(w_r, or_), _mm_mul_ps(w_i, oi));
+    __m128 ti = _mm_add_ps(_mm_mul_ps(w_r, oi), _mm_mul_ps(w_i, or_));
+
+    _mm_storeu_ps(re + k, _mm_add_ps(er, tr));
+    _mm_storeu_ps(im + k, _mm_add_ps(ei, ti));
+    br = _mm_sub_ps(er, tr);
+    bi = _mm_sub_ps(ti, ei);
+    _mm_storeu_ps(re + n - k - 3, _mm_shuffle_ps(br, br, _MM_SHUFFLE(0, 1, 2, 3)));
+    _mm_storeu_ps(im + n - k - 3, _mm_shuffle_ps(bi, bi, _MM_SHUFFLE(0, 1, 2, 3)));
+  }
+#elif defined(__ARM_NEON__)
+  for (; k + 3 < n - k - 3; k += 4)
+  {
+    float32x4_t ar = vld1q_f32(re + k), ai = vld1q_f32(im + k);
+    float32x4_t br = vrev64q_f32(vld1q_f32(re + n - k - 3));
+    float32x4_t bi = vrev64q_f32(vld1q_f32(im + n - k - 3));
+    br = vcombine_f32(vget_high_f32(br), vget_low_f32(br));
+    bi = vcombine_f32(vget_high_f32(bi), vget_low_f32(bi));
+
+    float32x4_t er = vmulq_n_f32(vaddq_f32(ar, br), 0.5f);
+    float32x4_t ei = vmulq_n_f32(vsubq_f32(ai, bi), 0.5f);
+    float32x4_t or_ = vmulq_n_f32(vaddq_f32(ai, bi), 0.5f);
+    float32x4_t oi = vmulq_n_f32(vsubq_f32(br, ar), 0.5f);
+    float32x4_t w_r = vld1q_f32(wr + k), w_i = vld1q_f32(wi + k);
+    float32x4_t tr = vmlsq_f32(vmulq_f32(w_r, or_), w_i, oi);
+    float32x4_t ti = vmlaq_f32(vmulq_f32(w_r, oi), w_i, or_);
+
+    vst1q_f32(re + k, vaddq_f32(er, tr));
+    vst1q_f32(im + k, vaddq_f32(ei, ti));
+    br = vrev64q_f32(vsubq_f32(er, tr));
+    bi = vrev64q_f32(vsubq_f32(ti, ei));
+    vst1q_f32(re + n - k - 3, vcombine_f32(vget_high_f32(br), vget_low_f32(br)));
+    vst1q_f32(im + n - k - 3, vcombine_f32(vget_high_f32(bi), vget_low_f32(bi)));
+  }
+#endif
+  for (; k <= n / 2; ++k)
+    SplitScalar(re, im, n, k, wr, wi);
+}
+
+class CRealFFTPlans
+{
+public:
+  ~CRealFFTPlans()
+  {
+    for (std::map<unsigned int, CRealFFT*>::iterator it = m_plans.begin(); it != m_plans.end(); ++it)
+      delete it->second;
+  }
+
+  CCriticalSection                    m_section;
+  std::map<unsigned int, CRealFFT*>   m_plans;
+};
+
+static CRealFFTPlans g_realFFTPlans;
+
+const CRealFFT *CRealFFT::Get(unsigned int size)
+{
+  if (size < 16 || (size & (size - 1)))
+    return NULL;
+
+  CSingleLock lock(g_realFFTPlans.m_section);
+  std::map<unsigned int, CRealFFT*>::iterator it = g_realFFTPlans.m_plans.find(size);
+  if (it != g_realFFTPlans.m_plans.end())
+    return it->second;
+
+  CRealFFT *plan = new CRealFFT(size);
+  g_realFFTPlans.m_plans[size] = plan;
+  return plan;
+}
+
+CRealFFT::CRealFFT(unsigned int size) :
+  m_size(size),
+  m_half(size / 2)
+{
+  unsigned int bits = 0;
+  while ((1U << bits) < m_half)
+    ++bits;
+  m_radix2 = (bits & 1) != 0;
+
+  m_reverse = new unsigned int[m_half];
+  for (unsigned int i = 0; i < m_half; ++i)
+  {
+    unsigned int r = 0;
+    for (unsigned int b = 0; b < bits; ++b)
+      r |= ((i >> b) & 1) << (bits - 1 - b);
+    m_reverse[i] = r;
+  }
+
+  /* the radix-4 passes run from h = 1 or 2 up to m_half / 4 */
+  unsigned int length = 0;
+  for (unsigned int h = m_radix2 ? 2 : 1; h < m_half; h *= 4)
+    length += ROW_LENGTH(h) * 4;
+  m_twiddles = (float*)_aligned_malloc(length * sizeof(float), 16);
+
+  float *tw = m_twiddles;
+  for (unsigned int h = m_radix2 ? 2 : 1; h < m_half; h *= 4)
+  {
+    const unsigned int row = ROW_LENGTH(h);
+    for (unsigned int j = 0; j < row; ++j)
+    {
+      tw[j          ] = (float) cos(M_PI * j / h);
+      tw[j + row    ] = (float)-sin(M_PI * j / h);
+      tw[j + row * 2] = (float) cos(M_PI * j / (2 * h));
+      tw[j + row * 3] = (float)-sin(M_PI * j / (2 * h));
+    }
+    tw += row * 4;
+  }
+
+  m_splitRe = (float*)_aligned_malloc((m_half / 2 + 4) * sizeof(float), 16);
+  m_splitIm = (float*)_aligned_malloc((m_half / 2 + 4) * sizeof(float), 16);
+  for (unsigned int k = 0; k < m_half / 2 + 4; ++k)
+  {
+    m_splitRe[k] = (float) cos(2.0 * M_PI * k / m_size);
+    m_splitIm[k] = (float)-sin(2.0 * M_PI * k / m_size);
+  }
+}
+
+CRealFFT::~CRealFFT()
+{
+  delete[] m_reverse;
+  _aligned_free(m_twiddles);
+  _aligned_free(m_splitRe);
+  _aligned_free(m_splitIm);
+}
+
+void CRealFFT::Forward(const float *in, float *re, float *im) const
+{
+  /* pack even samples as real and odd samples as imaginary, in bit reversed order */
+  for (unsigned int i = 0; i < m_half; ++i)
+  {
+    const unsigned int r = m_reverse[i];
+    re[r] = in[i * 2    ];
+    im[r] = in[i * 2 + 1];
+  }
+
+  unsigned int h = 1;
+  if (m_radix2)
+  {
+    for (unsigned int i = 0; i < m_half; i += 2)
+    {
+      float r = re[i + 1], m = im[i + 1];
+      re[i + 1] = re[i] - r; im[i + 1] = im[i] - m;
+      re[i    ] += r;        im[i    ] += m;
+    }
+    h = 2;
+  }
+
+  const float *tw = m_twiddles;
+  for (; h < m_half; h *= 4)
+  {
+    if (h < 4)
+      Radix4Scalar(re, im, m_half, h, tw);
+    else
+      Radix4(re, im, m_half, h, tw);
+    tw += ROW_LENGTH(h) * 4;
+  }
+
+  /* bin n/2 comes from bin 0, do it before the split step overwrites it */
+  float dc = re[0];
+  re[0]      = dc + im[0];
+  re[m_half] = dc - im[0];
+  im[0]      = 0.0f;
+  im[m_half] = 0.0f;
+  Split(re, im, m_half, m_splitRe, m_splitIm);
+}
+
+void CRealFFT::Power(const float *re, const float *im, float *power, unsigned int count)
+{
+  unsigned int i = 0;
+#if defined(__SSE__)
+  for (; i + 4 <= count; i += 4)
+  {
+    __m128 r = _mm_loadu_ps(re + i), m = _mm_loadu_ps(im + i);
+    _mm_storeu_ps(power + i, _mm_add_ps(_mm_mul_ps(r, r), _mm_mul_ps(m, m)));
+  }
+#elif defined(__ARM_NEON__)
+  for (; i + 4 <= count; i += 4)
+  {
+    float32x4_t r = vld1q_f32(re + i), m = vld1q_f32(im + i);
+    vst1q_f32(power + i, vmlaq_f32(vmulq_f32(r, r), m, m));
+  }
+#endif
+  for (; i < count; ++i)
+    power[i] = re[i] * re[i] + im[i] * im[i];
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+
+/*!
+ \brief Forward FFT of real input, shared by the visualisations and audio analysis.
+
+ The transform of N real samples is done as an N/2 point complex FFT followed
+ by a split step. The complex FFT runs radix-4 passes (with one radix-2 pass
+ when needed) over split real/imaginary arrays, vectorised with SSE or NEON.
+ Twiddles and the bit reversal table are computed once per size; plans are
+ cached and shared, use Get() to obtain one.
+ */
+class CRealFFT
+{
+public:
+  /*!
+   \brief Get the plan for a transform size, creating it on first use.
+   \param size the number of real input samples, a power of two of at least 16.
+   \return the shared plan, or NULL if the size is not supported.
+   */
+  static const CRealFFT *Get(unsigned int size);
+
+  ~CRealFFT();
+
+  unsigned int GetSize() const { return m_size; }
+
+  /*!
+   \brief Transform GetSize() real samples.
+   Plans are stateless so this may be called from several threads at once.
+   \param in the input samples.
+   \param re receives the real part of bins 0 to GetSize() / 2.
+   \param im receives the imaginary part of bins 0 to GetSize() / 2.
+   */
+  void Forward(const float *in, float *re, float *im) const;
+
+  /*! \brief Set power[i] = re[i]^2 + im[i]^2 for count bins */
+  static void Power(const float *re, const float *im, float *power, unsigned int count);
+
+private:
+  CRealFFT(unsigned int size);
+
+  unsigned int  m_size;
+  unsigned int  m_half;       /* size of the complex transform */
+  bool          m_radix2;     /* log2(m_half) is odd, start with a radix-2 pass */
+  unsigned int *m_reverse;    /* bit reversal of the complex input index */
+  float        *m_twiddles;   /* w1 re, w1 im, w2 re, w2 im rows of each radix-4 pass */
+  float        *m_splitRe;    /* e^(-2 pi i k / size) for the split step */
+  float        *m_splitIm;
+};
@@ -34,7 +34,11 @@
 
 #include "TimeSmoother.h"
 
-int64_t CurrentHostCounter(void)
+static double  hostCounterSpeed = 1.0;
+static int64_t hostCounterRealBase = 0;
+static int64_t hostCounterVirtualBase = 0;
+
+static int64_t RealHostCounter(void)
 {
 #if   defined(TARGET_DARWIN)
   return( (int64_t)CVGetCurrentHostTime() );
@@ -62,6 +66,31 @@ int64_t CurrentHostFrequency(void)
 #endif
 }
 
+int64_t CurrentHostCounter(void)
+{
+  if (hostCounterSpeed == 1.0)
+    return RealHostCounter() - hostCounterRealBase + hostCounterVirtualBase;
+
+  return hostCounterVirtualBase + (int64_t)((RealHostCounter() - hostCounterRealBase) * hostCounterSpeed);
+}
+
+void SetHostCounterSpeed(double speed)
+{
+  if (speed <= 0.0)
+    speed = 1.0;
+
+  // rebase so the counter continues from where it is now
+  int64_t now = CurrentHostCounter();
+  hostCounterRealBase    = RealHostCounter();
+  hostCounterVirtualBase = now;
+  hostCounterSpeed       = speed;
+}
+
+double GetHostCounterSpeed(void)
+{
+  return hostCounterSpeed;
+}
+
 CTimeSmoother *CTimeUtils::frameTimer = NULL;
 unsigned int CTimeUtils::frameTime = 0;
 
@@ -30,6 +30,14 @@ class CTimeSmoother;
 int64_t CurrentHostCounter(void);
 int64_t CurrentHostFrequency(void);
 
+/*! \brief Run the host counter faster (or slower) than real time.
+ Used by offline test harnesses to play media faster than real time; the
+ counter stays monotonic across speed changes. Code that sleeps until a host
+ counter target should divide its real sleep by GetHostCounterSpeed().
+ */
+void   SetHostCounterSpeed(double speed);
+double GetHostCounterSpeed(void);
+
 class CTimeUtils
 {
 public:
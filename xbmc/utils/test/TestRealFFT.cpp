@@ -0,0 +1,105 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+
+#include "utils/RealFFT.h"
+#include "utils/fft.h"
+
+#include <boost/test/unit_test.hpp>
+#include <math.h>
+#include <stdlib.h>
+#include <vector>
+
+#define TEST_SIZE 512
+
+static void Noise(std::vector<float> &data, unsigned int size)
+{
+  data.resize(size);
+  srand(size);
+  for (unsigned int i = 0; i < size; ++i)
+    data[i] = (float)rand() / RAND_MAX * 2.0f - 1.0f;
+}
+
+BOOST_AUTO_TEST_CASE(TestRealFFTAccuracy)
+{
+  BOOST_CHECK(CRealFFT::Get(8) == NULL);
+  BOOST_CHECK(CRealFFT::Get(100) == NULL);
+
+  /* compare against a direct DFT in double precision */
+  for (unsigned int size = 16; size <= 4096; size *= 2)
+  {
+    const CRealFFT *plan = CRealFFT::Get(size);
+    BOOST_REQUIRE(plan != NULL);
+    BOOST_CHECK(plan == CRealFFT::Get(size));
+
+    std::vector<float> in;
+    Noise(in, size);
+    std::vector<float> re(size / 2 + 1), im(size / 2 + 1);
+    plan->Forward(&in[0], &re[0], &im[0]);
+
+    double maxError = 0.0;
+    for (unsigned int k = 0; k <= size / 2; ++k)
+    {
+      double xr = 0.0, xi = 0.0;
+      for (unsigned int n = 0; n < size; ++n)
+      {
+        xr += in[n] * cos(2.0 * M_PI * k * n / size);
+        xi -= in[n] * sin(2.0 * M_PI * k * n / size);
+      }
+      maxError = std::max(maxError, std::max(fabs(xr - re[k]), fabs(xi - im[k])));
+    }
+
+    /* rms of the bins is sqrt(size / 3) for uniform noise */
+    double relative = maxError / sqrt(size / 3.0);
+    BOOST_CHECK_MESSAGE(relative < 1e-5, "size " << size << " relative error " << relative);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(TestRealFFTMatchesLegacy)
+{
+  /* the visualisation transform: two channels of TEST_SIZE samples */
+  std::vector<float> left, right, work(TEST_SIZE * 2);
+  Noise(left, TEST_SIZE);
+  Noise(right, TEST_SIZE);
+  for (unsigned int i = 0; i < TEST_SIZE; ++i)
+  {
+    work[i * 2    ] = left[i];
+    work[i * 2 + 1] = right[i];
+  }
+
+  const CRealFFT *plan = CRealFFT::Get(TEST_SIZE);
+  BOOST_REQUIRE(plan != NULL);
+  std::vector<float> re(TEST_SIZE / 2 + 1), im(TEST_SIZE / 2 + 1), power(TEST_SIZE + 2);
+  plan->Forward(&left[0], &re[0], &im[0]);
+  CRealFFT::Power(&re[0], &im[0], &power[0], TEST_SIZE / 2 + 1);
+  plan->Forward(&right[0], &re[0], &im[0]);
+  CRealFFT::Power(&re[0], &im[0], &power[TEST_SIZE / 2 + 1], TEST_SIZE / 2 + 1);
+
+  /* both must agree on the spectrum, twochannelrfft returns 2|X|^2 */
+  twochannelrfft(&work[0], TEST_SIZE);
+  double maxError = 0.0, maxPower = 0.0;
+  for (unsigned int k = 1; k < TEST_SIZE / 2; ++k)
+  {
+    maxError = std::max(maxError, (double)fabs(work[k * 2] - 2.0f * power[k]));
+    maxPower = std::max(maxPower, (double)work[k * 2]);
+  }
+  BOOST_CHECK(maxError < maxPower * 1e-4);
+}
@@ -23,6 +23,7 @@
 #include "FileItem.h"
 #include "VideoInfoScanner.h"
 #include "addons/AddonManager.h"
+#include "cores/dvdplayer/DVDDemuxers/DVDDemuxProbeCache.h"
 #include "filesystem/DirectoryCache.h"
 #include "Util.h"
 #include "NfoFile.h"
@@ -127,6 +128,11 @@ namespace VIDEO
 
       tick = XbmcThreads::SystemClockMillis() - tick;
       CLog::Log(LOGNOTICE, "VideoInfoScanner: Finished scan. Scanning for video info took %s", StringUtils::SecondsToTimeString(tick / 1000).c_str());
+      g_directoryCache.PrintPersistentStats();
+#ifdef _DEBUG
+      g_directoryCache.PrintStats();
+#endif
+      CDVDDemuxProbeCache::Get().PrintStats();
       ANNOUNCEMENT::CAnnouncementManager::Announce(ANNOUNCEMENT::VideoLibrary, "xbmc", "OnScanFinished");
       
       m_bRunning = false;
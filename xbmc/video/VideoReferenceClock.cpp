@@ -1314,7 +1314,7 @@ int64_t CVideoReferenceClock::Wait(int64_t Target)
     SingleLock.Leave();
     Now = CurrentHostCounter();
     //sleep until the timestamp has passed
-    SleepTime = (int)((Target - (Now + ClockOffset)) * 1000 / m_SystemFrequency);
+    SleepTime = (int)((Target - (Now + ClockOffset)) * 1000 / m_SystemFrequency / GetHostCounterSpeed());
     if (SleepTime > 0)
       ::Sleep(SleepTime);
 
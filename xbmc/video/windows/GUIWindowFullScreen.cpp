@@ -1016,7 +1016,8 @@ void CGUIWindowFullScreen::RenderTTFSubtitles()
       float maxWidth = (float) g_settings.m_ResInfo[res].Overscan.right - g_settings.m_ResInfo[res].Overscan.left;
       m_subsLayout->Update(subtitleText, maxWidth * 0.9f, false, true); // true to force LTR reading order (most Hebrew subs are this format)
 
-      int subalign = g_guiSettings.GetInt("subtitles.align");
+      static CSettingHandle subtitleAlign("subtitles.align");
+      int subalign = g_guiSettings.GetInt(subtitleAlign);
       float textWidth, textHeight;
       m_subsLayout->GetTextExtent(textWidth, textHeight);
       float x = maxWidth * 0.5f + g_settings.m_ResInfo[res].Overscan.left;
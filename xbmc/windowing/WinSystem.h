@@ -34,7 +34,8 @@ typedef enum _WindowSystemType
   WINDOW_SYSTEM_X11,
   WINDOW_SYSTEM_SDL,
   WINDOW_SYSTEM_EGL,
-  WINDOW_SYSTEM_ANDROID
+  WINDOW_SYSTEM_ANDROID,
+  WINDOW_SYSTEM_NULL
 } WindowSystemType;
 
 struct RESOLUTION_WHR
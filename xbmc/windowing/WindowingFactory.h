@@ -24,7 +24,10 @@
 
 #include "system.h"
 
-#if   defined(TARGET_WINDOWS) && defined(HAS_GL)
+#if   defined(HAS_HEADLESS)
+#include "null/WinSystemNull.h"
+
+#elif defined(TARGET_WINDOWS) && defined(HAS_GL)
 #include "windows/WinSystemWin32GL.h"
 
 #elif defined(TARGET_WINDOWS) && defined(HAS_DX)
@@ -0,0 +1,96 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+
+#include "system.h"
+
+#ifdef HAS_HEADLESS
+
+#include "WinSystemNull.h"
+#include "settings/Settings.h"
+#include "utils/log.h"
+
+// the resolution of the screen we pretend to have
+#define NULL_SCREEN_WIDTH   1920
+#define NULL_SCREEN_HEIGHT  1080
+#define NULL_SCREEN_REFRESH 60.0f
+
+CWinSystemNull::CWinSystemNull() : CWinSystemBase()
+{
+  m_eWindowSystem = WINDOW_SYSTEM_NULL;
+}
+
+CWinSystemNull::~CWinSystemNull()
+{
+  DestroyWindowSystem();
+}
+
+bool CWinSystemNull::InitWindowSystem()
+{
+  CLog::Log(LOGNOTICE, "%s: rendering without a display at %dx%d", __FUNCTION__, NULL_SCREEN_WIDTH, NULL_SCREEN_HEIGHT);
+  return CWinSystemBase::InitWindowSystem();
+}
+
+bool CWinSystemNull::DestroyWindowSystem()
+{
+  return true;
+}
+
+bool CWinSystemNull::CreateNewWindow(const CStdString& name, bool fullScreen, RESOLUTION_INFO& res, PHANDLE_EVENT_FUNC userFunction)
+{
+  m_nWidth = res.iWidth;
+  m_nHeight = res.iHeight;
+  m_bFullScreen = fullScreen;
+  m_bWindowCreated = true;
+  return true;
+}
+
+bool CWinSystemNull::DestroyWindow()
+{
+  m_bWindowCreated = false;
+  return true;
+}
+
+bool CWinSystemNull::ResizeWindow(int newWidth, int newHeight, int newLeft, int newTop)
+{
+  m_nWidth = newWidth;
+  m_nHeight = newHeight;
+  m_nLeft = newLeft;
+  m_nTop = newTop;
+  CRenderSystemNull::ResetRenderSystem(newWidth, newHeight, false, 0);
+  return true;
+}
+
+bool CWinSystemNull::SetFullScreen(bool fullScreen, RESOLUTION_INFO& res, bool blankOtherDisplays)
+{
+  CreateNewWindow("", fullScreen, res, NULL);
+  CRenderSystemNull::ResetRenderSystem(res.iWidth, res.iHeight, fullScreen, res.fRefreshRate);
+  return true;
+}
+
+void CWinSystemNull::UpdateResolutions()
+{
+  CWinSystemBase::UpdateResolutions();
+
+  UpdateDesktopResolution(g_settings.m_ResInfo[RES_DESKTOP], 0, NULL_SCREEN_WIDTH, NULL_SCREEN_HEIGHT, NULL_SCREEN_REFRESH);
+}
+
+#endif
@@ -0,0 +1,50 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "rendering/null/RenderSystemNull.h"
+#include "utils/GlobalsHandling.h"
+#include "windowing/WinSystem.h"
+
+/*!
+ \brief Window system without a display, for headless builds
+ \sa CRenderSystemNull
+ */
+class CWinSystemNull : public CWinSystemBase, public CRenderSystemNull
+{
+public:
+  CWinSystemNull();
+  virtual ~CWinSystemNull();
+
+  virtual bool InitWindowSystem();
+  virtual bool DestroyWindowSystem();
+  virtual bool CreateNewWindow(const CStdString& name, bool fullScreen, RESOLUTION_INFO& res, PHANDLE_EVENT_FUNC userFunction);
+  virtual bool DestroyWindow();
+  virtual bool ResizeWindow(int newWidth, int newHeight, int newLeft, int newTop);
+  virtual bool SetFullScreen(bool fullScreen, RESOLUTION_INFO& res, bool blankOtherDisplays);
+  virtual void UpdateResolutions();
+  virtual int  GetNumScreens() { return 1; }
+  virtual bool HasCursor() { return false; }
+};
+
+XBMC_GLOBAL_REF(CWinSystemNull,g_Windowing);
+#define g_Windowing XBMC_GLOBAL_USE(CWinSystemNull)
@@ -112,6 +112,10 @@ void CGUIWindowDebugInfo::Process(unsigned int currentTime, CDirtyRegionList &di
     info.Format("LOG: %sxbmc.log\nMEM: %"PRIu64"/%"PRIu64" KB - FPS: %2.1f fps\nCPU: %s (CPU-XBMC %4.2f%%%s)", g_settings.m_logFolder.c_str(),
                 stat.ullAvailPhys/1024, stat.ullTotalPhys/1024, g_infoManager.GetFPS(), strCores.c_str(), dCPU, profiling.c_str());
 #endif
+    info.AppendFormat("\nGUI: %u controls processed, %u rendered, %u culled",
+                      g_windowManager.GetControlCount(CGUIWindowManager::CONTROL_PROCESSED),
+                      g_windowManager.GetControlCount(CGUIWindowManager::CONTROL_RENDERED),
+                      g_windowManager.GetControlCount(CGUIWindowManager::CONTROL_CULLED));
   }
 
   // render the skin debug info